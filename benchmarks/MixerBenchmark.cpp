@@ -0,0 +1,161 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+/*
+* This file compares the summing functions of MixerKernels with the scalar loop
+* the Mixer used to run, which cleared each output stream and then added the
+* input streams to it one at a time. Each function sums a varying number of
+* input streams over a varying number of samples, and the results are printed
+* as JSON on the standard output. Only the instruction sets supported by the
+* CPU are measured. Every function is also checked against the scalar loop.
+*
+* The benchmark must be compiled along with ANGLECORE's sources, with
+* optimizations turned on. Passing "--quick" as an argument only runs a reduced
+* grid, which is useful for a quick check.
+*/
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "../source/core/audioworkflow/MixerKernels.h"
+#include "../source/utility/AlignedAllocator.h"
+
+using namespace ANGLECORE;
+
+/** Stream buffer, aligned like the ones of a StreamArena */
+typedef std::vector<floating_type, AlignedAllocator<floating_type, ANGLECORE_CACHE_LINE_SIZE>> Buffer;
+
+/** Total number of samples to mix for each measurement */
+static const uint64_t NUM_MEASURED_SAMPLES = 1 << 24;
+
+struct Measurement
+{
+    const char* function;
+    unsigned int numInputs;
+    unsigned int numSamples;
+    double nanosecondsPerInputSample;
+    bool matchesReference;
+};
+
+/** The scalar loop the Mixer used before MixerKernels */
+static void sumReference(floating_type* output, const floating_type* const* inputs, unsigned int numInputs, unsigned int numSamples)
+{
+    for (unsigned int s = 0; s < numSamples; s++)
+        output[s] = static_cast<floating_type>(0.0);
+    for (unsigned int i = 0; i < numInputs; i++)
+        for (unsigned int s = 0; s < numSamples; s++)
+            output[s] += inputs[i][s];
+}
+
+/**
+* Measures the given summing function, and appends the result to
+* \p measurements.
+*/
+static void measure(const char* name, MixerKernels::SumFunction function, unsigned int numInputs, unsigned int numSamples, std::vector<Measurement>& measurements)
+{
+    std::vector<Buffer> inputBuffers(numInputs, Buffer(numSamples));
+    std::vector<const floating_type*> inputs(numInputs);
+    for (unsigned int i = 0; i < numInputs; i++)
+    {
+        for (unsigned int s = 0; s < numSamples; s++)
+            inputBuffers[i][s] = static_cast<floating_type>(std::sin(0.01 * (i + 1) * s));
+        inputs[i] = inputBuffers[i].data();
+    }
+
+    Buffer output(numSamples);
+    Buffer expectedOutput(numSamples);
+    sumReference(expectedOutput.data(), inputs.data(), numInputs, numSamples);
+
+    /*
+    * The functions may sum the inputs in a different order than the reference,
+    * so we allow for rounding errors.
+    */
+    function(output.data(), inputs.data(), numInputs, numSamples);
+    bool matchesReference = true;
+    for (unsigned int s = 0; s < numSamples; s++)
+        matchesReference = matchesReference && std::fabs(output[s] - expectedOutput[s]) <= 1e-4 * (numInputs + 1);
+
+    uint64_t numCalls = std::max(static_cast<uint64_t>(1), NUM_MEASURED_SAMPLES / (static_cast<uint64_t>(numInputs) * numSamples));
+    for (uint64_t c = 0; c < numCalls / 10 + 1; c++)
+        function(output.data(), inputs.data(), numInputs, numSamples);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint64_t c = 0; c < numCalls; c++)
+        function(output.data(), inputs.data(), numInputs, numSamples);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    Measurement measurement;
+    measurement.function = name;
+    measurement.numInputs = numInputs;
+    measurement.numSamples = numSamples;
+    measurement.nanosecondsPerInputSample = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / (static_cast<double>(numCalls) * numInputs * numSamples);
+    measurement.matchesReference = matchesReference;
+    measurements.push_back(measurement);
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::vector<unsigned int> inputCounts = { 1, 2, 4, 8, 32, 64, 320 };
+    std::vector<unsigned int> sampleCounts = { 32, 64, 512, 4096 };
+    if (quick)
+    {
+        inputCounts = { 4, 320 };
+        sampleCounts = { 64, 512 };
+    }
+
+    MixerKernels::InstructionSet bestInstructionSet = MixerKernels::detectInstructionSet();
+
+    std::vector<Measurement> measurements;
+    for (unsigned int numInputs : inputCounts)
+        for (unsigned int numSamples : sampleCounts)
+        {
+            measure("reference", &sumReference, numInputs, numSamples, measurements);
+            for (int i = 0; i <= bestInstructionSet; i++)
+            {
+                MixerKernels::InstructionSet instructionSet = static_cast<MixerKernels::InstructionSet>(i);
+                measure(MixerKernels::getName(instructionSet), MixerKernels::getSumFunction(instructionSet), numInputs, numSamples, measurements);
+            }
+        }
+
+    std::printf("{\n");
+    std::printf("  \"benchmark\": \"MixerKernels\",\n");
+    std::printf("  \"sampleSize\": %u,\n", static_cast<unsigned int>(sizeof(floating_type)));
+    std::printf("  \"detectedInstructionSet\": \"%s\",\n", MixerKernels::getName(bestInstructionSet));
+    std::printf("  \"results\": [\n");
+    for (size_t i = 0; i < measurements.size(); i++)
+    {
+        const Measurement& m = measurements[i];
+        std::printf("    {\"function\": \"%s\", \"inputs\": %u, \"samples\": %u, \"nsPerInputSample\": %.4f, \"matchesReference\": %s}%s\n",
+            m.function, m.numInputs, m.numSamples, m.nanosecondsPerInputSample, m.matchesReference ? "true" : "false", i + 1 < measurements.size() ? "," : "");
+    }
+    std::printf("  ]\n");
+    std::printf("}\n");
+
+    return 0;
+}
@@ -0,0 +1,261 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+/*
+* This file measures the cost of the ParameterGenerator's transients, with
+* hundreds of parameters ramping at the same time, and compares it with the
+* recurrence the ParameterGenerator used to run, in which each sample was
+* computed from the previous one. It also measures how far both approaches
+* drift from the exact ramp over a long transient. The results are printed as
+* JSON on the standard output.
+*
+* The benchmark must be compiled along with ANGLECORE's sources, with
+* optimizations turned on. Passing "--quick" as an argument only runs a reduced
+* grid, which is useful for a quick check.
+*/
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "../source/core/audioworkflow/parameter/ParameterGenerator.h"
+#include "../source/core/audioworkflow/workflow/Stream.h"
+#include "../source/core/audioworkflow/workflow/StreamArena.h"
+
+using namespace ANGLECORE;
+
+/** Total number of samples to generate for each measurement */
+static const uint64_t NUM_MEASURED_SAMPLES = 1 << 24;
+
+/** Duration of the transients, which is longer than any measurement */
+static const uint32_t TRANSIENT_DURATION = 1 << 30;
+
+/** Duration of the transient used to measure the drift, in samples */
+static const uint32_t DRIFT_TRANSIENT_DURATION = 480000;
+
+struct Measurement
+{
+    const char* implementation;
+    const char* method;
+    unsigned int numParameters;
+    unsigned int numSamples;
+    double nanosecondsPerChunk;
+};
+
+struct Drift
+{
+    const char* implementation;
+    const char* method;
+    double maxRelativeError;
+};
+
+static const char* getName(Parameter::SmoothingMethod method)
+{
+    return method == Parameter::SmoothingMethod::ADDITIVE ? "additive" : "multiplicative";
+}
+
+/** The recurrence the ParameterGenerator used to run while in a transient */
+static void rampReference(Parameter::SmoothingMethod method, floating_type* output, floating_type& currentValue, floating_type increment, unsigned int numSamples)
+{
+    if (method == Parameter::SmoothingMethod::ADDITIVE)
+    {
+        output[0] = currentValue + increment;
+        for (unsigned int i = 1; i < numSamples; i++)
+            output[i] = output[i - 1] + increment;
+    }
+    else
+    {
+        output[0] = currentValue * increment;
+        for (unsigned int i = 1; i < numSamples; i++)
+            output[i] = output[i - 1] * increment;
+    }
+    currentValue = output[numSamples - 1];
+}
+
+/**
+* Measures the cost of rendering one chunk of \p numSamples samples with
+* \p numParameters parameters in a transient, both with the ParameterGenerator
+* and with the reference recurrence, and appends the results to
+* \p measurements.
+*/
+static void measure(Parameter::SmoothingMethod method, unsigned int numParameters, unsigned int numSamples, std::vector<Measurement>& measurements)
+{
+    StreamArena arena(numSamples);
+    Parameter parameter("benchmark", 1.0, 0.001, 1000.0, method, false, 0);
+
+    std::vector<std::unique_ptr<ParameterGenerator>> generators;
+    std::vector<std::shared_ptr<Stream>> streams;
+    for (unsigned int p = 0; p < numParameters; p++)
+    {
+        generators.emplace_back(new ParameterGenerator(parameter));
+        streams.emplace_back(new Stream(arena));
+        generators[p]->connectOutput(0, streams[p]);
+
+        /* Every generator starts a long transient, which lasts for the whole measurement */
+        ParameterChangeRequest request;
+        request.newValue = static_cast<floating_type>(p % 2 == 0 ? 1000.0 : 0.001);
+        request.durationInSamples = TRANSIENT_DURATION;
+        generators[p]->postParameterChangeRequest(request);
+    }
+
+    uint64_t numChunks = std::max(static_cast<uint64_t>(1), NUM_MEASURED_SAMPLES / (static_cast<uint64_t>(numParameters) * numSamples));
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint64_t c = 0; c < numChunks; c++)
+        for (unsigned int p = 0; p < numParameters; p++)
+            generators[p]->work(numSamples);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    Measurement measurement;
+    measurement.implementation = "closedForm";
+    measurement.method = getName(method);
+    measurement.numParameters = numParameters;
+    measurement.numSamples = numSamples;
+    measurement.nanosecondsPerChunk = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / static_cast<double>(numChunks);
+    measurements.push_back(measurement);
+
+    /* The reference recurrence writes into the same streams */
+    std::vector<floating_type> values(numParameters, static_cast<floating_type>(1.0));
+    floating_type increment = method == Parameter::SmoothingMethod::ADDITIVE ? static_cast<floating_type>(1e-6) : static_cast<floating_type>(1.0 + 1e-9);
+
+    start = std::chrono::steady_clock::now();
+    for (uint64_t c = 0; c < numChunks; c++)
+        for (unsigned int p = 0; p < numParameters; p++)
+            rampReference(method, generators[p]->getOutputStream(0), values[p], increment, numSamples);
+    end = std::chrono::steady_clock::now();
+
+    measurement.implementation = "recurrence";
+    measurement.nanosecondsPerChunk = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / static_cast<double>(numChunks);
+    measurements.push_back(measurement);
+}
+
+/**
+* Measures the maximal relative error between a long transient and the exact
+* ramp, both with the ParameterGenerator and with the reference recurrence,
+* and appends the results to \p drifts.
+*/
+static void measureDrift(Parameter::SmoothingMethod method, std::vector<Drift>& drifts)
+{
+    const unsigned int chunkSize = 512;
+    const double startValue = method == Parameter::SmoothingMethod::ADDITIVE ? 0.0 : 0.001;
+    const double targetValue = 1000.0;
+
+    StreamArena arena(chunkSize);
+    Parameter parameter("drift", static_cast<floating_type>(startValue), 0.0, 1000.0, method, false, 0);
+    ParameterGenerator generator(parameter);
+    std::shared_ptr<Stream> stream(new Stream(arena));
+    generator.connectOutput(0, stream);
+
+    /* The first call fills the stream with the default value */
+    generator.work(chunkSize);
+
+    ParameterChangeRequest request;
+    request.newValue = static_cast<floating_type>(targetValue);
+    request.durationInSamples = DRIFT_TRANSIENT_DURATION;
+    generator.postParameterChangeRequest(request);
+
+    /* The exact value of the ramp at the given position */
+    auto exactValue = [&](uint32_t position) -> double
+    {
+        double t = static_cast<double>(position) / DRIFT_TRANSIENT_DURATION;
+        if (method == Parameter::SmoothingMethod::ADDITIVE)
+            return startValue + t * (targetValue - startValue);
+        return startValue * std::pow(targetValue / startValue, t);
+    };
+
+    /* The reference uses the same increment as the ParameterGenerator */
+    floating_type increment = method == Parameter::SmoothingMethod::ADDITIVE
+        ? static_cast<floating_type>((targetValue - startValue) / DRIFT_TRANSIENT_DURATION)
+        : static_cast<floating_type>(std::exp((std::log(targetValue) - std::log(startValue)) / DRIFT_TRANSIENT_DURATION));
+    floating_type referenceValue = static_cast<floating_type>(startValue);
+    std::vector<floating_type> reference(chunkSize);
+
+    double closedFormError = 0.0;
+    double referenceError = 0.0;
+    for (uint32_t position = 0; position < DRIFT_TRANSIENT_DURATION; position += chunkSize)
+    {
+        generator.work(chunkSize);
+        rampReference(method, reference.data(), referenceValue, increment, chunkSize);
+
+        const floating_type* output = generator.getOutputStream(0);
+        for (uint32_t i = 0; i < chunkSize && position + i < DRIFT_TRANSIENT_DURATION; i++)
+        {
+            double exact = exactValue(position + i + 1);
+            closedFormError = std::max(closedFormError, std::fabs(output[i] - exact) / std::fabs(exact));
+            referenceError = std::max(referenceError, std::fabs(reference[i] - exact) / std::fabs(exact));
+        }
+    }
+
+    drifts.push_back({ "closedForm", getName(method), closedFormError });
+    drifts.push_back({ "recurrence", getName(method), referenceError });
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::vector<unsigned int> parameterCounts = { 1, 64, 256, 512 };
+    std::vector<unsigned int> sampleCounts = { 32, 64, 512 };
+    if (quick)
+    {
+        parameterCounts = { 256 };
+        sampleCounts = { 512 };
+    }
+
+    std::vector<Measurement> measurements;
+    for (int m = 0; m < Parameter::SmoothingMethod::NUM_METHODS; m++)
+        for (unsigned int numParameters : parameterCounts)
+            for (unsigned int numSamples : sampleCounts)
+                measure(static_cast<Parameter::SmoothingMethod>(m), numParameters, numSamples, measurements);
+
+    std::vector<Drift> drifts;
+    for (int m = 0; m < Parameter::SmoothingMethod::NUM_METHODS; m++)
+        measureDrift(static_cast<Parameter::SmoothingMethod>(m), drifts);
+
+    std::printf("{\n");
+    std::printf("  \"benchmark\": \"ParameterGenerator\",\n");
+    std::printf("  \"sampleSize\": %u,\n", static_cast<unsigned int>(sizeof(floating_type)));
+    std::printf("  \"results\": [\n");
+    for (size_t i = 0; i < measurements.size(); i++)
+    {
+        const Measurement& m = measurements[i];
+        std::printf("    {\"implementation\": \"%s\", \"method\": \"%s\", \"parameters\": %u, \"samples\": %u, \"nsPerChunk\": %.1f, \"nsPerSample\": %.4f}%s\n",
+            m.implementation, m.method, m.numParameters, m.numSamples, m.nanosecondsPerChunk, m.nanosecondsPerChunk / (static_cast<double>(m.numParameters) * m.numSamples), i + 1 < measurements.size() ? "," : "");
+    }
+    std::printf("  ],\n");
+    std::printf("  \"drift\": [\n");
+    for (size_t i = 0; i < drifts.size(); i++)
+    {
+        const Drift& d = drifts[i];
+        std::printf("    {\"implementation\": \"%s\", \"method\": \"%s\", \"transientDuration\": %u, \"maxRelativeError\": %.3e}%s\n",
+            d.implementation, d.method, DRIFT_TRANSIENT_DURATION, d.maxRelativeError, i + 1 < drifts.size() ? "," : "");
+    }
+    std::printf("  ]\n");
+    std::printf("}\n");
+
+    return 0;
+}
@@ -0,0 +1,325 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+/*
+* This file drives a Master the way a plugin would, while the real-time guard
+* watches the audio thread and the Renderer's helper threads: it adds
+* instruments, changes parameters from another thread and through parameter
+* events, and plays notes, in every rendering mode. Each violation is printed on
+* the standard error output, and the program exits with a non-zero status if
+* any occurred, so that it can be used as a check.
+*
+* To make sure the guard is not silently disabled, the check starts with
+* positive controls, which deliberately allocate memory and lock a Mutex on a
+* real-time thread, first directly and then from within an Instrument in every
+* rendering mode. The program also exits with a non-zero status if any of these
+* violations goes unreported.
+*
+* The check must be compiled along with ANGLECORE's sources, with
+* ANGLECORE_ENABLE_REALTIME_GUARD set to 1.
+*/
+
+#include <stdint.h>
+#include <cstdio>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <memory>
+
+#include "../source/core/master/Master.h"
+
+#if !ANGLECORE_ENABLE_REALTIME_GUARD
+#error "This check must be compiled with ANGLECORE_ENABLE_REALTIME_GUARD set to 1."
+#endif
+
+using namespace ANGLECORE;
+
+/*
+* =====================================================================
+* VIOLATION COUNTING
+* =====================================================================
+*/
+
+static std::atomic<uint64_t> g_numViolations(0);
+
+/** True while a positive control runs, in which case violations are expected */
+static std::atomic<bool> g_areViolationsExpected(false);
+
+/** Counts and prints each violation reported by the guard */
+static void countViolation(const char* description)
+{
+    g_numViolations++;
+    if (!g_areViolationsExpected.load())
+        std::fprintf(stderr, "Real-time violation: %s\n", description);
+}
+
+/** Destination of the deliberate allocations, so they are not optimized away */
+static int* volatile g_allocationSink = nullptr;
+
+/** Allocates and frees memory, which the guard must report on a real-time thread */
+static void allocateDeliberately()
+{
+    g_allocationSink = new int(0);
+    delete g_allocationSink;
+}
+
+/*
+* =====================================================================
+* SYNTHETIC INSTRUMENT
+* =====================================================================
+*/
+
+/**
+* Sine oscillator following the frequency of the note, with a short release. It
+* allocates memory on every call to play() while s_isMisbehaving is true.
+*/
+class CheckOscillator :
+    public Instrument
+{
+public:
+    static std::atomic<bool> s_isMisbehaving;
+
+    CheckOscillator() :
+        Instrument({ ContextParameter::FREQUENCY_OVER_SAMPLE_RATE }, {
+            Parameter("gain", 0.1, 0.0, 1.0, Parameter::SmoothingMethod::ADDITIVE, false, 0),
+            Parameter("detune", 1.0, 0.5, 2.0, Parameter::SmoothingMethod::MULTIPLICATIVE, false, 64)
+        }),
+        m_phase(0.0)
+    {}
+
+    void reset() override { m_phase = 0.0; }
+    void startPlaying() override {}
+    uint32_t computeStopDurationInSamples() const override { return 256; }
+    void stopPlaying() override {}
+
+    void play(unsigned int numSamplesToPlay) override
+    {
+        const floating_type* frequencyOverSampleRate = getInputStream(0);
+        const floating_type* gain = getInputStream(1);
+        const floating_type* detune = getInputStream(2);
+        floating_type* left = getOutputStream(0);
+        floating_type* right = getOutputStream(1);
+        if (s_isMisbehaving.load(std::memory_order_relaxed))
+            allocateDeliberately();
+        for (unsigned int i = 0; i < numSamplesToPlay; i++)
+        {
+            m_phase += frequencyOverSampleRate[i] * detune[i];
+            if (m_phase >= 1.0)
+                m_phase -= 1.0;
+            left[i] = right[i] = gain[i] * std::sin(6.283185307179586 * m_phase);
+        }
+    }
+
+private:
+    double m_phase;
+};
+
+std::atomic<bool> CheckOscillator::s_isMisbehaving(false);
+
+/*
+* =====================================================================
+* CHECK
+* =====================================================================
+*/
+
+/** Counts the instruments processed by a Master */
+struct CountingListener :
+    public AddInstrumentListener<CheckOscillator>
+{
+    CountingListener(std::atomic<unsigned int>& counter) : m_counter(counter) {}
+
+    void addedInstrument(unsigned short, const AddInstrumentRequest<CheckOscillator>&) override { m_counter++; }
+    void failedToAddInstrument(unsigned short, const AddInstrumentRequest<CheckOscillator>&) override { m_counter++; }
+
+private:
+    std::atomic<unsigned int>& m_counter;
+};
+
+static const uint32_t MAX_BLOCK_SIZE = 2048;
+static const unsigned short NUM_RACKS = 4;
+static const uint32_t NUM_BLOCKS = 2000;
+static const uint32_t NUM_CONTROL_BLOCKS = 200;
+
+/** Block sizes the host cycles through, including ones larger than a Stream */
+static const uint32_t BLOCK_SIZES[] = { 64, 511, 1024, 2048, 1, 300 };
+
+/**
+* Drives a Master in the given rendering mode for at least the given number of
+* audio blocks, and returns the number of violations.
+*/
+static uint64_t runCheck(Renderer::RenderingMode renderingMode, unsigned short numHelperThreads, uint32_t numBlocks)
+{
+    std::vector<export_type> left(MAX_BLOCK_SIZE);
+    std::vector<export_type> right(MAX_BLOCK_SIZE);
+    export_type* buffer[2] = { left.data(), right.data() };
+
+    uint64_t numViolationsBefore = g_numViolations.load();
+    std::atomic<unsigned int> numInstrumentsProcessed(0);
+    CountingListener listener(numInstrumentsProcessed);
+
+    Master master(renderingMode, numHelperThreads);
+    master.setSampleRate(48000.0);
+
+    /*
+    * A non real-time thread adds the instruments one by one while the audio is
+    * rendered, and keeps changing their parameters, by identifier and by handle.
+    */
+    std::atomic<bool> isRendering(true);
+    std::thread controlThread([&]()
+    {
+        for (unsigned short r = 0; r < NUM_RACKS; r++)
+        {
+            master.addInstrument<CheckOscillator>(&listener);
+            while (numInstrumentsProcessed.load() <= r)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        ParameterHandle handle = master.getParameterHandle(0, "gain");
+        for (unsigned int i = 0; isRendering.load(); i++)
+        {
+            master.setParameterValue(i % NUM_RACKS, "detune", 1.0 + 0.001 * (i % 100));
+            master.setParameterValue(handle, 0.05 + 0.0001 * (i % 100));
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    ParameterHandle eventHandles[NUM_RACKS];
+    /*
+    * Requests are only processed while rendering, so we keep rendering until
+    * every Instrument has been added, even if that takes more than numBlocks.
+    */
+    for (uint32_t b = 0; b < numBlocks || numInstrumentsProcessed.load() < NUM_RACKS; b++)
+    {
+        uint32_t blockSize = BLOCK_SIZES[b % (sizeof(BLOCK_SIZES) / sizeof(BLOCK_SIZES[0]))];
+
+        /*
+        * We start and stop notes in every block, so that voices are turned on,
+        * released, and stolen once every voice is busy.
+        */
+        master.clearMIDIBufferForNextAudioBlock();
+        MIDIMessage& noteOn = master.pushBackNewMIDIMessage();
+        noteOn.type = MIDIMessage::NOTE_ON;
+        noteOn.noteNumber = static_cast<unsigned char>(36 + b % 48);
+        noteOn.noteVelocity = 100;
+        noteOn.timestamp = 0;
+        if (b % 3 == 0)
+        {
+            MIDIMessage& noteOff = master.pushBackNewMIDIMessage();
+            noteOff.type = MIDIMessage::NOTE_OFF;
+            noteOff.noteNumber = static_cast<unsigned char>(36 + (b + 24) % 48);
+            noteOff.noteVelocity = 0;
+            noteOff.timestamp = blockSize / 2;
+        }
+
+        /* Handles are retrieved ahead of time, outside of the audio callback */
+        master.clearParameterEventsForNextAudioBlock();
+        for (unsigned short r = 0; r < NUM_RACKS; r++)
+        {
+            if (b % 64 == 0)
+                eventHandles[r] = master.getParameterHandle(r, "gain");
+            ParameterEvent& event = master.pushBackNewParameterEvent();
+            event.parameter = eventHandles[r];
+            event.newValue = 0.05 + 0.01 * (b % 8);
+            event.timestamp = (b * 7 + r) % blockSize;
+            event.durationInSamples = 32;
+        }
+
+        master.renderNextAudioBlock(buffer, 2, blockSize);
+
+        if (b % 16 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    isRendering.store(false);
+    controlThread.join();
+
+    return g_numViolations.load() - numViolationsBefore;
+}
+
+/**
+* Deliberately allocates memory and locks a Mutex within a real-time scope, and
+* returns true if the guard reported all three violations.
+*/
+static bool runDirectControl()
+{
+    uint64_t numViolationsBefore = g_numViolations.load();
+    g_areViolationsExpected.store(true);
+    {
+        RealtimeThreadScope scope;
+        allocateDeliberately();
+
+        Mutex mutex;
+        std::lock_guard<Mutex> scopedLock(mutex);
+    }
+    g_areViolationsExpected.store(false);
+
+    return g_numViolations.load() - numViolationsBefore == 3;
+}
+
+int main()
+{
+    RealtimeThreadScope::setViolationHandler(&countViolation);
+
+    bool areControlsCaught = runDirectControl();
+    std::printf("Direct control: %s\n", areControlsCaught ? "caught" : "MISSED");
+
+    struct Configuration
+    {
+        const char* name;
+        Renderer::RenderingMode renderingMode;
+        unsigned short numHelperThreads;
+    };
+
+    const Configuration configurations[] = {
+        { "SEQUENTIAL", Renderer::SEQUENTIAL, 0 },
+        { "VOICE_PARALLEL", Renderer::VOICE_PARALLEL, 3 },
+        { "DEPENDENCY_PARALLEL", Renderer::DEPENDENCY_PARALLEL, 3 }
+    };
+
+    /*
+    * The instruments first allocate memory on every call, so that each rendering
+    * mode must report violations.
+    */
+    CheckOscillator::s_isMisbehaving.store(true);
+    g_areViolationsExpected.store(true);
+    for (const Configuration& configuration : configurations)
+    {
+        bool isCaught = runCheck(configuration.renderingMode, configuration.numHelperThreads, NUM_CONTROL_BLOCKS) > 0;
+        std::printf("%s control: %s\n", configuration.name, isCaught ? "caught" : "MISSED");
+        areControlsCaught = areControlsCaught && isCaught;
+    }
+    g_areViolationsExpected.store(false);
+    CheckOscillator::s_isMisbehaving.store(false);
+
+    uint64_t numViolations = 0;
+    for (const Configuration& configuration : configurations)
+    {
+        uint64_t numConfigurationViolations = runCheck(configuration.renderingMode, configuration.numHelperThreads, NUM_BLOCKS);
+        std::printf("%s: %llu violation(s)\n", configuration.name, static_cast<unsigned long long>(numConfigurationViolations));
+        numViolations += numConfigurationViolations;
+    }
+
+    return numViolations == 0 && areControlsCaught ? 0 : 1;
+}
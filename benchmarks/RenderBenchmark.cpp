@@ -0,0 +1,449 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+/*
+* This file measures the performance of Master::renderNextAudioBlock() across a
+* grid of configurations (number of active voices, number of racks, host block
+* size and MIDI density), and prints the results as JSON on the standard output,
+* so that they can be stored and compared between versions. For each
+* configuration, it reports the rendering time per sample and the number of
+* memory allocations per audio block, which should always be zero.
+*
+* The benchmark must be compiled along with ANGLECORE's sources, with
+* optimizations turned on, and without the real-time guard, which would add its
+* own checks to the measured timings. Passing "--quick" as an argument only runs
+* a reduced grid, which is useful for a quick check.
+*/
+
+#include <stdint.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <memory>
+
+#include "../source/core/master/Master.h"
+
+#if ANGLECORE_ENABLE_REALTIME_GUARD
+#error "This benchmark must be compiled with ANGLECORE_ENABLE_REALTIME_GUARD set to 0."
+#endif
+
+using namespace ANGLECORE;
+
+/*
+* =====================================================================
+* ALLOCATION COUNTING
+* =====================================================================
+*/
+
+/*
+* We replace the global allocation functions to count the allocations performed
+* by any thread while a measurement is running. Counting only costs a relaxed
+* atomic increment, so it barely affects the timings.
+*/
+static std::atomic<bool> g_isCountingAllocations(false);
+static std::atomic<uint64_t> g_numAllocations(0);
+
+void* operator new(std::size_t size)
+{
+    if (g_isCountingAllocations.load(std::memory_order_relaxed))
+        g_numAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+/*
+* GCC warns about free() being called on memory from operator new once the
+* functions below are inlined into the benchmark, although that memory does come
+* from malloc(), so we silence that warning here.
+*/
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+/*
+* =====================================================================
+* SYNTHETIC INSTRUMENTS
+* =====================================================================
+*/
+
+/** Sine oscillator following the frequency of the note */
+class BenchmarkOscillator :
+    public Instrument
+{
+public:
+    BenchmarkOscillator() :
+        Instrument({ ContextParameter::FREQUENCY_OVER_SAMPLE_RATE }, { Parameter("gain", 0.1, 0.0, 1.0, Parameter::SmoothingMethod::ADDITIVE, false, 0) }),
+        m_phase(0.0)
+    {}
+
+    void reset() override { m_phase = 0.0; }
+    void startPlaying() override {}
+    uint32_t computeStopDurationInSamples() const override { return 0; }
+    void stopPlaying() override {}
+
+    void play(unsigned int numSamplesToPlay) override
+    {
+        const floating_type* frequencyOverSampleRate = getInputStream(0);
+        const floating_type* gain = getInputStream(1);
+        floating_type* left = getOutputStream(0);
+        floating_type* right = getOutputStream(1);
+        for (unsigned int i = 0; i < numSamplesToPlay; i++)
+        {
+            m_phase += frequencyOverSampleRate[i];
+            if (m_phase >= 1.0)
+                m_phase -= 1.0;
+            left[i] = right[i] = gain[i] * std::sin(6.283185307179586 * m_phase);
+        }
+    }
+
+private:
+    double m_phase;
+};
+
+/** White noise generator, based on a linear congruential generator */
+class BenchmarkNoise :
+    public Instrument
+{
+public:
+    BenchmarkNoise() :
+        Instrument({}, { Parameter("gain", 0.1, 0.0, 1.0, Parameter::SmoothingMethod::ADDITIVE, false, 0) }),
+        m_state(1)
+    {}
+
+    void reset() override { m_state = 1; }
+    void startPlaying() override {}
+    uint32_t computeStopDurationInSamples() const override { return 0; }
+    void stopPlaying() override {}
+
+    void play(unsigned int numSamplesToPlay) override
+    {
+        const floating_type* gain = getInputStream(0);
+        floating_type* left = getOutputStream(0);
+        floating_type* right = getOutputStream(1);
+        for (unsigned int i = 0; i < numSamplesToPlay; i++)
+        {
+            left[i] = gain[i] * nextSample();
+            right[i] = gain[i] * nextSample();
+        }
+    }
+
+protected:
+
+    /** Returns a pseudo-random value between -1.0 and 1.0 */
+    floating_type nextSample()
+    {
+        m_state = m_state * 1664525u + 1013904223u;
+        return static_cast<floating_type>(m_state) * static_cast<floating_type>(2.0 / 4294967296.0) - static_cast<floating_type>(1.0);
+    }
+
+private:
+    uint32_t m_state;
+};
+
+/** White noise filtered by a long cascade of biquads, to simulate a heavy Worker */
+class BenchmarkHeavyFilter :
+    public BenchmarkNoise
+{
+public:
+    static const unsigned int NUM_STAGES = 32;
+
+    BenchmarkHeavyFilter()
+    {
+        reset();
+    }
+
+    void reset() override
+    {
+        BenchmarkNoise::reset();
+        for (unsigned int s = 0; s < NUM_STAGES; s++)
+            for (unsigned int c = 0; c < 2; c++)
+                m_z1[s][c] = m_z2[s][c] = 0.0;
+    }
+
+    void play(unsigned int numSamplesToPlay) override
+    {
+        /* Coefficients of a gentle lowpass filter, in transposed direct form II */
+        const floating_type b0 = 0.0675, b1 = 0.135, b2 = 0.0675, a1 = -1.143, a2 = 0.413;
+
+        const floating_type* gain = getInputStream(0);
+        floating_type* outputs[2] = { getOutputStream(0), getOutputStream(1) };
+        for (unsigned int i = 0; i < numSamplesToPlay; i++)
+        {
+            for (unsigned int c = 0; c < 2; c++)
+            {
+                floating_type x = nextSample();
+                for (unsigned int s = 0; s < NUM_STAGES; s++)
+                {
+                    floating_type y = b0 * x + m_z1[s][c];
+                    m_z1[s][c] = b1 * x - a1 * y + m_z2[s][c];
+                    m_z2[s][c] = b2 * x - a2 * y;
+                    x = y;
+                }
+                outputs[c][i] = gain[i] * x;
+            }
+        }
+    }
+
+private:
+    floating_type m_z1[NUM_STAGES][2];
+    floating_type m_z2[NUM_STAGES][2];
+};
+
+/*
+* =====================================================================
+* BENCHMARK
+* =====================================================================
+*/
+
+/** Counts the instruments successfully added to a Master */
+template<class InstrumentType>
+struct CountingListener :
+    public AddInstrumentListener<InstrumentType>
+{
+    CountingListener(std::atomic<unsigned int>& counter) : m_counter(counter) {}
+
+    void addedInstrument(unsigned short, const AddInstrumentRequest<InstrumentType>&) override { m_counter++; }
+    void failedToAddInstrument(unsigned short, const AddInstrumentRequest<InstrumentType>&) override { m_counter++; }
+
+private:
+    std::atomic<unsigned int>& m_counter;
+};
+
+/** Description and results of one point of the grid */
+struct Measurement
+{
+    unsigned short numVoices;
+    unsigned short numRacks;
+    uint32_t blockSize;
+    uint32_t numMIDIEventsPerBlock;
+    double nanosecondsPerSample;
+    double allocationsPerBlock;
+};
+
+static const double SAMPLE_RATE = 48000.0;
+static const uint32_t MAX_BLOCK_SIZE = 4096;
+
+/** Number of samples rendered before measuring, and during each measurement */
+static const uint32_t NUM_WARMUP_SAMPLES = 8192;
+static const uint32_t NUM_MEASURED_SAMPLES = 48000;
+
+/**
+* Renders one audio block, preceded by the given number of MIDI events. The
+* events are NOTE_OFF messages for a note that is never played, so that they
+* split the block as much as real events would, without changing the number of
+* active voices.
+*/
+static void renderBlock(Master& master, export_type** buffer, uint32_t blockSize, uint32_t numMIDIEvents)
+{
+    master.clearMIDIBufferForNextAudioBlock();
+    for (uint32_t e = 0; e < numMIDIEvents; e++)
+    {
+        MIDIMessage& message = master.pushBackNewMIDIMessage();
+        message.type = MIDIMessage::NOTE_OFF;
+        message.noteNumber = 127;
+        message.noteVelocity = 0;
+        message.timestamp = static_cast<uint32_t>((static_cast<uint64_t>(e) * blockSize) / numMIDIEvents);
+    }
+    master.renderNextAudioBlock(buffer, 2, blockSize);
+}
+
+/** Adds an Instrument to the given rack, cycling through the synthetic instruments */
+static void addInstrument(Master& master, unsigned short rackNumber, std::vector<std::shared_ptr<void>>& listeners, std::atomic<unsigned int>& counter)
+{
+    switch (rackNumber % 3)
+    {
+    case 0:
+        {
+            std::shared_ptr<CountingListener<BenchmarkOscillator>> listener = std::make_shared<CountingListener<BenchmarkOscillator>>(counter);
+            master.addInstrument<BenchmarkOscillator>(listener.get());
+            listeners.push_back(listener);
+        }
+        break;
+    case 1:
+        {
+            std::shared_ptr<CountingListener<BenchmarkNoise>> listener = std::make_shared<CountingListener<BenchmarkNoise>>(counter);
+            master.addInstrument<BenchmarkNoise>(listener.get());
+            listeners.push_back(listener);
+        }
+        break;
+    default:
+        {
+            std::shared_ptr<CountingListener<BenchmarkHeavyFilter>> listener = std::make_shared<CountingListener<BenchmarkHeavyFilter>>(counter);
+            master.addInstrument<BenchmarkHeavyFilter>(listener.get());
+            listeners.push_back(listener);
+        }
+        break;
+    }
+}
+
+/**
+* Runs every configuration of block size and MIDI density on a Master with the
+* given number of racks and active voices, and appends the results to
+* \p measurements.
+*/
+static void runConfiguration(unsigned short numRacks, unsigned short numVoices, const std::vector<uint32_t>& blockSizes, const std::vector<uint32_t>& midiDensities, std::vector<Measurement>& measurements)
+{
+    std::vector<export_type> left(MAX_BLOCK_SIZE);
+    std::vector<export_type> right(MAX_BLOCK_SIZE);
+    export_type* buffer[2] = { left.data(), right.data() };
+
+    std::vector<std::shared_ptr<void>> listeners;
+    std::atomic<unsigned int> numInstrumentsProcessed(0);
+
+    Master master;
+    master.setSampleRate(SAMPLE_RATE);
+
+    /*
+    * Instruments are added asynchronously, and the requests are only processed
+    * when rendering, so we keep rendering until every Instrument has been added.
+    */
+    for (unsigned short r = 0; r < numRacks; r++)
+        addInstrument(master, r, listeners, numInstrumentsProcessed);
+    while (numInstrumentsProcessed.load() < numRacks)
+    {
+        renderBlock(master, buffer, 512, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    /* We then start one note per voice, which will play until the end */
+    master.clearMIDIBufferForNextAudioBlock();
+    for (unsigned short v = 0; v < numVoices; v++)
+    {
+        MIDIMessage& message = master.pushBackNewMIDIMessage();
+        message.type = MIDIMessage::NOTE_ON;
+        message.noteNumber = static_cast<unsigned char>(36 + v);
+        message.noteVelocity = 100;
+        message.timestamp = 0;
+    }
+    master.renderNextAudioBlock(buffer, 2, 512);
+
+    for (uint32_t blockSize : blockSizes)
+    {
+        for (uint32_t midiDensity : midiDensities)
+        {
+            /* A block cannot hold more events than samples */
+            uint32_t numMIDIEvents = std::min(midiDensity, blockSize);
+            uint32_t numWarmupBlocks = std::max(1u, NUM_WARMUP_SAMPLES / blockSize);
+            uint32_t numMeasuredBlocks = std::max(1u, NUM_MEASURED_SAMPLES / blockSize);
+
+            for (uint32_t b = 0; b < numWarmupBlocks; b++)
+                renderBlock(master, buffer, blockSize, numMIDIEvents);
+
+            uint64_t numAllocationsBefore = g_numAllocations.load();
+            g_isCountingAllocations.store(true);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            for (uint32_t b = 0; b < numMeasuredBlocks; b++)
+                renderBlock(master, buffer, blockSize, numMIDIEvents);
+
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            g_isCountingAllocations.store(false);
+            uint64_t numAllocations = g_numAllocations.load() - numAllocationsBefore;
+
+            Measurement measurement;
+            measurement.numVoices = numVoices;
+            measurement.numRacks = numRacks;
+            measurement.blockSize = blockSize;
+            measurement.numMIDIEventsPerBlock = numMIDIEvents;
+            measurement.nanosecondsPerSample = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / (static_cast<double>(numMeasuredBlocks) * blockSize);
+            measurement.allocationsPerBlock = static_cast<double>(numAllocations) / numMeasuredBlocks;
+            measurements.push_back(measurement);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool quick = (argc > 1 && std::strcmp(argv[1], "--quick") == 0);
+
+    std::vector<unsigned short> voiceCounts = { 1, 2, 4, 8, 16, 32 };
+    std::vector<unsigned short> rackCounts = { 1, 2, 5, 10 };
+    std::vector<uint32_t> blockSizes = { 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    std::vector<uint32_t> midiDensities = { 0, 1, 10, 100, 500 };
+    if (quick)
+    {
+        voiceCounts = { 1, 32 };
+        rackCounts = { 1, 10 };
+        blockSizes = { 32, 512, 4096 };
+        midiDensities = { 0, 100 };
+    }
+
+    std::vector<Measurement> measurements;
+    for (unsigned short numRacks : rackCounts)
+        for (unsigned short numVoices : voiceCounts)
+            runConfiguration(numRacks, numVoices, blockSizes, midiDensities, measurements);
+
+    std::printf("{\n");
+    std::printf("  \"benchmark\": \"Master::renderNextAudioBlock\",\n");
+    std::printf("  \"sampleRate\": %.1f,\n", SAMPLE_RATE);
+    std::printf("  \"results\": [\n");
+    for (size_t i = 0; i < measurements.size(); i++)
+    {
+        const Measurement& m = measurements[i];
+        std::printf("    {\"voices\": %u, \"racks\": %u, \"blockSize\": %u, \"midiEventsPerBlock\": %u, \"nsPerSample\": %.3f, \"allocationsPerBlock\": %.3f}%s\n",
+            m.numVoices, m.numRacks, m.blockSize, m.numMIDIEventsPerBlock, m.nanosecondsPerSample, m.allocationsPerBlock, i + 1 < measurements.size() ? "," : "");
+    }
+    std::printf("  ]\n");
+    std::printf("}\n");
+
+    return 0;
+}
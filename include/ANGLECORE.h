@@ -23,566 +23,618 @@
 #pragma once
 
 #include <stdint.h>
-#include <memory>
+#include <mutex>
+#include <cstddef>
+#include <atomic>
 #include <vector>
+#include <memory>
+#include <cstdint>
+#include <new>
 #include <unordered_map>
-#include <atomic>
+#include <cstring>
+#include <functional>
 #include <cassert>
 #include <thread>
 #include <array>
-#include <cstring>
-#include <functional>
-#include <mutex>
 #include <chrono>
+#include <fstream>
 #include <utility>
 
+
+/*
+=================================================
+Workflow
+=================================================
+*/
+
 namespace ANGLECORE
 {
-    /*
-    =================================================
-    General Configuration
-    =================================================
+    /**
+    * \struct WorkflowItem WorkflowItem.h
+    * Item of a workflow, with a unique ID.
     */
+    struct WorkflowItem
+    {
+        /** The ID of the workflow item. */
+        const uint32_t id;
 
-    #define ANGLECORE_PRECISION double          /**< Defines the precision of ANGLECORE's calculations as either single or double. It should equal float or double. Note that one can still use double precision within the workers of an AudioWorkflow if this is set to float. */
-    typedef ANGLECORE_PRECISION floating_type;
+        /**
+        * The constructor simply defines an ID for the new item, using a static
+        * integer variable.
+        */
+        WorkflowItem();
 
-    #define ANGLECORE_NUM_CHANNELS 2
-    #define ANGLECORE_EXPORT_TYPE float          /**< Defines the precision of ANGLECORE's export samples as either single or double. It should equal float or double. Note that one can still use double precision in an AudioWorkflow if this is set to float. */
-    typedef ANGLECORE_EXPORT_TYPE export_type;
+    private:
 
-    #define ANGLECORE_NUM_VOICES 32
+        /**
+        * This static variable is used to define a unique ID for each item in the
+        * workflow. Whenever an item is created, this integer is incremented. Note
+        * that using this method for creating IDs exposes our system to possible ID
+        * duplicates, especially with overflow. This should not a problem here:
+        * since the upper limit of uint32_t is approximately 4 billions, we are
+        * protected against 4 billions item creations, so we should be safe.
+        */
+        static uint32_t nextId;
+    };
+}
 
-    #define ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE 10
 
-    /*
-    =================================================
-    Utility
-    =================================================
-    */
+/*
+=================================================
+Configuration
+=================================================
+*/
+
+/*
+* =====================================================================
+* PROCESSING
+* =====================================================================
+*/
+
+#ifndef ANGLECORE_PRECISION
+#define ANGLECORE_PRECISION double          /**< Defines the precision of ANGLECORE's calculations as either single or double. It should equal float or double. Single precision doubles the number of samples each SIMD instruction processes in the workers. Note that one can still use double precision within the workers of an AudioWorkflow if this is set to float. This is a build-time choice for the whole engine: every Stream holds samples of this type, and there is neither a runtime switch between a float and a double engine, nor a way to request double-precision streams for some workers only. This can also be defined from the compiler's command line. */
+#endif
+#ifndef ANGLECORE_ACCUMULATION_PRECISION
+#define ANGLECORE_ACCUMULATION_PRECISION double     /**< Defines the precision the Mixer sums the instruments' outputs with. It should equal float or double. Keeping it to double while ANGLECORE_PRECISION is float avoids the rounding errors that accumulate when many voices are mixed together. Like ANGLECORE_PRECISION, it is fixed at build time and cannot be changed at runtime. This can also be defined from the compiler's command line. */
+#endif
+#define ANGLECORE_MIXER_CHUNK_SIZE 256      /**< Number of samples the Mixer sums at once when ANGLECORE_ACCUMULATION_PRECISION differs from ANGLECORE_PRECISION, using a buffer of that size on the stack. */
+#define ANGLECORE_MIXER_INPUTS_PER_PASS 4  /**< Maximum number of input streams the Mixer adds together before storing the result into its output stream. Higher values reduce the memory traffic on the output stream, but need more registers. */
+#define ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE 16  /**< Number of samples of a multiplicative Parameter transient computed from the same base value, each by multiplying it with a precomputed power of the transient's increment. */
+#define ANGLECORE_EXPORT_TYPE float          /**< Defines the precision of ANGLECORE's export samples as either single or double. It should equal float or double. Note that one can still use double precision in an AudioWorkflow if this is set to float. */
+
+/*
+* =====================================================================
+* MEMORY
+* =====================================================================
+*/
+
+#define ANGLECORE_DEFAULT_STREAM_SIZE 512  /**< Default size of the streams, used by the Master unless another size is given upon construction (the rendering will be splitted into chunks of this size). */
+#define ANGLECORE_NUM_VOICES 32
+#define ANGLECORE_MIDIBUFFER_SIZE 2048     /**< Maximum number of MIDI messages the engine can handle without resizing. */
+#define ANGLECORE_PARAMETER_EVENT_BUFFER_SIZE 1024  /**< Maximum number of timestamped parameter events the engine can handle in one audio block without resizing. */
+#define ANGLECORE_PARAMETER_MAX_NUM_SCHEDULED_CHANGES 64   /**< Maximum number of timestamped changes each ParameterGenerator can hold before rendering them. Further changes are dropped until the pending ones have been rendered. */
+#define ANGLECORE_RENDERER_SPIN_COUNT 1024   /**< Number of times a thread of the Renderer looks for something to render, or for the other threads to finish, before it stops spinning. Helper threads then sleep until the next rendering session, while the real-time thread yields the CPU between its checks. */
+#define ANGLECORE_RENDERER_MAX_PAUSES 64   /**< Maximum number of pause instructions a spinning thread of the Renderer executes between two attempts. The number doubles after each fruitless attempt until it reaches this value. */
+#define ANGLECORE_RENDERER_MAX_NUM_TASKS 16384  /**< Maximum number of workers the Renderer can schedule in DEPENDENCY_PARALLEL mode. It must be a power of two. Longer rendering sequences are rendered with a fallback mode. */
+#define ANGLECORE_CACHE_LINE_SIZE 64      /**< Size of a CPU cache line, in bytes, used to align the data accessed by the real-time thread. It must be a power of two. */
+#define ANGLECORE_STREAM_ARENA_SLAB_SIZE 2097152   /**< Size of each memory block the StreamArena allocates stream buffers from, in bytes. It must be a power of two, and should be a multiple of the system's huge page size (2 MiB on most platforms). Slabs are aligned on this size, so that each of them can be backed by whole huge pages, and enlarged to a multiple of it if needed to hold at least one stream buffer. */
+
+/*
+* =====================================================================
+* PROFILING
+* =====================================================================
+*/
+
+#ifndef ANGLECORE_ENABLE_PROFILING
+#define ANGLECORE_ENABLE_PROFILING 0        /**< Set to 1 to measure the time spent by the Renderer in each Worker. When set to 0, the profiling code is not compiled at all. This can also be defined from the compiler's command line. */
+#endif
+#define ANGLECORE_PROFILER_MAX_NUM_WORKERS 4096     /**< Maximum number of workers the profiler can keep track of. Workers beyond this limit in the rendering sequence are not measured. */
+
+#ifndef ANGLECORE_ENABLE_TRACING
+#define ANGLECORE_ENABLE_TRACING 0          /**< Set to 1 to be able to record the rendering sessions into a Chrome trace file (see Master::startTracing()). When set to 0, the tracing code is not compiled at all. This can also be defined from the compiler's command line. */
+#endif
+#define ANGLECORE_TRACER_QUEUE_SIZE 16384   /**< Maximum number of trace events each thread can hold before they are written to the trace file. Events are dropped when this limit is reached. */
+#define ANGLECORE_TRACER_DRAINING_PERIOD 10 /**< Time between two writings of the trace events into the trace file, in milliseconds. */
+
+/*
+* =====================================================================
+* LOAD MONITORING
+* =====================================================================
+*/
+
+#define ANGLECORE_LOAD_MONITOR_DEFAULT_BUDGET 0.8       /**< Default fraction of an audio block's duration the Master may spend rendering it. Blocks that take longer are counted as overruns. */
+#define ANGLECORE_LOAD_MONITOR_SMOOTHING_TIME 0.3       /**< Time constant of the smoothing applied to the DSP load, in seconds. */
+#define ANGLECORE_VOICE_LIMITER_SMOOTHING 0.05         /**< Weight given to each new audio block when the VoiceLimiter updates its estimates of the DSP load per voice. It should be between 0 and 1. */
+
+/*
+* =====================================================================
+* DEBUGGING
+* =====================================================================
+*/
+
+#ifndef ANGLECORE_ENABLE_REALTIME_GUARD
+#define ANGLECORE_ENABLE_REALTIME_GUARD 0   /**< Set to 1 in debug builds to report every memory allocation, deallocation and blocking lock performed by a real-time thread (see RealtimeThreadScope). This replaces the global operator new and operator delete. When set to 0, the guard is not compiled at all. This can also be defined from the compiler's command line. */
+#endif
+
+/*
+* =====================================================================
+* TYPE SHORTHANDS
+* =====================================================================
+*/
+
+namespace ANGLECORE
+{
+    typedef ANGLECORE_PRECISION floating_type;
+    typedef ANGLECORE_EXPORT_TYPE export_type;
+    typedef ANGLECORE_ACCUMULATION_PRECISION accumulation_type;
+}
+
 
+/*
+=================================================
+Utility
+=================================================
+*/
+
+namespace ANGLECORE
+{
     /**
-    * \struct StringView
-    * Provides a simplified version of the C++17 string_view feature for compiling
-    * with earlier versions of C++.
-    * A StringView is simply a view over an existing C string, which provides a
-    * simple interface for performing operations on that string.
-    * This structure only contains a pointer to a C string, but defines special
-    * comparison and hash operations which are applicable to that C string so that
-    * it can be properly used as a identifier inside an STL key-value container.
-    * Using a StringView instead of a std::string as a key type in such container
-    * will prevent undesired memory allocation and copies.
+    * \class RealtimeThreadScope RealtimeThreadScope.h
+    * Marks the calling thread as a real-time thread for as long as the object
+    * lives. When ANGLECORE_ENABLE_REALTIME_GUARD is set to 1, every memory
+    * allocation and deallocation made through the global operator new and
+    * operator delete, as well as every blocking lock of a Mutex, that occur on a
+    * real-time thread are reported as violations, along with the call stack when
+    * the platform allows it. Scopes can be nested. When the guard is disabled,
+    * this class does nothing and costs nothing.
+    *
+    * Only the locks taken through ANGLECORE's Mutex type are intercepted. A
+    * std::mutex, or any other synchronization primitive, locked on a real-time
+    * thread goes unnoticed, as do system calls that block without allocating,
+    * so the guard can only prove the presence of violations, not their absence.
     */
-    struct StringView
+    class RealtimeThreadScope
     {
+    public:
+
         /**
-        * The constructor simply stores the provided pointer to C string internally.
-        * It hereby provides an implicit conversion from const char* to StringView.
+        * Function called whenever a violation occurs, with a short description of
+        * the violation. It is called on the offending thread, while the guard is
+        * suspended, so it is allowed to allocate memory.
         */
-        StringView(const char* str) :
-            string_ptr(str)
-        {}
+        typedef void (*ViolationHandler)(const char* description);
+
+#if ANGLECORE_ENABLE_REALTIME_GUARD
+        /** Marks the calling thread as a real-time thread. */
+        RealtimeThreadScope();
 
         /**
-        * Comparing two StringViews consists in comparing their internal C strings,
-        * using strcmp.
+        * Restores the calling thread's previous state, which is non real-time
+        * unless the scope was nested inside another one.
         */
-        bool operator==(const StringView& other) const
-        {
-            return strcmp(string_ptr, other.string_ptr) == 0;
-        }
+        ~RealtimeThreadScope();
 
-        /** This is the internal pointer to the C string being viewed */
-        const char* string_ptr;
+        /** Returns true if the calling thread is currently in a real-time scope. */
+        static bool isActive();
+
+        /**
+        * Reports a violation if the calling thread is currently in a real-time
+        * scope, and does nothing otherwise.
+        * @param[in] description Short description of the violation. It must point
+        *   to a string literal.
+        */
+        static void check(const char* description);
+
+        /**
+        * Replaces the function called on each violation. By default, violations
+        * are printed to the standard error output, along with the call stack on
+        * platforms that support it.
+        * @param[in] handler The new handler. If null, the default one is used.
+        */
+        static void setViolationHandler(ViolationHandler handler);
+#else
+        RealtimeThreadScope() {}
+        static bool isActive() { return false; }
+        static void check(const char*) {}
+        static void setViolationHandler(ViolationHandler) {}
+#endif
+
+        RealtimeThreadScope(const RealtimeThreadScope&) = delete;
+        RealtimeThreadScope& operator=(const RealtimeThreadScope&) = delete;
     };
 
+#if ANGLECORE_ENABLE_REALTIME_GUARD
     /**
-    * \class Lockable Lockable.h
-    * Utility object that can be locked for handling concurrency issues. The class
-    * simply contains a mutex and a public method to access it by reference in order
-    * to lock it.
+    * \class GuardedMutex RealtimeThreadScope.h
+    * Mutex that reports a violation when a real-time thread blocks on it.
+    * Attempting to lock it with try_lock() is allowed, since it never blocks.
     */
-    class Lockable
+    class GuardedMutex
     {
     public:
+        void lock()
+        {
+            RealtimeThreadScope::check("Locking a mutex");
+            m_mutex.lock();
+        }
 
-        /**
-        * Returns the Lockable's internal mutex. Note that Lockable objects never
-        * lock their mutex themselves: it is the responsibility of the caller to
-        * lock a Lockable appropriately when consulting or modifying its content in
-        * a multi-threaded environment.
-        */
-        std::mutex& getLock()
+        bool try_lock()
         {
-            return m_lock;
+            return m_mutex.try_lock();
+        }
+
+        void unlock()
+        {
+            m_mutex.unlock();
         }
 
     private:
-        std::mutex m_lock;
+        std::mutex m_mutex;
     };
 
-    /**
-    * \class Thread Thread.h
-    * The Thread class provides a handy interface for derived thread handler
-    * classes.
+    /** Mutex type used throughout ANGLECORE */
+    typedef GuardedMutex Mutex;
+#else
+    /** Mutex type used throughout ANGLECORE */
+    typedef std::mutex Mutex;
+#endif
+}
 
-    * The interface consists of mainly three methods: start(), run(), and
-    * stop(). When the start() method of a Thread object is called, the latter
-    * spawns a thread that will execute the run() method. The stop() method can then
-    * be called to ask the internal thread to stop.
-    *.
-    * This class follows the RAII paradigm: when a Thread object is destroyed, the
-    * stop() method is automatically called, and the thread that called the
-    * destructor will wait for the internal thread to finish.
-    * .
-    * Note that the stop() method only makes a request and does not kill the
-    * internal thread. More precisely, the stop() method updates an internal boolean
-    * flag to make that request, and the flag's value can be easily accessed through
-    * the thread-safe auxiliary shouldStop() method, which returns true if the
-    * request was effectively made, and false otherwise.
-    * .
-    * The run() method is a pure virtual method, so it must be implemented in
-    * derived classes. It must either terminate in finite time, or regularly call
-    * the auxiliary shouldStop() method and ensure that, if shouldStop() returns
-    * true at any time, then it stops in a finite and preferably short time. If the
-    * run() method does not respect this rule, then the Thread destructor may enter
-    * an infinite loop while waiting for the internal thread to finish, and
-    * eventually crash the application.
+
+/*
+=================================================
+Workflow
+=================================================
+*/
+
+namespace ANGLECORE
+{
+    /**
+    * \class StreamArena StreamArena.h
+    * Allocator of stream buffers. Instead of allocating each buffer separately on
+    * the heap, the StreamArena carves them out of large slabs of
+    * ANGLECORE_STREAM_ARENA_SLAB_SIZE bytes, in the order they are requested.
+    * Each slab is aligned on its own size, so that the operating system can back
+    * it with huge pages, and every buffer is aligned on a cache line. All the
+    * buffers of an arena have the same size, which is chosen upon construction.
+    * Streams created together, such as the streams of one Voice, therefore end up
+    * next to each other in memory, which is also the order in which the Renderer
+    * accesses them. A slab is never moved nor freed before the arena is
+    * destroyed, so that the buffers handed out remain valid while the real-time
+    * thread reads them. Released buffers are recycled by subsequent allocations.
+    * The StreamArena is thread-safe. Apart from release(), which never blocks, its
+    * methods may block and allocate memory, so they should never be called by the
+    * real-time thread.
     */
-    class Thread
+    class StreamArena
     {
     public:
 
         /**
-        * Creates a Thread object, but does not effectively spawn the thread. The
-        * start() method must be called for that to happen.
+        * Creates an arena of stream buffers. No memory is allocated until the first
+        * buffer is requested.
+        * @param[in] streamSize Number of samples in each buffer. It should be
+        *   greater than 0.
         */
-        Thread();
+        StreamArena(unsigned int streamSize);
 
-        ~Thread();
+        /** Frees every slab. Every buffer must have been released beforehand. */
+        ~StreamArena();
+
+        StreamArena(const StreamArena& other) = delete;
+        StreamArena& operator=(const StreamArena& other) = delete;
 
         /**
-        * Instructs to spawn and start a thread that will run the callback() method.
+        * Returns a buffer of getStreamSize() samples, aligned on a cache line. The
+        * content of the buffer is unspecified. A new slab is allocated if all the
+        * existing ones are full.
         */
-        void start();
+        floating_type* allocate();
 
         /**
-        * Instructs to stop the thread using an atomic boolean flag. The run()
-        * method should check for that flag using the shouldStop() method. If the
-        * shouldStop() method returns true, then the run method should terminate.
+        * Gives back a buffer obtained from allocate(), so that it can be reused.
+        * This method neither blocks nor allocates memory, so it can be called by
+        * any thread, including the real-time thread when a Stream is destroyed
+        * there. The buffer is only made available again once a non real-time
+        * thread collects it (see collectReleasedBuffers()).
+        * @param[in] buffer The buffer to release. Null pointers are ignored.
         */
-        void stop();
+        void release(floating_type* buffer);
 
-    protected:
-        void callback();
-        bool shouldStop() const;
+        /**
+        * Makes the buffers given back through release() available to subsequent
+        * allocations. This is done automatically by allocate() and reserve(), and
+        * can also be called by a non real-time thread once a Request is done, so
+        * that the arena does not hold on to released buffers for too long.
+        */
+        void collectReleasedBuffers();
 
         /**
-        * Core routine of the thread. If the run() method consists of a loop, it
-        * should regularly check whether it should stop using the shouldStop()
-        * method. If the shouldStop() method returns true at any point, then the
-        * run() method should terminate.
+        * Ensures the arena can provide \p numBuffers more buffers without having to
+        * allocate a new slab.
+        * @param[in] numBuffers Number of buffers to make room for.
         */
-        virtual void run() = 0;
+        void reserve(unsigned int numBuffers);
+
+        /** Returns the total number of buffers the current slabs can hold. */
+        unsigned int getCapacity() const;
+
+        /** Returns the number of samples in each buffer of the arena. */
+        unsigned int getStreamSize() const;
 
     private:
-        std::atomic<bool> m_shouldStop;
-        std::atomic<bool> m_hasStopped;
-    };
-}
 
+        const unsigned int m_streamSize;
 
+        /**
+        * Distance between two consecutive buffers of a slab, in samples. This is
+        * the stream size rounded up to a whole number of cache lines, so that
+        * every buffer remains aligned.
+        */
+        const std::size_t m_bufferStride;
 
-/*
-=================================================
-General Utility
-=================================================
-*/
+        /** Number of buffers that fit into one slab, which is at least one */
+        const unsigned int m_numBuffersPerSlab;
 
-namespace std {
+        /** Number of samples in one slab */
+        const std::size_t m_slabLength;
 
-    /**
-    * In order to be used as a key within a standard key-value container, a StringView
-    * must have a dedicated hash function. Otherwise, only the internal pointer will be
-    * hashed, which will not produce the desired effect. Therefore, we have to
-    * specialize the standard hash structure to our StringView type.
-    */
-    template<>
-    struct hash<ANGLECORE::StringView>
-    {
-        size_t operator()(const ANGLECORE::StringView& view) const
-        {
-            /* This hash function comes from the boost library */
-            size_t hashValue = 0;
-            for (const char* p = view.string_ptr; p && *p; p++)
-                hashValue ^= *p + 0x9e3779b9 + (hashValue << 6) + (hashValue >> 2);
-            return hashValue;
-        }
-    };
-}
+        /**
+        * Number of bytes allocated for each slab, which is m_slabLength samples
+        * rounded up to a multiple of ANGLECORE_STREAM_ARENA_SLAB_SIZE.
+        */
+        const std::size_t m_slabSize;
+
+        /**
+        * Slabs allocated so far. The slabs before m_currentSlab are full, and the
+        * ones after it have been reserved but not used yet.
+        */
+        std::vector<floating_type*> m_slabs;
+        std::size_t m_currentSlab;
+
+        /** Number of buffers already handed out from the current slab */
+        unsigned int m_numBuffersUsedInCurrentSlab;
+
+        /** Released buffers, reused first on the next allocations */
+        std::vector<floating_type*> m_freeBuffers;
+
+        /**
+        * Buffers released but not collected yet. They are linked together into a
+        * lock-free stack, each buffer holding the address of the next one in its
+        * first bytes.
+        */
+        std::atomic<floating_type*> m_releasedBuffers;
 
+        /** Moves the released buffers into m_freeBuffers. m_lock must be held. */
+        void collectReleasedBuffersLocked();
 
+        mutable Mutex m_lock;
+    };
+}
 
 namespace ANGLECORE
 {
-    /*
-    =================================================
-    Dependencies
-    =================================================
+    /**
+    * \class Stream Stream.h
+    * Owner of a data stream used in the rendering process. The Stream itself is
+    * a lightweight handle: its buffer comes from the StreamArena of the Workflow
+    * it belongs to, and is given back to the arena upon destruction. The class
+    * implements RAII. The size of a Stream is the one of its arena. Its samples
+    * are always of type floating_type, whose precision is set for every Stream
+    * at once at build time (see ANGLECORE_PRECISION).
+    *
+    * Several streams can also share the same buffer, when their content is never
+    * needed at the same time. In that case, the buffer belongs to the first
+    * Stream, and the others keep it alive until they are destroyed.
     */
-
-    namespace farbot
+    class Stream :
+        public WorkflowItem
     {
-        namespace detail { template <typename, bool, bool, bool, bool, std::size_t> class fifo_impl; }
+    public:
 
-        namespace fifo_options
-        {
-            enum class concurrency
-            {
-                single,                  // single consumer/single producer
-                multiple
-            };
+        /**
+        * Creates a stream of constant size for rendering, filled with zeros.
+        * @param[in] arena The StreamArena to take the Stream's buffer from. It must
+        *   outlive the Stream.
+        */
+        Stream(StreamArena& arena);
 
-            enum class full_empty_failure_mode
-            {
-                // Setting this as producer option causes the fifo to overwrite on a push when the fifo is full
-                // Setting this as consumer option causes the fifo to return a default constructed value on pop when the fifo is empty
-                overwrite_or_return_default,
-
-                // Return false on push/pop if the fifo is full/empty respectively
-                return_false_on_full_or_empty
-            };
-        }
-
-        // single consumer, single producer
-        template <typename T,
-            fifo_options::concurrency consumer_concurrency = fifo_options::concurrency::multiple,
-            fifo_options::concurrency producer_concurrency = fifo_options::concurrency::multiple,
-            fifo_options::full_empty_failure_mode consumer_failure_mode = fifo_options::full_empty_failure_mode::return_false_on_full_or_empty,
-            fifo_options::full_empty_failure_mode producer_failure_mode = fifo_options::full_empty_failure_mode::return_false_on_full_or_empty,
-            std::size_t MAX_THREADS = 64>
-        class fifo
-        {
-        public:
-            fifo(int capacity);
-
-            bool push(T&& result);
-
-            bool pop(T& result);
-
-        private:
-            detail::fifo_impl<T,
-                consumer_concurrency == fifo_options::concurrency::single,
-                producer_concurrency == fifo_options::concurrency::single,
-                consumer_failure_mode == fifo_options::full_empty_failure_mode::overwrite_or_return_default,
-                producer_failure_mode == fifo_options::full_empty_failure_mode::overwrite_or_return_default,
-                MAX_THREADS> impl;
-        };
-    }
-
-    //==============================================================================
-
-    namespace farbot
-    {
-        namespace detail
-        {
-            template <typename T, bool isWrite, bool swap_when_read> struct fifo_manip { static void access(T && slot, T&& arg) { slot = std::move(arg); } };
-            template <typename T> struct fifo_manip<T, false, false>     { static void access(T && slot, T&& arg) { arg = std::move(slot); } };
-            template <typename T> struct fifo_manip<T, false, true>     { static void access(T && slot, T&& arg)  { arg = T(); std::swap(slot, arg); } };
-
-            struct thread_info
-            {
-                std::atomic<std::thread::id> tid = {};
-                std::atomic<uint32_t> pos = { std::numeric_limits<uint32_t>::max() };
-
-                thread_info()
-                {
-                    // We moved the initial lock-free assertion on thread::id here
-                    assert(tid.is_lock_free());
-                }
-            };
-
-            template <std::size_t MAX_THREADS>
-            struct multi_position_info
-            {
-                std::atomic<uint32_t> num_threads = { 0 };
-                std::array<thread_info, MAX_THREADS> tinfos = { {} };
-
-                std::atomic<uint32_t>& get_tpos()
-                {
-                    auto my_tid = std::this_thread::get_id();
-                    auto num = num_threads.load(std::memory_order_relaxed);
-
-                    for (auto it = tinfos.begin(); it != tinfos.begin() + num; ++it)
-                        if (it->tid.load(std::memory_order_relaxed) == my_tid)
-                            return it->pos;
-
-                    auto pos = num_threads.fetch_add(1, std::memory_order_relaxed);
-
-                    if (pos >= MAX_THREADS)
-                    {
-                        assert(false);
-                        // do something!
-                        return tinfos.front().pos;
-                    }
-
-                    auto& result = tinfos[pos];
-                    result.tid.store(my_tid, std::memory_order_relaxed);
-
-                    return result.pos;
-                }
-
-                uint32_t getpos(uint32_t min) const
-                {
-                    auto num = num_threads.load(std::memory_order_relaxed);
-
-                    for (auto it = tinfos.begin(); it != tinfos.begin() + num; ++it)
-                        min = std::min(min, it->pos.load(std::memory_order_acquire));
-
-                    return min;
-                }
-            };
-
-            template <typename T, bool is_writer,
-                bool single_consumer_producer,
-                bool overwrite_or_return_zero,
-                std::size_t MAX_THREADS>
-            struct read_or_writer
-            {
-                uint32_t getpos() const
-                {
-                    return posinfo.getpos(reserve.load(std::memory_order_relaxed));
-                }
-
-                bool push_or_pop(std::vector<T>& s, T && arg, uint32_t max)
-                {
-                    auto& tpos = posinfo.get_tpos();
-                    auto pos = reserve.load(std::memory_order_relaxed);
-
-                    if (pos >= max)
-                        return false;
-
-                    tpos.store(pos, std::memory_order_release);
-
-                    if (!reserve.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
-                    {
-                        do
-                        {
-                            if (pos >= max)
-                            {
-                                tpos.store(std::numeric_limits<uint32_t>::max(), std::memory_order_relaxed);
-                                return false;
-                            }
-                        } while (!reserve.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed));
-
-                        tpos.store(pos, std::memory_order_release);
-                    }
-
-                    detail::fifo_manip<T, is_writer, false>::access(std::move(s[pos & (s.size() - 1)]), std::move(arg));
-                    tpos.store(std::numeric_limits<uint32_t>::max(), std::memory_order_release);
-                    return true;
-                }
-
-                std::atomic<uint32_t> reserve = { 0 };
-                multi_position_info<MAX_THREADS> posinfo;
-            };
-
-            template <typename T, bool is_writer, std::size_t MAX_THREADS>
-            struct read_or_writer<T, is_writer, true, false, MAX_THREADS>
-            {
-                uint32_t getpos() const
-                {
-                    return reserve.load(std::memory_order_acquire);
-                }
-
-                bool push_or_pop(std::vector<T>& s, T && arg, uint32_t max)
-                {
-                    auto pos = reserve.load(std::memory_order_relaxed);
-
-                    if (pos >= max)
-                        return false;
-
-                    detail::fifo_manip<T, is_writer, false>::access(std::move(s[pos & (s.size() - 1)]), std::move(arg));
-                    reserve.store(pos + 1, std::memory_order_release);
-
-                    return true;
-                }
-
-                std::atomic<uint32_t> reserve = { 0 };
-            };
-
-            template <typename T, bool is_writer, std::size_t MAX_THREADS>
-            struct read_or_writer<T, is_writer, true, true, MAX_THREADS>
-            {
-                uint32_t getpos() const
-                {
-                    return reserve.load(std::memory_order_acquire);
-                }
-
-                bool push_or_pop(std::vector<T>& s, T && arg, uint32_t)
-                {
-                    auto pos = reserve.load(std::memory_order_relaxed);
-
-                    detail::fifo_manip<T, is_writer, true>::access(std::move(s[pos & (s.size() - 1)]), std::move(arg));
-                    reserve.store(pos + 1, std::memory_order_release);
-
-                    return true;
-                }
-
-                std::atomic<uint32_t> reserve = { 0 };
-            };
-
-            template <typename T, bool is_writer, std::size_t MAX_THREADS>
-            struct read_or_writer<T, is_writer, false, true, MAX_THREADS>
-            {
-                uint32_t getpos() const
-                {
-                    return posinfo.getpos(reserve.load(std::memory_order_relaxed));
-                }
-
-                bool push_or_pop(std::vector<T>& s, T && arg, uint32_t)
-                {
-                    auto& tpos = posinfo.get_tpos();
-                    auto pos = reserve.fetch_add(1, std::memory_order_relaxed);
-
-                    tpos.store(pos, std::memory_order_release);
-                    detail::fifo_manip<T, is_writer, true>::access(std::move(s[pos & (s.size() - 1)]), std::move(arg));
-                    tpos.store(std::numeric_limits<uint32_t>::max(), std::memory_order_release);
-
-                    return true;
-                }
-
-                multi_position_info<MAX_THREADS> posinfo;
-                std::atomic<uint32_t> reserve = { 0 };
-            };
+        /**
+        * Creates a stream that uses the same buffer as \p bufferOwner, without
+        * resetting its content. The caller is responsible for never having both
+        * streams hold data that is still to be read at the same time.
+        * @param[in] bufferOwner The Stream whose buffer is to be shared. It must
+        *   not be sharing the buffer of another Stream itself.
+        */
+        Stream(const std::shared_ptr<Stream>& bufferOwner);
 
-            template <typename T, bool consumer_concurrency, bool producer_concurrency,
-                bool consumer_failure_mode, bool producer_failure_mode, std::size_t MAX_THREADS>
-            class fifo_impl
-            {
-            public:
-                fifo_impl(int capacity) : slots(capacity)
-                {
-                    assert((capacity & (capacity - 1)) == 0);
-                }
+        /**
+        * Delete the copy constructor.
+        */
+        Stream(const Stream& other) = delete;
 
-                bool push(T&& result)
-                {
-                    return writer.push_or_pop(slots, std::move(result), reader.getpos() + static_cast<uint32_t> (slots.size()));
-                }
+        /**
+        * Deletes the stream, and gives its internal buffer back to the arena. This
+        * never blocks, even when called by the real-time thread (see
+        * StreamArena::release()).
+        */
+        ~Stream();
 
-                bool pop(T& result)
-                {
-                    return reader.push_or_pop(slots, std::move(result), writer.getpos());
-                }
+        /** Returns the number of samples in the Stream. */
+        unsigned int getSize() const;
 
-            private:
-                //==============================================================================
-                std::vector<T> slots = {};
+        /** Provides a read access to the internal buffer. */
+        const floating_type* getDataForReading() const;
 
-                read_or_writer<T, false, consumer_concurrency, consumer_failure_mode, MAX_THREADS> reader;
-                read_or_writer<T, true, producer_concurrency, producer_failure_mode, MAX_THREADS> writer;
-            };
-        } // detail
+        /** Provides a write access to the internal buffer. */
+        floating_type* getDataForWriting();
 
-        template <typename T,
-            fifo_options::concurrency consumer_concurrency,
-            fifo_options::concurrency producer_concurrency,
-            fifo_options::full_empty_failure_mode consumer_failure_mode,
-            fifo_options::full_empty_failure_mode producer_failure_mode,
-            std::size_t MAX_THREADS>
-            fifo<T, consumer_concurrency, producer_concurrency, consumer_failure_mode, producer_failure_mode, MAX_THREADS>::fifo(int capacity) : impl(capacity) {}
+        /**
+        * Fills the entire Stream with the given value, and marks it as constant,
+        * so that the workers reading it can use a scalar fast path. The buffer is
+        * only written if the Stream did not already hold that value, which makes
+        * this method very cheap to call on every rendering session. This shortcut
+        * is not taken when the buffer is shared with another Stream, which may
+        * have overwritten it in the meantime.
+        * @param[in] value The value of every sample in the Stream.
+        */
+        void setConstant(floating_type value);
 
-        template <typename T,
-            fifo_options::concurrency consumer_concurrency,
-            fifo_options::concurrency producer_concurrency,
-            fifo_options::full_empty_failure_mode consumer_failure_mode,
-            fifo_options::full_empty_failure_mode producer_failure_mode,
-            std::size_t MAX_THREADS>
-            bool fifo<T, consumer_concurrency, producer_concurrency, consumer_failure_mode, producer_failure_mode, MAX_THREADS>::push(T&& result) { return impl.push(std::move(result)); }
+        /**
+        * Marks the Stream as varying, meaning its samples may all be different.
+        * This must be called by the producer of a Stream before it writes anything
+        * but a constant into it.
+        */
+        void setVarying();
 
-        template <typename T,
-            fifo_options::concurrency consumer_concurrency,
-            fifo_options::concurrency producer_concurrency,
-            fifo_options::full_empty_failure_mode consumer_failure_mode,
-            fifo_options::full_empty_failure_mode producer_failure_mode,
-            std::size_t MAX_THREADS>
-            bool fifo<T, consumer_concurrency, producer_concurrency, consumer_failure_mode, producer_failure_mode, MAX_THREADS>::pop(T& result) { return impl.pop(result); }
-    }
+        /**
+        * Returns true if every sample of the Stream equals getConstantValue(), and
+        * false if the Stream is varying or if its producer does not keep track of
+        * its constant-ness.
+        */
+        bool isConstant() const;
 
+        /**
+        * Returns the value of every sample in the Stream. This is only meaningful
+        * if isConstant() returns true.
+        */
+        floating_type getConstantValue() const;
 
+    private:
 
-    /*
-    =================================================
-    Workflow
-    =================================================
-    */
+        StreamArena& m_arena;
 
-    /**
-    * \struct WorkflowItem WorkflowItem.h
-    * Item of a workflow, with a unique ID.
-    */
-    struct WorkflowItem
-    {
-        /** The ID of the workflow item. */
-        const uint32_t id;
+        /** Internal buffer, taken from m_arena */
+        floating_type* data;
 
         /**
-        * The constructor simply defines an ID for the new item, using a static
-        * integer variable.
+        * Stream that owns the internal buffer, if the latter is shared and does
+        * not belong to this Stream. The buffer is then given back to the arena by
+        * its owner.
         */
-        WorkflowItem();
+        std::shared_ptr<Stream> m_bufferOwner;
 
-    private:
+        /** True if the internal buffer is used by several streams */
+        bool m_isShared;
 
         /**
-        * This static variable is used to define a unique ID for each item in the
-        * workflow. Whenever an item is created, this integer is incremented. Note
-        * that using this method for creating IDs exposes our system to possible ID
-        * duplicates, especially with overflow. This should not a problem here:
-        * since the upper limit of uint32_t is approximately 4 billions, we are
-        * protected against 4 billions item creations, so we should be safe.
+        * Constant-ness of the Stream. These are only modified by the Stream's
+        * producer during a rendering session, and read by the workers called after
+        * it, so they need no synchronization of their own.
         */
-        static uint32_t nextId;
+        bool m_isConstant;
+        floating_type m_constantValue;
     };
+}
+
+
+/*
+=================================================
+Utility
+=================================================
+*/
 
+namespace ANGLECORE
+{
     /**
-    * \class Stream Stream.h
-    * Owner of a data stream used in the rendering process. The class implements
-    * RAII.
+    * \class AlignedAllocator AlignedAllocator.h
+    * Standard-compliant allocator that aligns every memory block it allocates on
+    * the given \p Alignment, in bytes. It can be used with standard containers,
+    * for example to ensure the content of a std::vector starts at the beginning of
+    * a cache line. The alignment is achieved by over-allocating memory and storing
+    * the address of the original block right before the aligned one, which keeps
+    * the allocator portable across platforms.
     */
-    class Stream :
-        public WorkflowItem
+    template<class T, std::size_t Alignment>
+    class AlignedAllocator
     {
     public:
+        static_assert(Alignment >= sizeof(void*) && (Alignment & (Alignment - 1)) == 0, "The alignment must be a power of two, and at least the size of a pointer.");
 
-        /**
-        * Creates a stream of constant size for rendering.
-        */
-        Stream();
+        typedef T value_type;
+
+        /** Allows containers to rebind the allocator to another type */
+        template<class U>
+        struct rebind
+        {
+            typedef AlignedAllocator<U, Alignment> other;
+        };
+
+        AlignedAllocator() {}
+
+        template<class U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
 
         /**
-        * Delete the copy constructor.
+        * Allocates a memory block that can hold \p n objects of type T, and whose
+        * address is a multiple of Alignment.
+        * @param[in] n Number of objects to allocate memory for.
         */
-        Stream(const Stream& other) = delete;
+        T* allocate(std::size_t n)
+        {
+            /*
+            * We allocate enough memory to move the block forward up to the next
+            * aligned address, while keeping room for the original address.
+            */
+            char* block = static_cast<char*>(::operator new(n * sizeof(T) + Alignment + sizeof(void*)));
+            std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block + sizeof(void*));
+            char* alignedBlock = reinterpret_cast<char*>((address + Alignment - 1) & ~static_cast<std::uintptr_t>(Alignment - 1));
+            reinterpret_cast<void**>(alignedBlock)[-1] = block;
+            return reinterpret_cast<T*>(alignedBlock);
+        }
 
         /**
-        * Deletes the stream and its internal buffer.
+        * Deallocates a memory block previously returned by allocate().
+        * @param[in] p Address of the memory block.
         */
-        ~Stream();
+        void deallocate(T* p, std::size_t)
+        {
+            if (p)
+                ::operator delete(reinterpret_cast<void**>(p)[-1]);
+        }
+    };
 
-        /** Provides a read access to the internal buffer. */
-        const floating_type* getDataForReading() const;
+    template<class T, class U, std::size_t Alignment>
+    bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+    {
+        return true;
+    }
 
-        /** Provides a write access to the internal buffer. */
-        floating_type* getDataForWriting();
+    template<class T, class U, std::size_t Alignment>
+    bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+    {
+        return false;
+    }
+}
 
-    private:
 
-        /** Internal buffer */
-        floating_type* data;
+/*
+=================================================
+Workflow
+=================================================
+*/
+
+namespace ANGLECORE
+{
+    /**
+    * \struct WorkCall Worker.h
+    * Pair of raw pointers that allows to call a Worker's work() method through a
+    * plain function pointer, without any virtual dispatch nor shared pointer
+    * dereferencing. Calling \p function with \p worker as its first argument is
+    * equivalent to calling the work() method on the corresponding Worker.
+    */
+    struct WorkCall
+    {
+        void (*function)(void*, unsigned int);
+        void* worker;
     };
 
+    /**
+    * Flat sequence of WorkCall objects, whose memory is aligned on a cache line.
+    * This is the form under which the Renderer consumes its rendering sequence.
+    */
+    typedef std::vector<WorkCall, AlignedAllocator<WorkCall, ANGLECORE_CACHE_LINE_SIZE>> WorkCallSequence;
+
     /**
     * \class Worker Worker.h
     * Represents an agent that processes input streams into output streams. This is
@@ -659,6 +711,41 @@ namespace ANGLECORE
         */
         floating_type* getOutputStream(unsigned short index) const;
 
+        /**
+        * Returns true if the Stream at \p index in the input bus is connected and
+        * constant, in which case the Worker can read its value with
+        * getInputConstantValue() rather than reading it sample by sample.
+        * @param[in] index Index of the stream within the input bus.
+        */
+        bool isInputConstant(unsigned short index) const;
+
+        /**
+        * Returns the value of the constant Stream at \p index in the input bus.
+        * This is only meaningful if isInputConstant() returns true.
+        * @param[in] index Index of the stream within the input bus.
+        */
+        floating_type getInputConstantValue(unsigned short index) const;
+
+        /**
+        * Fills the Stream at \p index in the output bus with the given value, and
+        * marks it as constant (see Stream::setConstant()). Workers that compute
+        * each output sample from the input samples at the same position should
+        * call this method whenever all of their inputs are constant, so that
+        * constant values propagate through the Workflow and whole parts of it
+        * reduce to scalar computations.
+        * @param[in] index Index of the stream within the output bus.
+        * @param[in] value The value of every sample in the output stream.
+        */
+        void setOutputConstant(unsigned short index, floating_type value) const;
+
+        /**
+        * Marks the Stream at \p index in the output bus as varying. Workers that
+        * mark their outputs as constant must call this method before writing
+        * anything else into them.
+        * @param[in] index Index of the stream within the output bus.
+        */
+        void setOutputVarying(unsigned short index) const;
+
         /**
         * Returns a vector containing all the input streams the worker is connected
         * to. The vector may contain null pointers when no stream is attached.
@@ -688,6 +775,14 @@ namespace ANGLECORE
         */
         virtual void work(unsigned int numSamplesToWorkOn) = 0;
 
+        /**
+        * Returns a WorkCall that calls the Worker's work() method. By default, the
+        * WorkCall returned still relies on a virtual call, so subclasses should
+        * preferably derive from the DevirtualizedWorker class, which overrides
+        * this method to call their work() method directly.
+        */
+        virtual WorkCall getWorkCall();
+
     private:
         const unsigned short m_numInputs;
         const unsigned short m_numOutputs;
@@ -695,7 +790,10 @@ namespace ANGLECORE
         std::vector<std::shared_ptr<Stream>> m_outputBus;
         const bool m_hasInputs;
     };
+}
 
+namespace ANGLECORE
+{
     /** Type of connection to use in a ConnectionInstruction */
     enum ConnectionType
     {
@@ -763,7 +861,10 @@ namespace ANGLECORE
         std::vector<ConnectionInstruction<STREAM_TO_WORKER, PLUG>> streamToWorkerPlugInstructions;
         std::vector<ConnectionInstruction<WORKER_TO_STREAM, PLUG>> workerToStreamPlugInstructions;
     };
+}
 
+namespace ANGLECORE
+{
     /**
     * \class Workflow Workflow.h
     * Represents a set of instructions as a succession of workers and streams. A
@@ -773,15 +874,31 @@ namespace ANGLECORE
     {
     public:
 
+        /**
+        * Creates an empty Workflow.
+        * @param[in] streamSize Number of samples in each Stream of the Workflow.
+        */
+        Workflow(unsigned int streamSize);
+
         /**
         * Adds the given Stream into the Workflow, and updates the workflow's
         * internal ID-Stream map accordingly. Note that streams are never created by
         * the Workflow itself, but rather passed as arguments after being created by
-        * a dedicated entity.
+        * a dedicated entity. This method allocates memory, so it should never be
+        * called by the real-time thread.
         * @param[in] streamToAdd The Stream to add into the Workflow.
         */
         void addStream(const std::shared_ptr<Stream>& streamToAdd);
 
+        /**
+        * Returns the StreamArena that provides the buffers of the Workflow's
+        * streams. Every Stream added into the Workflow should be created with it.
+        */
+        StreamArena& getStreamArena();
+
+        /** Returns the number of samples in each Stream of the Workflow. */
+        unsigned int getStreamSize() const;
+
         /**
         * Adds the given Worker into the Workflow, and updates the workflow's
         * internal ID-Worker map accordingly. Note that workers are never created by
@@ -922,6 +1039,31 @@ namespace ANGLECORE
         */
         bool executeConnectionPlan(const ConnectionPlan& plan);
 
+        /**
+        * Computes the dependency graph of the given rendering sequence, as it will
+        * be once the given ConnectionPlan is executed. The graph is returned in a
+        * compact form: for each Worker at position i in the sequence,
+        * \p predecessorCounts[i] contains the number of workers of the sequence it
+        * directly depends on, and its successors, i.e. the positions of the
+        * workers that directly depend on it, are stored in \p successors between
+        * positions \p successorOffsets[i] (included) and \p successorOffsets[i + 1]
+        * (excluded). Dependencies are derived from the streams connecting the
+        * workers together. This method allocates memory, so it should never be
+        * called by the real-time thread.
+        * @param[in] renderingSequence The rendering sequence to compute the graph
+        *   of. It should not contain any null pointer.
+        * @param[in] plan The ConnectionPlan that will be executed next, and that
+        *   should therefore be taken into account in the computation.
+        * @param[out] predecessorCounts Number of predecessors of each Worker. It
+        *   will be of the same size as \p renderingSequence.
+        * @param[out] successorOffsets Start position of each Worker's successors
+        *   within \p successors. It will contain one more element than
+        *   \p renderingSequence, the last one being the size of \p successors.
+        * @param[out] successors Positions of every Worker's successors, listed one
+        *   Worker after the other.
+        */
+        void buildDependencyGraph(const std::vector<std::shared_ptr<Worker>>& renderingSequence, const ConnectionPlan& plan, std::vector<uint32_t>& predecessorCounts, std::vector<uint32_t>& successorOffsets, std::vector<uint32_t>& successors) const;
+
     protected:
 
         /**
@@ -956,8 +1098,56 @@ namespace ANGLECORE
         */
         void completeRenderingSequenceForStream(const std::shared_ptr<const Stream>& stream, const ConnectionPlan& plan, std::vector<std::shared_ptr<Worker>>& currentRenderingSequence) const;
 
+        /**
+        * Returns the Stream that will be connected to the given \p worker's input
+        * bus at \p inputPortNumber once the given \p plan is executed, or a null
+        * pointer if the port will be left empty. This method takes into account
+        * both the current connections of the Workflow and the plug and unplug
+        * instructions of the plan. Note that \p worker is expected to be a non-null
+        * pointer to a Worker of the Workflow, and \p inputPortNumber to be
+        * in-range.
+        * @param[in] worker The Worker whose input bus should be inspected.
+        * @param[in] inputPortNumber The index of the port to inspect in the
+        *   Worker's input bus.
+        * @param[in] plan The ConnectionPlan that will be executed next, and which
+        *   should therefore be taken into account in the computation
+        */
+        std::shared_ptr<const Stream> findInputStreamAfterPlan(const std::shared_ptr<Worker>& worker, unsigned short inputPortNumber, const ConnectionPlan& plan) const;
+
+        /**
+        * Returns the Worker that will fill in the given \p stream once the given
+        * \p plan is executed, or a null pointer if no Worker will be connected to
+        * it. This method takes into account both the current connections of the
+        * Workflow and the plug and unplug instructions of the plan. Note that \p
+        * stream is expected to be a non-null pointer to a Stream of the Workflow.
+        * @param[in] stream The Stream whose input Worker should be retrieved.
+        * @param[in] plan The ConnectionPlan that will be executed next, and which
+        *   should therefore be taken into account in the computation
+        */
+        std::shared_ptr<Worker> findInputWorkerAfterPlan(const std::shared_ptr<const Stream>& stream, const ConnectionPlan& plan) const;
+
+        /**
+        * Returns every Worker that will directly fill in one of the given \p
+        * worker's input streams once the given \p plan is executed. In other
+        * words, this method returns the direct predecessors of \p worker in the
+        * Workflow's graph. The vector returned contains no null pointer and no
+        * duplicate. This method allocates memory, so it should never be called by
+        * the real-time thread.
+        * @param[in] worker The Worker whose predecessors should be retrieved. It
+        *   should be a non-null pointer to a Worker of the Workflow.
+        * @param[in] plan The ConnectionPlan that will be executed next, and which
+        *   should therefore be taken into account in the computation
+        */
+        std::vector<std::shared_ptr<Worker>> findInputWorkersAfterPlan(const std::shared_ptr<Worker>& worker, const ConnectionPlan& plan) const;
+
     private:
 
+        /*
+        * The arena is declared first, so that it is destroyed after every Stream
+        * held by the Workflow.
+        */
+        StreamArena m_streamArena;
+
         /**
         * Maps a Stream with its ID, hereby providing an ID-based access to a Stream
         * in constant time. This unordered_map will always verify:
@@ -972,18 +1162,24 @@ namespace ANGLECORE
         */
         std::unordered_map<uint32_t, std::shared_ptr<Worker>> m_workers;
 
-        /** Maps a Stream ID to its input worker */
+        /**
+        * Maps a Stream ID to its input worker. Every Stream has an entry from the
+        * moment it is added to the Workflow, which remains null until a Worker is
+        * plugged into the Stream.
+        */
         std::unordered_map<uint32_t, std::shared_ptr<Worker>> m_inputWorkers;
     };
+}
 
 
+/*
+=================================================
+VoiceAssigner
+=================================================
+*/
 
-    /*
-    =================================================
-    VoiceAssigner
-    =================================================
-    */
-
+namespace ANGLECORE
+{
     /**
     * \struct VoiceAssignment VoiceAssigner.h
     * Represents an item in a voice sequence.
@@ -1036,6 +1232,26 @@ namespace ANGLECORE
         */
         std::vector<VoiceAssignment> getVoiceAssignments(const std::vector<std::shared_ptr<Worker>>& workers) const;
 
+        /**
+        * Computes the position of each Voice's segment within a rendering sequence
+        * grouped by voice, from the sequence's voice assignments. Such a sequence
+        * starts with workers that are not assigned to any Voice, then contains the
+        * workers of each Voice by increasing voice number, and ends with workers
+        * that are not assigned to any Voice. After this method returns true,
+        * \p segmentStarts[v] contains the position of the first Worker of Voice v,
+        * and the workers of Voice v are located between \p segmentStarts[v]
+        * (included) and \p segmentStarts[v + 1] (excluded). The last value,
+        * \p segmentStarts[ANGLECORE_NUM_VOICES], is the position of the first
+        * Worker after all voices. If the voice assignments do not follow the
+        * layout described above, this method returns false, and the content of
+        * \p segmentStarts should be ignored.
+        * @param[in] voiceAssignments Voice assignments of the rendering sequence,
+        *   as returned by getVoiceAssignments().
+        * @param[out] segmentStarts Array of ANGLECORE_NUM_VOICES + 1 positions to
+        *   fill in.
+        */
+        static bool getVoiceSegmentStarts(const std::vector<VoiceAssignment>& voiceAssignments, uint32_t* segmentStarts);
+
     private:
 
         /**
@@ -1044,22 +1260,225 @@ namespace ANGLECORE
         */
         std::unordered_map<uint32_t, unsigned short> m_voiceAssignments;
     };
+}
+
 
+/*
+=================================================
+Utility
+=================================================
+*/
 
+namespace ANGLECORE
+{
+    /**
+    * \class Lockable Lockable.h
+    * Utility object that can be locked for handling concurrency issues. The class
+    * simply contains a mutex and a public method to access it by reference in order
+    * to lock it.
+    */
+    class Lockable
+    {
+    public:
 
-    /*
-    =================================================
-    AudioWorkflow
-    =================================================
+        /**
+        * Returns the Lockable's internal mutex. Note that Lockable objects never
+        * lock their mutex themselves: it is the responsibility of the caller to
+        * lock a Lockable appropriately when consulting or modifying its content in
+        * a multi-threaded environment.
+        */
+        Mutex& getLock()
+        {
+            return m_lock;
+        }
+
+    private:
+        Mutex m_lock;
+    };
+}
+
+
+/*
+=================================================
+Workflow
+=================================================
+*/
+
+namespace ANGLECORE
+{
+    /**
+    * \class DevirtualizedWorker DevirtualizedWorker.h
+    * Intermediate base class that allows the Renderer to call a Worker's work()
+    * method without any virtual dispatch. It uses the curiously recurring template
+    * pattern: a class Derived should inherit from DevirtualizedWorker<Derived>
+    * rather than directly from Worker. The WorkCall it then provides will call
+    * Derived::work() directly, which the compiler can inline into the
+    * trampoline function.
+    * .
+    * Note that the work() method called is the one defined in Derived, so classes
+    * deriving from Derived should not override work() themselves, as their
+    * implementation would be bypassed by the Renderer.
+    */
+    template<class Derived>
+    class DevirtualizedWorker :
+        public Worker
+    {
+    public:
+
+        /**
+        * Creates a Worker with the given number of inputs and outputs.
+        * @param[in] numInputs Number of inputs.
+        * @param[in] numOutputs Number of output.
+        */
+        DevirtualizedWorker(unsigned short numInputs, unsigned short numOutputs);
+
+        /** Returns a WorkCall that directly calls Derived::work(). */
+        WorkCall getWorkCall() override;
+
+    private:
+
+        /**
+        * Trampoline function stored in the WorkCall, which converts the raw
+        * pointer back into a Derived object and performs a non-virtual call.
+        */
+        static void callWork(void* worker, unsigned int numSamplesToWorkOn);
+    };
+
+    template<class Derived>
+    DevirtualizedWorker<Derived>::DevirtualizedWorker(unsigned short numInputs, unsigned short numOutputs) :
+        Worker(numInputs, numOutputs)
+    {}
+
+    template<class Derived>
+    WorkCall DevirtualizedWorker<Derived>::getWorkCall()
+    {
+        /*
+        * The pointer stored must be the one of the Derived object, which may differ
+        * from this one, so that callWork() can safely cast it back.
+        */
+        WorkCall workCall;
+        workCall.function = &DevirtualizedWorker<Derived>::callWork;
+        workCall.worker = static_cast<Derived*>(this);
+        return workCall;
+    }
+
+    template<class Derived>
+    void DevirtualizedWorker<Derived>::callWork(void* worker, unsigned int numSamplesToWorkOn)
+    {
+        /* The qualified name prevents any virtual dispatch: */
+        static_cast<Derived*>(worker)->Derived::work(numSamplesToWorkOn);
+    }
+}
+
+
+/*
+=================================================
+AudioWorkflow
+=================================================
+*/
+
+namespace ANGLECORE
+{
+    /**
+    * \class ExportBuffer ExportBuffer.h
+    * Describes the memory location the host wants an audio block to be exported
+    * into, and converts ANGLECORE's samples into that location's layout. The
+    * buffer can either be planar, with one array of export_type per channel, or
+    * interleaved, with the channels of each frame stored next to each other in
+    * one of the sample formats used by audio devices and network streams. This
+    * lets the engine write straight into the host's buffer, whatever its
+    * layout, without going through an intermediate copy.
     */
+    class ExportBuffer
+    {
+    public:
+
+        /** Formats the samples of an interleaved buffer can be stored with */
+        enum SampleFormat
+        {
+            FLOAT32 = 0,    /**< 32-bit floating point samples, between -1 and 1 */
+            INT16,          /**< 16-bit signed integers */
+            INT24,          /**< 24-bit signed integers, packed on 3 little-endian bytes */
+            INT32,          /**< 32-bit signed integers */
+            NUM_SAMPLE_FORMATS
+        };
+
+        /**
+        * Creates an empty ExportBuffer, which has no channel. Nothing should be
+        * written into it.
+        */
+        ExportBuffer();
+
+        /**
+        * Describes a planar buffer.
+        * @param[in] channels Array of \p numChannels arrays, one per channel.
+        * @param[in] numChannels Number of channels in the buffer.
+        */
+        ExportBuffer(export_type** channels, unsigned short numChannels);
+
+        /**
+        * Describes an interleaved buffer. Integer samples are clipped to their
+        * range, and rounded to the nearest integer.
+        * @param[in] frames Memory location of the first sample of the first frame.
+        * @param[in] format Format of the samples.
+        * @param[in] numChannels Number of channels to write into each frame.
+        * @param[in] frameStride Distance between the beginning of two consecutive
+        *   frames, in samples. It must be greater than or equal to \p numChannels.
+        *   The samples of a frame that lie beyond \p numChannels are left
+        *   untouched, which allows to export into a subset of a larger frame.
+        */
+        ExportBuffer(void* frames, SampleFormat format, unsigned short numChannels, uint32_t frameStride);
+
+        /** Returns the number of channels in the buffer */
+        unsigned short getNumChannels() const;
+
+        /**
+        * Writes \p numSamples samples into each channel of the buffer, after
+        * multiplying them by \p gain. The sources are mapped onto the buffer's
+        * channels using a modulo: if there are less sources than channels, they
+        * are duplicated, which is why callers that have more sources than
+        * channels must mix them down beforehand.
+        * @param[in] position Position of the first sample to write in the buffer.
+        * @param[in] numSamples Number of samples to write into each channel.
+        * @param[in] sources Array of \p numSources arrays of \p numSamples samples.
+        * @param[in] numSources Number of arrays in \p sources. It must be positive.
+        * @param[in] gain Gain to apply before the conversion.
+        */
+        void write(uint32_t position, unsigned int numSamples, const floating_type* const* sources, unsigned short numSources, floating_type gain) const;
+
+        /**
+        * Writes \p numSamples samples of silence into each channel of the buffer.
+        * @param[in] position Position of the first sample to write in the buffer.
+        * @param[in] numSamples Number of samples to write into each channel.
+        */
+        void clear(uint32_t position, unsigned int numSamples) const;
+
+    private:
+
+        /**
+        * Writes into an interleaved buffer, using the given sample format (see
+        * write()).
+        */
+        template <class Format>
+        void writeInterleaved(uint32_t position, unsigned int numSamples, const floating_type* const* sources, unsigned short numSources, floating_type gain) const;
+
+        export_type** m_channels;
+        void* m_frames;
+        SampleFormat m_format;
+        unsigned short m_numChannels;
+        uint32_t m_frameStride;
+    };
+}
 
+namespace ANGLECORE
+{
     /**
     * \class Exporter Exporter.h
     * Worker that exports data from its input streams into an output buffer sent
     * to the host. An exporter applies a gain for calibrating its output level.
     */
     class Exporter :
-        public Worker
+        public DevirtualizedWorker<Exporter>
     {
     public:
 
@@ -1070,11 +1489,11 @@ namespace ANGLECORE
 
         /**
         * Sets the new memory location to write into when exporting.
-        * @param[in] buffer The new memory location.
-        * @param[in] numChannels Number of output channels.
+        * @param[in] buffer The new memory location, which can be planar or
+        *   interleaved.
         * @param[in] startSample Position to start from in the buffer.
         */
-        void setOutputBuffer(export_type** buffer, unsigned short numChannels, uint32_t startSample);
+        void setOutputBuffer(const ExportBuffer& buffer, uint32_t startSample);
 
         /**
         * Exports its input streams into the memory location that was given by the
@@ -1101,34 +1520,180 @@ namespace ANGLECORE
         */
         void decrementVoiceCount();
 
+        /**
+        * Enables or disables the fused export, in which the Mixer writes its mix
+        * directly into the host's buffer (see Mixer::setFusedExport()), and the
+        * Exporter has nothing left to do. This method should not be called while
+        * the Exporter is rendering.
+        * @param[in] isFused True to skip the Exporter's work, false to export the
+        *   input streams as usual.
+        */
+        void setFusedExport(bool isFused);
+
     private:
-        export_type** m_outputBuffer;
-        unsigned short m_numOutputChannels;
+        ExportBuffer m_outputBuffer;
         uint32_t m_startSample;
         unsigned short m_numVoicesOn;
+        bool m_isExportFused;
+    };
+}
+
+namespace ANGLECORE
+{
+    /**
+    * \class MixerKernels MixerKernels.h
+    * Provides the functions the Mixer uses to sum its input streams, in several
+    * versions that each rely on a different instruction set. The best version
+    * the CPU supports is detected at runtime, so that the same binary runs on
+    * every x86 CPU and still takes advantage of the widest SIMD registers
+    * available. Every version sums up to ANGLECORE_MIXER_INPUTS_PER_PASS input
+    * streams per pass over the output stream, which reduces the number of times
+    * the output is loaded and stored.
+    */
+    class MixerKernels
+    {
+    public:
+        MixerKernels() = delete;
+
+        /** Instruction sets a summing function can be implemented with */
+        enum InstructionSet
+        {
+            SCALAR = 0,     /**< Plain C++, which runs on every CPU */
+            SSE2,           /**< 128-bit SIMD registers */
+            AVX2,           /**< 256-bit SIMD registers */
+            AVX512,         /**< 512-bit SIMD registers, using AVX-512F */
+            NUM_INSTRUCTION_SETS
+        };
+
+        /**
+        * Function that sums \p numInputs streams of \p numSamples samples into an
+        * output stream, whose previous content is overwritten. The output stream
+        * is filled with zeros if \p numInputs equals zero.
+        */
+        typedef void (*SumFunction)(floating_type* output, const floating_type* const* inputs, unsigned int numInputs, unsigned int numSamples);
+
+        /**
+        * Returns the widest instruction set supported by both the CPU and the
+        * operating system, among the ones ANGLECORE was compiled with. This
+        * method queries the CPU, so its result should be stored rather than
+        * computed on every rendering session.
+        */
+        static InstructionSet detectInstructionSet();
+
+        /**
+        * Returns the summing function implemented with the given instruction set.
+        * The instruction set must be supported by the CPU, which is the case for
+        * every instruction set up to the one returned by detectInstructionSet().
+        * @param[in] instructionSet The instruction set to use. If ANGLECORE was
+        *   not compiled with it, the scalar version is returned.
+        */
+        static SumFunction getSumFunction(InstructionSet instructionSet);
+
+        /**
+        * Returns the name of the given instruction set, for display purposes.
+        * @param[in] instructionSet The instruction set to name.
+        */
+        static const char* getName(InstructionSet instructionSet);
     };
+}
+
+
+/*
+=================================================
+Configuration
+=================================================
+*/
 
+/**********************************************************************
+** GENERAL AUDIO SETTINGS
+**********************************************************************/
+
+#define ANGLECORE_NUM_CHANNELS 2
+#define ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE 10
+#define ANGLECORE_MAX_SAMPLE_RATE 192000                /**< Maximum sample rate, in Hz */
+
+/**********************************************************************
+** AUDIO WORKFLOW
+**********************************************************************/
+
+#define ANGLECORE_AUDIOWORKFLOW_EXPORTER_GAIN 0.5
+
+/**********************************************************************
+** INSTRUMENT
+**********************************************************************/
+
+#define ANGLECORE_INSTRUMENT_MINIMUM_SMOOTHING_DURATION 0.005   /**< Minimum duration to change the parameter of an instrument, in seconds */
+
+
+/*
+=================================================
+AudioWorkflow
+=================================================
+*/
+
+namespace ANGLECORE
+{
     /**
     * \class Mixer Mixer.h
     * Worker that sums all of its non-nullptr input stream, based on the audio
-    * channel they each represent.
+    * channel they each represent. The input streams are laid out as a grid of
+    * voices and racks, each with one Stream per channel, and only the voices that
+    * are on and the racks that are activated are mixed. The AudioWorkflow uses
+    * one Mixer per Voice to sum the racks of that Voice, and one final Mixer to
+    * sum the voices, so that most of the mixing happens within each Voice, and
+    * can therefore be rendered in parallel.
     */
     class Mixer :
-        public Worker
+        public DevirtualizedWorker<Mixer>
     {
     public:
 
         /**
-        * Initializes the Worker's buses size according to the audio
-        * configuration (number of channels, number of instruments...)
+        * Initializes the Worker's buses size according to the given grid of voices
+        * and racks, and to the number of channels. Every Voice starts off, and
+        * every rack deactivated.
+        * @param[in] numVoices Number of voices to mix. It must not exceed
+        *   ANGLECORE_NUM_VOICES.
+        * @param[in] numRacks Number of racks to mix in each Voice. It must not
+        *   exceed ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE.
         */
-        Mixer();
+        Mixer(unsigned short numVoices, unsigned short numRacks);
 
         /**
         * Mixes all the channels together
         */
         void work(unsigned int numSamplesToWorkOn);
 
+        /**
+        * Selects the instruction set the Mixer sums its input streams with. This
+        * method should not be called while the Mixer is rendering.
+        * @param[in] instructionSet The instruction set to use, which must be
+        *   supported by the CPU (see MixerKernels::detectInstructionSet()).
+        */
+        void setInstructionSet(MixerKernels::InstructionSet instructionSet);
+
+        /**
+        * Enables or disables the fused export. When enabled, the Mixer no longer
+        * writes into its output streams: it applies the Exporter's gain to its
+        * mix, converts it into the host's format, and writes it directly into the
+        * buffer given by setOutputBuffer(), in a single pass. This saves a pass
+        * through memory on every rendering session, but it can only be used if
+        * the Exporter is the only reader of the Mixer's output streams, and if
+        * the Exporter itself is told to skip its work. This method should not be
+        * called while the Mixer is rendering.
+        * @param[in] isFused True to export directly, false to write into the
+        *   output streams.
+        */
+        void setFusedExport(bool isFused);
+
+        /**
+        * Sets the memory location to export into when the fused export is enabled,
+        * with the same meaning as in Exporter::setOutputBuffer().
+        * @param[in] buffer The new memory location.
+        * @param[in] startSample Position to start from in the buffer.
+        */
+        void setOutputBuffer(const ExportBuffer& buffer, uint32_t startSample);
+
         /**
         * Instructs the Mixer to turn a Voice on, and to recompute its increments.
         * This method is really fast, as it will only be called by the real-time
@@ -1163,6 +1728,21 @@ namespace ANGLECORE
 
     private:
 
+        /**
+        * Mixes the instruments like work(), but sums them with the precision of
+        * accumulation_type rather than floating_type. This is used when
+        * ANGLECORE_ACCUMULATION_PRECISION differs from ANGLECORE_PRECISION.
+        * @param[in] numSamplesToWorkOn Number of samples to mix.
+        */
+        void mixWithAccumulator(unsigned int numSamplesToWorkOn);
+
+        /**
+        * Mixes the instruments and exports the result into the output buffer, as
+        * described in setFusedExport().
+        * @param[in] numSamplesToWorkOn Number of samples to mix and export.
+        */
+        void mixAndExport(unsigned int numSamplesToWorkOn);
+
         /**
         * Recomputes the Mixer's voice increments after a Voice has been turned on
         * or off. This method is really fast, as it will only be called by the
@@ -1177,7 +1757,8 @@ namespace ANGLECORE
         */
         void updateRackIncrements();
 
-        const unsigned short m_totalNumInstruments;
+        const unsigned short m_numVoices;
+        const unsigned short m_numRacks;
 
         /**
         * Voice to start from when mixing voices. This may vary depending on which
@@ -1207,277 +1788,158 @@ namespace ANGLECORE
         uint32_t m_rackIncrements[ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
 
         /** Tracks the activated/deactivated status of every Rack */
-        bool m_rackIsActivated[ANGLECORE_NUM_VOICES];
+        bool m_rackIsActivated[ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
+
+        /** Function used to sum the input streams into each output stream */
+        MixerKernels::SumFunction m_sumFunction;
+
+        /** Fused export's status and destination (see setFusedExport()) */
+        bool m_isExportFused;
+        ExportBuffer m_outputBuffer;
+        uint32_t m_startSample;
     };
+}
+
+
+/*
+=================================================
+Utility
+=================================================
+*/
 
+/**
+* In order to avoid unnecessary copies and memory allocations when manipulating an
+* STL key-value containers (map, unordered_map, etc.), it is definitely tempting to
+* use const char* instead of std::string as a key type. This especially makes sense
+* in the context of the Instrument class, where some parameters' information is
+* stored in unordered maps that are likely to be heavily solicited when rendering an
+* audio block.
+* However, in order to use C string keys (const char*) in those containers, one
+* needs to define a structure for automatically hashing and comparing C strings.
+* In C++17, the std::string_view type seems perfectly suited for the job, but in
+* earlier C++ versions, there is no such convenient feature. This file proposes a
+* solution for C++11 and later versions: the ANGLECORE::StringView structure.
+*/
+
+namespace ANGLECORE
+{
     /**
-    * \struct Parameter Parameter.h
-    * Represents a parameter that an AudioWorkflow can modify and use for rendering.
+    * \struct StringView
+    * Provides a simplified version of the C++17 string_view feature for compiling
+    * with earlier versions of C++.
+    * A StringView is simply a view over an existing C string, which provides a
+    * simple interface for performing operations on that string.
+    * This structure only contains a pointer to a C string, but defines special
+    * comparison and hash operations which are applicable to that C string so that
+    * it can be properly used as a identifier inside an STL key-value container.
+    * Using a StringView instead of a std::string as a key type in such container
+    * will prevent undesired memory allocation and copies.
     */
-    struct Parameter
+    struct StringView
     {
         /**
-        * \enum SmoothingMethod Parameter.h
-        * Method used to smooth out a parameter change. If set to ADDITIVE, then a
-        * parameter change will result in an arithmetic sequence from an initial
-        * value to a target value. If set to MULTIPLICATIVE, then the sequence will
-        * be geometric and use a multiplicative increment instead.
+        * The constructor simply stores the provided pointer to C string internally.
+        * It hereby provides an implicit conversion from const char* to StringView.
         */
-        enum SmoothingMethod
+        StringView(const char* str) :
+            string_ptr(str)
+        {}
+
+        /**
+        * Comparing two StringViews consists in comparing their internal C strings,
+        * using strcmp.
+        */
+        bool operator==(const StringView& other) const
         {
-            ADDITIVE = 0,   /**< Generates an arithmetic sequence */
-            MULTIPLICATIVE, /**< Generates a geometric sequence */
-            NUM_METHODS     /**< Counts the number of available methods */
-        };
+            return strcmp(string_ptr, other.string_ptr) == 0;
+        }
 
-        StringView identifier;
-        floating_type defaultValue;
-        floating_type minimalValue;
-        floating_type maximalValue;
-        SmoothingMethod smoothingMethod;
-        bool minimalSmoothingEnabled;
-        uint32_t minimalSmoothingDurationInSamples;
-
-        /** Creates a Parameter from the arguments provided */
-        Parameter(const char* identifier, floating_type defaultValue, floating_type minimalValue, floating_type maximalValue, SmoothingMethod smoothingMethod, bool minimalSmoothingEnabled, uint32_t minimalSmoothingDurationInSamples) :
-            identifier(identifier),
-            defaultValue(defaultValue),
-            minimalValue(minimalValue),
-            maximalValue(maximalValue),
-            smoothingMethod(smoothingMethod),
-            minimalSmoothingEnabled(minimalSmoothingEnabled),
-            minimalSmoothingDurationInSamples(minimalSmoothingDurationInSamples)
-        {}
+        /** This is the internal pointer to the C string being viewed */
+        const char* string_ptr;
     };
+}
 
-    /**
-    * \struct ParameterChangeRequest ParameterChangeRequest.h
-    * When the end-user asks to change the value of a Parameter within an Instrument
-    * (volume, etc.) or the entire AudioWorkflow (sample rate, etc.), an instance of
-    * this structure is created to store all necessary information about that
-    * request.
-    */
-    struct ParameterChangeRequest
-    {
-        floating_type newValue;
-        uint32_t durationInSamples;
-    };
+/* We need to specialize the std::hash method, so we open a new namespace scope: */
+namespace std {
 
     /**
-    * \class ParameterGenerator ParameterGenerator.h
-    * Worker that generates the values of a Parameter in a Stream, according to the
-    * end-user requests. A ParameterGenerator also takes care of smoothing out every
-    * sudden change to avoid audio glitches.
+    * In order to be used as a key within a standard key-value container, a StringView
+    * must have a dedicated hash function. Otherwise, only the internal pointer will be
+    * hashed, which will not produce the desired effect. Therefore, we have to
+    * specialize the standard hash structure to our StringView type.
     */
-    class ParameterGenerator :
-        public Worker
+    template<>
+    struct hash<ANGLECORE::StringView>
     {
-    public:
-
-        /**
-        * Creates a ParameterGenerator from the given Parameter.
-        * @param[in] parameter Parameter containing all the necessary information
-        *   for the ParameterGenerator to generate its value.
-        */
-        ParameterGenerator(const Parameter& parameter);
-
-        /**
-        * Pushes the given request into the request queue. This method uses move
-        * semantics, so it will take ownership of the pointer passed as argument. It
-        * will never be called by the real-time thread, and will only be called by
-        * the non real-time thread upon user request.
-        * @param[in] request The ParameterChangeRequest to post to the
-        *   ParameterGenerator. It will not be processed immediately, but before
-        *   rendering the next audio block.
-        */
-        void postParameterChangeRequest(std::shared_ptr<ParameterChangeRequest>&& request);
-
-        /**
-        * Generates the successive values of the associated Parameter for the next
-        * rendering session.
-        * @param[in] numSamplesToWorkOn Number of samples to generate.
-        */
-        void work(unsigned int numSamplesToWorkOn);
-
-        /**
-        * Instructs the generator to change the parameter's value instantaneously,
-        * without any transient phase. This method must never be called by the non
-        * real-time thread, and should only be called by the real-time thread.
-        * Requests emitted by the non real-time thread should use the
-        * postParameterChangeRequest() method instead.
-        * @param[in] newValue The new value of the Parameter.
-        */
-        void setParameterValue(floating_type newValue);
-
-    private:
-
-        /**
-        * \struct TransientTracker ParameterGenerator.h
-        * A TransientTracker tracks a Parameter's position while in a transient
-        * state. This structure can store how close the Parameter is to its target
-        * value (in terms of remaining samples), as well as the increment to use for
-        * its update.
-        */
-        struct TransientTracker
-        {
-            floating_type targetValue;
-            uint32_t transientDurationInSamples;
-            uint32_t position;
-            floating_type increment;
-        };
-
-        /**
-        * \enum State
-        * Represents the state of a ParameterGenerator.
-        */
-        enum State
+        size_t operator()(const ANGLECORE::StringView& view) const
         {
-            STEADY = 0,             /**< The Parameter has a constant value, and the output stream is entierly filled with that value */
-            TRANSIENT,              /**< The Parameter is currently changing its value */
-            TRANSIENT_TO_STEADY,    /**< The Parameter has reached a new value but the output stream still needs to be filled up accordingly */
-            NUM_STATES              /**< Counts the number of possible states */
-        };
-
-        const Parameter& m_parameter;
-        floating_type m_currentValue;
-        State m_currentState;
-
-        /** Queue for receiving Parameter change requests. */
-        farbot::fifo<
-            std::shared_ptr<const ParameterChangeRequest>,
-            farbot::fifo_options::concurrency::single,
-            farbot::fifo_options::concurrency::single,
-            farbot::fifo_options::full_empty_failure_mode::return_false_on_full_or_empty,
-            farbot::fifo_options::full_empty_failure_mode::overwrite_or_return_default
-        > m_requestQueue;
-
-        TransientTracker m_transientTracker;
+            /* This hash function comes from the boost library */
+            size_t hashValue = 0;
+            for (const char* p = view.string_ptr; p && *p; p++)
+                hashValue ^= *p + 0x9e3779b9 + (hashValue << 6) + (hashValue >> 2);
+            return hashValue;
+        }
     };
+}
 
-    /**
-    * \class ParameterRegister ParameterRegister.h
-    * The goal of a ParameterRegister is to track which workflow items are involved
-    * in the generation of a Parameter. It maps a Parameter with its corresponding
-    * ParameterGenerator and with the Stream the generator will write into, which
-    * provides a more direct access to the Parameter's values.
-    */
-    class ParameterRegister
-    {
-    public:
-
-        /**
-        * \struct Entry ParameterRegister.h
-        * Element stored in the ParameterRegister that contains the
-        * ParameterGenerator and Stream corresponding to a particular Parameter.
-        */
-        struct Entry
-        {
-            std::shared_ptr<ParameterGenerator> generator;
-            std::shared_ptr<Stream> stream;
-        };
-
-        /**
-        * Stores the given Entry into the register. Note that this method must only
-        * be called by the real-time thread to execute a ParameterRegistrationPlan.
-        * It should not be called by the non real-time thread, since the real-time
-        * thread may be using the register to dispatch parameter change requests in
-        * the meantime.
-        * @param[in] parameterIdentifier The Parameter's identifier.
-        * @param[in] entryToInsert The ParameterGenerator and Stream that correspond
-        *   to the Parameter identified by \p parameterIdentifier.
-        */
-        void insert(StringView parameterIdentifier, const Entry& entryToInsert);
-
-        /**
-        * Searches for the given Parameter in the register. If the Parameter is
-        * found, then the corresponding Entry is returned. Otherwise, this method
-        * will return an Entry with empty pointers.
-        * @param[in] parameterIdentifier The Parameter's identifier.
-        */
-        Entry find(StringView parameterIdentifier) const;
-
-        /**
-        * Removes any Entry that matches the given Parameter from the register. Note
-        * that this method must only be called by the real-time thread to execute a
-        * ParameterRegistrationPlan. It should not be called by the non real-time
-        * thread, since the real-time thread may be using the register to dispatch
-        * parameter change requests in the meantime. Also note that this method
-        * deletes the shared pointers that were contained in the register after
-        * removing them. It is the responsibility of the Master to retrieve a copy
-        * of those pointers first, and then pass the copies to the non real-time
-        * thread for deletion, so that the real-time thread does not deallocate any
-        * memory.
-        * @param[in] parameterIdentifier The Parameter's identifier.
-        */
-        void remove(StringView parameterIdentifier);
 
-    private:
-        std::unordered_map<StringView, Entry> m_data;
-    };
+/*
+=================================================
+AudioWorkflow
+=================================================
+*/
 
+namespace ANGLECORE
+{
     /**
-    * \struct ParameterRegistrationPlan ParameterRegistrationPlan.h
-    * When the end-user asks to add an Instrument to an AudioWorkflow or to remove
-    * one from it, an instance of this structure is created to plan an update of its
-    * parameter registers.
+    * \struct Parameter Parameter.h
+    * Represents a parameter that an AudioWorkflow can modify and use for rendering.
     */
-    struct ParameterRegistrationPlan
+    struct Parameter
     {
         /**
-        * \struct Instruction ParameterRegistrationPlan.h
-        * Contains all the details of a specific entry to either add to or remove
-        * from the ParameterRegister.
+        * \enum SmoothingMethod Parameter.h
+        * Method used to smooth out a parameter change. If set to ADDITIVE, then a
+        * parameter change will result in an arithmetic sequence from an initial
+        * value to a target value. If set to MULTIPLICATIVE, then the sequence will
+        * be geometric and use a multiplicative increment instead.
         */
-        struct Instruction
+        enum SmoothingMethod
         {
-            unsigned short rackNumber;
-            StringView parameterIdentifier;
-            std::shared_ptr<ParameterGenerator> parameterGenerator;
-            std::shared_ptr<Stream> parameterStream;
-
-            Instruction(unsigned short rackNumber, StringView parameterIdentifier, std::shared_ptr<ParameterGenerator> parameterGenerator, std::shared_ptr<Stream> parameterStream) :
-                rackNumber(rackNumber),
-                parameterIdentifier(parameterIdentifier),
-                parameterGenerator(parameterGenerator),
-                parameterStream(parameterStream)
-            {}
+            ADDITIVE = 0,   /**< Generates an arithmetic sequence */
+            MULTIPLICATIVE, /**< Generates a geometric sequence */
+            NUM_METHODS     /**< Counts the number of available methods */
         };
 
-        std::vector<Instruction> removeInstructions;
-        std::vector<Instruction> addInstructions;
-    };
-
-    /**
-    * \struct GlobalContext GlobalContext.h
-    * Set of streams which provide useful information, such as the sample rate the
-    * audio should be rendered into, in a centralized spot, shared by the rest of
-    * the AudioWorkflow.
-    */
-    struct GlobalContext
-    {
-        std::shared_ptr<Stream> sampleRateStream;
-        std::shared_ptr<Stream> sampleRateReciprocalStream;
-
-        /**
-        * Creates a GlobalContext, hereby initializing every pointer to a Stream or
-        * a Worker to a non null pointer. Note that this method does not do any
-        * connection between streams and workers, as this is the responsability of
-        * the AudioWorkflow to which the GlobalContext belong.
-        */
-        GlobalContext();
-
-        void setSampleRate(floating_type sampleRate);
+        StringView identifier;
+        floating_type defaultValue;
+        floating_type minimalValue;
+        floating_type maximalValue;
+        SmoothingMethod smoothingMethod;
+        bool minimalSmoothingEnabled;
+        uint32_t minimalSmoothingDurationInSamples;
 
-    private:
-        floating_type m_currentSampleRate;
+        /** Creates a Parameter from the arguments provided */
+        Parameter(const char* identifier, floating_type defaultValue, floating_type minimalValue, floating_type maximalValue, SmoothingMethod smoothingMethod, bool minimalSmoothingEnabled, uint32_t minimalSmoothingDurationInSamples) :
+            identifier(identifier),
+            defaultValue(defaultValue),
+            minimalValue(minimalValue),
+            maximalValue(maximalValue),
+            smoothingMethod(smoothingMethod),
+            minimalSmoothingEnabled(minimalSmoothingEnabled),
+            minimalSmoothingDurationInSamples(minimalSmoothingDurationInSamples)
+        {}
     };
+}
 
+namespace ANGLECORE
+{
     /**
     * \class Instrument Instrument.h
     * Worker that generates audio within an AudioWorkflow.
     */
     class Instrument :
-        public Worker
+        public DevirtualizedWorker<Instrument>
     {
     public:
 
@@ -1579,6 +2041,9 @@ namespace ANGLECORE
         * Generates the given number of samples according to the Instrument's
         * internal state. This method overrides the pure virtual work() method from
         * the Worker class, and it will only be called by the real-time thread.
+        * Subclasses should not override this method, but implement play()
+        * instead, as the Renderer calls Instrument::work() without any virtual
+        * dispatch.
         * @param[in] numSamplesToWorkOn Number of samples to generate.
         */
         void work(unsigned int numSamplesToWorkOn);
@@ -1667,20 +2132,336 @@ namespace ANGLECORE
         State m_state;
         StopTracker m_stopTracker;
     };
+}
+
+
+/*
+=================================================
+Utility
+=================================================
+*/
 
+namespace ANGLECORE
+{
     /**
-    * \struct VoiceContext VoiceContext.h
-    * Set of streams and workers designed to provide useful information, such as the
-    * frequency the instruments of Each voice should play, in a centralized spot.
-    * Note that Workers and streams are not connected upon creation: it is the
-    * responsability of the AudioWorkflow they will belong to to make the
-    * appropriate connections.
+    * \class TripleBuffer TripleBuffer.h
+    * Lock-free mechanism that allows one producer thread to publish successive
+    * versions of an object to one consumer thread, without either thread ever
+    * waiting for the other. The producer writes into a back buffer and publishes
+    * it, while the consumer reads from a front buffer it can update to the latest
+    * published version. A third buffer sits in between, and is exchanged
+    * atomically by both threads. The producer can therefore be the real-time
+    * thread: publishing never blocks nor allocates memory.
+    * .
+    * The three objects are allocated upon construction, so the type T must be
+    * default constructible and copy assignable.
     */
-    struct VoiceContext
+    template<class T>
+    class TripleBuffer
     {
+    public:
+
+        /** Allocates the three buffers. */
+        TripleBuffer();
+
         /**
-        * \class RatioCalculator GlobalContext.h
-        * Worker that computes the sample-wise division of the Voice's frequency by
+        * Returns the buffer the producer should write into before publishing it.
+        * This method must only be called by the producer thread.
+        */
+        T& getBackBuffer();
+
+        /**
+        * Publishes the back buffer, making it available to the consumer thread,
+        * and provides a new back buffer to the producer. Note that the content of
+        * the new back buffer is not specified. This method must only be called by
+        * the producer thread.
+        */
+        void publish();
+
+        /**
+        * Makes the front buffer point to the last version published by the
+        * producer, if any. Returns true if a new version was available, and false
+        * otherwise. This method must only be called by the consumer thread.
+        */
+        bool update();
+
+        /**
+        * Returns the buffer the consumer can read from. This method must only be
+        * called by the consumer thread.
+        */
+        const T& getFrontBuffer() const;
+
+    private:
+
+        /**
+        * Flag stored alongside the middle buffer's index, which indicates that the
+        * middle buffer contains a version the consumer has not read yet.
+        */
+        static const unsigned char NEW_DATA = 4;
+        static const unsigned char INDEX_MASK = 3;
+
+        std::unique_ptr<T[]> m_buffers;
+        unsigned char m_back;
+        std::atomic<unsigned char> m_middle;
+        unsigned char m_front;
+    };
+
+    template<class T>
+    TripleBuffer<T>::TripleBuffer() :
+        m_buffers(new T[3]),
+        m_back(0),
+        m_middle(1),
+        m_front(2)
+    {}
+
+    template<class T>
+    T& TripleBuffer<T>::getBackBuffer()
+    {
+        return m_buffers[m_back];
+    }
+
+    template<class T>
+    void TripleBuffer<T>::publish()
+    {
+        /*
+        * We exchange the back and middle buffers, and flag the middle buffer as
+        * new. The release semantics ensure that the consumer will see everything
+        * written into the buffer, while the acquire semantics ensure we do not
+        * start writing into the previous middle buffer before the consumer is done
+        * with it.
+        */
+        m_back = m_middle.exchange(m_back | NEW_DATA, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    template<class T>
+    bool TripleBuffer<T>::update()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & NEW_DATA))
+            return false;
+
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    template<class T>
+    const T& TripleBuffer<T>::getFrontBuffer() const
+    {
+        return m_buffers[m_front];
+    }
+}
+
+
+/*
+=================================================
+AudioWorkflow
+=================================================
+*/
+
+namespace ANGLECORE
+{
+    /**
+    * \struct ParameterChangeRequest ParameterChangeRequest.h
+    * When the end-user asks to change the value of a Parameter within an Instrument
+    * (volume, etc.) or the entire AudioWorkflow (sample rate, etc.), an instance of
+    * this structure is created to store all necessary information about that
+    * request.
+    */
+    struct ParameterChangeRequest
+    {
+        floating_type newValue;
+        uint32_t durationInSamples;
+    };
+}
+
+namespace ANGLECORE
+{
+    /**
+    * \class ParameterGenerator ParameterGenerator.h
+    * Worker that generates the values of a Parameter in a Stream, according to the
+    * end-user requests. A ParameterGenerator also takes care of smoothing out every
+    * sudden change to avoid audio glitches.
+    */
+    class ParameterGenerator :
+        public DevirtualizedWorker<ParameterGenerator>
+    {
+    public:
+
+        /**
+        * Creates a ParameterGenerator from the given Parameter.
+        * @param[in] parameter Parameter containing all the necessary information
+        *   for the ParameterGenerator to generate its value.
+        */
+        ParameterGenerator(const Parameter& parameter);
+
+        /**
+        * Copies the given request into the request mailbox, replacing any request
+        * the real-time thread has not processed yet. Neither this method nor the
+        * real-time thread that processes the request allocates or frees any
+        * memory, and neither waits for the other. It will never be called by the
+        * real-time thread, and will only be called by one non real-time thread
+        * upon user request.
+        * @param[in] request The ParameterChangeRequest to post to the
+        *   ParameterGenerator. It will not be processed immediately, but before
+        *   rendering the next audio block.
+        */
+        void postParameterChangeRequest(const ParameterChangeRequest& request);
+
+        /**
+        * Generates the successive values of the associated Parameter for the next
+        * rendering session.
+        * @param[in] numSamplesToWorkOn Number of samples to generate.
+        */
+        void work(unsigned int numSamplesToWorkOn);
+
+        /**
+        * Instructs the generator to change the parameter's value instantaneously,
+        * without any transient phase. This method must never be called by the non
+        * real-time thread, and should only be called by the real-time thread.
+        * Requests emitted by the non real-time thread should use the
+        * postParameterChangeRequest() method instead.
+        * @param[in] newValue The new value of the Parameter.
+        */
+        void setParameterValue(floating_type newValue);
+
+        /**
+        * Schedules a change of the parameter's value at a precise sample of the
+        * audio block about to be rendered. Unlike the requests posted with
+        * postParameterChangeRequest(), the change can happen in the middle of a
+        * rendering session. This method must never be called by the non real-time
+        * thread, and should only be called by the real-time thread before
+        * rendering the audio block.
+        * @param[in] offset Position of the change, in samples, from the beginning
+        *   of the next rendering session.
+        * @param[in] newValue The new value of the Parameter.
+        * @param[in] durationInSamples Duration of the transient towards the new
+        *   value, in samples.
+        * @return False if the change could not be scheduled, because
+        *   ANGLECORE_PARAMETER_MAX_NUM_SCHEDULED_CHANGES changes are already
+        *   waiting to be rendered.
+        */
+        bool scheduleParameterChange(uint32_t offset, floating_type newValue, uint32_t durationInSamples);
+
+    private:
+
+        /**
+        * Changes the parameter's value, either instantly or through a transient,
+        * depending on the requested duration and on the Parameter's minimal
+        * smoothing. The new value is clamped into the Parameter's range.
+        * @param[in] newValue The new value of the Parameter.
+        * @param[in] requestedDurationInSamples Requested duration of the
+        *   transient, in samples.
+        */
+        void applyChange(floating_type newValue, uint32_t requestedDurationInSamples);
+
+        /**
+        * Renders \p numSamples values of the parameter into \p output according
+        * to the current state, and updates the state accordingly.
+        * @param[in] output The memory location to write into.
+        * @param[in] numSamples Number of values to write. It must be positive.
+        * @param[in] coversWholeStream True if the segment covers the whole
+        *   rendering session, in which case a steady value can fill the output
+        *   stream entirely.
+        */
+        void renderSegment(floating_type* output, uint32_t numSamples, bool coversWholeStream);
+
+        /**
+        * Writes the next \p numSamples values of the current transient into
+        * \p output, starting from the position following the transient
+        * tracker's one. The values are computed in closed form, without
+        * depending on each other, so this method does not update the tracker.
+        * @param[in] output The memory location to write into.
+        * @param[in] numSamples Number of values to write. The transient must not
+        *   end before them.
+        */
+        void renderTransient(floating_type* output, uint32_t numSamples) const;
+
+        /**
+        * \struct TransientTracker ParameterGenerator.h
+        * A TransientTracker tracks a Parameter's position while in a transient
+        * state. This structure can store how close the Parameter is to its target
+        * value (in terms of remaining samples), as well as the value it started
+        * from and the increment to use for its update.
+        */
+        struct TransientTracker
+        {
+            floating_type targetValue;
+            uint32_t transientDurationInSamples;
+            uint32_t position;
+            floating_type startValue;
+            floating_type increment;
+
+            /** The natural logarithm of the increment, for multiplicative transients */
+            floating_type logIncrement;
+
+            /** The increment raised to the powers 1 to ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE, for multiplicative transients */
+            floating_type powers[ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE];
+        };
+
+        /**
+        * \enum State
+        * Represents the state of a ParameterGenerator.
+        */
+        enum State
+        {
+            STEADY = 0,             /**< The Parameter has a constant value, and the output stream is entierly filled with that value */
+            TRANSIENT,              /**< The Parameter is currently changing its value */
+            TRANSIENT_TO_STEADY,    /**< The Parameter has reached a new value but the output stream still needs to be filled up accordingly */
+            NUM_STATES              /**< Counts the number of possible states */
+        };
+
+        /**
+        * \struct ScheduledChange ParameterGenerator.h
+        * A change of the parameter's value scheduled at a precise sample (see
+        * scheduleParameterChange()).
+        */
+        struct ScheduledChange
+        {
+            /** Time of the change, on the ParameterGenerator's clock */
+            uint64_t time;
+            floating_type newValue;
+            uint32_t durationInSamples;
+        };
+
+        const Parameter& m_parameter;
+        floating_type m_currentValue;
+        State m_currentState;
+
+        /**
+        * Mailbox for receiving Parameter change requests. Only the latest request
+        * matters, so each new request replaces the previous one, and the
+        * real-time thread checks the mailbox once per rendering session.
+        */
+        TripleBuffer<ParameterChangeRequest> m_requestMailbox;
+
+        TransientTracker m_transientTracker;
+
+        /**
+        * Number of samples the ParameterGenerator has rendered since its
+        * creation, which is used to locate the scheduled changes.
+        */
+        uint64_t m_clock;
+
+        /** Changes waiting to be rendered, sorted by time */
+        ScheduledChange m_scheduledChanges[ANGLECORE_PARAMETER_MAX_NUM_SCHEDULED_CHANGES];
+        unsigned int m_numScheduledChanges;
+    };
+}
+
+namespace ANGLECORE
+{
+    /**
+    * \struct VoiceContext VoiceContext.h
+    * Set of streams and workers designed to provide useful information, such as the
+    * frequency the instruments of Each voice should play, in a centralized spot.
+    * Note that Workers and streams are not connected upon creation: it is the
+    * responsability of the AudioWorkflow they will belong to to make the
+    * appropriate connections.
+    */
+    struct VoiceContext
+    {
+        /**
+        * \class RatioCalculator GlobalContext.h
+        * Worker that computes the sample-wise division of the Voice's frequency by
         * the global sample rate. The RatioCalculator takes advantage of the fact
         * that the reciprocal of the sample rate is already computed in the
         * AudioWorkflow's GlobalContext, and therefore performs a multiplication
@@ -1688,7 +2469,7 @@ namespace ANGLECORE
         * shorter computation time.
         */
         class RatioCalculator :
-            public Worker
+            public DevirtualizedWorker<RatioCalculator>
         {
         public:
 
@@ -1728,10 +2509,14 @@ namespace ANGLECORE
         * Worker to a non null pointer. Note that this method does not do any
         * connection between streams and workers, as this is the responsability of
         * the AudioWorkflow to which the VoiceContext belong.
+        * @param[in] streamArena The StreamArena to create the streams with.
         */
-        VoiceContext();
+        VoiceContext(StreamArena& streamArena);
     };
+}
 
+namespace ANGLECORE
+{
     /**
     * \struct Voice Voice.h
     * Set of workers and streams, which together form an audio engine that can be
@@ -1764,62 +2549,523 @@ namespace ANGLECORE
         VoiceContext voiceContext;
         Rack racks[ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
 
+        /**
+        * Mixer that sums the output of every rack of the Voice, hereby producing
+        * the Voice's submix. Since it belongs to the Voice, the submix is rendered
+        * right after the Voice's instruments, while their output streams are
+        * still in the cache, and in parallel with the other voices when the
+        * Renderer allows it. Its only Voice is always on.
+        */
+        std::shared_ptr<Mixer> submixer;
+
         /**
         * Creates a Voice only comprised of empty racks.
+        * @param[in] streamArena The StreamArena to create the VoiceContext's
+        *   streams with.
         */
-        Voice();
+        Voice(StreamArena& streamArena);
     };
+}
 
+namespace ANGLECORE
+{
     /**
-    * \class AudioWorkflow AudioWorkflow.h
-    * Workflow internally structured to generate an audio output. It consists of a
-    * succession of workers and streams, and it should not contain any feedback.
+    * \struct GlobalContext GlobalContext.h
+    * Set of streams which provide useful information, such as the sample rate the
+    * audio should be rendered into, in a centralized spot, shared by the rest of
+    * the AudioWorkflow.
     */
-    class AudioWorkflow :
-        public Workflow,
-        public VoiceAssigner,
-        public Lockable
+    struct GlobalContext
     {
-    public:
-
-        /** Builds the base structure of the AudioWorkflow (Exporter, Mixer...) */
-        AudioWorkflow();
+        std::shared_ptr<Stream> sampleRateStream;
+        std::shared_ptr<Stream> sampleRateReciprocalStream;
 
         /**
-        * Sets the sample rate of the AudioWorkflow.
-        * @param[in] sampleRate The value of the sample rate, in Hz.
+        * Creates a GlobalContext, hereby initializing every pointer to a Stream or
+        * a Worker to a non null pointer. Note that this method does not do any
+        * connection between streams and workers, as this is the responsability of
+        * the AudioWorkflow to which the GlobalContext belong.
+        * @param[in] streamArena The StreamArena to create the streams with.
         */
+        GlobalContext(StreamArena& streamArena);
+
         void setSampleRate(floating_type sampleRate);
 
-        /**
-        * Builds and returns the Workflow's rendering sequence, starting from its
-        * Exporter. This method allocates memory, so it should never be called by
-        * the real-time thread. Note that the method relies on the move semantics to
-        * optimize its vector return.
-        * @param[in] connectionPlan The ConnectionPlan that will be executed next,
-        *   and that should therefore be taken into account in the computation
-        */
-        std::vector<std::shared_ptr<Worker>> buildRenderingSequence(const ConnectionPlan& connectionPlan) const;
+        /** Returns the current sample rate, in Hz. */
+        floating_type getSampleRate() const;
+
+    private:
+        floating_type m_currentSampleRate;
+    };
+}
+
+namespace ANGLECORE
+{
+    /**
+    * \class ParameterRegister ParameterRegister.h
+    * The goal of a ParameterRegister is to track which workflow items are involved
+    * in the generation of a Parameter. It maps a Parameter with its corresponding
+    * ParameterGenerator and with the Stream the generator will write into, which
+    * provides a more direct access to the Parameter's values. Entries are stored
+    * in a dense array, at the position of their Parameter in the Instrument's list
+    * of parameters, so that they can also be accessed by index through a
+    * ParameterHandle.
+    *
+    * The content of the register is held in an immutable Snapshot, which is never
+    * modified once published. To update the register, a non real-time thread
+    * prepares a modified copy of the current Snapshot, which the real-time thread
+    * then publishes by swapping a single pointer. Any thread can therefore look up
+    * the register in parallel without locking it. The Snapshot that was replaced
+    * is only deleted by a non real-time thread, after a call to synchronize()
+    * has ensured no thread is still reading it.
+    */
+    class ParameterRegister
+    {
+    public:
 
         /**
-        * Set the Exporter's memory location to write into when exporting.
-        * @param[in] buffer The new memory location.
-        * @param[in] numChannels Number of output channels.
-        * @param[in] startSample Position to start from in the buffer.
+        * \struct Entry ParameterRegister.h
+        * Element stored in the ParameterRegister that contains the
+        * ParameterGenerator and Stream corresponding to a particular Parameter.
         */
-        void setExporterOutput(export_type** buffer, unsigned short numChannels, uint32_t startSample);
+        struct Entry
+        {
+            std::shared_ptr<ParameterGenerator> generator;
+            std::shared_ptr<Stream> stream;
+        };
 
         /**
-        * Tries to find a Rack that is empty in all voices to insert an instrument
-        * inside. Returns the valid rack number of an empty rack if has found one,
-        * and an out-of-range number otherwise.
+        * \class Snapshot ParameterRegister.h
+        * Content of a ParameterRegister at a given time. A Snapshot can only be
+        * modified by the non real-time thread that prepares it, before it is
+        * published into the register. It is then read-only. Each slot of a
+        * Snapshot has a generation number, which starts at 0 and is incremented
+        * whenever the slot is emptied or given to another Parameter, so that a
+        * ParameterHandle retrieved for the slot's previous Parameter can be told
+        * apart. Generations are copied along with the slots, so modifying a slot
+        * never affects the handles of the others.
         */
-        unsigned short findEmptyRack() const;
+        class Snapshot
+        {
+        public:
 
-        /**
-        * Adds an Instrument to the given Voice, at the given \p rackNumber, then
-        * build the Instrument's environment, plan its bridging to the real-time
-        * rendering pipeline by completing the given \p connectionPlanToComplete,
+            /**
+            * Stores the given Entry into the Snapshot. If the slot at
+            * \p parameterIndex already holds another Parameter, its generation is
+            * incremented. This method must not be called once the Snapshot has
+            * been published.
+            * @param[in] parameterIdentifier The Parameter's identifier.
+            * @param[in] parameterIndex Position of the Parameter in the list of
+            *   parameters of its Instrument.
+            * @param[in] entryToInsert The ParameterGenerator and Stream that
+            *   correspond to the Parameter identified by \p parameterIdentifier.
+            */
+            void insert(StringView parameterIdentifier, unsigned short parameterIndex, const Entry& entryToInsert);
+
+            /**
+            * Removes any Entry that matches the given Parameter from the Snapshot,
+            * and increments the generation of its slot. This method must not be
+            * called once the Snapshot has been published.
+            * @param[in] parameterIdentifier The Parameter's identifier.
+            */
+            void remove(StringView parameterIdentifier);
+
+            /**
+            * Searches for the given Parameter in the Snapshot, and returns a
+            * pointer to its Entry, or nullptr if the Parameter is not found.
+            * @param[in] parameterIdentifier The Parameter's identifier.
+            */
+            const Entry* find(StringView parameterIdentifier) const;
+
+            /**
+            * Searches for the given Parameter in the Snapshot, and writes its
+            * index, i.e. its position in the list of parameters of its Instrument,
+            * into \p parameterIndex. Returns true if the Parameter is found, and
+            * false otherwise, in which case \p parameterIndex is left untouched.
+            * @param[in] parameterIdentifier The Parameter's identifier.
+            * @param[out] parameterIndex The Parameter's index.
+            */
+            bool findIndex(StringView parameterIdentifier, unsigned short& parameterIndex) const;
+
+            /**
+            * Returns a pointer to the Entry stored at the given index, without
+            * searching for any identifier, or nullptr if \p parameterIndex is
+            * out-of-range. Note that the Entry may be empty.
+            * @param[in] parameterIndex Position of the Parameter in the list of
+            *   parameters of its Instrument.
+            */
+            const Entry* get(unsigned short parameterIndex) const;
+
+            /**
+            * Returns the generation number of the slot at the given index, or 0 if
+            * \p parameterIndex is out-of-range, as such a slot has never been used.
+            * @param[in] parameterIndex Position of the Parameter in the list of
+            *   parameters of its Instrument.
+            */
+            uint32_t getGeneration(unsigned short parameterIndex) const;
+
+        private:
+            /** Maps each Parameter's identifier to the index of its slot */
+            std::unordered_map<StringView, unsigned short> m_indices;
+            std::vector<Entry> m_entries;
+
+            /** Generation number of each slot of m_entries */
+            std::vector<uint32_t> m_generations;
+        };
+
+        /** Creates a ParameterRegister holding an empty Snapshot. */
+        ParameterRegister();
+
+        /**
+        * Deletes the current Snapshot. No other thread should be reading the
+        * register anymore.
+        */
+        ~ParameterRegister();
+
+        ParameterRegister(const ParameterRegister&) = delete;
+        ParameterRegister& operator=(const ParameterRegister&) = delete;
+
+        /**
+        * Searches for the given Parameter in the register. If the Parameter is
+        * found, then the corresponding Entry is returned. Otherwise, this method
+        * will return an Entry with empty pointers. This method can be called by
+        * any thread.
+        * @param[in] parameterIdentifier The Parameter's identifier.
+        */
+        Entry find(StringView parameterIdentifier) const;
+
+        /**
+        * Searches for the given Parameter in the register, and writes its index
+        * into \p parameterIndex, along with the generation of its slot into
+        * \p generation. Returns true if the Parameter is found, and false
+        * otherwise. This method can be called by any thread.
+        * @param[in] parameterIdentifier The Parameter's identifier.
+        * @param[out] parameterIndex The Parameter's index.
+        * @param[out] generation The generation of the Parameter's slot.
+        */
+        bool findIndex(StringView parameterIdentifier, unsigned short& parameterIndex, uint32_t& generation) const;
+
+        /**
+        * Returns the Entry stored at the given index, without searching for any
+        * identifier. If \p generation does not match the slot's, if
+        * \p parameterIndex is out-of-range, or if the slot is empty, this method
+        * will return an Entry with empty pointers. This method can be called by
+        * any thread.
+        * @param[in] parameterIndex Position of the Parameter in the list of
+        *   parameters of its Instrument.
+        * @param[in] generation Generation of the slot when \p parameterIndex was
+        *   retrieved.
+        */
+        Entry get(unsigned short parameterIndex, uint32_t generation) const;
+
+        /**
+        * Returns the ParameterGenerator stored at the given index, just like get(),
+        * but only as a raw pointer, or nullptr if the Entry is not found or if
+        * \p generation is not the slot's. Unlike get(), this method does not
+        * copy any shared pointer nor announce itself as a reader, so it must only
+        * be called by the real-time thread. The latter is the one that publishes
+        * snapshots, so the Snapshot it reads cannot be replaced in the meantime.
+        * @param[in] parameterIndex Position of the Parameter in the list of
+        *   parameters of its Instrument.
+        * @param[in] generation Generation of the slot when \p parameterIndex was
+        *   retrieved.
+        */
+        ParameterGenerator* getGenerator(unsigned short parameterIndex, uint32_t generation) const;
+
+        /**
+        * Returns a copy of the current Snapshot, which can then be modified and
+        * published. This method allocates memory, so it must only be called by a
+        * non real-time thread.
+        */
+        std::unique_ptr<Snapshot> copySnapshot() const;
+
+        /**
+        * Replaces the current Snapshot with \p newSnapshot, and returns the
+        * previous one. The register takes ownership of \p newSnapshot, and the
+        * caller takes ownership of the returned Snapshot, which must be passed to a
+        * non real-time thread and only deleted after a call to synchronize(). This
+        * method neither allocates nor frees any memory, and is meant to be called
+        * by the real-time thread.
+        * @param[in] newSnapshot The Snapshot to publish. It must not be null.
+        */
+        Snapshot* publish(Snapshot* newSnapshot);
+
+        /**
+        * Waits until every thread that was reading the register when this method
+        * was called is done, so that the snapshots replaced before the call can
+        * be safely deleted. This method blocks, so it must only be called by a
+        * non real-time thread.
+        */
+        void synchronize();
+
+    private:
+
+        /**
+        * \class ReadScope ParameterRegister.h
+        * Announces the calling thread as a reader of the register for as long as
+        * the ReadScope exists, so that synchronize() waits for it.
+        */
+        class ReadScope
+        {
+        public:
+            ReadScope(const ParameterRegister& parameterRegister);
+            ~ReadScope();
+
+            ReadScope(const ReadScope&) = delete;
+            ReadScope& operator=(const ReadScope&) = delete;
+
+        private:
+            std::atomic<uint32_t>& m_numReaders;
+
+            /** Returns the reader counter of the current epoch, once incremented */
+            static std::atomic<uint32_t>& enter(const ParameterRegister& parameterRegister);
+        };
+
+        std::atomic<Snapshot*> m_snapshot;
+
+        /**
+        * Readers are counted separately for the current and the previous epoch.
+        * Each call to synchronize() starts a new epoch, and waits for the readers
+        * of the previous one to leave.
+        */
+        std::atomic<unsigned char> m_epoch;
+        mutable std::atomic<uint32_t> m_numReaders[2];
+
+        /** Prevents two threads from running synchronize() concurrently */
+        Mutex m_synchronizationLock;
+    };
+}
+
+namespace ANGLECORE
+{
+    /**
+    * \struct ParameterHandle ParameterHandle.h
+    * Identifies a Parameter by its Instrument's rack number and by its position in
+    * the list of parameters the Instrument was constructed with. Unlike a
+    * Parameter's StringView identifier, a ParameterHandle gives direct access to
+    * the Parameter's slot in the AudioWorkflow's parameter registers, without
+    * hashing nor comparing any string. A handle can be retrieved once from the
+    * Master, or built at compile-time by an Instrument that declares the position
+    * of each of its parameters as a constant. It also records the generation of
+    * the Parameter's slot in the register, which only changes when the slot is
+    * emptied or given to another Parameter, so that a handle that has become
+    * stale is rejected instead of silently targeting another Parameter. A slot
+    * used for the first time is of generation 0.
+    */
+    struct ParameterHandle
+    {
+        /**
+        * Rack number of the Instrument the Parameter belongs to. It is out-of-range
+        * for invalid handles.
+        */
+        uint16_t rackNumber;
+
+        /** Position of the Parameter in its Instrument's list of parameters */
+        uint16_t parameterIndex;
+
+        /**
+        * Generation of the Parameter's slot in the register. The handle is
+        * rejected once the slot has moved on to another generation.
+        */
+        uint32_t generation;
+
+        /**
+        * Creates an invalid ParameterHandle, which does not correspond to any
+        * Parameter.
+        */
+        constexpr ParameterHandle() :
+            rackNumber(ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE),
+            parameterIndex(0),
+            generation(0)
+        {}
+
+        /**
+        * Creates a ParameterHandle from the given position, for a Parameter whose
+        * slot is used for the first time, which is the case of every Parameter of
+        * an Instrument inserted into a rack that was never used before. Note that
+        * the handle is not checked against the Instrument actually located at
+        * \p rackNumber, so this constructor can be used in constant expressions.
+        * @param[in] rackNumber The Instrument's rack number.
+        * @param[in] parameterIndex Position of the Parameter in the list of
+        *   parameters the Instrument was constructed with.
+        */
+        constexpr ParameterHandle(uint16_t rackNumber, uint16_t parameterIndex) :
+            rackNumber(rackNumber),
+            parameterIndex(parameterIndex),
+            generation(0)
+        {}
+
+        /**
+        * Creates a ParameterHandle from the given position and generation. Note
+        * that the handle is not checked against the parameter register of
+        * \p rackNumber, which only happens when the handle is used.
+        * @param[in] rackNumber The Instrument's rack number.
+        * @param[in] parameterIndex Position of the Parameter in the list of
+        *   parameters the Instrument was constructed with.
+        * @param[in] generation Generation of the Parameter's slot.
+        */
+        constexpr ParameterHandle(uint16_t rackNumber, uint16_t parameterIndex, uint32_t generation) :
+            rackNumber(rackNumber),
+            parameterIndex(parameterIndex),
+            generation(generation)
+        {}
+
+        /**
+        * Returns true if the handle's rack number is in-range. Note that a valid
+        * handle may still not correspond to any Parameter, if it has become stale.
+        */
+        constexpr bool isValid() const
+        {
+            return rackNumber < ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE;
+        }
+    };
+}
+
+namespace ANGLECORE
+{
+    /**
+    * \struct ParameterRegistrationPlan ParameterRegistrationPlan.h
+    * When the end-user asks to add an Instrument to an AudioWorkflow or to remove
+    * one from it, an instance of this structure is created to plan an update of its
+    * parameter registers. The instructions are turned into new snapshots of the
+    * registers by a non real-time thread, so that the real-time thread only has
+    * to publish them when executing the plan.
+    */
+    struct ParameterRegistrationPlan
+    {
+        /**
+        * \struct Instruction ParameterRegistrationPlan.h
+        * Contains all the details of a specific entry to either add to or remove
+        * from the ParameterRegister.
+        */
+        struct Instruction
+        {
+            unsigned short rackNumber;
+            StringView parameterIdentifier;
+
+            /** Position of the Parameter in the list of parameters of its Instrument */
+            unsigned short parameterIndex;
+            std::shared_ptr<ParameterGenerator> parameterGenerator;
+            std::shared_ptr<Stream> parameterStream;
+
+            Instruction(unsigned short rackNumber, StringView parameterIdentifier, unsigned short parameterIndex, std::shared_ptr<ParameterGenerator> parameterGenerator, std::shared_ptr<Stream> parameterStream) :
+                rackNumber(rackNumber),
+                parameterIdentifier(parameterIdentifier),
+                parameterIndex(parameterIndex),
+                parameterGenerator(parameterGenerator),
+                parameterStream(parameterStream)
+            {}
+        };
+
+        std::vector<Instruction> removeInstructions;
+        std::vector<Instruction> addInstructions;
+
+        /**
+        * Snapshots to publish into the parameter register of each rack, or null
+        * for the racks the plan does not modify. Once the plan is executed, they
+        * are replaced by the snapshots they took the place of, which must then be
+        * deleted by a non real-time thread.
+        */
+        std::unique_ptr<ParameterRegister::Snapshot> snapshots[ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
+    };
+}
+
+namespace ANGLECORE
+{
+    /**
+    * \class AudioWorkflow AudioWorkflow.h
+    * Workflow internally structured to generate an audio output. It consists of a
+    * succession of workers and streams, and it should not contain any feedback.
+    */
+    class AudioWorkflow :
+        public Workflow,
+        public VoiceAssigner,
+        public Lockable
+    {
+    public:
+
+        /**
+        * Builds the base structure of the AudioWorkflow (Exporter, Mixer...).
+        * @param[in] streamSize Number of samples in each Stream of the
+        *   AudioWorkflow, which is the maximum number of samples it can render in
+        *   one rendering session.
+        * @param[in] shareInstrumentOutputs True if the AudioWorkflow's voices will
+        *   always be rendered one after the other, in which case the instruments
+        *   of every Voice write into the same buffers, and false otherwise. Each
+        *   Voice's submixer consumes the outputs of its instruments before the
+        *   next Voice is rendered, so sharing them saves the memory of all voices
+        *   but one, and keeps the buffers warm in cache from one Voice to the
+        *   next. This must be false if the voices can be rendered in parallel.
+        */
+        AudioWorkflow(unsigned int streamSize, bool shareInstrumentOutputs);
+
+        /**
+        * Sets the sample rate of the AudioWorkflow.
+        * @param[in] sampleRate The value of the sample rate, in Hz.
+        */
+        void setSampleRate(floating_type sampleRate);
+
+        /** Returns the sample rate of the AudioWorkflow, in Hz. */
+        floating_type getSampleRate() const;
+
+        /**
+        * Builds and returns the Workflow's rendering sequence, starting from its
+        * Exporter. Whenever possible, the sequence is reordered into three
+        * consecutive parts: first the workers that are not assigned to any Voice
+        * and do not depend on any Voice, then the workers of each Voice grouped
+        * together by increasing voice number, and finally the workers that are not
+        * assigned to any Voice but depend on some (such as the Mixer and the
+        * Exporter). This layout allows the Renderer to render each Voice
+        * independently. This method allocates memory, so it should never be called
+        * by the real-time thread. Note that the method relies on the move semantics
+        * to optimize its vector return.
+        * @param[in] connectionPlan The ConnectionPlan that will be executed next,
+        *   and that should therefore be taken into account in the computation
+        * @param[out] isSplittableByVoice Will be set to true if the sequence
+        *   returned follows the layout described above, and false if some
+        *   dependencies between voices prevented the reordering, in which case the
+        *   sequence is returned in its original order.
+        */
+        std::vector<std::shared_ptr<Worker>> buildRenderingSequence(const ConnectionPlan& connectionPlan, bool& isSplittableByVoice) const;
+
+        /**
+        * Selects the instruction set the Mixer sums the instruments' outputs with.
+        * This method should not be called while the AudioWorkflow is rendering.
+        * @param[in] instructionSet The instruction set to use, which must be
+        *   supported by the CPU (see MixerKernels::detectInstructionSet()).
+        */
+        void setMixerInstructionSet(MixerKernels::InstructionSet instructionSet);
+
+        /**
+        * Set the Exporter's memory location to write into when exporting.
+        * @param[in] buffer The new memory location, which can be planar or
+        *   interleaved.
+        * @param[in] startSample Position to start from in the buffer.
+        */
+        void setExporterOutput(const ExportBuffer& buffer, uint32_t startSample);
+
+        /**
+        * Enables or disables the fused export, in which the Mixer writes its mix
+        * directly into the host's buffer instead of going through the Exporter's
+        * input streams (see Mixer::setFusedExport()). The fused export is enabled
+        * by default, and must be disabled before inserting any Worker that reads
+        * the Mixer's output. This method should not be called while the
+        * AudioWorkflow is rendering.
+        * @param[in] isFused True to enable the fused export, false to disable it.
+        */
+        void setFusedExport(bool isFused);
+
+        /**
+        * Tries to find a Rack that is empty in all voices to insert an instrument
+        * inside. Returns the valid rack number of an empty rack if has found one,
+        * and an out-of-range number otherwise.
+        */
+        unsigned short findEmptyRack() const;
+
+        /**
+        * Adds an Instrument to the given Voice, at the given \p rackNumber, then
+        * build the Instrument's environment, plan its bridging to the real-time
+        * rendering pipeline by completing the given \p connectionPlanToComplete,
         * and complete the \p parameterRegistrationPlan to add new parameters to the
         * appropriate ParameterRegister if they were not already there. Note that
         * every parameter is expected to be in-range and valid, and that no safety
@@ -1880,239 +3126,2036 @@ namespace ANGLECORE
         bool playsNoteNumber(unsigned short voiceNumber, unsigned char noteNumber) const;
 
         /**
-        * Activates the given Rack for the Mixer to use it in the mix. This method
-        * may start all instances of the Instrument present in the rack if some
-        * voices are on when this method is called.
-        *
-        * This method must only be called by the real-time thread.
-        * @param[in] rackNumber Rack to activate.
+        * Activates the given Rack for the Mixer to use it in the mix. This method
+        * may start all instances of the Instrument present in the rack if some
+        * voices are on when this method is called.
+        *
+        * This method must only be called by the real-time thread.
+        * @param[in] rackNumber Rack to activate.
+        */
+        void activateRack(unsigned short rackNumber);
+
+        /**
+        * Deactivates the given Rack for the Mixer to stop using it in the mix. Note
+        * that this method merely deactivates the rack, and does not call any method
+        * on any instrument to stop and render its audio tail. Such processing must
+        * therefore be called for beforehand if needed.
+        *
+        * This method must only be called by the real-time thread.
+        * @param[in] rackNumber Rack to deactivate.
+        */
+        void deactivateRack(unsigned short rackNumber);
+
+        /**
+        * Requests all the instruments contained in the given Voice to stop playing,
+        * and returns the Voice's audio tail duration in samples, which is the
+        * number of samples before the Voice begins to emit complete silence.
+        * This method must only be called by the real-time thread.
+        * @param[in] voiceNumber Voice that should stop playing.
+        */
+        uint32_t stopVoice(unsigned short voiceNumber);
+
+        /**
+        * Turns the instructions of the given \p plan into new snapshots of the
+        * AudioWorkflow's parameter registers, by applying them to copies of the
+        * current snapshots. Removal instructions are applied first, and additions
+        * second. This method allocates memory, so it must only be called by a non
+        * real-time thread, before the plan is sent to the real-time thread.
+        * @param[in, out] plan The ParameterRegistrationPlan to prepare.
+        */
+        void prepareParameterRegistrationPlan(ParameterRegistrationPlan& plan) const;
+
+        /**
+        * Executes the given \p plan, by publishing the snapshots it contains into
+        * the AudioWorkflow's parameter registers. This method needs to be fast as
+        * it might be called by the real-time thread at the beginning of any
+        * rendering session, and it neither allocates nor frees any memory. The
+        * plan must have been prepared using prepareParameterRegistrationPlan()
+        * before. Once executed, the plan holds the snapshots that were replaced,
+        * which must be released using releaseParameterRegistrationPlan().
+        * @param[in, out] plan The ParameterRegistrationPlan to execute.
+        */
+        void executeParameterRegistrationPlan(ParameterRegistrationPlan& plan);
+
+        /**
+        * Deletes the snapshots held by the given \p plan, once no thread is
+        * reading them anymore. This method blocks until then, so it must only be
+        * called by a non real-time thread.
+        * @param[in, out] plan The ParameterRegistrationPlan to release.
+        */
+        void releaseParameterRegistrationPlan(ParameterRegistrationPlan& plan);
+
+        /**
+        * Tries to find the ParameterGenerator corresponding to the given Parameter.
+        * The AudioWorkflow will search through the parameters that are registered
+        * for the given \p rackNumber and look for a matching identifier. If one is
+        * found, this method will return the associated ParameterGenerator.
+        * Otherwise, this method will return a null pointer. Note that the rack
+        * number is expected to be in-range, as no safety check will be performed by
+        * this method. This method can be called by any thread.
+        * @param[in] rackNumber The Rack number. It must be in-range.
+        * @param[in] parameterIdentifier The Parameter's identifier. This can be
+        *   passed in as a C string, as it will be implicitely converted into a
+        *   StringView. If this parameter does not correspond to any parameter of
+        *   the Instrument located at \p rackNumber, then this method will return a
+        *   null pointer.
+        */
+        std::shared_ptr<ParameterGenerator> findParameterGenerator(unsigned short rackNumber, StringView parameterIdentifier);
+
+        /**
+        * Returns a ParameterHandle that gives direct access to the given
+        * Parameter's slot in the parameter register of \p rackNumber. If the
+        * Parameter is not registered, this method returns an invalid handle.
+        * @param[in] rackNumber The Rack number. It must be in-range.
+        * @param[in] parameterIdentifier The Parameter's identifier.
+        */
+        ParameterHandle getParameterHandle(unsigned short rackNumber, StringView parameterIdentifier) const;
+
+        /**
+        * Retrieves the ParameterGenerator located at the given \p handle, just
+        * like findParameterGenerator() does with an identifier, but by indexing the
+        * parameter register directly. If the handle does not correspond to any
+        * registered Parameter, or if it has become stale because the rack's
+        * parameters have changed since it was retrieved, this method will return a
+        * null pointer.
+        * @param[in] handle The Parameter's handle. It must be valid.
+        */
+        std::shared_ptr<ParameterGenerator> findParameterGenerator(ParameterHandle handle);
+
+        /**
+        * Retrieves the ParameterGenerator located at the given \p handle just like
+        * findParameterGenerator(), but returns a raw pointer, without copying any
+        * shared pointer. This method must only be called by the real-time thread.
+        * @param[in] handle The Parameter's handle. It must be valid.
+        */
+        ParameterGenerator* getParameterGenerator(ParameterHandle handle) const;
+
+    protected:
+
+        /**
+        * Retrieve the ID of the input Stream of a Voice's submixer at the provided
+        * location. Note that every parameter is expected to be in-range, and that
+        * no safety check will be performed by this method.
+        * @param[in] voiceNumber Voice whose workers ultimately fill in the Stream.
+        * @param[in] rackNumber Rack at the end of which the Stream is located.
+        * @param[in] channel Audio channel that the Stream corresponds to.
+        */
+        uint32_t getSubmixerInputStreamID(unsigned short voiceNumber, unsigned short rackNumber, unsigned short channel) const;
+
+        /**
+        * Retrieve the ID of the Stream containing the current sample rate in the
+        * AudioWorkflow's global context.
+        */
+        uint32_t getSampleRateStreamID() const;
+
+        /**
+        * Retrieve the ID of the Stream containing the reciprocal of the current
+        * sample rate in the AudioWorkflow's global context.
+        */
+        uint32_t getSampleRateReciprocalStreamID() const;
+
+        /**
+        * Retrieve the ID of the Stream containing the given Voice's current
+        * frequency. Note that voiceNumber is expected to be in-range, and that no
+        * safety check will be performed by this method.
+        * @param[in] voiceNumber Voice to retrieve the information from.
+        */
+        uint32_t getFrequencyStreamID(unsigned short voiceNumber) const;
+
+        /**
+        * Retrieve the ID of the Stream containing the given Voice's current
+        * frequency divided by the global sample rate. Note that voiceNumber is
+        * expected to be in-range, and that no safety check will be performed by
+        * this method.
+        * @param[in] voiceNumber Voice to retrieve the information from.
+        */
+        uint32_t getFrequencyOverSampleRateStreamID(unsigned short voiceNumber) const;
+
+        /**
+        * Retrieve the ID of the Stream containing the given Voice's current
+        * velocity. Note that voiceNumber is expected to be in-range, and that no
+        * safety check will be performed by this method.
+        * @param[in] voiceNumber Voice to retrieve the information from.
+        */
+        uint32_t getVelocityStreamID(unsigned short voiceNumber) const;
+
+    private:
+        std::shared_ptr<Exporter> m_exporter;
+        std::shared_ptr<Mixer> m_mixer;
+        /**
+        * The ANGLECORE_NUM_VOICES voices of the AudioWorkflow. They are stored in a
+        * vector only because their constructor needs the StreamArena. The vector
+        * is filled upon construction and never resized afterwards.
+        */
+        std::vector<Voice> m_voices;
+        GlobalContext m_globalContext;
+        const bool m_sharesInstrumentOutputs;
+        ParameterRegister m_parameterRegisters[ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
+    };
+}
+
+
+/*
+=================================================
+Dependencies
+=================================================
+*/
+
+namespace farbot
+{
+    namespace detail { template <typename, bool, bool, bool, bool, std::size_t> class fifo_impl; }
+
+    namespace fifo_options
+    {
+    enum class concurrency
+    {
+        single,                  // single consumer/single producer
+        multiple
+    };
+
+    enum class full_empty_failure_mode
+    {
+        // Setting this as producer option causes the fifo to overwrite on a push when the fifo is full
+        // Setting this as consumer option causes the fifo to return a default constructed value on pop when the fifo is empty
+        overwrite_or_return_default,
+
+        // Return false on push/pop if the fifo is full/empty respectively
+        return_false_on_full_or_empty
+    };
+    }
+
+    // single consumer, single producer
+    template <typename T,
+              fifo_options::concurrency consumer_concurrency = fifo_options::concurrency::multiple,
+              fifo_options::concurrency producer_concurrency = fifo_options::concurrency::multiple,
+              fifo_options::full_empty_failure_mode consumer_failure_mode = fifo_options::full_empty_failure_mode::return_false_on_full_or_empty,
+              fifo_options::full_empty_failure_mode producer_failure_mode = fifo_options::full_empty_failure_mode::return_false_on_full_or_empty,
+              std::size_t MAX_THREADS = 64>
+    class fifo
+    {
+    public:
+        fifo (int capacity);
+
+        bool push(T&& result);
+
+        bool pop(T& result);
+
+    private:
+        detail::fifo_impl<T,
+                          consumer_concurrency == fifo_options::concurrency::single,
+                          producer_concurrency == fifo_options::concurrency::single,
+                          consumer_failure_mode == fifo_options::full_empty_failure_mode::overwrite_or_return_default,
+                          producer_failure_mode == fifo_options::full_empty_failure_mode::overwrite_or_return_default,
+                          MAX_THREADS> impl;
+    };
+}
+
+//==============================================================================
+
+namespace farbot
+{
+    namespace detail
+    {
+        template <typename T, bool isWrite, bool swap_when_read> struct fifo_manip { static void access(T && slot, T&& arg) { slot = std::move(arg); } };
+        template <typename T> struct fifo_manip<T, false, false>     { static void access(T && slot, T&& arg) { arg = std::move(slot); } };
+        template <typename T> struct fifo_manip<T, false, true>     { static void access(T && slot, T&& arg)  { arg = T(); std::swap(slot, arg); } };
+
+        struct thread_info
+        {
+            std::atomic<std::thread::id> tid = {};
+            std::atomic<uint32_t> pos = { std::numeric_limits<uint32_t>::max() };
+
+            thread_info()
+            {
+                // We moved the initial lock-free assertion on thread::id here
+                assert(tid.is_lock_free());
+            }
+        };
+
+        template <std::size_t MAX_THREADS>
+        struct multi_position_info
+        {
+            std::atomic<uint32_t> num_threads = { 0 };
+            std::array<thread_info, MAX_THREADS> tinfos = { {} };
+
+            std::atomic<uint32_t>& get_tpos()
+            {
+                auto my_tid = std::this_thread::get_id();
+                auto num = num_threads.load(std::memory_order_relaxed);
+
+                for (auto it = tinfos.begin(); it != tinfos.begin() + num; ++it)
+                    if (it->tid.load(std::memory_order_relaxed) == my_tid)
+                        return it->pos;
+
+                auto pos = num_threads.fetch_add(1, std::memory_order_relaxed);
+
+                if (pos >= MAX_THREADS)
+                {
+                    assert(false);
+                    // do something!
+                    return tinfos.front().pos;
+                }
+
+                auto& result = tinfos[pos];
+                result.tid.store(my_tid, std::memory_order_relaxed);
+
+                return result.pos;
+            }
+
+            uint32_t getpos(uint32_t min) const
+            {
+                auto num = num_threads.load(std::memory_order_relaxed);
+
+                for (auto it = tinfos.begin(); it != tinfos.begin() + num; ++it)
+                    min = std::min(min, it->pos.load(std::memory_order_acquire));
+
+                return min;
+            }
+        };
+
+        template <typename T, bool is_writer,
+            bool single_consumer_producer,
+            bool overwrite_or_return_zero,
+            std::size_t MAX_THREADS>
+        struct read_or_writer
+        {
+            uint32_t getpos() const
+            {
+                return posinfo.getpos(reserve.load(std::memory_order_relaxed));
+            }
+
+            bool push_or_pop(std::vector<T>& s, T && arg, uint32_t max)
+            {
+                auto& tpos = posinfo.get_tpos();
+                auto pos = reserve.load(std::memory_order_relaxed);
+
+                if (pos >= max)
+                    return false;
+
+                tpos.store(pos, std::memory_order_release);
+
+                if (!reserve.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    do
+                    {
+                        if (pos >= max)
+                        {
+                            tpos.store(std::numeric_limits<uint32_t>::max(), std::memory_order_relaxed);
+                            return false;
+                        }
+                    } while (!reserve.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed));
+
+                    tpos.store(pos, std::memory_order_release);
+                }
+
+                detail::fifo_manip<T, is_writer, false>::access(std::move(s[pos & (s.size() - 1)]), std::move(arg));
+                tpos.store(std::numeric_limits<uint32_t>::max(), std::memory_order_release);
+                return true;
+            }
+
+            std::atomic<uint32_t> reserve = { 0 };
+            multi_position_info<MAX_THREADS> posinfo;
+        };
+
+        template <typename T, bool is_writer, std::size_t MAX_THREADS>
+        struct read_or_writer<T, is_writer, true, false, MAX_THREADS>
+        {
+            uint32_t getpos() const
+            {
+                return reserve.load(std::memory_order_acquire);
+            }
+
+            bool push_or_pop(std::vector<T>& s, T && arg, uint32_t max)
+            {
+                auto pos = reserve.load(std::memory_order_relaxed);
+
+                if (pos >= max)
+                    return false;
+
+                detail::fifo_manip<T, is_writer, false>::access(std::move(s[pos & (s.size() - 1)]), std::move(arg));
+                reserve.store(pos + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            std::atomic<uint32_t> reserve = { 0 };
+        };
+
+        template <typename T, bool is_writer, std::size_t MAX_THREADS>
+        struct read_or_writer<T, is_writer, true, true, MAX_THREADS>
+        {
+            uint32_t getpos() const
+            {
+                return reserve.load(std::memory_order_acquire);
+            }
+
+            bool push_or_pop(std::vector<T>& s, T && arg, uint32_t)
+            {
+                auto pos = reserve.load(std::memory_order_relaxed);
+
+                detail::fifo_manip<T, is_writer, true>::access(std::move(s[pos & (s.size() - 1)]), std::move(arg));
+                reserve.store(pos + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            std::atomic<uint32_t> reserve = { 0 };
+        };
+
+        template <typename T, bool is_writer, std::size_t MAX_THREADS>
+        struct read_or_writer<T, is_writer, false, true, MAX_THREADS>
+        {
+            uint32_t getpos() const
+            {
+                return posinfo.getpos(reserve.load(std::memory_order_relaxed));
+            }
+
+            bool push_or_pop(std::vector<T>& s, T && arg, uint32_t)
+            {
+                auto& tpos = posinfo.get_tpos();
+                auto pos = reserve.fetch_add(1, std::memory_order_relaxed);
+
+                tpos.store(pos, std::memory_order_release);
+                detail::fifo_manip<T, is_writer, true>::access(std::move(s[pos & (s.size() - 1)]), std::move(arg));
+                tpos.store(std::numeric_limits<uint32_t>::max(), std::memory_order_release);
+
+                return true;
+            }
+
+            multi_position_info<MAX_THREADS> posinfo;
+            std::atomic<uint32_t> reserve = { 0 };
+        };
+
+        template <typename T, bool consumer_concurrency, bool producer_concurrency,
+            bool consumer_failure_mode, bool producer_failure_mode, std::size_t MAX_THREADS>
+        class fifo_impl
+        {
+        public:
+            fifo_impl(int capacity) : slots(capacity)
+            {
+                assert((capacity & (capacity - 1)) == 0);
+            }
+
+            bool push(T&& result)
+            {
+                return writer.push_or_pop(slots, std::move(result), reader.getpos() + static_cast<uint32_t> (slots.size()));
+            }
+
+            bool pop(T& result)
+            {
+                return reader.push_or_pop(slots, std::move(result), writer.getpos());
+            }
+
+        private:
+            //==============================================================================
+            std::vector<T> slots = {};
+
+            read_or_writer<T, false, consumer_concurrency, consumer_failure_mode, MAX_THREADS> reader;
+            read_or_writer<T, true, producer_concurrency, producer_failure_mode, MAX_THREADS> writer;
+        };
+    } // detail
+
+    template <typename T,
+        fifo_options::concurrency consumer_concurrency,
+        fifo_options::concurrency producer_concurrency,
+        fifo_options::full_empty_failure_mode consumer_failure_mode,
+        fifo_options::full_empty_failure_mode producer_failure_mode,
+        std::size_t MAX_THREADS>
+        fifo<T, consumer_concurrency, producer_concurrency, consumer_failure_mode, producer_failure_mode, MAX_THREADS>::fifo(int capacity) : impl(capacity) {}
+
+    template <typename T,
+        fifo_options::concurrency consumer_concurrency,
+        fifo_options::concurrency producer_concurrency,
+        fifo_options::full_empty_failure_mode consumer_failure_mode,
+        fifo_options::full_empty_failure_mode producer_failure_mode,
+        std::size_t MAX_THREADS>
+        bool fifo<T, consumer_concurrency, producer_concurrency, consumer_failure_mode, producer_failure_mode, MAX_THREADS>::push(T&& result) { return impl.push(std::move(result)); }
+
+    template <typename T,
+        fifo_options::concurrency consumer_concurrency,
+        fifo_options::concurrency producer_concurrency,
+        fifo_options::full_empty_failure_mode consumer_failure_mode,
+        fifo_options::full_empty_failure_mode producer_failure_mode,
+        std::size_t MAX_THREADS>
+        bool fifo<T, consumer_concurrency, producer_concurrency, consumer_failure_mode, producer_failure_mode, MAX_THREADS>::pop(T& result) { return impl.pop(result); }
+}
+
+
+/*
+=================================================
+RequestManager
+=================================================
+*/
+
+namespace ANGLECORE
+{
+    /**
+    * \struct Request Request.h
+    * When the end-user instructs to change something in the AudioWorkflow, an
+    * instance of this structure is created to store all necessary information
+    * about that request.
+    *
+    * The Request structure provides three virtual methods that can be overriden in
+    * derived classes: preprocess(), process(), and postprocess(). The preprocess()
+    * method should prepare everything for the Request's execution and must return a
+    * boolean indicating if the preparation went well. The process() method should
+    * contain the core implementation of the Request's execution. It is a pure
+    * virtual method, so it must be implemented in all derived classes. Finally, the
+    * postprocess() method is called right before the deletion of the Request
+    * object, in order to do some final processing, like calling listeners to inform
+    * them about how the Request's execution went.
+    *
+    * Both preprocess() and postprocess() methods are called on a non real-time
+    * thread, whereas the process() method is always executed on the real-time
+    * thread, so it must be really fast.
+    *
+    * The preprocess() method is guaranteed to always be executed before the
+    * process() method, which in turn is guaranteed to always be executed before the
+    * postprocess() method. However, if the preparation stage goes wrong and the
+    * preprocess() method returns false, then the process() method will not be
+    * called (the Request will not even be sent to the real-time thread), and the
+    * RequestManager will jump directly to the postprocess() method instead.
+    *
+    * For two different requests both posted asynchronously to the RequestManager,
+    * the preprocess() method is guaranteed to always be executed separately and
+    * never concurrently. That guarantee no longer holds for requests posted
+    * synchronously: a request posted synchronously could be preprocessed in
+    * parallel with another request posted synchronously, or with another request
+    * posted asynchronously, since synchronous posting aims at preprocessing and
+    * transferring requests upon reception. If concurrency is an issue, a proper
+    * locking or sharing mechanism should be implemented in the preprocess() and
+    * postprocess() methods, or the Request in question should be posted
+    * asynchronously.
+    */
+    struct Request
+    {
+        /**
+        * Indicates whether or not the request was preprocessed, that is if the
+        * preprocess() method was called, regardless of the success of the
+        * preprocessing.
+        */
+        std::atomic<bool> hasBeenPreprocessed;
+
+        /**
+        * Indicates whether or not the request was processed, that is if the
+        * process() method was called, regardless of the success of the processing.
+        */
+        std::atomic<bool> hasBeenProcessed;
+
+        /**
+        * Indicates whether or not the request was postprocessed, that is if the
+        * postprocess() method was called. This atomic boolean must always be set to
+        * true once a Request is postprocessed; otherwise, if the Request has been
+        * posted asynchronously to the RequestManager, then the latter may not
+        * detect the end of the Request's execution and indefinitely wait for it.
+        */
+        std::atomic<bool> hasBeenPostprocessed;
+
+        /**
+        * Handy flag that can be used to indicate whether the request was
+        * successfully processed or not.
+        */
+        std::atomic<bool> success;
+
+        Request();
+
+        /**
+        * This method is called by the RequestManager on a non real-time thread to
+        * preprocess the Request for its execution, before sending it to the
+        * real-time thread. It must return true if the preparation went well, and
+        * false otherwise, in which case the Request will not be executed on the
+        * real-time thread and the process() method will not be called by the
+        * RequestManager. By default, this method returns true.
+        *
+        * If the Request is posted synchronously, then this method will be called by
+        * the RequestManager on the non real-time thread upon reception. Otherwise,
+        * if the Request is posted asynchronously, then this method will be called
+        * by the RequestManager's asynchronous, non real-time thread.
+        *
+        * The preprocess() method is mostly useful for asynchronously posted
+        * requests: since the RequestManager's asynchronous thread treats only one
+        * request at a time, the preprocess() method is guaranteed to always be
+        * executed separately and never concurrently for two different requests both
+        * posted asynchronously.
+        */
+        virtual bool preprocess();
+
+        /**
+        * This method is called by the Master on the real-time thread to process the
+        * request. Derived classes of the Request class must implement this method.
+        */
+        virtual void process() = 0;
+
+        /**
+        * This method is called by the RequestManager on a non real-time thread to
+        * make any final processing before the Request object is deleted. It is
+        * always executed, even if the preprocessing failed and the process() method
+        * was not called before. It will therefore give the same result as if its
+        * content was implemented into the ~Request() destructor.
+        *
+        * The postprocess() method is suitable for broadcasting information about
+        * the Request's success to listeners, using the provided atomic flags and,
+        * if necessary, other additional status variables defined in derived
+        * classes.
+        */
+        virtual void postprocess();
+    };
+}
+
+namespace ANGLECORE
+{
+    /*
+    * We use forward declaration here, as both the Renderer and ConnectionRequest
+    * classes depend on each other. Declaring the Renderer class as an incomplete
+    * type should not trigger any compilation error since that class is only used to
+    * declare references within the ConnectionRequest class' declaration.
+    */
+    class Renderer;
+
+    /**
+    * \class ConnectionRequest ConnectionRequest.h
+    * Request to execute a ConnectionPlan on a Workflow. A ConnectionRequest
+    * contains both the ConnectionPlan and its consequences (the new rendering
+    * sequence and voice assignments after the plan is executed), which should be
+    * computed in advance for the Renderer. To be valid, a ConnectionRequest should
+    * verify the following two properties:
+    * 1. None of its three vectors newRenderingSequence, newVoiceAssignments, and
+    * newWorkCalls should be empty;
+    * 2. All of those three vectors should be of the same length.
+    * .
+    * To be consistent, both vectors newRenderingSequence and newVoiceAssignments
+    * should be computed from the same ConnectionPlan and by the same AudioWorkflow.
+    */
+    class ConnectionRequest :
+        public Request
+    {
+    public:
+        ConnectionRequest(AudioWorkflow& audioWorkflow, Renderer& renderer);
+
+        /**
+        * Creates and removes connections in the AudioWorkflow according to the
+        * Request's ConnectionPlan, and sends updated information to the Renderer
+        * for adapting its next rendering sessions accordingly.
+        */
+        void process();
+
+        /**
+        * Makes the stream buffers released during processing available again in
+        * the AudioWorkflow's StreamArena. A Stream destroyed by the real-time
+        * thread only gives its buffer back to the arena without blocking, so the
+        * buffer is collected here, on a non real-time thread.
+        */
+        void postprocess() override;
+
+    public:
+        ConnectionPlan plan;
+        std::vector<std::shared_ptr<Worker>> newRenderingSequence;
+        std::vector<VoiceAssignment> newVoiceAssignments;
+
+        /**
+        * The WorkCall of every Worker in newRenderingSequence, in the same order.
+        * This is what the Renderer actually uses to call the workers, while the
+        * workers themselves remain owned by the Workflow.
+        */
+        WorkCallSequence newWorkCalls;
+
+#if ANGLECORE_ENABLE_PROFILING || ANGLECORE_ENABLE_TRACING
+        /**
+        * The ID of every Worker in newRenderingSequence, in the same order, which
+        * the Renderer uses to identify its profiling measurements and traces.
+        */
+        std::vector<uint32_t> newWorkerIDs;
+#endif
+
+        /**
+        * Indicates whether newRenderingSequence is grouped by voice, i.e. whether
+        * it consists of a voice-free head, followed by one contiguous segment per
+        * Voice, and a voice-free tail. If so, the Renderer can render each Voice
+        * independently, and possibly in parallel.
+        */
+        bool isSplittableByVoice;
+
+        /**
+        * Position of each Voice's segment within newRenderingSequence, as computed
+        * by VoiceAssigner::getVoiceSegmentStarts(). The last value corresponds to
+        * the start of the voice-free tail. This array is only meaningful if
+        * isSplittableByVoice is true.
+        */
+        uint32_t newVoiceSegmentStarts[ANGLECORE_NUM_VOICES + 1];
+
+        /**
+        * Dependency graph of newRenderingSequence, as computed by
+        * Workflow::buildDependencyGraph(): the number of predecessors of each
+        * Worker, and the positions of each Worker's successors, stored between
+        * newSuccessorOffsets[i] and newSuccessorOffsets[i + 1] in newSuccessors.
+        * These vectors may be left empty, in which case the Renderer will not be
+        * able to use its DEPENDENCY_PARALLEL mode.
+        */
+        std::vector<uint32_t> newPredecessorCounts;
+        std::vector<uint32_t> newSuccessorOffsets;
+        std::vector<uint32_t> newSuccessors;
+
+    private:
+        AudioWorkflow& m_audioWorkflow;
+        Renderer& m_renderer;
+    };
+}
+
+
+/*
+=================================================
+Utility
+=================================================
+*/
+
+namespace ANGLECORE
+{
+    /**
+    * \class Thread Thread.h
+    * The Thread class provides a handy interface for derived thread handler
+    * classes.
+
+    * The interface consists of mainly three methods: start(), run(), and
+    * stop(). When the start() method of a Thread object is called, the latter
+    * spawns a thread that will execute the run() method. The stop() method can then
+    * be called to ask the internal thread to stop.
+    *.
+    * This class follows the RAII paradigm: when a Thread object is destroyed, the
+    * stop() method is automatically called, and the thread that called the
+    * destructor will wait for the internal thread to finish.
+    * .
+    * Note that the stop() method only makes a request and does not kill the
+    * internal thread. More precisely, the stop() method updates an internal boolean
+    * flag to make that request, and the flag's value can be easily accessed through
+    * the thread-safe auxiliary shouldStop() method, which returns true if the
+    * request was effectively made, and false otherwise.
+    * .
+    * The run() method is a pure virtual method, so it must be implemented in
+    * derived classes. It must either terminate in finite time, or regularly call
+    * the auxiliary shouldStop() method and ensure that, if shouldStop() returns
+    * true at any time, then it stops in a finite and preferably short time. If the
+    * run() method does not respect this rule, then the Thread destructor may enter
+    * an infinite loop while waiting for the internal thread to finish, and
+    * eventually crash the application.
+    */
+    class Thread
+    {
+    public:
+
+        /**
+        * \struct Priority Thread.h
+        * Scheduling policy and priority of a thread, as defined by the operating
+        * system. The policy is only meaningful on POSIX systems.
+        */
+        struct Priority
+        {
+            int policy;
+            int level;
+        };
+
+        /**
+        * Returns the scheduling policy and priority of the calling thread. This
+        * method neither allocates memory nor locks any Mutex.
+        */
+        static Priority getCurrentPriority();
+
+        /**
+        * Gives the calling thread the given scheduling policy and priority, for
+        * example to schedule it like another thread. Returns false if the
+        * operating system refused the change, for example because the process
+        * lacks the required privileges, in which case the thread keeps its
+        * priority.
+        * @param[in] priority The new scheduling policy and priority.
+        */
+        static bool setCurrentPriority(const Priority& priority);
+
+        /**
+        * Tells the processor that the calling thread is busy-waiting, using the
+        * dedicated instruction of the platform (pause on x86, yield on ARM).
+        * Unlike std::this_thread::yield(), this never enters the scheduler of
+        * the operating system, so it cannot hand the core over to another
+        * thread, but it saves power and lets the sibling hardware thread run.
+        */
+        static void pause();
+
+        /**
+        * Creates a Thread object, but does not effectively spawn the thread. The
+        * start() method must be called for that to happen.
+        */
+        Thread();
+
+        ~Thread();
+
+        /**
+        * Instructs to spawn and start a thread that will run the callback() method.
+        */
+        void start();
+
+        /**
+        * Instructs to stop the thread using an atomic boolean flag. The run()
+        * method should check for that flag using the shouldStop() method. If the
+        * shouldStop() method returns true, then the run method should terminate.
+        */
+        void stop();
+
+    protected:
+        void callback();
+        bool shouldStop() const;
+
+        /**
+        * Core routine of the thread. If the run() method consists of a loop, it
+        * should regularly check whether it should stop using the shouldStop()
+        * method. If the shouldStop() method returns true at any point, then the
+        * run() method should terminate.
+        */
+        virtual void run() = 0;
+
+    private:
+        std::atomic<bool> m_shouldStop;
+        std::atomic<bool> m_hasStopped;
+    };
+}
+
+#if !defined(__linux__) && !defined(_WIN32)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace ANGLECORE
+{
+    /**
+    * \class WakeupSignal WakeupSignal.h
+    * Lets threads sleep until another thread signals them. The signal is
+    * represented by an epoch number, which notifyAll() increments: a thread
+    * retrieves the current epoch with getEpoch(), checks whether it has anything
+    * to do, and if not, calls wait() with the epoch it retrieved. If notifyAll()
+    * is called in between, wait() returns immediately, so no signal can be lost.
+    * .
+    * notifyAll() never blocks and never allocates memory, so it can be called by
+    * the real-time thread. It only makes a system call when a thread is actually
+    * sleeping. Threads sleep on a futex on Linux, and on their epoch's address on
+    * Windows. On other platforms, they sleep on a condition variable for short
+    * periods of time, as notifyAll() does not lock the corresponding mutex.
+    */
+    class WakeupSignal
+    {
+    public:
+
+        /** Creates a WakeupSignal, with no thread waiting for it. */
+        WakeupSignal();
+
+        WakeupSignal(const WakeupSignal&) = delete;
+        WakeupSignal& operator=(const WakeupSignal&) = delete;
+
+        /**
+        * Returns the current epoch, which should be passed to wait() once the
+        * calling thread has found nothing to do.
+        */
+        uint32_t getEpoch() const;
+
+        /**
+        * Blocks the calling thread until the epoch differs from \p epoch. This
+        * method may also return spuriously, so the caller should check again if it
+        * has anything to do. It must never be called by the real-time thread.
+        * @param[in] epoch The epoch returned by getEpoch().
+        */
+        void wait(uint32_t epoch);
+
+        /**
+        * Starts a new epoch, and wakes up every thread waiting for the signal. This
+        * method never blocks, and can be called by any thread.
+        */
+        void notifyAll();
+
+    private:
+        std::atomic<uint32_t> m_epoch;
+        std::atomic<uint32_t> m_numWaitingThreads;
+
+#if !defined(__linux__) && !defined(_WIN32)
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+#endif
+    };
+}
+
+namespace ANGLECORE
+{
+    /**
+    * \class WorkStealingQueue WorkStealingQueue.h
+    * Fixed-capacity, lock-free double-ended queue of task numbers, based on the
+    * Chase-Lev algorithm. The queue has one owner thread, which pushes and pops
+    * tasks at the bottom of the queue, while any other thread can steal tasks from
+    * the top of the queue.
+    * .
+    * The indices of the queue's ends only ever increase, and are mapped onto the
+    * internal buffer using a bit mask. As a consequence, the queue never moves or
+    * reallocates memory after creation, and can be used by real-time threads. It
+    * is the responsibility of the owner thread not to push more tasks than the
+    * queue's capacity.
+    */
+    class WorkStealingQueue
+    {
+    public:
+
+        /**
+        * Creates an empty queue. This constructor allocates memory, so it should
+        * never be called by the real-time thread.
+        * @param[in] capacity Maximum number of tasks the queue can hold at the same
+        *   time. It must be a power of two.
+        */
+        WorkStealingQueue(uint32_t capacity);
+
+        /**
+        * Pushes a task at the bottom of the queue. This method must only be called
+        * by the owner thread.
+        * @param[in] task The task to push.
+        */
+        void push(uint32_t task);
+
+        /**
+        * Pops a task from the bottom of the queue. Returns true if a task could be
+        * popped, and false if the queue was empty. This method must only be called
+        * by the owner thread.
+        * @param[out] task The task popped, if any.
+        */
+        bool pop(uint32_t& task);
+
+        /**
+        * Steals a task from the top of the queue. Returns true if a task could be
+        * stolen, and false if the queue was empty or if another thread took the
+        * task first. This method can be called by any thread.
+        * @param[out] task The task stolen, if any.
+        */
+        bool steal(uint32_t& task);
+
+    private:
+        const int64_t m_mask;
+        std::unique_ptr<std::atomic<uint32_t>[]> m_tasks;
+        std::atomic<int64_t> m_top;
+        std::atomic<int64_t> m_bottom;
+    };
+}
+
+
+/*
+=================================================
+Math
+=================================================
+*/
+
+namespace ANGLECORE
+{
+    /**
+    * \class BitMath BitMath.h
+    * Provides fast and portable bit manipulation routines.
+    */
+    class BitMath
+    {
+    public:
+        BitMath() = delete;
+
+        /**
+        * Returns the position of the least significant bit set in \p value, using
+        * a de Bruijn sequence to avoid any loop or branch. The result is undefined
+        * if \p value equals zero.
+        * @param[in] value The value to inspect. It should not be null.
+        */
+        inline static unsigned short countTrailingZeros(uint64_t value)
+        {
+            static const unsigned short positions[64] =
+            {
+                0, 1, 2, 53, 3, 7, 54, 27, 4, 38, 41, 8, 34, 55, 48, 28,
+                62, 5, 39, 46, 44, 42, 22, 9, 24, 35, 59, 56, 49, 18, 29, 11,
+                63, 52, 6, 26, 37, 40, 33, 47, 61, 45, 43, 21, 23, 58, 17, 10,
+                51, 25, 36, 32, 60, 20, 57, 16, 50, 31, 19, 15, 30, 14, 13, 12
+            };
+
+            /*
+            * Isolating the lowest bit set gives a power of two, which, multiplied by
+            * the de Bruijn constant, places a unique 6-bit pattern in the upper
+            * bits of the product.
+            */
+            return positions[((value & (~value + 1)) * 0x022FDD63CC95386DULL) >> 58];
+        }
+    };
+}
+
+
+/*
+=================================================
+Renderer
+=================================================
+*/
+
+namespace ANGLECORE
+{
+    /**
+    * \struct RenderProfile RenderProfiler.h
+    * Snapshot of the time spent by the Renderer in each Worker of its rendering
+    * sequence during a rendering session. Its size is fixed, so that it can be
+    * published by the real-time thread without allocating any memory.
+    */
+    struct RenderProfile
+    {
+        /**
+        * \struct WorkerEntry RenderProfiler.h
+        * Time measurements of one Worker, identified by its WorkflowItem ID.
+        */
+        struct WorkerEntry
+        {
+            uint32_t workerID;
+
+            /** Duration of the Worker's last call, in nanoseconds */
+            uint64_t lastDuration;
+
+            /**
+            * Longest duration of the Worker's calls since the rendering sequence
+            * last changed, in nanoseconds
+            */
+            uint64_t maxDuration;
+        };
+
+        RenderProfile();
+
+        /**
+        * Measurements of each Worker, in the order of the rendering sequence. Only
+        * the first numWorkers entries are meaningful.
+        */
+        WorkerEntry workers[ANGLECORE_PROFILER_MAX_NUM_WORKERS];
+        uint32_t numWorkers;
+
+        /** Total duration of the rendering session, in nanoseconds */
+        uint64_t sessionDuration;
+
+        /** Number of samples rendered during the rendering session */
+        unsigned int numSamplesRendered;
+
+        /** Number of rendering sessions profiled so far, including this one */
+        uint64_t sessionNumber;
+    };
+
+    /**
+    * \class RenderProfiler RenderProfiler.h
+    * Records the time spent by the Renderer in each Worker, and publishes the
+    * result of each rendering session to a non real-time reader through a
+    * TripleBuffer. Recording and publishing never block nor allocate memory, so
+    * they can be performed by the real-time thread.
+    */
+    class RenderProfiler
+    {
+    public:
+
+        /**
+        * Allocates all the memory the profiler needs. This constructor should
+        * never be called by the real-time thread.
+        */
+        RenderProfiler();
+
+        /**
+        * Returns the current time, in nanoseconds, to be used for measuring
+        * durations.
+        */
+        static uint64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /**
+        * Resets the durations measured, which should be done whenever the
+        * rendering sequence changes. This method must only be called by the
+        * real-time thread.
+        */
+        void reset();
+
+        /**
+        * Records the duration of the Worker at the given position in the rendering
+        * sequence. This method can be called by any rendering thread, as long as
+        * each position is recorded by only one thread per rendering session.
+        * @param[in] position Position of the Worker in the rendering sequence.
+        * @param[in] duration Duration of the Worker's call, in nanoseconds.
+        */
+        void recordWorker(uint32_t position, uint64_t duration)
+        {
+            if (position < ANGLECORE_PROFILER_MAX_NUM_WORKERS)
+            {
+                m_lastDurations[position] = duration;
+                if (duration > m_maxDurations[position])
+                    m_maxDurations[position] = duration;
+            }
+        }
+
+        /**
+        * Publishes the measurements of the rendering session that just ended. This
+        * method must only be called by the real-time thread, once every Worker of
+        * the session has been rendered.
+        * @param[in] workerIDs The IDs of the workers of the rendering sequence, in
+        *   the same order.
+        * @param[in] numSamplesRendered Number of samples rendered in the session.
+        * @param[in] sessionDuration Total duration of the session, in nanoseconds.
+        */
+        void publishSession(const std::vector<uint32_t>& workerIDs, unsigned int numSamplesRendered, uint64_t sessionDuration);
+
+        /**
+        * Copies the last published profile into \p profile. Returns true if a new
+        * profile has been published since the last call, and false otherwise, in
+        * which case the same profile as before is copied. This method is
+        * thread-safe, but should never be called by the real-time thread.
+        * @param[out] profile The RenderProfile to copy the measurements into.
+        */
+        bool getLatestProfile(RenderProfile& profile);
+
+    private:
+        std::vector<uint64_t> m_lastDurations;
+        std::vector<uint64_t> m_maxDurations;
+        uint64_t m_sessionNumber;
+        TripleBuffer<RenderProfile> m_snapshots;
+
+        /** Serializes the readers, as the TripleBuffer only allows one consumer */
+        Mutex m_readerLock;
+    };
+}
+
+
+/*
+=================================================
+Tracer
+=================================================
+*/
+
+namespace ANGLECORE
+{
+    /**
+    * \struct TraceEvent Tracer.h
+    * Beginning or end of a traced operation, as recorded by a Tracer.
+    */
+    struct TraceEvent
+    {
+        /** Name of the operation. It must point to a string literal. */
+        const char* name;
+
+        /** ID of the Worker involved in the operation, or 0 if not relevant */
+        uint32_t workerID;
+
+        /** Time of the event, in nanoseconds */
+        uint64_t timestamp;
+
+        /** Number of the thread the event occurred in */
+        unsigned short threadNumber;
+
+        /** 'B' for the beginning of the operation, and 'E' for its end */
+        char phase;
+    };
+
+    /**
+    * \class Tracer Tracer.h
+    * Records the beginning and end of the engine's operations, and writes them
+    * into a file using the Chrome trace event format, which can be opened in
+    * Chrome's about:tracing page or in Perfetto.
+    * .
+    * Each thread that records events owns a single-producer, single-consumer
+    * queue, so that recording an event never blocks nor allocates memory, and can
+    * be done by the real-time thread. A background thread regularly empties the
+    * queues and writes the events into the trace file. Threads identify
+    * themselves with a thread number, 0 being the real-time thread, which they
+    * set using setCurrentThreadNumber().
+    */
+    class Tracer
+    {
+    public:
+
+        /**
+        * Creates a Tracer that does not record anything until start() is called.
+        * This constructor allocates memory, so it should never be called by the
+        * real-time thread.
+        * @param[in] numThreads Number of threads that will record events. Events
+        *   recorded by threads whose number is out of this range are dropped.
+        */
+        Tracer(unsigned short numThreads);
+
+        /** Stops recording, and closes the trace file if necessary. */
+        ~Tracer();
+
+        /**
+        * Opens the given trace file and starts recording events. Returns true if
+        * the file could be opened, and false otherwise. This method should never
+        * be called by the real-time thread.
+        * @param[in] filePath Path of the trace file to create or overwrite.
+        */
+        bool start(const char* filePath);
+
+        /**
+        * Stops recording events, writes the events left into the trace file, and
+        * closes it. This method should never be called by the real-time thread.
+        */
+        void stop();
+
+        /**
+        * Records the beginning of an operation in the calling thread. This method
+        * is lock-free, and can be called by the real-time thread.
+        * @param[in] name Name of the operation. It must point to a string literal.
+        * @param[in] workerID ID of the Worker involved, or 0 if not relevant.
+        */
+        void beginEvent(const char* name, uint32_t workerID = 0);
+
+        /**
+        * Records the end of an operation in the calling thread. This method is
+        * lock-free, and can be called by the real-time thread.
+        * @param[in] name Name of the operation. It must be the same as the one
+        *   used in the matching call to beginEvent().
+        * @param[in] workerID ID of the Worker involved, or 0 if not relevant.
+        */
+        void endEvent(const char* name, uint32_t workerID = 0);
+
+        /**
+        * Returns the number of events that could not be recorded because a queue
+        * was full, since the Tracer was started.
+        */
+        uint64_t getNumDroppedEvents() const;
+
+        /**
+        * Sets the thread number of the calling thread, which identifies its queue
+        * and its track in the trace file. Threads that never call this method are
+        * considered to be the real-time thread.
+        * @param[in] threadNumber The number of the calling thread.
+        */
+        static void setCurrentThreadNumber(unsigned short threadNumber);
+
+    protected:
+
+        typedef farbot::fifo<
+            TraceEvent,
+            farbot::fifo_options::concurrency::single,
+            farbot::fifo_options::concurrency::single,
+            farbot::fifo_options::full_empty_failure_mode::return_false_on_full_or_empty,
+            farbot::fifo_options::full_empty_failure_mode::return_false_on_full_or_empty
+        > EventQueue;
+
+        /**
+        * \class DrainingThread Tracer.h
+        * Thread that regularly writes the events recorded by a Tracer into its
+        * trace file.
+        */
+        class DrainingThread :
+            public Thread
+        {
+        public:
+            DrainingThread(Tracer& tracer);
+
+        protected:
+
+            /**
+            * Writes the events recorded into the trace file every
+            * ANGLECORE_TRACER_DRAINING_PERIOD milliseconds, until the thread is
+            * requested to stop.
+            */
+            void run();
+
+        private:
+            Tracer& m_tracer;
+        };
+
+        /** Records the given event in the calling thread's queue. */
+        void recordEvent(const char* name, uint32_t workerID, char phase);
+
+        /**
+        * Empties every queue, and writes the events into the trace file, if it is
+        * open.
+        */
+        void drain();
+
+    private:
+        std::vector<std::unique_ptr<EventQueue>> m_queues;
+        std::atomic<bool> m_isRecording;
+        std::atomic<uint64_t> m_numDroppedEvents;
+        std::ofstream m_file;
+        bool m_isFirstEvent;
+        uint64_t m_startTimestamp;
+        std::unique_ptr<DrainingThread> m_drainingThread;
+
+        /** Serializes the calls to start() and stop() */
+        Mutex m_controlLock;
+
+        static thread_local unsigned short s_currentThreadNumber;
+    };
+
+    /**
+    * \class ScopedTraceEvent Tracer.h
+    * Records the beginning of an operation upon construction, and its end upon
+    * destruction, so that a whole scope can be traced with a single declaration.
+    */
+    class ScopedTraceEvent
+    {
+    public:
+
+        /**
+        * Records the beginning of the operation.
+        * @param[in] tracer The Tracer to record the operation into.
+        * @param[in] name Name of the operation. It must point to a string literal.
+        */
+        ScopedTraceEvent(Tracer& tracer, const char* name);
+
+        /** Records the end of the operation. */
+        ~ScopedTraceEvent();
+
+    private:
+        Tracer& m_tracer;
+        const char* m_name;
+    };
+}
+
+
+/*
+=================================================
+Renderer
+=================================================
+*/
+
+/*
+* The Renderer tracks the active voices using the bits of a 64-bit integer, so it
+* cannot handle more than 64 voices.
+*/
+static_assert(ANGLECORE_NUM_VOICES <= 64, "The Renderer supports at most 64 voices.");
+
+namespace ANGLECORE
+{
+    /**
+    * \class Renderer Renderer.h
+    * Agent responsible for actually performing the rendering of an audio block, by
+    * calling the proper workers in its rendering sequence.
+    */
+    class Renderer
+    {
+    public:
+
+        /**
+        * \enum RenderingMode Renderer.h
+        * Defines how the Renderer should distribute its rendering sequence across
+        * threads.
+        */
+        enum RenderingMode
+        {
+            SEQUENTIAL = 0,     /**< Every Worker is rendered by the real-time thread, one after the other. */
+            VOICE_PARALLEL,     /**< The voices are rendered in parallel by the real-time thread and a pool of helper threads, and joined before the voice-free workers that depend on them (such as the Mixer). */
+            DEPENDENCY_PARALLEL,    /**< Every Worker is rendered as soon as all the workers it depends on have been rendered, by any thread among the real-time thread and a pool of helper threads, which steal work from one another. This mode falls back to VOICE_PARALLEL if the dependency graph is not available. */
+            NUM_MODES
+        };
+
+        /**
+        * Creates a Renderer with an empty rendering sequence, which renders every
+        * Worker sequentially on the real-time thread. The Renderer will not be
+        * ready to render anything upon creation: it will wait to be initialized
+        * with a ConnectionRequest.
+        */
+        Renderer();
+
+        /**
+        * Creates a Renderer with an empty rendering sequence and the given
+        * RenderingMode. The Renderer will not be ready to render anything upon
+        * creation: it will wait to be initialized with a ConnectionRequest.
+        * @param[in] renderingMode The RenderingMode to use.
+        * @param[in] numHelperThreads Number of threads to spawn in order to help
+        *   the real-time thread render the voices in parallel. These threads are
+        *   spawned upon creation and kept alive until the Renderer is destroyed.
+        *   This parameter is ignored in SEQUENTIAL mode. If it is null, the
+        *   Renderer will behave as in SEQUENTIAL mode.
+        */
+        Renderer(RenderingMode renderingMode, unsigned short numHelperThreads);
+
+        /**
+        * Stops and destroys the helper threads, if any. The destructor waits for
+        * each thread to terminate before returning.
+        */
+        ~Renderer();
+
+        /**
+        * Renders the given number of samples. This method constitutes the kernel of
+        * ANGLECORE's real-time rendering pipeline. It will be repeatedly called by
+        * the real-time thread, and is implemented to be the fastest possible.
+        * @param[in] numSamplesToRender Number of samples to render. Every Worker in
+        *   the rendering sequence that should be rendered will be instructed to
+        *   render this number of samples.
+        */
+        void render(unsigned int numSamplesToRender);
+
+        /**
+        * Instructs the Renderer to turn a Voice on, so that its workers are
+        * rendered from the next audio block on. This method runs in constant time,
+        * as it will only be called by the real-time thread.
+        * @param[in] voiceNumber Number identifying the Voice to turn on
+        */
+        void turnVoiceOn(unsigned short voiceNumber);
+
+        /**
+        * Instructs the Renderer to turn a Voice off, so that its workers are
+        * skipped from the next audio block on. This method runs in constant time,
+        * as it will only be called by the real-time thread.
+        * @param[in] voiceNumber Number identifying the Voice to turn off
+        */
+        void turnVoiceOff(unsigned short voiceNumber);
+
+        /**
+        * Acquires the new rendering sequence and voice assignments from the given
+        * ConnectionRequest, as well as the voice segments and dependency graph
+        * computed along with them. The request passed as
+        * argument must be valid, as this method will perform no validity check and
+        * take the ConnectionRequest's results from granted. This method uses move
+        * semantics, so it will take ownership of the vectors contained in the
+        * ConnectionRequest passed as argument. This method must only be called by
+        * the real-time thread.
+        * @param[in] request The ConnectionRequest to take the results from. It
+        *   should be a valid ConnectionRequest, i.e. it should respect the two
+        *   properties defined in the structure definition (the rendering sequence
+        *   and voice assignments must be of the same size and must both be non
+        *   empty).
+        */
+        void processConnectionRequest(ConnectionRequest& request);
+
+#if ANGLECORE_ENABLE_TRACING
+        /**
+        * Sets the Tracer to record the rendering sessions and the workers' calls
+        * into. This method should be called before any rendering takes place.
+        * @param[in] tracer The Tracer to use. If null, nothing is recorded.
+        */
+        void setTracer(Tracer* tracer);
+#endif
+
+#if ANGLECORE_ENABLE_PROFILING
+        /**
+        * Copies the measurements of the last rendering session into \p profile.
+        * Returns true if a new session has been profiled since the last call, and
+        * false otherwise. This method is thread-safe, but should never be called
+        * by the real-time thread.
+        * @param[out] profile The RenderProfile to copy the measurements into.
+        */
+        bool getRenderProfile(RenderProfile& profile);
+#endif
+
+    protected:
+
+        /**
+        * \class HelperThread Renderer.h
+        * Thread that helps the real-time thread render the voices in parallel. It
+        * adopts the priority of the real-time thread as soon as the latter has
+        * rendered once, whenever the system allows it, and never runs with a
+        * higher priority. It polls the Renderer for something to render, so that
+        * it can react as fast as possible when a new rendering session begins,
+        * and pauses the processor with an exponential backoff in between. Once it
+        * has found nothing to render ANGLECORE_RENDERER_SPIN_COUNT times in a
+        * row, it sleeps until the real-time thread publishes the next session.
+        */
+        class HelperThread :
+            public Thread
+        {
+        public:
+
+            /**
+            * Creates a HelperThread that will help the given Renderer once started.
+            * @param[in] renderer The Renderer to help.
+            * @param[in] threadNumber Number identifying the thread within the
+            *   Renderer, starting from 1 (0 designates the real-time thread).
+            */
+            HelperThread(Renderer& renderer, unsigned short threadNumber);
+
+        protected:
+
+            /**
+            * Polls the Renderer for something to render, and sleeps in between
+            * rendering sessions, until the thread is requested to stop.
+            */
+            void run();
+
+        private:
+            Renderer& m_renderer;
+            const unsigned short m_threadNumber;
+        };
+
+        /**
+        * Tries to claim one of the voices published for the current rendering
+        * session, and renders its segment if it succeeds. Returns true if a voice
+        * was rendered, and false if no voice was left to claim. This method is
+        * lock-free, and is called by both the real-time thread and the helper
+        * threads.
+        */
+        bool claimAndRenderVoice();
+
+        /**
+        * Renders the given number of samples by splitting the rendering sequence
+        * by voice: the voice-free head is rendered first, then the active voices
+        * are rendered in parallel, and the voice-free tail is rendered once every
+        * voice has been rendered. This method must only be called by the
+        * real-time thread, and only if the current rendering sequence is
+        * splittable by voice.
+        * @param[in] numSamplesToRender Number of samples to render.
+        */
+        void renderVoicesInParallel(unsigned int numSamplesToRender);
+
+        /**
+        * Tries to take a Worker that is ready to be rendered, first from the
+        * calling thread's own queue, and then from the other threads' queues, and
+        * renders it if it succeeds. Returns true if a Worker was rendered, and
+        * false if no Worker could be found. This method is lock-free, and is
+        * called by both the real-time thread and the helper threads.
+        * @param[in] threadNumber Number identifying the calling thread, 0 being the
+        *   real-time thread.
+        */
+        bool popOrStealAndRenderTask(unsigned short threadNumber);
+
+        /**
+        * Renders the given number of samples by following the dependency graph of
+        * the rendering sequence: the real-time thread pushes the workers without
+        * active predecessors into its queue, and every rendered Worker then pushes
+        * its successors once they are ready. The method returns once every active
+        * Worker has been rendered. This method must only be called by the
+        * real-time thread, and only if the current dependency graph is valid.
+        * @param[in] numSamplesToRender Number of samples to render.
+        */
+        void renderDependencyGraph(unsigned int numSamplesToRender);
+
+        /**
+        * Called by the real-time thread each time it checks in vain whether the
+        * helper threads are done. It pauses the processor for the first
+        * ANGLECORE_RENDERER_SPIN_COUNT attempts, and yields the CPU afterwards.
+        * @param[in, out] numAttempts Number of attempts made so far, which should
+        *   be set to zero before the first one.
+        */
+        static void backOff(unsigned int& numAttempts);
+
+        /**
+        * Pauses the processor a number of times that doubles with each attempt,
+        * up to ANGLECORE_RENDERER_MAX_PAUSES, so that a spinning thread leaves
+        * the memory bus and the sibling hardware thread alone without ever
+        * giving up its core.
+        * @param[in] numAttempts Number of fruitless attempts made so far.
+        */
+        static void pause(unsigned int numAttempts);
+
+        /**
+        * Recomputes which workers are active, the number of active predecessors of
+        * each Worker, and the workers to start from, after a Voice has been turned
+        * on or off, or after a ConnectionRequest has been processed. This method
+        * will be called by the real-time thread.
+        */
+        void updateActiveTasks();
+
+        /**
+        * Renders the given number of samples on the calling thread only. If the
+        * rendering sequence is grouped by voice, only the segments of the active
+        * voices are visited. Otherwise, the voice assignment of every Worker is
+        * checked before rendering it.
+        * @param[in] numSamplesToRender Number of samples to render.
+        */
+        void renderSequentially(unsigned int numSamplesToRender);
+
+        /**
+        * Calls the Worker at the given position in the rendering sequence. If
+        * profiling is enabled, this method also measures the duration of the
+        * call.
+        * @param[in] position Position of the Worker in the rendering sequence.
+        * @param[in] numSamplesToRender Number of samples to render.
+        */
+        inline void callWorker(uint32_t position, unsigned int numSamplesToRender);
+
+        /**
+        * Renders the workers located between positions \p begin (included) and
+        * \p end (excluded) in the rendering sequence, without any voice check.
+        */
+        void renderRange(uint32_t begin, uint32_t end, unsigned int numSamplesToRender);
+
+    private:
+
+        /**
+        * Boolean flag which signals when the rendering sequence and voice
+        * assignments are valid, i.e. when they are both non-empty and of the same
+        * size. It is initialized to false, and the Renderer expects an empty
+        * ConnectionRequest to start up. Once set to true, this boolean will never
+        * be set to false again, as only valid connection requests will be accepted.
+        */
+        bool m_isReadyToRender;
+
+        /**
+        * The current rendering sequence used by the renderer, as a flat array of
+        * WorkCall objects aligned on a cache line. It should always be of the same
+        * length as m_voiceAssignments.
+        */
+        WorkCallSequence m_workCalls;
+
+        /**
+        * The voice assignments corresponding to each Worker in the current
+        * rendering sequence. It should always be of the same length as
+        * m_workCalls.
+        */
+        std::vector<VoiceAssignment> m_voiceAssignments;
+
+        /**
+        * Tracks the on/off status of every Voice: the bit at position v is set if
+        * and only if Voice v is on. Iterating over the bits set visits the active
+        * voices in increasing order, which is the order of their segments in the
+        * rendering sequence.
+        */
+        uint64_t m_activeVoices;
+
+        /**
+        * Flag that indicates whether to recompute the active workers of the
+        * dependency graph or not in the next rendering session. This flag is
+        * useful for preventing the Renderer from updating them twice, after a
+        * Voice has been turned on or off and a new ConnectionRequest has been
+        * received.
+        */
+        bool m_shouldUpdateActiveTasks;
+
+        /** The RenderingMode used by the Renderer */
+        const RenderingMode m_renderingMode;
+
+        /**
+        * Indicates whether the current rendering sequence is grouped by voice, and
+        * can therefore be rendered using the VOICE_PARALLEL mode.
+        */
+        bool m_isSplittableByVoice;
+
+        /**
+        * Position of each Voice's segment within the current rendering sequence.
+        * The last value corresponds to the start of the voice-free tail. This array
+        * is only meaningful if m_isSplittableByVoice is true.
+        */
+        uint32_t m_voiceSegmentStarts[ANGLECORE_NUM_VOICES + 1];
+
+        /**
+        * Voices to render in the current rendering session. This array is written
+        * by the real-time thread before the session is published, and only read
+        * by the other threads during the session.
+        */
+        unsigned short m_voicesToRender[ANGLECORE_NUM_VOICES];
+
+        /** Number of samples to render in the current rendering session */
+        unsigned int m_numSamplesToRender;
+
+        /** Counts the rendering sessions published to the helper threads */
+        uint32_t m_sessionNumber;
+
+        /**
+        * Ticket used by the threads to claim the voices to render. It packs the
+        * session number in its 32 most significant bits, the number of voices to
+        * render in the next 16 bits, and the index of the next voice to claim in
+        * the 16 least significant bits. Packing them together allows a thread to
+        * claim a voice with a single compare-and-swap operation, which fails if
+        * the session has changed in the meantime.
+        */
+        std::atomic<uint64_t> m_voiceTicket;
+
+        /**
+        * Number of voices that have been entirely rendered in the current
+        * rendering session. The real-time thread waits for this number to reach
+        * the number of voices to render before rendering the voice-free tail.
+        */
+        std::atomic<unsigned short> m_numRenderedVoices;
+
+        /**
+        * Signal the real-time thread sends at the beginning of each parallel
+        * rendering session, to wake up the helper threads that went to sleep.
+        */
+        WakeupSignal m_sessionSignal;
+
+        /**
+        * Scheduling priority of the real-time thread, which the helper threads
+        * adopt once m_hasRealtimeThreadPriority is true. It is recorded when the
+        * real-time thread renders for the first time, as the Renderer is usually
+        * created on another thread.
+        */
+        Thread::Priority m_realtimeThreadPriority;
+        std::atomic<bool> m_hasRealtimeThreadPriority;
+
+        /**
+        * Indicates whether the current rendering sequence comes with a valid
+        * dependency graph, and can therefore be rendered using the
+        * DEPENDENCY_PARALLEL mode.
+        */
+        bool m_hasDependencyGraph;
+
+        /**
+        * Dependency graph of the current rendering sequence: the positions of the
+        * successors of the Worker at position i are stored in m_successors between
+        * m_successorOffsets[i] (included) and m_successorOffsets[i + 1] (excluded).
+        */
+        std::vector<uint32_t> m_predecessorCounts;
+        std::vector<uint32_t> m_successorOffsets;
+        std::vector<uint32_t> m_successors;
+
+        /**
+        * The following vectors are only allocated in DEPENDENCY_PARALLEL mode, with
+        * a fixed size of ANGLECORE_RENDERER_MAX_NUM_TASKS, so that the real-time
+        * thread never allocates memory. For each Worker of the sequence, they
+        * respectively store whether it should be rendered, its number of active
+        * predecessors, and its number of active predecessors that remain to be
+        * rendered in the current rendering session.
+        */
+        std::vector<bool> m_taskIsActive;
+        std::vector<uint32_t> m_activePredecessorCounts;
+        std::vector<std::atomic<uint32_t>> m_pendingPredecessorCounts;
+
+        /** Active workers without any active predecessor */
+        std::vector<uint32_t> m_rootTasks;
+        uint32_t m_numRootTasks;
+
+        /** Number of workers to render in each rendering session */
+        uint32_t m_numActiveTasks;
+
+        /** Number of workers rendered so far in the current rendering session */
+        std::atomic<uint32_t> m_numCompletedTasks;
+
+        /**
+        * Queues of workers ready to be rendered, one per thread. The first one
+        * belongs to the real-time thread.
+        */
+        std::vector<std::unique_ptr<WorkStealingQueue>> m_taskQueues;
+
+#if ANGLECORE_ENABLE_PROFILING
+        /** Measures the time spent in each Worker */
+        RenderProfiler m_profiler;
+#endif
+
+#if ANGLECORE_ENABLE_TRACING
+        /** Records the rendering sessions and workers' calls, if not null */
+        Tracer* m_tracer;
+#endif
+
+#if ANGLECORE_ENABLE_PROFILING || ANGLECORE_ENABLE_TRACING
+        /**
+        * The ID of every Worker in the rendering sequence, used to identify the
+        * workers in the profiling measurements and in the trace.
+        */
+        std::vector<uint32_t> m_workerIDs;
+#endif
+
+        /**
+        * Threads helping the real-time thread to render the voices. This member is
+        * declared last, so that the threads are destroyed before any other member
+        * they could access.
+        */
+        std::vector<std::unique_ptr<HelperThread>> m_helperThreads;
+    };
+}
+
+
+/*
+=================================================
+Master
+=================================================
+*/
+
+namespace ANGLECORE
+{
+    /**
+    * \struct MIDIMessage MIDIBuffer.h
+    * Represents a MIDI message supported by the Master object.
+    */
+    struct MIDIMessage
+    {
+        /** Types of MIDI messages supported by the Master object */
+        enum Type
+        {
+            NONE = 0,       /**< MIDI Messages of this type will be ignored */
+            NOTE_ON,
+            NOTE_OFF,
+            ALL_NOTES_OFF,
+            ALL_SOUND_OFF,
+            NUM_TYPES
+        };
+
+        /** Type of MIDI message */
+        Type type;
+
+        /**
+        * Timestamp of the message as a sample position within the current audio
+        * buffer
+        */
+        uint32_t timestamp;
+
+        unsigned char noteNumber;
+        unsigned char noteVelocity;
+
+        /**
+        * Creates a MIDI message of type NONE, and initializes every attribute to
+        * their default value.
+        */
+        MIDIMessage();
+    };
+
+    /**
+    * \class MIDIBuffer MIDIBuffer.h
+    * Buffer of MIDI messages.
+    */
+    class MIDIBuffer
+    {
+    public:
+
+        /** Creates a MIDI buffer of fixed size */
+        MIDIBuffer();
+
+        /**
+        * Returns the number of MIDI messages contained in the buffer. This will be
+        * different from the buffer's capacity.
+        */
+        uint32_t getNumMIDIMessages() const;
+
+        /**
+        * Adds a new empty MIDIMessage at the end of the buffer, and returns a
+        * reference to it.
+        */
+        MIDIMessage& pushBackNewMIDIMessage();
+
+        /** Removes every MIDIMessage from the buffer. */
+        void clear();
+
+        /**
+        * Provides a read an write access to the MIDI messages.
+        * @param[in] index Position of the MIDIMessage to retrieve from the buffer.
+        *   It should be in-range, as it will not be checked at runtime.
+        */
+        MIDIMessage& operator[](uint32_t index);
+
+    private:
+        uint32_t m_capacity;
+        std::vector<MIDIMessage> m_messages;
+        uint32_t m_numMessages;
+    };
+}
+
+namespace ANGLECORE
+{
+    /**
+    * \struct ParameterEvent ParameterEventBuffer.h
+    * Represents a change of a Parameter's value that should happen at a precise
+    * sample within the audio block being rendered. The Parameter is designated by
+    * a ParameterHandle, so that the real-time thread can find it without hashing
+    * nor comparing any string.
+    */
+    struct ParameterEvent
+    {
+        /**
+        * Handle of the Parameter, as returned by Master::getParameterHandle().
+        * Events with an invalid or stale handle are dropped.
+        */
+        ParameterHandle parameter;
+
+        /** The Parameter's new value */
+        floating_type newValue;
+
+        /**
+        * Timestamp of the event as a sample position within the current audio
+        * buffer
+        */
+        uint32_t timestamp;
+
+        /**
+        * Duration of the transition towards the new value, in samples. The
+        * Parameter's minimal smoothing duration applies just like it does for the
+        * other change requests.
         */
-        void activateRack(unsigned short rackNumber);
+        uint32_t durationInSamples;
 
         /**
-        * Deactivates the given Rack for the Mixer to stop using it in the mix. Note
-        * that this method merely deactivates the rack, and does not call any method
-        * on any instrument to stop and render its audio tail. Such processing must
-        * therefore be called for beforehand if needed.
-        *
-        * This method must only be called by the real-time thread.
-        * @param[in] rackNumber Rack to deactivate.
+        * Creates a ParameterEvent with an invalid handle, and initializes every
+        * other attribute to its default value.
         */
-        void deactivateRack(unsigned short rackNumber);
+        ParameterEvent();
+    };
+
+    /**
+    * \class ParameterEventBuffer ParameterEventBuffer.h
+    * Buffer of ParameterEvents.
+    */
+    class ParameterEventBuffer
+    {
+    public:
+
+        /** Creates a ParameterEvent buffer of fixed size */
+        ParameterEventBuffer();
 
         /**
-        * Requests all the instruments contained in the given Voice to stop playing,
-        * and returns the Voice's audio tail duration in samples, which is the
-        * number of samples before the Voice begins to emit complete silence.
-        * This method must only be called by the real-time thread.
-        * @param[in] voiceNumber Voice that should stop playing.
+        * Returns the number of ParameterEvents contained in the buffer. This will be
+        * different from the buffer's capacity.
         */
-        uint32_t stopVoice(unsigned short voiceNumber);
+        uint32_t getNumParameterEvents() const;
 
         /**
-        * Executes the given \p plan, and adds or removes entries from the
-        * AudioWorkflow's parameter registers as instructed. This method needs to be
-        * fast as it might be called by the real-time thread at the beginning of any
-        * rendering session. Note that the plan passed in as argument may be altered
-        * when executed, as the AudioWorkflow will move some shared pointers around.
-        * @param[in] plan The ParameterRegistrationPlan to execute.
+        * Adds a new empty ParameterEvent at the end of the buffer, and returns a
+        * reference to it.
         */
-        void executeParameterRegistrationPlan(ParameterRegistrationPlan& plan);
+        ParameterEvent& pushBackNewParameterEvent();
+
+        /** Removes every ParameterEvent from the buffer. */
+        void clear();
 
         /**
-        * Tries to find the ParameterGenerator corresponding to the given Parameter.
-        * The AudioWorkflow will search through the parameters that are registered
-        * for the given \p rackNumber and look for a matching identifier. If one is
-        * found, this method will return the associated ParameterGenerator.
-        * Otherwise, this method will return a null pointer. Note that the rack
-        * number is expected to be in-range, as no safety check will be performed by
-        * this method.
-        * @param[in] rackNumber The Rack number. It must be in-range.
-        * @param[in] parameterIdentifier The Parameter's identifier. This can be
-        *   passed in as a C string, as it will be implicitely converted into a
-        *   StringView. If this parameter does not correspond to any parameter of
-        *   the Instrument located at \p rackNumber, then this method will return a
-        *   null pointer.
+        * Provides a read an write access to the ParameterEvents.
+        * @param[in] index Position of the ParameterEvent to retrieve from the
+        *   buffer. It should be in-range, as it will not be checked at runtime.
         */
-        std::shared_ptr<ParameterGenerator> findParameterGenerator(unsigned short rackNumber, StringView parameterIdentifier);
+        ParameterEvent& operator[](uint32_t index);
 
-    protected:
+    private:
+        uint32_t m_capacity;
+        std::vector<ParameterEvent> m_events;
+        uint32_t m_numEvents;
+    };
+}
+
+namespace ANGLECORE
+{
+    /**
+    * \class LoadMonitor LoadMonitor.h
+    * Compares the time spent rendering each audio block with the duration of the
+    * audio it contains, hereby measuring how close the real-time thread is to
+    * missing its deadline. The measurements are stored into atomic variables, so
+    * that they can be read from any thread (typically to display a CPU meter in
+    * the UI) while the real-time thread keeps updating them.
+    */
+    class LoadMonitor
+    {
+    public:
+        LoadMonitor();
 
         /**
-        * Retrieve the ID of the Mixer's input Stream at the provided location. Note
-        * that every parameter is expected to be in-range, and that no safety check
-        * will be performed by this method.
-        * @param[in] voiceNumber Voice whose workers ultimately fill in the Stream.
-        * @param[in] rackNumber Rack at the end of which the Stream is located.
-        * @param[in] channel Audio channel that the Stream corresponds to.
+        * Starts measuring the rendering time of an audio block. This method must
+        * only be called by the real-time thread.
         */
-        uint32_t getMixerInputStreamID(unsigned short voiceNumber, unsigned short rackNumber, unsigned short channel) const;
+        void beginBlock();
 
         /**
-        * Retrieve the ID of the Stream containing the current sample rate in the
-        * AudioWorkflow's global context.
+        * Ends the measurement started by the last call to beginBlock(), and updates
+        * the load values and the overrun count accordingly. This method must only
+        * be called by the real-time thread.
+        * @param[in] numSamples Number of samples in the audio block rendered.
+        * @param[in] sampleRate Sample rate of the audio block, in Hz.
         */
-        uint32_t getSampleRateStreamID() const;
+        void endBlock(uint32_t numSamples, floating_type sampleRate);
 
         /**
-        * Retrieve the ID of the Stream containing the reciprocal of the current
-        * sample rate in the AudioWorkflow's global context.
+        * Returns the DSP load of the last audio block, that is the ratio between
+        * its rendering time and its audio duration. A value of 1.0 or more means
+        * the deadline has been missed.
         */
-        uint32_t getSampleRateReciprocalStreamID() const;
+        float getLastLoad() const;
 
         /**
-        * Retrieve the ID of the Stream containing the given Voice's current
-        * frequency. Note that voiceNumber is expected to be in-range, and that no
-        * safety check will be performed by this method.
-        * @param[in] voiceNumber Voice to retrieve the information from.
+        * Returns the DSP load smoothed over ANGLECORE_LOAD_MONITOR_SMOOTHING_TIME
+        * seconds of audio, which is better suited for display.
         */
-        uint32_t getFrequencyStreamID(unsigned short voiceNumber) const;
+        float getSmoothedLoad() const;
+
+        /** Returns the highest DSP load measured since the last resetPeakLoad(). */
+        float getPeakLoad() const;
+
+        /** Resets the peak load, so that a new peak can be measured. */
+        void resetPeakLoad();
 
         /**
-        * Retrieve the ID of the Stream containing the given Voice's current
-        * frequency divided by the global sample rate. Note that voiceNumber is
-        * expected to be in-range, and that no safety check will be performed by
-        * this method.
-        * @param[in] voiceNumber Voice to retrieve the information from.
+        * Returns the number of audio blocks whose DSP load exceeded the budget
+        * since the LoadMonitor was created.
         */
-        uint32_t getFrequencyOverSampleRateStreamID(unsigned short voiceNumber) const;
+        uint64_t getNumOverruns() const;
+
+        /** Returns the fraction of each block's duration allowed for rendering. */
+        float getBudget() const;
 
         /**
-        * Retrieve the ID of the Stream containing the given Voice's current
-        * velocity. Note that voiceNumber is expected to be in-range, and that no
-        * safety check will be performed by this method.
-        * @param[in] voiceNumber Voice to retrieve the information from.
+        * Sets the fraction of each block's duration allowed for rendering. Blocks
+        * that exceed it are counted as overruns.
+        * @param[in] budget The new budget. Negative values are replaced by zero.
         */
-        uint32_t getVelocityStreamID(unsigned short voiceNumber) const;
+        void setBudget(float budget);
 
     private:
-        std::shared_ptr<Exporter> m_exporter;
-        std::shared_ptr<Mixer> m_mixer;
-        Voice m_voices[ANGLECORE_NUM_VOICES];
-        GlobalContext m_globalContext;
-        ParameterRegister m_parameterRegisters[ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
+        std::atomic<float> m_lastLoad;
+        std::atomic<float> m_smoothedLoad;
+        std::atomic<float> m_peakLoad;
+        std::atomic<uint64_t> m_numOverruns;
+        std::atomic<float> m_budget;
+
+        /** Time at which the current block started, only used by the real-time thread */
+        uint64_t m_blockStartTime;
     };
+}
 
-
-
-    /*
-    =================================================
-    RequestManager
-    =================================================
-    */
-
+namespace ANGLECORE
+{
     /**
-    * \struct Request Request.h
-    * When the end-user instructs to change something in the AudioWorkflow, an
-    * instance of this structure is created to store all necessary information
-    * about that request.
-    *
-    * The Request structure provides three virtual methods that can be overriden in
-    * derived classes: preprocess(), process(), and postprocess(). The preprocess()
-    * method should prepare everything for the Request's execution and must return a
-    * boolean indicating if the preparation went well. The process() method should
-    * contain the core implementation of the Request's execution. It is a pure
-    * virtual method, so it must be implemented in all derived classes. Finally, the
-    * postprocess() method is called right before the deletion of the Request
-    * object, in order to do some final processing, like calling listeners to inform
-    * them about how the Request's execution went.
-    *
-    * Both preprocess() and postprocess() methods are called on a non real-time
-    * thread, whereas the process() method is always executed on the real-time
-    * thread, so it must be really fast.
-    *
-    * The preprocess() method is guaranteed to always be executed before the
-    * process() method, which in turn is guaranteed to always be executed before the
-    * postprocess() method. However, if the preparation stage goes wrong and the
-    * preprocess() method returns false, then the process() method will not be
-    * called (the Request will not even be sent to the real-time thread), and the
-    * RequestManager will jump directly to the postprocess() method instead.
-    *
-    * For two different requests both posted asynchronously to the RequestManager,
-    * the preprocess() method is guaranteed to always be executed separately and
-    * never concurrently. That guarantee no longer holds for requests posted
-    * synchronously: a request posted synchronously could be preprocessed in
-    * parallel with another request posted synchronously, or with another request
-    * posted asynchronously, since synchronous posting aims at preprocessing and
-    * transferring requests upon reception. If concurrency is an issue, a proper
-    * locking or sharing mechanism should be implemented in the preprocess() and
-    * postprocess() methods, or the Request in question should be posted
-    * asynchronously.
+    * \class VoiceLimiter VoiceLimiter.h
+    * Estimates how much of the DSP load each active Voice costs, and deduces the
+    * maximum number of voices that can play together without exceeding the load
+    * budget. The Master consults it before playing a new note, so that it can
+    * refuse the note, or steal the oldest Voice, instead of missing the deadline.
+    * The limit is lowered as soon as the load approaches the budget, and raised
+    * back one Voice at a time when the load drops.
     */
-    struct Request
+    class VoiceLimiter
     {
-        /**
-        * Indicates whether or not the request was preprocessed, that is if the
-        * preprocess() method was called, regardless of the success of the
-        * preprocessing.
-        */
-        std::atomic<bool> hasBeenPreprocessed;
+    public:
 
         /**
-        * Indicates whether or not the request was processed, that is if the
-        * process() method was called, regardless of the success of the processing.
+        * \enum Policy
+        * Defines what the Master does with a new note when the voice limit is
+        * reached.
         */
-        std::atomic<bool> hasBeenProcessed;
+        enum Policy
+        {
+            DISABLED = 0,   /**< The limit is ignored, and notes only fail when every Voice is busy */
+            REFUSE,         /**< The new note is ignored */
+            STEAL,          /**< The oldest note is released to make room for the new one */
+            NUM_POLICIES
+        };
 
-        /**
-        * Indicates whether or not the request was postprocessed, that is if the
-        * postprocess() method was called. This atomic boolean must always be set to
-        * true once a Request is postprocessed; otherwise, if the Request has been
-        * posted asynchronously to the RequestManager, then the latter may not
-        * detect the end of the Request's execution and indefinitely wait for it.
-        */
-        std::atomic<bool> hasBeenPostprocessed;
+        VoiceLimiter();
 
         /**
-        * Handy flag that can be used to indicate whether the request was
-        * successfully processed or not.
+        * Updates the estimates of the DSP load per Voice using the measurements of
+        * the last audio block, and recomputes the voice limit accordingly. This
+        * method must only be called by the real-time thread.
+        * @param[in] load DSP load of the last audio block.
+        * @param[in] budget Maximum DSP load allowed.
+        * @param[in] numActiveVoices Number of voices that were rendered in the
+        *   last audio block.
         */
-        std::atomic<bool> success;
+        void update(float load, float budget, unsigned short numActiveVoices);
 
-        Request();
+        /** Returns the current Policy. */
+        Policy getPolicy() const;
 
         /**
-        * This method is called by the RequestManager on a non real-time thread to
-        * preprocess the Request for its execution, before sending it to the
-        * real-time thread. It must return true if the preparation went well, and
-        * false otherwise, in which case the Request will not be executed on the
-        * real-time thread and the process() method will not be called by the
-        * RequestManager. By default, this method returns true.
-        *
-        * If the Request is posted synchronously, then this method will be called by
-        * the RequestManager on the non real-time thread upon reception. Otherwise,
-        * if the Request is posted asynchronously, then this method will be called
-        * by the RequestManager's asynchronous, non real-time thread.
-        *
-        * The preprocess() method is mostly useful for asynchronously posted
-        * requests: since the RequestManager's asynchronous thread treats only one
-        * request at a time, the preprocess() method is guaranteed to always be
-        * executed separately and never concurrently for two different requests both
-        * posted asynchronously.
+        * Sets the Policy applied when the voice limit is reached. This method can
+        * be called from any thread.
         */
-        virtual bool preprocess();
+        void setPolicy(Policy policy);
 
         /**
-        * This method is called by the Master on the real-time thread to process the
-        * request. Derived classes of the Request class must implement this method.
+        * Returns the maximum number of voices that can currently play together.
+        * It is always between 1 and ANGLECORE_NUM_VOICES.
         */
-        virtual void process() = 0;
+        unsigned short getVoiceLimit() const;
 
-        /**
-        * This method is called by the RequestManager on a non real-time thread to
-        * make any final processing before the Request object is deleted. It is
-        * always executed, even if the preprocessing failed and the process() method
-        * was not called before. It will therefore give the same result as if its
-        * content was implemented into the ~Request() destructor.
-        *
-        * The postprocess() method is suitable for broadcasting information about
-        * the Request's success to listeners, using the provided atomic flags and,
-        * if necessary, other additional status variables defined in derived
-        * classes.
+    private:
+        std::atomic<int> m_policy;
+        std::atomic<unsigned short> m_voiceLimit;
+
+        /*
+        * The following estimates are only used by the real-time thread. The load
+        * of a block is modelled as a base load, spent whatever the number of
+        * voices, plus a load proportional to the number of active voices.
         */
-        virtual void postprocess();
+        float m_baseLoad;
+        float m_loadPerVoice;
     };
+}
 
+
+/*
+=================================================
+RequestManager
+=================================================
+*/
+
+namespace ANGLECORE
+{
     /**
     * \class RequestManager RequestManager.h
     * A RequestManager handles requests before they are sent to the real-time thread
@@ -2309,59 +5352,10 @@ namespace ANGLECORE
 
         PostProcessingThread m_postProcessingThread;
     };
+}
 
-    /*
-    * We use forward declaration here, as both the Renderer and ConnectionRequest
-    * classes depend on each other. Declaring the Renderer class as an incomplete
-    * type should not trigger any compilation error since that class is only used to
-    * declare references within the ConnectionRequest class' declaration.
-    */
-    class Renderer;
-
-    /**
-    * \class ConnectionRequest ConnectionRequest.h
-    * Request to execute a ConnectionPlan on a Workflow. A ConnectionRequest
-    * contains both the ConnectionPlan and its consequences (the new rendering
-    * sequence and voice assignments after the plan is executed), which should be
-    * computed in advance for the Renderer. To be valid, a ConnectionRequest should
-    * verify the following two properties:
-    * 1. None of its three vectors newRenderingSequence, newVoiceAssignments, and
-    * oneIncrements should be empty;
-    * 2. All of those three vectors should be of the same length.
-    * .
-    * To be consistent, both vectors newRenderingSequence and newVoiceAssignments
-    * should be computed from the same ConnectionPlan and by the same AudioWorkflow.
-    */
-    class ConnectionRequest :
-        public Request
-    {
-    public:
-        ConnectionRequest(AudioWorkflow& audioWorkflow, Renderer& renderer);
-
-        /**
-        * Creates and removes connections in the AudioWorkflow according to the
-        * Request's ConnectionPlan, and sends updated information to the Renderer
-        * for adapting its next rendering sessions accordingly.
-        */
-        void process();
-
-    public:
-        ConnectionPlan plan;
-        std::vector<std::shared_ptr<Worker>> newRenderingSequence;
-        std::vector<VoiceAssignment> newVoiceAssignments;
-
-        /**
-        * This vector provides pre-allocated memory for the Renderer's increment
-        * computation. It should always be of the same size as newRenderingSequence
-        * and newVoiceAssignments, and should always end with the number 1.
-        */
-        std::vector<uint32_t> oneIncrements;
-
-    private:
-        AudioWorkflow& m_audioWorkflow;
-        Renderer& m_renderer;
-    };
-
+namespace ANGLECORE
+{
     /**
     * \class AddInstrumentRequest AddInstrumentRequest.h
     * When the end-user adds a new Instrument to an AudioWorkflow, an instance of
@@ -2371,9 +5365,9 @@ namespace ANGLECORE
     * ParameterRegister.
     */
     template <class InstrumentType>
-    class AddInstrumentRequest :
+	class AddInstrumentRequest :
         public Request
-    {
+	{
     public:
 
         /**
@@ -2476,7 +5470,8 @@ namespace ANGLECORE
         void process();
 
         /**
-        * Calls the request's Listener to send information about how the request's
+        * Releases the snapshots of the parameter registers that were replaced, and
+        * calls the request's Listener to send information about how the request's
         * execution went.
         */
         void postprocess() override;
@@ -2500,7 +5495,7 @@ namespace ANGLECORE
         * into.
         */
         ParameterRegistrationPlan m_parameterRegistrationPlan;
-    };
+	};
 
     template<class InstrumentType>
     AddInstrumentRequest<InstrumentType>::AddInstrumentRequest(AudioWorkflow& audioWorkflow, Renderer& renderer) :
@@ -2526,7 +5521,7 @@ namespace ANGLECORE
     template<class InstrumentType>
     bool AddInstrumentRequest<InstrumentType>::preprocess()
     {
-        std::lock_guard<std::mutex> scopedLock(m_audioWorkflow.getLock());
+        std::lock_guard<Mutex> scopedLock(m_audioWorkflow.getLock());
 
         /* Can we insert a new instrument? We need to find an empty spot first: */
         unsigned short emptyRackNumber = m_audioWorkflow.findEmptyRack();
@@ -2565,6 +5560,13 @@ namespace ANGLECORE
             m_audioWorkflow.addInstrumentAndPlanBridging(v, m_selectedRackNumber, instrument, connectionPlan, m_parameterRegistrationPlan);
         }
 
+        /*
+        * The parameter registration plan is then turned into new snapshots of the
+        * parameter registers, so that the real-time thread only has to publish
+        * them:
+        */
+        m_audioWorkflow.prepareParameterRegistrationPlan(m_parameterRegistrationPlan);
+
         /*
         * Once here, we have a ConnectionPlan and a ParameterRegisterPlan ready to
         * be used. We now need to precompute the consequences of executing the
@@ -2576,7 +5578,8 @@ namespace ANGLECORE
         * We first calculate the rendering sequence that will take effect right
         * after the connection plan is executed.
         */
-        std::vector<std::shared_ptr<Worker>> newRenderingSequence = m_audioWorkflow.buildRenderingSequence(connectionPlan);
+        bool isSplittableByVoice;
+        std::vector<std::shared_ptr<Worker>> newRenderingSequence = m_audioWorkflow.buildRenderingSequence(connectionPlan, isSplittableByVoice);
 
         /*
         * And from that sequence, we can precompute and assign the rest of the
@@ -2584,7 +5587,27 @@ namespace ANGLECORE
         */
         m_connectionRequest.newRenderingSequence = newRenderingSequence;
         m_connectionRequest.newVoiceAssignments = m_audioWorkflow.getVoiceAssignments(newRenderingSequence);
-        m_connectionRequest.oneIncrements.resize(newRenderingSequence.size(), 1);
+        m_connectionRequest.newWorkCalls.reserve(newRenderingSequence.size());
+        for (const std::shared_ptr<Worker>& worker : newRenderingSequence)
+            m_connectionRequest.newWorkCalls.push_back(worker->getWorkCall());
+
+#if ANGLECORE_ENABLE_PROFILING || ANGLECORE_ENABLE_TRACING
+        m_connectionRequest.newWorkerIDs.reserve(newRenderingSequence.size());
+        for (const std::shared_ptr<Worker>& worker : newRenderingSequence)
+            m_connectionRequest.newWorkerIDs.push_back(worker->id);
+#endif
+
+        /*
+        * We also locate each voice within the new sequence, so that the Renderer
+        * can render the voices independently if the sequence allows it.
+        */
+        m_connectionRequest.isSplittableByVoice = isSplittableByVoice && VoiceAssigner::getVoiceSegmentStarts(m_connectionRequest.newVoiceAssignments, m_connectionRequest.newVoiceSegmentStarts);
+
+        /*
+        * Finally, we compute the dependencies between the workers of the new
+        * sequence, so that the Renderer can schedule them across threads.
+        */
+        m_audioWorkflow.buildDependencyGraph(newRenderingSequence, connectionPlan, m_connectionRequest.newPredecessorCounts, m_connectionRequest.newSuccessorOffsets, m_connectionRequest.newSuccessors);
 
         /*
         * If we arrive here, then the preparation went well, so we return true for
@@ -2623,6 +5646,20 @@ namespace ANGLECORE
     template<class InstrumentType>
     void AddInstrumentRequest<InstrumentType>::postprocess()
     {
+        /*
+        * We first delete the snapshots of the parameter registers that were
+        * replaced during processing, once no other thread reads them anymore. If
+        * the request was not processed, these are simply the snapshots that were
+        * prepared and never published.
+        */
+        m_audioWorkflow.releaseParameterRegistrationPlan(m_parameterRegistrationPlan);
+
+        /*
+        * The embedded ConnectionRequest is never posted on its own, so we
+        * postprocess it here.
+        */
+        m_connectionRequest.postprocess();
+
         if (m_listener)
         {
             if (hasBeenPreprocessed.load() && hasBeenProcessed.load() && success.load())
@@ -2635,222 +5672,60 @@ namespace ANGLECORE
     /** Handy short name for listeners of AddInstrumentRequest objects */
     template<class InstrumentType>
     using AddInstrumentListener = typename AddInstrumentRequest<InstrumentType>::Listener;
+}
 
 
+/*
+=================================================
+Master
+=================================================
+*/
 
-    /*
-    =================================================
-    Renderer
-    =================================================
-    */
-
+namespace ANGLECORE
+{
     /**
-    * \class Renderer Renderer.h
-    * Agent responsible for actually performing the rendering of an audio block, by
-    * calling the proper workers in its rendering sequence.
+    * \class Master Master.h
+    * The Master orchestrates the rendering and the interaction with the end-user
+    * requests. It should be the only entry point from outside when developping an
+    * ANGLECORE-based application.
     */
-    class Renderer
+    class Master
     {
     public:
 
         /**
-        * Creates a Renderer with an empty rendering sequence. The Renderer will not
-        * be ready to render anything upon creation: it will wait to be initialized
-        * with a ConnectionRequest.
-        */
-        Renderer();
-
-        /**
-        * Renders the given number of samples. This method constitutes the kernel of
-        * ANGLECORE's real-time rendering pipeline. It will be repeatedly called by
-        * the real-time thread, and is implemented to be the fastest possible.
-        * @param[in] numSamplesToRender Number of samples to render. Every Worker in
-        *   the rendering sequence that should be rendered will be instructed to
-        *   render this number of samples.
-        */
-        void render(unsigned int numSamplesToRender);
-
-        /**
-        * Instructs the Renderer to turn a Voice on, and to recompute its increments
-        * later, before rendering the next audio block. This method is really fast,
-        * as it will only be called by the real-time thread.
-        * @param[in] voiceNumber Number identifying the Voice to turn on
-        */
-        void turnVoiceOn(unsigned short voiceNumber);
-
-        /**
-        * Instructs the Renderer to turn a Voice off, and to recompute its
-        * increments later, before rendering the next audio block. This method is
-        * really fast, as it will only be called by the real-time thread.
-        * @param[in] voiceNumber Number identifying the Voice to turn off
-        */
-        void turnVoiceOff(unsigned short voiceNumber);
-
-        /**
-        * Acquires the new rendering sequence and voice assignments from the given
-        * ConnectionRequest, as well as the increment vector. The request passed as
-        * argument must be valid, as this method will perform no validity check and
-        * take the ConnectionRequest's results from granted. This method uses move
-        * semantics, so it will take ownership of the vectors contained in the
-        * ConnectionRequest passed as argument. This method must only be called by
-        * the real-time thread.
-        * @param[in] request The ConnectionRequest to take the results from. It
-        *   should be a valid ConnectionRequest, i.e. it should respect the two
-        *   properties defined in the structure definition (the rendering sequence,
-        *   voice assignments and one increment vectors must all be of the same size
-        *   and must all be non empty).
-        */
-        void processConnectionRequest(ConnectionRequest& request);
-
-    private:
-
-        /**
-        * Recomputes the Renderer's increments after a Voice has been turned on or
-        * off, or after a ConnectionRequest has been processed. This method is fast,
-        * as it will be called by the real-time thread.
-        */
-        void updateIncrements();
-
-        /**
-        * Boolean flag which signals when the rendering sequence and voice
-        * assignments are valid, i.e. when they are both non-empty and of the same
-        * size. It is initialized to false, and the Renderer expects an empty
-        * ConnectionRequest to start up. Once set to true, this boolean will never
-        * be set to false again, as only valid connection requests will be accepted.
-        */
-        bool m_isReadyToRender;
-
-        /**
-        * The current rendering sequence used by the renderer. It should always be
-        * of the same length as m_voiceAssignments and m_increments.
-        */
-        std::vector<std::shared_ptr<Worker>> m_renderingSequence;
-
-        /**
-        * The voice assignments corresponding to each Worker in the current
-        * rendering sequence. It should always be of the same length as
-        * m_renderingSequence and m_increments.
-        */
-        std::vector<VoiceAssignment> m_voiceAssignments;
-
-        /**
-        * Position to start from in the rendering sequence. This may vary depending
-        * on which Voice is on and off, and depending on the Workflow's connections.
-        */
-        uint32_t m_start;
-
-        /**
-        * Jumps to perform in the rendering sequence, in order to avoid Workers that
-        * should not be called. It should always be of the same length as
-        * m_renderingSequence and m_voiceAssignments.
-        */
-        std::vector<uint32_t> m_increments;
-
-        /** Tracks the on/off status of every Voice */
-        bool m_voiceIsOn[ANGLECORE_NUM_VOICES];
-
-        /**
-        * Flag that indicates whether to recompute the increments or not in the next
-        * rendering session. This flag is useful for preventing the Renderer from
-        * updating its increments twice, after a Voice has been turned on or off and
-        * a new ConnectionRequest has been received.
-        */
-        bool m_shouldUpdateIncrements;
-    };
-
-
-
-    /*
-    =================================================
-    Master
-    =================================================
-    */
-
-    /**
-    * \struct MIDIMessage MIDIBuffer.h
-    * Represents a MIDI message supported by the Master object.
-    */
-    struct MIDIMessage
-    {
-        /** Types of MIDI messages supported by the Master object */
-        enum Type
-        {
-            NONE = 0,       /**< MIDI Messages of this type will be ignored */
-            NOTE_ON,
-            NOTE_OFF,
-            ALL_NOTES_OFF,
-            ALL_SOUND_OFF,
-            NUM_TYPES
-        };
-
-        /** Type of MIDI message */
-        Type type;
-
-        /**
-        * Timestamp of the message as a sample position within the current audio
-        * buffer
-        */
-        uint32_t timestamp;
-
-        unsigned char noteNumber;
-        unsigned char noteVelocity;
-
-        /**
-        * Creates a MIDI message of type NONE, and initializes every attribute to
-        * their default value.
+        * Creates a Master whose Renderer renders every Worker sequentially on the
+        * real-time thread.
         */
-        MIDIMessage();
-    };
-
-    /**
-    * \class MIDIBuffer MIDIBuffer.h
-    * Buffer of MIDI messages.
-    */
-    class MIDIBuffer
-    {
-    public:
-
-        /** Creates a MIDI buffer of fixed size */
-        MIDIBuffer();
+        Master();
 
         /**
-        * Returns the number of MIDI messages contained in the buffer. This will be
-        * different from the buffer's capacity.
+        * Creates a Master whose Renderer uses the given RenderingMode.
+        * @param[in] renderingMode The RenderingMode of the Master's Renderer.
+        * @param[in] numHelperThreads Number of threads the Renderer should spawn to
+        *   help the real-time thread. This parameter is ignored in SEQUENTIAL mode.
         */
-        uint32_t getNumMIDIMessages() const;
+        Master(Renderer::RenderingMode renderingMode, unsigned short numHelperThreads);
 
         /**
-        * Adds a new empty MIDIMessage at the end of the buffer, and returns a
-        * reference to it.
+        * Creates a Master whose Renderer uses the given RenderingMode, and whose
+        * streams hold the given number of samples. The audio blocks are rendered in
+        * chunks of that size, so a small size suits low-latency rendering, while a
+        * large one reduces the overhead of each rendering session for offline
+        * rendering.
+        * @param[in] renderingMode The RenderingMode of the Master's Renderer.
+        * @param[in] numHelperThreads Number of threads the Renderer should spawn to
+        *   help the real-time thread. This parameter is ignored in SEQUENTIAL mode.
+        * @param[in] streamSize Number of samples in each Stream. Values lower than
+        *   one are replaced by one.
         */
-        MIDIMessage& pushBackNewMIDIMessage();
-
-        /** Removes every MIDIMessage from the buffer. */
-        void clear();
+        Master(Renderer::RenderingMode renderingMode, unsigned short numHelperThreads, unsigned int streamSize);
 
         /**
-        * Provides a read an write access to the MIDI messages.
-        * @param[in] index Position of the MIDIMessage to retrieve from the buffer.
-        *   It should be in-range, as it will not be checked at runtime.
+        * Returns the number of samples in each Stream of the Master, which is the
+        * size of the chunks the audio blocks are rendered in.
         */
-        MIDIMessage& operator[](uint32_t index);
-
-    private:
-        uint32_t m_capacity;
-        std::vector<MIDIMessage> m_messages;
-        uint32_t m_numMessages;
-    };
-
-    /**
-    * \class Master Master.h
-    * The Master orchestrates the rendering and the interaction with the end-user
-    * requests. It should be the only entry point from outside when developping an
-    * ANGLECORE-based application.
-    */
-    class Master
-    {
-    public:
-        Master();
+        unsigned int getStreamSize() const;
 
         /**
         * Sets the sample rate of the Master's AudioWorkflow.
@@ -2871,11 +5746,41 @@ namespace ANGLECORE
         */
         MIDIMessage& pushBackNewMIDIMessage();
 
+        /**
+        * Clears the Master's internal ParameterEventBuffer to prepare for rendering
+        * the next audio block.
+        */
+        void clearParameterEventsForNextAudioBlock();
+
+        /**
+        * Adds a new ParameterEvent at the end of the Master's internal
+        * ParameterEventBuffer, and returns a reference to it. Each event changes
+        * the value of a Parameter at the sample given by its timestamp, even in
+        * the middle of a rendering session, so that automation is sample-accurate.
+        * Unlike MIDI messages, parameter events do not split the audio block into
+        * more rendering sessions, and they can be pushed in any order. This method
+        * should only be called by the real-time thread, right before calling the
+        * renderNextAudioBlock() method.
+        */
+        ParameterEvent& pushBackNewParameterEvent();
+
+        /**
+        * Returns the number of ParameterEvents that were dropped during the last
+        * call to renderNextAudioBlock(), either because their timestamp was out of
+        * the audio block, because their handle was invalid or stale, or because
+        * their Parameter already had ANGLECORE_PARAMETER_MAX_NUM_SCHEDULED_CHANGES
+        * changes waiting to be rendered. This method should only be called by the
+        * real-time thread, after calling renderNextAudioBlock().
+        */
+        uint32_t getNumDroppedParameterEvents() const;
+
         /**
         * Requests the Master to change one Parameter's value within the Instrument
         * positioned at the rack number \p rackNumber. Note that this does not mean
         * the request will take effect immediately: the Master will post the request
         * to the real-time thread to be taken care of in the next rendering session.
+        * Several threads can call this method at the same time, as the parameter
+        * registers are looked up without locking them.
         * @param[in] rackNumber The Instrument's rack number. If this number is not
         *   valid, this method will have no effect.
         * @param[in] parameterIdentifier The Parameter's identifier. This can be
@@ -2887,6 +5792,34 @@ namespace ANGLECORE
         */
         void setParameterValue(unsigned short rackNumber, StringView parameterIdentifier, floating_type newParameterValue);
 
+        /**
+        * Returns a ParameterHandle corresponding to the given Parameter, which can
+        * then be passed to setParameterValue() instead of the Parameter's
+        * identifier, to avoid searching for the Parameter on each call. The
+        * handle remains valid as long as the Parameter stays registered at the
+        * same slot, regardless of the changes made to the other parameters. Once
+        * the Parameter is replaced by another one, the handle becomes stale, and
+        * setParameterValue() ignores it, so a new handle should be retrieved.
+        * This method can be called by any thread.
+        * @param[in] rackNumber The Instrument's rack number.
+        * @param[in] parameterIdentifier The Parameter's identifier. If this
+        *   parameter does not correspond to any parameter of the Instrument located
+        *   at \p rackNumber, or if the rack number is not valid, then this method
+        *   will return an invalid handle.
+        */
+        ParameterHandle getParameterHandle(unsigned short rackNumber, StringView parameterIdentifier) const;
+
+        /**
+        * Requests the Master to change the value of the Parameter identified by
+        * the given \p handle, just like the other overload of this method does,
+        * but without searching for the Parameter by its identifier.
+        * @param[in] handle The Parameter's handle. If it is invalid, stale, or if
+        *   it does not correspond to any Parameter, this method will have no
+        *   effect.
+        * @param[in] newParameterValue The Parameter's new value.
+        */
+        void setParameterValue(ParameterHandle handle, floating_type newParameterValue);
+
         /**
         * Renders the next audio block, using the internal MIDIBuffer as a source
         * of MIDI messages, and the provided parameters for computing and exporting
@@ -2904,6 +5837,20 @@ namespace ANGLECORE
         */
         void renderNextAudioBlock(export_type** audioBlockToGenerate, unsigned short numChannels, uint32_t numSamples);
 
+        /**
+        * Renders the next audio block just like the method above, but into a
+        * buffer of any layout, such as the interleaved integer buffer of an audio
+        * device or a network stream. The samples are converted while being
+        * exported, so they are written directly into the given buffer without any
+        * intermediate copy.
+        * @param[in] audioBlockToGenerate The memory location that will be used to
+        *   output the audio data generated by the Renderer, along with its layout.
+        *   It should hold at least \p numSamples frames.
+        * @param[in] numSamples The number of samples to generate and write into
+        *   each channel of \p audioBlockToGenerate.
+        */
+        void renderNextAudioBlock(const ExportBuffer& audioBlockToGenerate, uint32_t numSamples);
+
         /**
         * Requests the Master to add an Instrument of the given type to the
         * AudioWorkflow. The type given as a template parameter must be a class that
@@ -2961,6 +5908,56 @@ namespace ANGLECORE
         template<class InstrumentType>
         void addInstrument(AddInstrumentListener<InstrumentType>* listener);
 
+        /**
+        * Returns the LoadMonitor that measures how much of each audio block's
+        * duration the Master spends rendering it. Its measurements can be read,
+        * and its budget changed, from any thread.
+        */
+        LoadMonitor& getLoadMonitor();
+
+        /**
+        * Returns the VoiceLimiter that lowers the polyphony when the DSP load
+        * approaches the LoadMonitor's budget. Its Policy is DISABLED by default,
+        * and can be changed from any thread.
+        */
+        VoiceLimiter& getVoiceLimiter();
+
+#if ANGLECORE_ENABLE_PROFILING
+        /**
+        * Copies the time measurements of the Renderer's last rendering session
+        * into \p profile, so that one can identify which Worker takes the most
+        * time. Returns true if a new session has been profiled since the last
+        * call, and false otherwise. This method is only available if
+        * ANGLECORE_ENABLE_PROFILING is set to 1. It is thread-safe and never
+        * blocks the real-time thread, but it should not be called by the
+        * real-time thread itself. Note that RenderProfile is a large structure,
+        * which should preferably be allocated on the heap.
+        * @param[out] profile The RenderProfile to copy the measurements into.
+        */
+        bool getRenderProfile(RenderProfile& profile);
+#endif
+
+#if ANGLECORE_ENABLE_TRACING
+        /**
+        * Starts recording the rendering sessions, the calls to every Worker and
+        * the Master's own processing into a trace file, which can be opened in
+        * Chrome's "about:tracing" page or in Perfetto. Returns true if the file
+        * could be opened, and false otherwise. This method is only available if
+        * ANGLECORE_ENABLE_TRACING is set to 1, and should not be called by the
+        * real-time thread.
+        * @param[in] filePath Path of the trace file to create. Any existing file
+        *   at this location is overwritten.
+        */
+        bool startTracing(const char* filePath);
+
+        /**
+        * Stops recording, and completes the trace file. This method is only
+        * available if ANGLECORE_ENABLE_TRACING is set to 1, and should not be
+        * called by the real-time thread.
+        */
+        void stopTracing();
+#endif
+
     protected:
 
         /**
@@ -2981,26 +5978,52 @@ namespace ANGLECORE
         * method is the one that guarantees the Renderer only receives a valid
         * number of samples to render.
         * @param[in] audioBlockToGenerate The memory location that will be used to
-        *   output the audio data generated by the Renderer. This should correspond
-        *   to an audio buffer of at least \p numChannels audio channels and \p
-        *   numSamples audio samples.
-        * @param[in] numChannels The number of channels available at the memory
-        *   location \p audioBlockToGenerate. Note that ANGLECORE's engine may
-        *   generate more channels than this number, and eventually merge them all
-        *   to match that number.
+        *   output the audio data generated by the Renderer, along with its layout.
+        *   It should hold at least \p startSample + \p numSamples frames.
         * @param[in] numSamples The number of samples to generate and write into
         *   \p audioBlockToGenerate.
         * @param[in] startSample The position within the \p audioBlockToGenerate to
         *   start writing from.
         */
-        void splitAndRenderNextAudioBlock(export_type** audioBlockToGenerate, unsigned short numChannels, uint32_t numSamples, uint32_t startSample);
+        void splitAndRenderNextAudioBlock(const ExportBuffer& audioBlockToGenerate, uint32_t numSamples, uint32_t startSample);
+
+        /**
+        * Sends a ParameterChangeRequest to the given ParameterGenerator, so that
+        * its Parameter instantly changes to \p newParameterValue.
+        * @param[in] generator The Parameter's generator.
+        * @param[in] newParameterValue The Parameter's new value.
+        */
+        void postParameterChange(ParameterGenerator& generator, floating_type newParameterValue);
 
         /** Processes the requests received in its internal queues. */
         void processRequests();
 
+        /**
+        * Schedules the events of the ParameterEventBuffer into the corresponding
+        * parameter generators. Events that are out of the audio block, that refer
+        * to a Parameter that does not exist, or that cannot be scheduled, are
+        * dropped and counted (see getNumDroppedParameterEvents()).
+        * @param[in] numSamples The number of samples in the audio block.
+        */
+        void dispatchParameterEvents(uint32_t numSamples);
+
         /** Processes the given MIDIMessage. */
         void processMIDIMessage(const MIDIMessage& message);
 
+        /**
+        * Stops the given Voice, and starts tracking its tail so that it can be
+        * turned off once the tail is over.
+        * @param[in] voiceNumber The Voice to stop. It must be on.
+        */
+        void releaseVoice(unsigned short voiceNumber);
+
+        /**
+        * Returns the number of the Voice that started playing its note first,
+        * among the voices that are on and not stopping yet, or
+        * ANGLECORE_NUM_VOICES if there is no such Voice.
+        */
+        unsigned short findOldestPlayingVoice() const;
+
         /**
         * Updates the Master's internal stop trackers corresponding to each Voice,
         * after \p numSamples were rendered. This method detects if it is necessary
@@ -3011,12 +6034,32 @@ namespace ANGLECORE
         void updateStopTrackersAfterRendering(uint32_t numSamples);
 
     private:
+#if ANGLECORE_ENABLE_TRACING
+        /*
+        * The Tracer is declared before the Renderer, so that it outlives the
+        * Renderer and its helper threads.
+        */
+        Tracer m_tracer;
+#endif
         AudioWorkflow m_audioWorkflow;
         Renderer m_renderer;
         MIDIBuffer m_midiBuffer;
+        ParameterEventBuffer m_parameterEventBuffer;
+        uint32_t m_numDroppedParameterEvents;
+        LoadMonitor m_loadMonitor;
+        VoiceLimiter m_voiceLimiter;
+        unsigned short m_numActiveVoices;
         RequestManager m_requestManager;
         bool m_voiceIsStopping[ANGLECORE_NUM_VOICES];
         StopTracker m_stopTrackers[ANGLECORE_NUM_VOICES];
+        bool m_voiceIsOn[ANGLECORE_NUM_VOICES];
+
+        /*
+        * Number of notes started so far, used to order the voices by age for
+        * voice stealing.
+        */
+        uint64_t m_numNotesStarted;
+        uint64_t m_voiceStartOrders[ANGLECORE_NUM_VOICES];
     };
 
     template<class InstrumentType>
@@ -28,7 +28,15 @@
 * =====================================================================
 */
 
-#define ANGLECORE_PRECISION double          /**< Defines the precision of ANGLECORE's calculations as either single or double. It should equal float or double. Note that one can still use double precision within the workers of an AudioWorkflow if this is set to float. */
+#ifndef ANGLECORE_PRECISION
+#define ANGLECORE_PRECISION double          /**< Defines the precision of ANGLECORE's calculations as either single or double. It should equal float or double. Single precision doubles the number of samples each SIMD instruction processes in the workers. Note that one can still use double precision within the workers of an AudioWorkflow if this is set to float. This is a build-time choice for the whole engine: every Stream holds samples of this type, and there is neither a runtime switch between a float and a double engine, nor a way to request double-precision streams for some workers only. This can also be defined from the compiler's command line. */
+#endif
+#ifndef ANGLECORE_ACCUMULATION_PRECISION
+#define ANGLECORE_ACCUMULATION_PRECISION double     /**< Defines the precision the Mixer sums the instruments' outputs with. It should equal float or double. Keeping it to double while ANGLECORE_PRECISION is float avoids the rounding errors that accumulate when many voices are mixed together. Like ANGLECORE_PRECISION, it is fixed at build time and cannot be changed at runtime. This can also be defined from the compiler's command line. */
+#endif
+#define ANGLECORE_MIXER_CHUNK_SIZE 256      /**< Number of samples the Mixer sums at once when ANGLECORE_ACCUMULATION_PRECISION differs from ANGLECORE_PRECISION, using a buffer of that size on the stack. */
+#define ANGLECORE_MIXER_INPUTS_PER_PASS 4  /**< Maximum number of input streams the Mixer adds together before storing the result into its output stream. Higher values reduce the memory traffic on the output stream, but need more registers. */
+#define ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE 16  /**< Number of samples of a multiplicative Parameter transient computed from the same base value, each by multiplying it with a precomputed power of the transient's increment. */
 #define ANGLECORE_EXPORT_TYPE float          /**< Defines the precision of ANGLECORE's export samples as either single or double. It should equal float or double. Note that one can still use double precision in an AudioWorkflow if this is set to float. */
 
 /*
@@ -37,9 +45,53 @@
 * =====================================================================
 */
 
-#define ANGLECORE_FIXED_STREAM_SIZE 512    /**< Fixed size to use for rendering (the rendering will be splitted into chunks of this size). */
+#define ANGLECORE_DEFAULT_STREAM_SIZE 512  /**< Default size of the streams, used by the Master unless another size is given upon construction (the rendering will be splitted into chunks of this size). */
 #define ANGLECORE_NUM_VOICES 32
 #define ANGLECORE_MIDIBUFFER_SIZE 2048     /**< Maximum number of MIDI messages the engine can handle without resizing. */
+#define ANGLECORE_PARAMETER_EVENT_BUFFER_SIZE 1024  /**< Maximum number of timestamped parameter events the engine can handle in one audio block without resizing. */
+#define ANGLECORE_PARAMETER_MAX_NUM_SCHEDULED_CHANGES 64   /**< Maximum number of timestamped changes each ParameterGenerator can hold before rendering them. Further changes are dropped until the pending ones have been rendered. */
+#define ANGLECORE_RENDERER_SPIN_COUNT 1024   /**< Number of times a thread of the Renderer looks for something to render, or for the other threads to finish, before it stops spinning. Helper threads then sleep until the next rendering session, while the real-time thread yields the CPU between its checks. */
+#define ANGLECORE_RENDERER_MAX_PAUSES 64   /**< Maximum number of pause instructions a spinning thread of the Renderer executes between two attempts. The number doubles after each fruitless attempt until it reaches this value. */
+#define ANGLECORE_RENDERER_MAX_NUM_TASKS 16384  /**< Maximum number of workers the Renderer can schedule in DEPENDENCY_PARALLEL mode. It must be a power of two. Longer rendering sequences are rendered with a fallback mode. */
+#define ANGLECORE_CACHE_LINE_SIZE 64      /**< Size of a CPU cache line, in bytes, used to align the data accessed by the real-time thread. It must be a power of two. */
+#define ANGLECORE_STREAM_ARENA_SLAB_SIZE 2097152   /**< Size of each memory block the StreamArena allocates stream buffers from, in bytes. It must be a power of two, and should be a multiple of the system's huge page size (2 MiB on most platforms). Slabs are aligned on this size, so that each of them can be backed by whole huge pages, and enlarged to a multiple of it if needed to hold at least one stream buffer. */
+
+/*
+* =====================================================================
+* PROFILING
+* =====================================================================
+*/
+
+#ifndef ANGLECORE_ENABLE_PROFILING
+#define ANGLECORE_ENABLE_PROFILING 0        /**< Set to 1 to measure the time spent by the Renderer in each Worker. When set to 0, the profiling code is not compiled at all. This can also be defined from the compiler's command line. */
+#endif
+#define ANGLECORE_PROFILER_MAX_NUM_WORKERS 4096     /**< Maximum number of workers the profiler can keep track of. Workers beyond this limit in the rendering sequence are not measured. */
+
+#ifndef ANGLECORE_ENABLE_TRACING
+#define ANGLECORE_ENABLE_TRACING 0          /**< Set to 1 to be able to record the rendering sessions into a Chrome trace file (see Master::startTracing()). When set to 0, the tracing code is not compiled at all. This can also be defined from the compiler's command line. */
+#endif
+#define ANGLECORE_TRACER_QUEUE_SIZE 16384   /**< Maximum number of trace events each thread can hold before they are written to the trace file. Events are dropped when this limit is reached. */
+#define ANGLECORE_TRACER_DRAINING_PERIOD 10 /**< Time between two writings of the trace events into the trace file, in milliseconds. */
+
+/*
+* =====================================================================
+* LOAD MONITORING
+* =====================================================================
+*/
+
+#define ANGLECORE_LOAD_MONITOR_DEFAULT_BUDGET 0.8       /**< Default fraction of an audio block's duration the Master may spend rendering it. Blocks that take longer are counted as overruns. */
+#define ANGLECORE_LOAD_MONITOR_SMOOTHING_TIME 0.3       /**< Time constant of the smoothing applied to the DSP load, in seconds. */
+#define ANGLECORE_VOICE_LIMITER_SMOOTHING 0.05         /**< Weight given to each new audio block when the VoiceLimiter updates its estimates of the DSP load per voice. It should be between 0 and 1. */
+
+/*
+* =====================================================================
+* DEBUGGING
+* =====================================================================
+*/
+
+#ifndef ANGLECORE_ENABLE_REALTIME_GUARD
+#define ANGLECORE_ENABLE_REALTIME_GUARD 0   /**< Set to 1 in debug builds to report every memory allocation, deallocation and blocking lock performed by a real-time thread (see RealtimeThreadScope). This replaces the global operator new and operator delete. When set to 0, the guard is not compiled at all. This can also be defined from the compiler's command line. */
+#endif
 
 
 
@@ -53,4 +105,5 @@ namespace ANGLECORE
 {
     typedef ANGLECORE_PRECISION floating_type;
     typedef ANGLECORE_EXPORT_TYPE export_type;
+    typedef ANGLECORE_ACCUMULATION_PRECISION accumulation_type;
 }
\ No newline at end of file
@@ -21,6 +21,8 @@
 **********************************************************************/
 
 #include <algorithm>
+#include <unordered_map>
+#include <utility>
 
 #include "AudioWorkflow.h"
 
@@ -29,16 +31,33 @@
 
 namespace ANGLECORE
 {
-    AudioWorkflow::AudioWorkflow() :
-        Workflow(),
+    AudioWorkflow::AudioWorkflow(unsigned int streamSize, bool shareInstrumentOutputs) :
+        Workflow(streamSize),
         VoiceAssigner(),
         Lockable(),
         m_exporter(std::make_shared<Exporter>()),
-        m_mixer(std::make_shared<Mixer>())
+        m_mixer(std::make_shared<Mixer>(ANGLECORE_NUM_VOICES, 1)),
+        m_globalContext(getStreamArena()),
+        m_sharesInstrumentOutputs(shareInstrumentOutputs)
     {
+        /*
+        * We reserve the buffers of every Stream created below at once, so that the
+        * StreamArena allocates them in as few slabs as possible. Each Voice has
+        * three context streams and one submix input Stream per rack and channel,
+        * the Mixer has one input Stream per Voice and channel, and the Exporter
+        * has one per channel. When the instruments' outputs are shared, only the
+        * first Voice's submix input streams have their own buffer.
+        */
+        const unsigned int numVoicesWithOwnSubmixInputs = m_sharesInstrumentOutputs ? 1 : ANGLECORE_NUM_VOICES;
+        getStreamArena().reserve(m_mixer->getNumInputs() + numVoicesWithOwnSubmixInputs * ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE * ANGLECORE_NUM_CHANNELS + ANGLECORE_NUM_CHANNELS + 3 * ANGLECORE_NUM_VOICES);
+
+        m_voices.reserve(ANGLECORE_NUM_VOICES);
+        for (unsigned short v = 0; v < ANGLECORE_NUM_VOICES; v++)
+            m_voices.emplace_back(getStreamArena());
+
         /*
         * ===================================
-        * STEP 1/3: MIXER AND EXPORTER
+        * STEP 1/4: MIXER AND EXPORTER
         * ===================================
         */
 
@@ -49,7 +68,7 @@ namespace ANGLECORE
         /* We connect the mixer into the exporter */
         for (unsigned short c = 0; c < ANGLECORE_NUM_CHANNELS; c++)
         {
-            std::shared_ptr<Stream> exporterInputStream = std::make_shared<Stream>();
+            std::shared_ptr<Stream> exporterInputStream = std::make_shared<Stream>(getStreamArena());
             addStream(exporterInputStream);
 
             plugStreamIntoWorker(exporterInputStream->id, m_exporter->id, c);
@@ -57,20 +76,80 @@ namespace ANGLECORE
         }
 
         /*
-        * We prepare all of the Mixer's input streams, so that the memory is already
-        * allocated, and the streams do not need to be created and destroyed
-        * repeatedly, which would have unnecessarily consumed ID numbers.
+        * The Mixer only has one rack per Voice, which contains the Voice's submix,
+        * so that rack is always activated.
+        */
+        m_mixer->activateRack(0);
+
+        /*
+        * Since no Worker stands between the Mixer and the Exporter, the Mixer can
+        * export its mix by itself.
+        */
+        setFusedExport(true);
+
+        /*
+        * ===================================
+        * STEP 2/4: SUBMIXERS
+        * ===================================
+        */
+
+        /*
+        * Each Voice's submixer belongs to the Voice, so that it is rendered along
+        * with the Voice's instruments, and its output streams are mixed into the
+        * Mixer.
         */
-        for (unsigned short i = 0; i < m_mixer->getNumInputs(); i++)
+        std::vector<std::shared_ptr<Stream>> firstSubmixerInputStreams;
+        for (unsigned short v = 0; v < ANGLECORE_NUM_VOICES; v++)
         {
-            std::shared_ptr<Stream> mixerInputStream = std::make_shared<Stream>();
-            addStream(mixerInputStream);
-            plugStreamIntoWorker(mixerInputStream->id, m_mixer->id, i);
+            const std::shared_ptr<Mixer>& submixer = m_voices[v].submixer;
+            addWorker(submixer);
+            assignVoiceToWorker(v, submixer->id);
+
+            for (unsigned short c = 0; c < ANGLECORE_NUM_CHANNELS; c++)
+            {
+                std::shared_ptr<Stream> submixStream = std::make_shared<Stream>(getStreamArena());
+                addStream(submixStream);
+
+                plugStreamIntoWorker(submixStream->id, m_mixer->id, v * ANGLECORE_NUM_CHANNELS + c);
+                plugWorkerIntoStream(submixer->id, c, submixStream->id);
+            }
+
+            /*
+            * We prepare all of the submixer's input streams, so that the memory is
+            * already allocated, and the streams do not need to be created and
+            * destroyed repeatedly, which would have unnecessarily consumed ID
+            * numbers.
+            */
+            for (unsigned short i = 0; i < submixer->getNumInputs(); i++)
+            {
+                /*
+                * If the voices are always rendered one after the other, then the
+                * instruments' outputs of a Voice are no longer needed once its
+                * submixer has run, so the next Voice can write into the same
+                * buffers. This holds whether or not the rendering sequence is
+                * split by voice, since a Voice's instruments only depend on
+                * workers that belong to no Voice or to the same Voice, and are
+                * therefore always placed right before their submixer. In that
+                * case, every Voice uses the buffers of the first Voice's submix
+                * input streams.
+                */
+                std::shared_ptr<Stream> submixerInputStream;
+                if (m_sharesInstrumentOutputs && v > 0)
+                    submixerInputStream = std::make_shared<Stream>(firstSubmixerInputStreams[i]);
+                else
+                    submixerInputStream = std::make_shared<Stream>(getStreamArena());
+
+                if (m_sharesInstrumentOutputs && v == 0)
+                    firstSubmixerInputStreams.push_back(submixerInputStream);
+
+                addStream(submixerInputStream);
+                plugStreamIntoWorker(submixerInputStream->id, submixer->id, i);
+            }
         }
 
         /*
         * ===================================
-        * STEP 2/3: GLOBAL CONTEXT
+        * STEP 3/4: GLOBAL CONTEXT
         * ===================================
         */
 
@@ -80,7 +159,7 @@ namespace ANGLECORE
 
         /*
         * ===================================
-        * STEP 3/3: VOICE CONTEXTS
+        * STEP 4/4: VOICE CONTEXTS
         * ===================================
         */
 
@@ -124,16 +203,129 @@ namespace ANGLECORE
         m_globalContext.setSampleRate(sampleRate);
     }
 
-    std::vector<std::shared_ptr<Worker>> AudioWorkflow::buildRenderingSequence(const ConnectionPlan& connectionPlan) const
+    void AudioWorkflow::setMixerInstructionSet(MixerKernels::InstructionSet instructionSet)
+    {
+        m_mixer->setInstructionSet(instructionSet);
+        for (Voice& voice : m_voices)
+            voice.submixer->setInstructionSet(instructionSet);
+    }
+
+    floating_type AudioWorkflow::getSampleRate() const
+    {
+        return m_globalContext.getSampleRate();
+    }
+
+    std::vector<std::shared_ptr<Worker>> AudioWorkflow::buildRenderingSequence(const ConnectionPlan& connectionPlan, bool& isSplittableByVoice) const
     {
         std::vector<std::shared_ptr<Worker>> renderingSequence;
         completeRenderingSequenceForWorker(m_exporter, connectionPlan, renderingSequence);
-        return renderingSequence;
+
+        /*
+        * The rendering sequence computed above is a valid order of execution, but
+        * the workers of the different voices are interleaved within it. We now try
+        * to group them by voice, so that each voice corresponds to one contiguous
+        * segment of the sequence, which can then be rendered independently.
+        */
+        std::vector<VoiceAssignment> voiceAssignments = getVoiceAssignments(renderingSequence);
+
+        /*
+        * We classify each worker into one of three groups: HEAD for the workers
+        * that are not assigned to any voice and do not depend on any voice, VOICE
+        * for the workers assigned to a voice, and TAIL for the workers that are not
+        * assigned to any voice but depend on at least one voice.
+        */
+        enum WorkerGroup { HEAD = 0, VOICE, TAIL };
+
+        std::unordered_map<uint32_t, std::pair<WorkerGroup, unsigned short>> groups;
+        std::vector<std::vector<std::shared_ptr<Worker>>> voiceSegments(ANGLECORE_NUM_VOICES);
+        std::vector<std::shared_ptr<Worker>> head;
+        std::vector<std::shared_ptr<Worker>> tail;
+
+        /*
+        * Since the rendering sequence is already a valid order of execution, every
+        * worker is visited after all the workers it depends on, so a single pass
+        * is enough to classify them all.
+        */
+        for (uint32_t i = 0; i < renderingSequence.size(); i++)
+        {
+            const std::shared_ptr<Worker>& worker = renderingSequence[i];
+            const VoiceAssignment& assignment = voiceAssignments[i];
+            std::vector<std::shared_ptr<Worker>> inputWorkers = findInputWorkersAfterPlan(worker, connectionPlan);
+
+            WorkerGroup group = assignment.isNull ? HEAD : VOICE;
+            for (const std::shared_ptr<Worker>& inputWorker : inputWorkers)
+            {
+                const std::pair<WorkerGroup, unsigned short>& inputGroup = groups[inputWorker->id];
+                if (assignment.isNull)
+                {
+                    /*
+                    * A worker that is not assigned to any voice moves to the tail
+                    * as soon as one of its inputs depends on a voice.
+                    */
+                    if (inputGroup.first != HEAD)
+                        group = TAIL;
+                }
+                else
+                {
+                    /*
+                    * A worker assigned to a voice may only depend on the head, or
+                    * on workers of the same voice. Otherwise, the voices are not
+                    * independent from one another, so we give up on the grouping
+                    * and return the sequence in its original order.
+                    */
+                    bool isValidInput = inputGroup.first == HEAD || (inputGroup.first == VOICE && inputGroup.second == assignment.voiceNumber);
+                    if (!isValidInput)
+                    {
+                        isSplittableByVoice = false;
+                        return renderingSequence;
+                    }
+                }
+            }
+            groups[worker->id] = std::make_pair(group, assignment.voiceNumber);
+
+            /* We then append the worker to its group, preserving the initial order */
+            switch (group)
+            {
+            case HEAD:
+                head.push_back(worker);
+                break;
+            case VOICE:
+                voiceSegments[assignment.voiceNumber].push_back(worker);
+                break;
+            case TAIL:
+                tail.push_back(worker);
+                break;
+            }
+        }
+
+        /*
+        * Once here, every voice is independent from the others, so we can
+        * concatenate the groups: the head first, then each voice segment, and
+        * finally the tail. Each group preserves the order of the initial sequence,
+        * and no group depends on a group placed after it, so the result remains a
+        * valid order of execution.
+        */
+        std::vector<std::shared_ptr<Worker>> groupedRenderingSequence;
+        groupedRenderingSequence.reserve(renderingSequence.size());
+        groupedRenderingSequence.insert(groupedRenderingSequence.end(), head.begin(), head.end());
+        for (const std::vector<std::shared_ptr<Worker>>& voiceSegment : voiceSegments)
+            groupedRenderingSequence.insert(groupedRenderingSequence.end(), voiceSegment.begin(), voiceSegment.end());
+        groupedRenderingSequence.insert(groupedRenderingSequence.end(), tail.begin(), tail.end());
+
+        isSplittableByVoice = true;
+        return groupedRenderingSequence;
+    }
+
+    void AudioWorkflow::setExporterOutput(const ExportBuffer& buffer, uint32_t startSample)
+    {
+        m_exporter->setOutputBuffer(buffer, startSample);
+        m_mixer->setOutputBuffer(buffer, startSample);
     }
 
-    void AudioWorkflow::setExporterOutput(export_type** buffer, unsigned short numChannels, uint32_t startSample)
+    void AudioWorkflow::setFusedExport(bool isFused)
     {
-        m_exporter->setOutputBuffer(buffer, numChannels, startSample);
+        m_mixer->setFusedExport(isFused);
+        m_exporter->setFusedExport(isFused);
     }
 
     unsigned short AudioWorkflow::findEmptyRack() const
@@ -201,9 +393,15 @@ namespace ANGLECORE
         * rendering pipeline.
         */
 
-        /* We loop through each parameter */
-        for (const Parameter& parameter : instrument->getParameters())
+        /*
+        * We loop through each parameter, keeping track of its position in the
+        * instrument's list of parameters, which will be its index in the register:
+        */
+        const std::vector<Parameter>& parameters = instrument->getParameters();
+        for (unsigned short parameterIndex = 0; parameterIndex < parameters.size(); parameterIndex++)
         {
+            const Parameter& parameter = parameters[parameterIndex];
+
             /*
             * We first test if the parameter generators already exist for that
             * instrument, using the content of the current parameter registration
@@ -279,7 +477,7 @@ namespace ANGLECORE
                 * Then we create a stream that will contain the output of the
                 * generator, i.e. the parameter's value:
                 */
-                std::shared_ptr<Stream> stream = std::make_shared<Stream>();
+                std::shared_ptr<Stream> stream = std::make_shared<Stream>(getStreamArena());
                 addStream(stream);
 
                 /*
@@ -298,7 +496,7 @@ namespace ANGLECORE
                 * And finally, we add a new instruction to the parameter
                 * registration plan.
                 */
-                parameterRegistrationPlan.addInstructions.emplace_back(rackNumber, parameter.identifier, generator, stream);
+                parameterRegistrationPlan.addInstructions.emplace_back(rackNumber, parameter.identifier, parameterIndex, generator, stream);
             }
         }
 
@@ -307,7 +505,7 @@ namespace ANGLECORE
         * output bus into the Mixer.
         */
         for (unsigned short c = 0; c < ANGLECORE_NUM_CHANNELS; c++)
-            connectionPlanToComplete.workerToStreamPlugInstructions.emplace_back(getMixerInputStreamID(voiceNumber, rackNumber, c), instrument->id, c);
+            connectionPlanToComplete.workerToStreamPlugInstructions.emplace_back(getSubmixerInputStreamID(voiceNumber, rackNumber, c), instrument->id, c);
     }
 
     unsigned short AudioWorkflow::findFreeVoice() const
@@ -377,11 +575,10 @@ namespace ANGLECORE
         voice.voiceContext.frequencyGenerator->setParameterValue(MIDI::getFrequencyOf(noteNumber));
 
         /*
-        * For the velocity, since it is a discrete parameter, we simply write its
-        * value into the first sample of the voice context's corresponding stream:
+        * For the velocity, since it is a discrete parameter, the voice context's
+        * corresponding stream simply holds its value as a constant:
         */
-        floating_type* velocity = voice.voiceContext.velocityStream->getDataForWriting();
-        velocity[0] = static_cast<floating_type>(noteVelocity);
+        voice.voiceContext.velocityStream->setConstant(static_cast<floating_type>(noteVelocity));
 
         /*
         * Finally, we reset every instrument located in the voice so that they get
@@ -436,7 +633,8 @@ namespace ANGLECORE
             }
         }
 
-        m_mixer->activateRack(rackNumber);
+        for (Voice& voice : m_voices)
+            voice.submixer->activateRack(rackNumber);
     }
 
     void AudioWorkflow::deactivateRack(unsigned short rackNumber)
@@ -444,7 +642,8 @@ namespace ANGLECORE
         for (unsigned short v = 0; v < ANGLECORE_NUM_VOICES; v++)
             m_voices[v].racks[rackNumber].isActivated = false;
 
-        m_mixer->deactivateRack(rackNumber);
+        for (Voice& voice : m_voices)
+            voice.submixer->deactivateRack(rackNumber);
     }
 
     uint32_t AudioWorkflow::stopVoice(unsigned short voiceNumber)
@@ -504,9 +703,13 @@ namespace ANGLECORE
         return voiceStopDuration;
     }
 
-    void AudioWorkflow::executeParameterRegistrationPlan(ParameterRegistrationPlan& plan)
+    void AudioWorkflow::prepareParameterRegistrationPlan(ParameterRegistrationPlan& plan) const
     {
-        /* We execute then given plan, starting from the remove instructions. */
+        /*
+        * We prepare the new snapshots, starting from the remove instructions. Each
+        * register that is concerned by an instruction gets its snapshot copied
+        * once, and the copy is then modified by all the instructions that follow.
+        */
 
         for (auto& instruction : plan.removeInstructions)
         {
@@ -517,30 +720,17 @@ namespace ANGLECORE
             */
             if (instruction.rackNumber < ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE)
             {
-                /*
-                * If the rack number is valid, then we access the corresponding
-                * register and remove the parameter from it. Note that we first need
-                * to retrieve the corresponding workflow items, in order to send
-                * them to the Master for later deletion.
-                */
+                std::unique_ptr<ParameterRegister::Snapshot>& snapshot = plan.snapshots[instruction.rackNumber];
+                if (!snapshot)
+                    snapshot = m_parameterRegisters[instruction.rackNumber].copySnapshot();
 
                 /*
-                * We look for the workflow items corresponding to the parameter in
-                * the register:
+                * Note that the workflow items that were registered for the
+                * parameter remain in the snapshot that is currently published. They
+                * will therefore be deleted along with it, by the non real-time
+                * thread that releases the plan.
                 */
-                ParameterRegister::Entry entry = m_parameterRegisters[instruction.rackNumber].find(instruction.parameterIdentifier);
-
-                /*
-                * And if we found them, then we send them into the method's second
-                * argument for later deletion, and we finally remove them from the
-                * register.
-                */
-                if (entry.generator && entry.stream)
-                {
-                    // TO DO: send the generator and stream to a garbage collector
-
-                    m_parameterRegisters[instruction.rackNumber].remove(instruction.parameterIdentifier);
-                }
+                snapshot->remove(instruction.parameterIdentifier);
             }
         }
 
@@ -553,14 +743,48 @@ namespace ANGLECORE
             */
             if (instruction.rackNumber < ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE && instruction.parameterGenerator && instruction.parameterStream)
             {
+                std::unique_ptr<ParameterRegister::Snapshot>& snapshot = plan.snapshots[instruction.rackNumber];
+                if (!snapshot)
+                    snapshot = m_parameterRegisters[instruction.rackNumber].copySnapshot();
+
                 /*
                 * If the instruction is valid, then we add a new entry to the
-                * corresponding register:
+                * corresponding snapshot:
                 */
                 ParameterRegister::Entry entry;
-                entry.generator = std::move(instruction.parameterGenerator);
-                entry.stream = std::move(instruction.parameterStream);
-                m_parameterRegisters[instruction.rackNumber].insert(instruction.parameterIdentifier, entry);
+                entry.generator = instruction.parameterGenerator;
+                entry.stream = instruction.parameterStream;
+                snapshot->insert(instruction.parameterIdentifier, instruction.parameterIndex, entry);
+            }
+        }
+    }
+
+    void AudioWorkflow::executeParameterRegistrationPlan(ParameterRegistrationPlan& plan)
+    {
+        /*
+        * We publish each snapshot of the plan into its register, and store the
+        * snapshot it replaces in its place, so that it is deleted later on by a
+        * non real-time thread. Releasing the unique pointer before resetting it
+        * ensures no snapshot is deleted here.
+        */
+        for (unsigned short r = 0; r < ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE; r++)
+            if (plan.snapshots[r])
+                plan.snapshots[r].reset(m_parameterRegisters[r].publish(plan.snapshots[r].release()));
+    }
+
+    void AudioWorkflow::releaseParameterRegistrationPlan(ParameterRegistrationPlan& plan)
+    {
+        /*
+        * If the plan has been executed, other threads may still be reading the
+        * snapshots it holds, so we wait for them before deleting the snapshots.
+        * Otherwise, the snapshots were never published, and waiting is harmless.
+        */
+        for (unsigned short r = 0; r < ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE; r++)
+        {
+            if (plan.snapshots[r])
+            {
+                m_parameterRegisters[r].synchronize();
+                plan.snapshots[r].reset();
             }
         }
     }
@@ -576,22 +800,55 @@ namespace ANGLECORE
         return entry.generator;
     }
 
-    uint32_t AudioWorkflow::getMixerInputStreamID(unsigned short voiceNumber, unsigned short instrumentRackNumber, unsigned short channel) const
+    ParameterHandle AudioWorkflow::getParameterHandle(unsigned short rackNumber, StringView parameterIdentifier) const
+    {
+        /*
+        * We look for the parameter's slot in the rack's register, along with the
+        * register's current generation:
+        */
+        unsigned short parameterIndex;
+        uint32_t generation;
+
+        /* If the parameter is not registered, we return an invalid handle */
+        if (!m_parameterRegisters[rackNumber].findIndex(parameterIdentifier, parameterIndex, generation))
+            return ParameterHandle();
+
+        return ParameterHandle(rackNumber, parameterIndex, generation);
+    }
+
+    std::shared_ptr<ParameterGenerator> AudioWorkflow::findParameterGenerator(ParameterHandle handle)
+    {
+        /*
+        * The handle directly gives the parameter's slot, so no identifier needs to
+        * be hashed nor compared. An out-of-range index or a stale handle results in
+        * an empty entry.
+        */
+        return m_parameterRegisters[handle.rackNumber].get(handle.parameterIndex, handle.generation).generator;
+    }
+
+    ParameterGenerator* AudioWorkflow::getParameterGenerator(ParameterHandle handle) const
+    {
+        return m_parameterRegisters[handle.rackNumber].getGenerator(handle.parameterIndex, handle.generation);
+    }
+
+    uint32_t AudioWorkflow::getSubmixerInputStreamID(unsigned short voiceNumber, unsigned short instrumentRackNumber, unsigned short channel) const
     {
         /*
         * We assume voiceNumber, instrumentRackNumber, and channel are in-range, and
-        * we compute the corresponding input port to retrieve the stream ID from.
+        * we compute the corresponding input port of the Voice's submixer to
+        * retrieve the stream ID from.
         */
-        unsigned short inputPort = voiceNumber * ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE * ANGLECORE_NUM_CHANNELS + instrumentRackNumber * ANGLECORE_NUM_CHANNELS + channel;
+        unsigned short inputPort = instrumentRackNumber * ANGLECORE_NUM_CHANNELS + channel;
 
         /*
         * Provided every input number is in-range, which we assumed, the inputPort
-        * is guaranteed to be in-range for the Mixer's input bus. So we do not need
-        * to perform any check before accessing this input bus. In addition, because
-        * all the Mixer's input streams were initialized on construction, it is also
-        * guaranteed that the Mixer's input bus does not contain any null pointer.
+        * is guaranteed to be in-range for the submixer's input bus. So we do not
+        * need to perform any check before accessing this input bus. In addition,
+        * because all the submixer's input streams were initialized on
+        * construction, it is also guaranteed that the submixer's input bus does
+        * not contain any null pointer.
         */
-        return m_mixer->getInputBus()[inputPort]->id;
+        return m_voices[voiceNumber].submixer->getInputBus()[inputPort]->id;
     }
 
     uint32_t AudioWorkflow::getSampleRateStreamID() const
@@ -37,6 +37,7 @@
 #include "GlobalContext.h"
 #include "instrument/Instrument.h"
 #include "ParameterRegister.h"
+#include "ParameterHandle.h"
 #include "ParameterRegistrationPlan.h"
 #include "parameter/ParameterGenerator.h"
 
@@ -54,8 +55,20 @@ namespace ANGLECORE
     {
     public:
 
-        /** Builds the base structure of the AudioWorkflow (Exporter, Mixer...) */
-        AudioWorkflow();
+        /**
+        * Builds the base structure of the AudioWorkflow (Exporter, Mixer...).
+        * @param[in] streamSize Number of samples in each Stream of the
+        *   AudioWorkflow, which is the maximum number of samples it can render in
+        *   one rendering session.
+        * @param[in] shareInstrumentOutputs True if the AudioWorkflow's voices will
+        *   always be rendered one after the other, in which case the instruments
+        *   of every Voice write into the same buffers, and false otherwise. Each
+        *   Voice's submixer consumes the outputs of its instruments before the
+        *   next Voice is rendered, so sharing them saves the memory of all voices
+        *   but one, and keeps the buffers warm in cache from one Voice to the
+        *   next. This must be false if the voices can be rendered in parallel.
+        */
+        AudioWorkflow(unsigned int streamSize, bool shareInstrumentOutputs);
 
         /**
         * Sets the sample rate of the AudioWorkflow.
@@ -63,23 +76,55 @@ namespace ANGLECORE
         */
         void setSampleRate(floating_type sampleRate);
 
+        /** Returns the sample rate of the AudioWorkflow, in Hz. */
+        floating_type getSampleRate() const;
+
         /**
         * Builds and returns the Workflow's rendering sequence, starting from its
-        * Exporter. This method allocates memory, so it should never be called by
-        * the real-time thread. Note that the method relies on the move semantics to
-        * optimize its vector return.
+        * Exporter. Whenever possible, the sequence is reordered into three
+        * consecutive parts: first the workers that are not assigned to any Voice
+        * and do not depend on any Voice, then the workers of each Voice grouped
+        * together by increasing voice number, and finally the workers that are not
+        * assigned to any Voice but depend on some (such as the Mixer and the
+        * Exporter). This layout allows the Renderer to render each Voice
+        * independently. This method allocates memory, so it should never be called
+        * by the real-time thread. Note that the method relies on the move semantics
+        * to optimize its vector return.
         * @param[in] connectionPlan The ConnectionPlan that will be executed next,
         *   and that should therefore be taken into account in the computation
+        * @param[out] isSplittableByVoice Will be set to true if the sequence
+        *   returned follows the layout described above, and false if some
+        *   dependencies between voices prevented the reordering, in which case the
+        *   sequence is returned in its original order.
         */
-        std::vector<std::shared_ptr<Worker>> buildRenderingSequence(const ConnectionPlan& connectionPlan) const;
+        std::vector<std::shared_ptr<Worker>> buildRenderingSequence(const ConnectionPlan& connectionPlan, bool& isSplittableByVoice) const;
+
+        /**
+        * Selects the instruction set the Mixer sums the instruments' outputs with.
+        * This method should not be called while the AudioWorkflow is rendering.
+        * @param[in] instructionSet The instruction set to use, which must be
+        *   supported by the CPU (see MixerKernels::detectInstructionSet()).
+        */
+        void setMixerInstructionSet(MixerKernels::InstructionSet instructionSet);
 
         /**
         * Set the Exporter's memory location to write into when exporting.
-        * @param[in] buffer The new memory location.
-        * @param[in] numChannels Number of output channels.
+        * @param[in] buffer The new memory location, which can be planar or
+        *   interleaved.
         * @param[in] startSample Position to start from in the buffer.
         */
-        void setExporterOutput(export_type** buffer, unsigned short numChannels, uint32_t startSample);
+        void setExporterOutput(const ExportBuffer& buffer, uint32_t startSample);
+
+        /**
+        * Enables or disables the fused export, in which the Mixer writes its mix
+        * directly into the host's buffer instead of going through the Exporter's
+        * input streams (see Mixer::setFusedExport()). The fused export is enabled
+        * by default, and must be disabled before inserting any Worker that reads
+        * the Mixer's output. This method should not be called while the
+        * AudioWorkflow is rendering.
+        * @param[in] isFused True to enable the fused export, false to disable it.
+        */
+        void setFusedExport(bool isFused);
 
         /**
         * Tries to find a Rack that is empty in all voices to insert an instrument
@@ -182,15 +227,35 @@ namespace ANGLECORE
         uint32_t stopVoice(unsigned short voiceNumber);
 
         /**
-        * Executes the given \p plan, and adds or removes entries from the
-        * AudioWorkflow's parameter registers as instructed. This method needs to be
-        * fast as it might be called by the real-time thread at the beginning of any
-        * rendering session. Note that the plan passed in as argument may be altered
-        * when executed, as the AudioWorkflow will move some shared pointers around.
-        * @param[in] plan The ParameterRegistrationPlan to execute.
+        * Turns the instructions of the given \p plan into new snapshots of the
+        * AudioWorkflow's parameter registers, by applying them to copies of the
+        * current snapshots. Removal instructions are applied first, and additions
+        * second. This method allocates memory, so it must only be called by a non
+        * real-time thread, before the plan is sent to the real-time thread.
+        * @param[in, out] plan The ParameterRegistrationPlan to prepare.
+        */
+        void prepareParameterRegistrationPlan(ParameterRegistrationPlan& plan) const;
+
+        /**
+        * Executes the given \p plan, by publishing the snapshots it contains into
+        * the AudioWorkflow's parameter registers. This method needs to be fast as
+        * it might be called by the real-time thread at the beginning of any
+        * rendering session, and it neither allocates nor frees any memory. The
+        * plan must have been prepared using prepareParameterRegistrationPlan()
+        * before. Once executed, the plan holds the snapshots that were replaced,
+        * which must be released using releaseParameterRegistrationPlan().
+        * @param[in, out] plan The ParameterRegistrationPlan to execute.
         */
         void executeParameterRegistrationPlan(ParameterRegistrationPlan& plan);
 
+        /**
+        * Deletes the snapshots held by the given \p plan, once no thread is
+        * reading them anymore. This method blocks until then, so it must only be
+        * called by a non real-time thread.
+        * @param[in, out] plan The ParameterRegistrationPlan to release.
+        */
+        void releaseParameterRegistrationPlan(ParameterRegistrationPlan& plan);
+
         /**
         * Tries to find the ParameterGenerator corresponding to the given Parameter.
         * The AudioWorkflow will search through the parameters that are registered
@@ -198,7 +263,7 @@ namespace ANGLECORE
         * found, this method will return the associated ParameterGenerator.
         * Otherwise, this method will return a null pointer. Note that the rack
         * number is expected to be in-range, as no safety check will be performed by
-        * this method.
+        * this method. This method can be called by any thread.
         * @param[in] rackNumber The Rack number. It must be in-range.
         * @param[in] parameterIdentifier The Parameter's identifier. This can be
         *   passed in as a C string, as it will be implicitely converted into a
@@ -208,17 +273,45 @@ namespace ANGLECORE
         */
         std::shared_ptr<ParameterGenerator> findParameterGenerator(unsigned short rackNumber, StringView parameterIdentifier);
 
+        /**
+        * Returns a ParameterHandle that gives direct access to the given
+        * Parameter's slot in the parameter register of \p rackNumber. If the
+        * Parameter is not registered, this method returns an invalid handle.
+        * @param[in] rackNumber The Rack number. It must be in-range.
+        * @param[in] parameterIdentifier The Parameter's identifier.
+        */
+        ParameterHandle getParameterHandle(unsigned short rackNumber, StringView parameterIdentifier) const;
+
+        /**
+        * Retrieves the ParameterGenerator located at the given \p handle, just
+        * like findParameterGenerator() does with an identifier, but by indexing the
+        * parameter register directly. If the handle does not correspond to any
+        * registered Parameter, or if it has become stale because the rack's
+        * parameters have changed since it was retrieved, this method will return a
+        * null pointer.
+        * @param[in] handle The Parameter's handle. It must be valid.
+        */
+        std::shared_ptr<ParameterGenerator> findParameterGenerator(ParameterHandle handle);
+
+        /**
+        * Retrieves the ParameterGenerator located at the given \p handle just like
+        * findParameterGenerator(), but returns a raw pointer, without copying any
+        * shared pointer. This method must only be called by the real-time thread.
+        * @param[in] handle The Parameter's handle. It must be valid.
+        */
+        ParameterGenerator* getParameterGenerator(ParameterHandle handle) const;
+
     protected:
 
         /**
-        * Retrieve the ID of the Mixer's input Stream at the provided location. Note
-        * that every parameter is expected to be in-range, and that no safety check
-        * will be performed by this method.
+        * Retrieve the ID of the input Stream of a Voice's submixer at the provided
+        * location. Note that every parameter is expected to be in-range, and that
+        * no safety check will be performed by this method.
         * @param[in] voiceNumber Voice whose workers ultimately fill in the Stream.
         * @param[in] rackNumber Rack at the end of which the Stream is located.
         * @param[in] channel Audio channel that the Stream corresponds to.
         */
-        uint32_t getMixerInputStreamID(unsigned short voiceNumber, unsigned short rackNumber, unsigned short channel) const;
+        uint32_t getSubmixerInputStreamID(unsigned short voiceNumber, unsigned short rackNumber, unsigned short channel) const;
 
         /**
         * Retrieve the ID of the Stream containing the current sample rate in the
@@ -260,8 +353,14 @@ namespace ANGLECORE
     private:
         std::shared_ptr<Exporter> m_exporter;
         std::shared_ptr<Mixer> m_mixer;
-        Voice m_voices[ANGLECORE_NUM_VOICES];
+        /**
+        * The ANGLECORE_NUM_VOICES voices of the AudioWorkflow. They are stored in a
+        * vector only because their constructor needs the StreamArena. The vector
+        * is filled upon construction and never resized afterwards.
+        */
+        std::vector<Voice> m_voices;
         GlobalContext m_globalContext;
+        const bool m_sharesInstrumentOutputs;
         ParameterRegister m_parameterRegisters[ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
     };
 }
\ No newline at end of file
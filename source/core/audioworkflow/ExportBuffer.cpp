@@ -0,0 +1,239 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ExportBuffer.h"
+
+namespace ANGLECORE
+{
+    /*
+    * Each sample format is described by a structure that tells how many units of
+    * memory a sample occupies, and how a sample is stored. The conversions are
+    * written without any branch nor library call, so that the compiler can
+    * vectorize the loops that use them.
+    */
+    namespace
+    {
+        /**
+        * Clips \p value to [-1, 1], multiplies it by \p scale and rounds the
+        * result to the nearest integer, away from zero. NaNs are clipped to 1.
+        */
+        template <typename Real, typename Integer>
+        inline Integer toInteger(Real value, Real scale)
+        {
+            value = value < static_cast<Real>(1.0) ? value : static_cast<Real>(1.0);
+            value = value > static_cast<Real>(-1.0) ? value : static_cast<Real>(-1.0);
+            value *= scale;
+            return static_cast<Integer>(value + (value < static_cast<Real>(0.0) ? static_cast<Real>(-0.5) : static_cast<Real>(0.5)));
+        }
+
+        struct Float32Format
+        {
+            typedef float unit_type;
+            static const unsigned int numUnits = 1;
+
+            static inline void store(unit_type* destination, floating_type value)
+            {
+                *destination = static_cast<float>(value);
+            }
+        };
+
+        struct Int16Format
+        {
+            typedef int16_t unit_type;
+            static const unsigned int numUnits = 1;
+
+            static inline void store(unit_type* destination, floating_type value)
+            {
+                *destination = toInteger<floating_type, int16_t>(value, static_cast<floating_type>(32767.0));
+            }
+        };
+
+        struct Int24Format
+        {
+            typedef uint8_t unit_type;
+            static const unsigned int numUnits = 3;
+
+            static inline void store(unit_type* destination, floating_type value)
+            {
+                const uint32_t sample = static_cast<uint32_t>(toInteger<floating_type, int32_t>(value, static_cast<floating_type>(8388607.0)));
+                destination[0] = static_cast<uint8_t>(sample);
+                destination[1] = static_cast<uint8_t>(sample >> 8);
+                destination[2] = static_cast<uint8_t>(sample >> 16);
+            }
+        };
+
+        struct Int32Format
+        {
+            typedef int32_t unit_type;
+            static const unsigned int numUnits = 1;
+
+            /*
+            * The scale of 32-bit integers cannot be represented in single
+            * precision, so we always convert them in double precision.
+            */
+            static inline void store(unit_type* destination, floating_type value)
+            {
+                *destination = toInteger<double, int32_t>(static_cast<double>(value), 2147483647.0);
+            }
+        };
+    }
+
+    ExportBuffer::ExportBuffer() :
+        m_channels(nullptr),
+        m_frames(nullptr),
+        m_format(FLOAT32),
+        m_numChannels(0),
+        m_frameStride(0)
+    {}
+
+    ExportBuffer::ExportBuffer(export_type** channels, unsigned short numChannels) :
+        m_channels(channels),
+        m_frames(nullptr),
+        m_format(FLOAT32),
+        m_numChannels(numChannels),
+        m_frameStride(0)
+    {}
+
+    ExportBuffer::ExportBuffer(void* frames, SampleFormat format, unsigned short numChannels, uint32_t frameStride) :
+        m_channels(nullptr),
+        m_frames(frames),
+        m_format(format),
+        m_numChannels(numChannels),
+        m_frameStride(frameStride)
+    {}
+
+    unsigned short ExportBuffer::getNumChannels() const
+    {
+        return m_numChannels;
+    }
+
+    void ExportBuffer::write(uint32_t position, unsigned int numSamples, const floating_type* const* sources, unsigned short numSources, floating_type gain) const
+    {
+        /* A planar buffer only needs one conversion loop per channel */
+        if (m_channels)
+        {
+            for (unsigned short h = 0; h < m_numChannels; h++)
+            {
+                const floating_type* source = sources[h % numSources];
+                export_type* output = m_channels[h] + position;
+                for (unsigned int s = 0; s < numSamples; s++)
+                    output[s] = static_cast<export_type>(source[s] * gain);
+            }
+            return;
+        }
+
+        switch (m_format)
+        {
+        case FLOAT32:
+            writeInterleaved<Float32Format>(position, numSamples, sources, numSources, gain);
+            break;
+        case INT16:
+            writeInterleaved<Int16Format>(position, numSamples, sources, numSources, gain);
+            break;
+        case INT24:
+            writeInterleaved<Int24Format>(position, numSamples, sources, numSources, gain);
+            break;
+        case INT32:
+            writeInterleaved<Int32Format>(position, numSamples, sources, numSources, gain);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void ExportBuffer::clear(uint32_t position, unsigned int numSamples) const
+    {
+        /*
+        * Silence is made of zeros in every supported format, so we can clear the
+        * buffer without converting anything.
+        */
+        if (m_channels)
+        {
+            for (unsigned short h = 0; h < m_numChannels; h++)
+                for (unsigned int s = 0; s < numSamples; s++)
+                    m_channels[h][position + s] = static_cast<export_type>(0.0);
+            return;
+        }
+
+        unsigned int sampleSize = 0;
+        switch (m_format)
+        {
+        case FLOAT32:
+            sampleSize = sizeof(float);
+            break;
+        case INT16:
+            sampleSize = sizeof(int16_t);
+            break;
+        case INT24:
+            sampleSize = 3;
+            break;
+        case INT32:
+            sampleSize = sizeof(int32_t);
+            break;
+        default:
+            return;
+        }
+
+        const std::size_t frameSize = static_cast<std::size_t>(m_frameStride) * sampleSize;
+        uint8_t* frame = static_cast<uint8_t*>(m_frames) + position * frameSize;
+        for (unsigned int s = 0; s < numSamples; s++, frame += frameSize)
+            for (unsigned int b = 0; b < m_numChannels * sampleSize; b++)
+                frame[b] = 0;
+    }
+
+    template <class Format>
+    void ExportBuffer::writeInterleaved(uint32_t position, unsigned int numSamples, const floating_type* const* sources, unsigned short numSources, floating_type gain) const
+    {
+        typedef typename Format::unit_type unit_type;
+        const std::size_t frameSize = static_cast<std::size_t>(m_frameStride) * Format::numUnits;
+        unit_type* frames = static_cast<unit_type*>(m_frames) + position * frameSize;
+
+        /*
+        * Tightly packed stereo frames are by far the most common layout, so we
+        * give them a dedicated loop, in which the compiler knows the stride and
+        * can interleave both channels within its SIMD registers.
+        */
+        if (m_numChannels == 2 && m_frameStride == 2)
+        {
+            const floating_type* left = sources[0];
+            const floating_type* right = sources[1 % numSources];
+            for (unsigned int s = 0; s < numSamples; s++)
+            {
+                Format::store(frames + (2 * s) * Format::numUnits, left[s] * gain);
+                Format::store(frames + (2 * s + 1) * Format::numUnits, right[s] * gain);
+            }
+            return;
+        }
+
+        /* Otherwise, we write each channel in turn, one frame after the other */
+        for (unsigned short h = 0; h < m_numChannels; h++)
+        {
+            const floating_type* source = sources[h % numSources];
+            unit_type* output = frames + h * Format::numUnits;
+            for (unsigned int s = 0; s < numSamples; s++)
+                Format::store(output + s * frameSize, source[s] * gain);
+        }
+    }
+}
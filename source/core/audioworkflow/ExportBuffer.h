@@ -0,0 +1,120 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "../../config/RenderingConfig.h"
+
+namespace ANGLECORE
+{
+    /**
+    * \class ExportBuffer ExportBuffer.h
+    * Describes the memory location the host wants an audio block to be exported
+    * into, and converts ANGLECORE's samples into that location's layout. The
+    * buffer can either be planar, with one array of export_type per channel, or
+    * interleaved, with the channels of each frame stored next to each other in
+    * one of the sample formats used by audio devices and network streams. This
+    * lets the engine write straight into the host's buffer, whatever its
+    * layout, without going through an intermediate copy.
+    */
+    class ExportBuffer
+    {
+    public:
+
+        /** Formats the samples of an interleaved buffer can be stored with */
+        enum SampleFormat
+        {
+            FLOAT32 = 0,    /**< 32-bit floating point samples, between -1 and 1 */
+            INT16,          /**< 16-bit signed integers */
+            INT24,          /**< 24-bit signed integers, packed on 3 little-endian bytes */
+            INT32,          /**< 32-bit signed integers */
+            NUM_SAMPLE_FORMATS
+        };
+
+        /**
+        * Creates an empty ExportBuffer, which has no channel. Nothing should be
+        * written into it.
+        */
+        ExportBuffer();
+
+        /**
+        * Describes a planar buffer.
+        * @param[in] channels Array of \p numChannels arrays, one per channel.
+        * @param[in] numChannels Number of channels in the buffer.
+        */
+        ExportBuffer(export_type** channels, unsigned short numChannels);
+
+        /**
+        * Describes an interleaved buffer. Integer samples are clipped to their
+        * range, and rounded to the nearest integer.
+        * @param[in] frames Memory location of the first sample of the first frame.
+        * @param[in] format Format of the samples.
+        * @param[in] numChannels Number of channels to write into each frame.
+        * @param[in] frameStride Distance between the beginning of two consecutive
+        *   frames, in samples. It must be greater than or equal to \p numChannels.
+        *   The samples of a frame that lie beyond \p numChannels are left
+        *   untouched, which allows to export into a subset of a larger frame.
+        */
+        ExportBuffer(void* frames, SampleFormat format, unsigned short numChannels, uint32_t frameStride);
+
+        /** Returns the number of channels in the buffer */
+        unsigned short getNumChannels() const;
+
+        /**
+        * Writes \p numSamples samples into each channel of the buffer, after
+        * multiplying them by \p gain. The sources are mapped onto the buffer's
+        * channels using a modulo: if there are less sources than channels, they
+        * are duplicated, which is why callers that have more sources than
+        * channels must mix them down beforehand.
+        * @param[in] position Position of the first sample to write in the buffer.
+        * @param[in] numSamples Number of samples to write into each channel.
+        * @param[in] sources Array of \p numSources arrays of \p numSamples samples.
+        * @param[in] numSources Number of arrays in \p sources. It must be positive.
+        * @param[in] gain Gain to apply before the conversion.
+        */
+        void write(uint32_t position, unsigned int numSamples, const floating_type* const* sources, unsigned short numSources, floating_type gain) const;
+
+        /**
+        * Writes \p numSamples samples of silence into each channel of the buffer.
+        * @param[in] position Position of the first sample to write in the buffer.
+        * @param[in] numSamples Number of samples to write into each channel.
+        */
+        void clear(uint32_t position, unsigned int numSamples) const;
+
+    private:
+
+        /**
+        * Writes into an interleaved buffer, using the given sample format (see
+        * write()).
+        */
+        template <class Format>
+        void writeInterleaved(uint32_t position, unsigned int numSamples, const floating_type* const* sources, unsigned short numSources, floating_type gain) const;
+
+        export_type** m_channels;
+        void* m_frames;
+        SampleFormat m_format;
+        unsigned short m_numChannels;
+        uint32_t m_frameStride;
+    };
+}
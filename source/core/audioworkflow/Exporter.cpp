@@ -20,6 +20,8 @@
 **
 **********************************************************************/
 
+#include <algorithm>
+
 #include "Exporter.h"
 
 #include "../../config/AudioConfig.h"
@@ -28,43 +30,40 @@
 namespace ANGLECORE
 {
     Exporter::Exporter() :
-        Worker(ANGLECORE_NUM_CHANNELS, 0),
-        m_outputBuffer(nullptr),
-        m_numOutputChannels(0),
-        m_numVoicesOn(0)
+        DevirtualizedWorker<Exporter>(ANGLECORE_NUM_CHANNELS, 0),
+        m_startSample(0),
+        m_numVoicesOn(0),
+        m_isExportFused(false)
     {}
 
-    void Exporter::setOutputBuffer(export_type** buffer, unsigned short numChannels, uint32_t startSample)
+    void Exporter::setOutputBuffer(const ExportBuffer& buffer, uint32_t startSample)
     {
         m_outputBuffer = buffer;
-        m_numOutputChannels = numChannels;
         m_startSample = startSample;
     }
 
     void Exporter::work(unsigned int numSamplesToWorkOn)
     {
+        /* If the Mixer exports its mix itself, then we have nothing to do */
+        if (m_isExportFused)
+            return;
+
         /*
-        * It is assumed that both m_numOutputChannels and numSamplesToWorkOn are
-        * in-range, i.e. less than or equal to the output buffer's number of
-        * channels and the stream and buffer size respectively. It is also assumed
-        * the output buffer has been properly set to a valid memory location.
+        * It is assumed that both the output buffer's number of channels and
+        * numSamplesToWorkOn are in-range, i.e. less than or equal to the number
+        * of channels the host allocated and the stream and buffer size
+        * respectively. It is also assumed the output buffer has been properly set
+        * to a valid memory location.
         */
 
         /*
         * If the number of voices that are currently on is zero, then we do not need
-        * to do any calculation: we can simply output zero.
+        * to do any calculation: we can simply output zero, without forgetting to
+        * start on the start sample provided.
         */
         if (m_numVoicesOn == 0)
         {
-            /*
-            * We fill the output buffer with zeros, without forgetting to start on
-            * the start sample provided:
-            */
-            for (unsigned short c = 0; c < m_numOutputChannels; c++)
-                for (uint32_t i = 0; i < numSamplesToWorkOn; i++)
-                    m_outputBuffer[c][i + m_startSample] = static_cast<export_type>(0.0);
-
-            /* And then we simply return here. */
+            m_outputBuffer.clear(m_startSample, numSamplesToWorkOn);
             return;
         }
 
@@ -72,43 +71,61 @@ namespace ANGLECORE
         * If we arrive here, then the number of voices currently on is greater than
         * zero, which means we have something to render.
         */
+        const floating_type gain = static_cast<floating_type>(ANGLECORE_AUDIOWORKFLOW_EXPORTER_GAIN);
+        const unsigned short numOutputChannels = m_outputBuffer.getNumChannels();
 
         /*
         * If the host requests less channels than rendered, we sum their content
-        * using a modulo approach.
+        * using a modulo approach. The sums are computed in chunks that live on the
+        * stack, and converted into the output buffer's format right away.
         */
-        if (m_numOutputChannels < ANGLECORE_NUM_CHANNELS)
+        if (numOutputChannels < ANGLECORE_NUM_CHANNELS)
         {
-            /* We first clear the output buffer */
-            for (unsigned short c = 0; c < m_numOutputChannels; c++)
-                for (uint32_t i = 0; i < numSamplesToWorkOn; i++)
-                    m_outputBuffer[c][i + m_startSample] = static_cast<export_type>(0.0);
+            floating_type sums[ANGLECORE_NUM_CHANNELS][ANGLECORE_MIXER_CHUNK_SIZE];
+            const floating_type* sources[ANGLECORE_NUM_CHANNELS];
+            for (unsigned short h = 0; h < numOutputChannels; h++)
+                sources[h] = sums[h];
 
-            /* And then we compute the sum into the output buffer */
-            for (unsigned short c = 0; c < ANGLECORE_NUM_CHANNELS; c++)
+            for (unsigned int chunkStart = 0; chunkStart < numSamplesToWorkOn; chunkStart += ANGLECORE_MIXER_CHUNK_SIZE)
             {
-                const floating_type* channel = getInputStream(c);
-                for (uint32_t i = 0; i < numSamplesToWorkOn; i++)
-                    m_outputBuffer[c % m_numOutputChannels][i + m_startSample] += static_cast<export_type>(channel[i] * static_cast<floating_type>(ANGLECORE_AUDIOWORKFLOW_EXPORTER_GAIN));
+                const unsigned int chunkSize = std::min(numSamplesToWorkOn - chunkStart, static_cast<unsigned int>(ANGLECORE_MIXER_CHUNK_SIZE));
+
+                for (unsigned short h = 0; h < numOutputChannels; h++)
+                    for (unsigned int s = 0; s < chunkSize; s++)
+                        sums[h][s] = static_cast<floating_type>(0.0);
+
+                for (unsigned short c = 0; c < ANGLECORE_NUM_CHANNELS; c++)
+                {
+                    const floating_type* channel = getInputStream(c) + chunkStart;
+                    floating_type* sum = sums[c % numOutputChannels];
+                    for (unsigned int s = 0; s < chunkSize; s++)
+                        sum[s] += channel[s];
+                }
+
+                m_outputBuffer.write(m_startSample + chunkStart, chunkSize, sources, numOutputChannels, gain);
             }
         }
 
         /*
-        * Otherwise, if we have not rendered enough channels for the host, we simply
-        * duplicate data. Note that we do not have to clear the output buffer in this
-        * case, as we write directly into it without performing any addition.
+        * Otherwise, if we have not rendered enough channels for the host, the
+        * output buffer duplicates our channels by itself, so we can directly
+        * convert our input streams.
         */
         else
         {
-            for (unsigned int c = 0; c < m_numOutputChannels; c++)
-            {
-                const floating_type* channel = getInputStream(c % ANGLECORE_NUM_CHANNELS);
-                for (uint32_t i = 0; i < numSamplesToWorkOn; i++)
-                    m_outputBuffer[c][i + m_startSample] = static_cast<export_type>(channel[i] * static_cast<floating_type>(ANGLECORE_AUDIOWORKFLOW_EXPORTER_GAIN));
-            }
+            const floating_type* sources[ANGLECORE_NUM_CHANNELS];
+            for (unsigned short c = 0; c < ANGLECORE_NUM_CHANNELS; c++)
+                sources[c] = getInputStream(c);
+
+            m_outputBuffer.write(m_startSample, numSamplesToWorkOn, sources, ANGLECORE_NUM_CHANNELS, gain);
         }
     }
 
+    void Exporter::setFusedExport(bool isFused)
+    {
+        m_isExportFused = isFused;
+    }
+
     void Exporter::incrementVoiceCount()
     {
         if (m_numVoicesOn < ANGLECORE_NUM_VOICES)
@@ -22,7 +22,8 @@
 
 #pragma once
 
-#include "workflow/Worker.h"
+#include "workflow/DevirtualizedWorker.h"
+#include "ExportBuffer.h"
 
 #include "../../config/RenderingConfig.h"
 
@@ -34,7 +35,7 @@ namespace ANGLECORE
     * to the host. An exporter applies a gain for calibrating its output level.
     */
     class Exporter :
-        public Worker
+        public DevirtualizedWorker<Exporter>
     {
     public:
 
@@ -45,11 +46,11 @@ namespace ANGLECORE
 
         /**
         * Sets the new memory location to write into when exporting.
-        * @param[in] buffer The new memory location.
-        * @param[in] numChannels Number of output channels.
+        * @param[in] buffer The new memory location, which can be planar or
+        *   interleaved.
         * @param[in] startSample Position to start from in the buffer.
         */
-        void setOutputBuffer(export_type** buffer, unsigned short numChannels, uint32_t startSample);
+        void setOutputBuffer(const ExportBuffer& buffer, uint32_t startSample);
 
         /**
         * Exports its input streams into the memory location that was given by the
@@ -76,10 +77,20 @@ namespace ANGLECORE
         */
         void decrementVoiceCount();
 
+        /**
+        * Enables or disables the fused export, in which the Mixer writes its mix
+        * directly into the host's buffer (see Mixer::setFusedExport()), and the
+        * Exporter has nothing left to do. This method should not be called while
+        * the Exporter is rendering.
+        * @param[in] isFused True to skip the Exporter's work, false to export the
+        *   input streams as usual.
+        */
+        void setFusedExport(bool isFused);
+
     private:
-        export_type** m_outputBuffer;
-        unsigned short m_numOutputChannels;
+        ExportBuffer m_outputBuffer;
         uint32_t m_startSample;
         unsigned short m_numVoicesOn;
+        bool m_isExportFused;
     };
 }
\ No newline at end of file
@@ -28,23 +28,21 @@
 
 namespace ANGLECORE
 {
-    GlobalContext::GlobalContext() :
+    GlobalContext::GlobalContext(StreamArena& streamArena) :
         m_currentSampleRate(1.0)
     {
         /*
         * We create a stream for the sample rate as well as one fore its reciprocal
         */
-        sampleRateStream = std::make_shared<Stream>();
-        sampleRateReciprocalStream = std::make_shared<Stream>();
+        sampleRateStream = std::make_shared<Stream>(streamArena);
+        sampleRateReciprocalStream = std::make_shared<Stream>(streamArena);
 
-        /* And then fill them up with an initial value of 1.0 */
-        floating_type* sampleRateRawData = sampleRateStream->getDataForWriting();
-        floating_type* sampleRateReciprocalRawData = sampleRateReciprocalStream->getDataForWriting();
-        for (unsigned int i = 0; i < ANGLECORE_FIXED_STREAM_SIZE; i++)
-        {
-            sampleRateRawData[i] = static_cast<floating_type>(1.0);
-            sampleRateReciprocalRawData[i] = static_cast<floating_type>(1.0);
-        }
+        /*
+        * And then fill them up with an initial value of 1.0. Both streams will
+        * always remain constant.
+        */
+        sampleRateStream->setConstant(static_cast<floating_type>(1.0));
+        sampleRateReciprocalStream->setConstant(static_cast<floating_type>(1.0));
     }
 
     void GlobalContext::setSampleRate(floating_type sampleRate)
@@ -62,21 +60,22 @@ namespace ANGLECORE
         if (clampedSampleRate != m_currentSampleRate)
         {
             /* We fill the sample rate stream with the new sample rate value. */
-            floating_type* sampleRateRawData = sampleRateStream->getDataForWriting();
-            for (unsigned int i = 0; i < ANGLECORE_FIXED_STREAM_SIZE; i++)
-                sampleRateRawData[i] = clampedSampleRate;
+            sampleRateStream->setConstant(clampedSampleRate);
 
             /*
             * Then we compute the reciprocal of the sample rate, and fill the
             * corresponding stream accordingly.
             */
             floating_type clampedSampleRateReciprocal = static_cast<floating_type>(1.0) / clampedSampleRate;
-            floating_type* sampleRateReciprocalRawData = sampleRateReciprocalStream->getDataForWriting();
-            for (unsigned int i = 0; i < ANGLECORE_FIXED_STREAM_SIZE; i++)
-                sampleRateReciprocalRawData[i] = clampedSampleRateReciprocal;
+            sampleRateReciprocalStream->setConstant(clampedSampleRateReciprocal);
 
             /* And finally, we update the current sample rate value */
             m_currentSampleRate = clampedSampleRate;
         }
     }
+
+    floating_type GlobalContext::getSampleRate() const
+    {
+        return m_currentSampleRate;
+    }
 }
\ No newline at end of file
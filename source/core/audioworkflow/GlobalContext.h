@@ -47,11 +47,15 @@ namespace ANGLECORE
         * a Worker to a non null pointer. Note that this method does not do any
         * connection between streams and workers, as this is the responsability of
         * the AudioWorkflow to which the GlobalContext belong.
+        * @param[in] streamArena The StreamArena to create the streams with.
         */
-        GlobalContext();
+        GlobalContext(StreamArena& streamArena);
 
         void setSampleRate(floating_type sampleRate);
 
+        /** Returns the current sample rate, in Hz. */
+        floating_type getSampleRate() const;
+
     private:
         floating_type m_currentSampleRate;
     };
@@ -20,6 +20,9 @@
 **
 **********************************************************************/
 
+#include <algorithm>
+#include <type_traits>
+
 #include "Mixer.h"
 
 #include "../../config/AudioConfig.h"
@@ -27,27 +30,60 @@
 
 namespace ANGLECORE
 {
-    Mixer::Mixer() :
-        Worker(ANGLECORE_NUM_VOICES * ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE * ANGLECORE_NUM_CHANNELS, ANGLECORE_NUM_CHANNELS),
-        m_totalNumInstruments(ANGLECORE_NUM_VOICES * ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE),
-        m_voiceStart(ANGLECORE_NUM_VOICES),
-        m_rackStart(ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE)
+    Mixer::Mixer(unsigned short numVoices, unsigned short numRacks) :
+        DevirtualizedWorker<Mixer>(numVoices * numRacks * ANGLECORE_NUM_CHANNELS, ANGLECORE_NUM_CHANNELS),
+        m_numVoices(numVoices),
+        m_numRacks(numRacks),
+        m_voiceStart(numVoices),
+        m_rackStart(numRacks),
+
+        /*
+        * The scalar summing function runs on every CPU, until the Master selects
+        * the one that best suits the CPU.
+        */
+        m_sumFunction(MixerKernels::getSumFunction(MixerKernels::SCALAR)),
+
+        m_isExportFused(false),
+        m_startSample(0)
     {
-        for (unsigned short v = 0; v < ANGLECORE_NUM_VOICES; v++)
+        for (unsigned short v = 0; v < m_numVoices; v++)
         {
-            m_voiceIncrements[v] = ANGLECORE_NUM_VOICES - v;
+            m_voiceIncrements[v] = m_numVoices - v;
             m_voiceIsOn[v] = false;
         }
 
-        for (unsigned short i = 0; i < ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE; i++)
+        for (unsigned short i = 0; i < m_numRacks; i++)
         {
-            m_rackIncrements[i] = ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE - i;
+            m_rackIncrements[i] = m_numRacks - i;
             m_rackIsActivated[i] = false;
         }
     }
 
     void Mixer::work(unsigned int numSamplesToWorkOn)
     {
+        if (m_isExportFused)
+        {
+            mixAndExport(numSamplesToWorkOn);
+            return;
+        }
+
+        /*
+        * If the sums need a higher precision than the streams, we use a dedicated
+        * method. Since this test only depends on the configuration, the compiler
+        * removes the unused branch.
+        */
+        if (!std::is_same<accumulation_type, floating_type>::value)
+        {
+            mixWithAccumulator(numSamplesToWorkOn);
+            return;
+        }
+
+        /*
+        * We first gather the input streams to mix, so that the summing function
+        * can add several of them at once to each output stream.
+        */
+        const floating_type* inputs[ANGLECORE_NUM_VOICES * ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
+
         for (unsigned short c = 0; c < ANGLECORE_NUM_CHANNELS; c++)
         {
             floating_type* output = getOutputStream(c);
@@ -56,43 +92,181 @@ namespace ANGLECORE
             * The output bus is supposed to be already connected to existing streams
             * (towards the Exporter), so we do not need to check if 'output' is a
             * null pointer. We know it is not.
+            */
 
-            /* We first clear the output buffer: */
-            for (unsigned int s = 0; s < numSamplesToWorkOn; s++)
-                output[s] = static_cast<floating_type>(0.0);
+            unsigned int numInputs = 0;
 
             /* We iterate through the voices using the increments */
-            for (unsigned short v = m_voiceStart; v < ANGLECORE_NUM_VOICES; v += m_voiceIncrements[v])
+            for (unsigned short v = m_voiceStart; v < m_numVoices; v += m_voiceIncrements[v])
             {
                 /* We iterate through the racks using the increments */
-                for (unsigned short i = m_rackStart; i < ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE; i += m_rackIncrements[i])
+                for (unsigned short i = m_rackStart; i < m_numRacks; i += m_rackIncrements[i])
                 {
                     /*
                     * The following formula computes the input port number
                     * corresponding to the current voice, instrument rack, and
                     * channel:
                     */
-                    unsigned short inputPortNumber = v * ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE * ANGLECORE_NUM_CHANNELS + i * ANGLECORE_NUM_CHANNELS + c;
-
-                    const floating_type* input = getInputStream(inputPortNumber);
+                    unsigned short inputPortNumber = (v * m_numRacks + i) * ANGLECORE_NUM_CHANNELS + c;
 
                     /*
                     * Just like the output bus, the input bus is supposed to be
                     * already connected to existing streams, so we do not need to
-                    * check if 'input' is a null pointer. We know it is not.
+                    * check if the input is a null pointer. We know it is not.
                     */
+                    inputs[numInputs++] = getInputStream(inputPortNumber);
+                }
+            }
 
-                    /*
-                    * We can finally sum the audio output of each instruments to its
-                    * corresponding output stream.
-                    */
-                    for (unsigned int s = 0; s < numSamplesToWorkOn; s++)
-                        output[s] += input[s];
+            /*
+            * We can finally sum the audio output of each instruments into the
+            * corresponding output stream, which also clears the output stream if
+            * there is nothing to mix.
+            */
+            m_sumFunction(output, inputs, numInputs, numSamplesToWorkOn);
+        }
+    }
+
+    void Mixer::mixWithAccumulator(unsigned int numSamplesToWorkOn)
+    {
+        /*
+        * We sum the instruments into a buffer of the accumulation type, in chunks
+        * of ANGLECORE_MIXER_CHUNK_SIZE samples so that the buffer can live on the
+        * stack, and only round the sums to the streams' precision once they are
+        * complete.
+        */
+        accumulation_type sums[ANGLECORE_MIXER_CHUNK_SIZE];
+
+        for (unsigned short c = 0; c < ANGLECORE_NUM_CHANNELS; c++)
+        {
+            floating_type* output = getOutputStream(c);
+
+            for (unsigned int chunkStart = 0; chunkStart < numSamplesToWorkOn; chunkStart += ANGLECORE_MIXER_CHUNK_SIZE)
+            {
+                const unsigned int chunkSize = std::min(numSamplesToWorkOn - chunkStart, static_cast<unsigned int>(ANGLECORE_MIXER_CHUNK_SIZE));
+
+                for (unsigned int s = 0; s < chunkSize; s++)
+                    sums[s] = static_cast<accumulation_type>(0.0);
+
+                /* We traverse the voices and racks just like the work() method */
+                for (unsigned short v = m_voiceStart; v < m_numVoices; v += m_voiceIncrements[v])
+                    for (unsigned short i = m_rackStart; i < m_numRacks; i += m_rackIncrements[i])
+                    {
+                        unsigned short inputPortNumber = (v * m_numRacks + i) * ANGLECORE_NUM_CHANNELS + c;
+                        const floating_type* input = getInputStream(inputPortNumber) + chunkStart;
+                        for (unsigned int s = 0; s < chunkSize; s++)
+                            sums[s] += static_cast<accumulation_type>(input[s]);
+                    }
+
+                for (unsigned int s = 0; s < chunkSize; s++)
+                    output[chunkStart + s] = static_cast<floating_type>(sums[s]);
+            }
+        }
+    }
+
+    void Mixer::mixAndExport(unsigned int numSamplesToWorkOn)
+    {
+        /*
+        * It is assumed the output buffer has been properly set, and that the
+        * number of samples is in-range, just like in Exporter::work().
+        */
+
+        /*
+        * Each output channel receives the sum of the rendered channels that map
+        * onto it: when the host requests less channels than rendered, several
+        * rendered channels are summed using a modulo approach, just like the
+        * Exporter does. When it requests more, each rendered channel is only
+        * computed once, and then duplicated by the output buffer.
+        */
+        const unsigned short numComputedChannels = std::min(m_outputBuffer.getNumChannels(), static_cast<unsigned short>(ANGLECORE_NUM_CHANNELS));
+        const floating_type gain = static_cast<floating_type>(ANGLECORE_AUDIOWORKFLOW_EXPORTER_GAIN);
+
+        /*
+        * We first gather the input streams of every computed channel. Since each
+        * input stream maps onto exactly one computed channel, they can all be
+        * stored one after the other into the same array.
+        */
+        const floating_type* inputs[ANGLECORE_NUM_VOICES * ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE * ANGLECORE_NUM_CHANNELS];
+        const floating_type* chunkInputs[ANGLECORE_NUM_VOICES * ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE * ANGLECORE_NUM_CHANNELS];
+        unsigned int firstInputs[ANGLECORE_NUM_CHANNELS + 1];
+
+        unsigned int numInputs = 0;
+        for (unsigned short h = 0; h < numComputedChannels; h++)
+        {
+            firstInputs[h] = numInputs;
+            for (unsigned short c = h; c < ANGLECORE_NUM_CHANNELS; c += numComputedChannels)
+                for (unsigned short v = m_voiceStart; v < m_numVoices; v += m_voiceIncrements[v])
+                    for (unsigned short i = m_rackStart; i < m_numRacks; i += m_rackIncrements[i])
+                        inputs[numInputs++] = getInputStream((v * m_numRacks + i) * ANGLECORE_NUM_CHANNELS + c);
+        }
+        firstInputs[numComputedChannels] = numInputs;
+
+        /*
+        * The mix is computed in chunks that remain in the cache, and every chunk
+        * is exported into all the output channels at once, so that interleaved
+        * buffers are written frame after frame.
+        */
+        floating_type mix[ANGLECORE_NUM_CHANNELS][ANGLECORE_MIXER_CHUNK_SIZE];
+        const floating_type* sources[ANGLECORE_NUM_CHANNELS];
+        for (unsigned short h = 0; h < numComputedChannels; h++)
+            sources[h] = mix[h];
+
+        for (unsigned int chunkStart = 0; chunkStart < numSamplesToWorkOn; chunkStart += ANGLECORE_MIXER_CHUNK_SIZE)
+        {
+            const unsigned int chunkSize = std::min(numSamplesToWorkOn - chunkStart, static_cast<unsigned int>(ANGLECORE_MIXER_CHUNK_SIZE));
+
+            for (unsigned short h = 0; h < numComputedChannels; h++)
+            {
+                const unsigned int firstInput = firstInputs[h];
+                const unsigned int numChannelInputs = firstInputs[h + 1] - firstInput;
+
+                /*
+                * When the sums have the precision of the streams, we use the
+                * summing function. Otherwise, we sum with the accumulation type
+                * and round the result, like mixWithAccumulator() does.
+                */
+                if (std::is_same<accumulation_type, floating_type>::value)
+                {
+                    for (unsigned int i = 0; i < numChannelInputs; i++)
+                        chunkInputs[i] = inputs[firstInput + i] + chunkStart;
+                    m_sumFunction(mix[h], chunkInputs, numChannelInputs, chunkSize);
+                }
+                else
+                {
+                    accumulation_type sums[ANGLECORE_MIXER_CHUNK_SIZE];
+                    for (unsigned int s = 0; s < chunkSize; s++)
+                        sums[s] = static_cast<accumulation_type>(0.0);
+                    for (unsigned int i = 0; i < numChannelInputs; i++)
+                    {
+                        const floating_type* input = inputs[firstInput + i] + chunkStart;
+                        for (unsigned int s = 0; s < chunkSize; s++)
+                            sums[s] += static_cast<accumulation_type>(input[s]);
+                    }
+                    for (unsigned int s = 0; s < chunkSize; s++)
+                        mix[h][s] = static_cast<floating_type>(sums[s]);
                 }
             }
+
+            m_outputBuffer.write(m_startSample + chunkStart, chunkSize, sources, numComputedChannels, gain);
         }
     }
 
+    void Mixer::setFusedExport(bool isFused)
+    {
+        m_isExportFused = isFused;
+    }
+
+    void Mixer::setOutputBuffer(const ExportBuffer& buffer, uint32_t startSample)
+    {
+        m_outputBuffer = buffer;
+        m_startSample = startSample;
+    }
+
+    void Mixer::setInstructionSet(MixerKernels::InstructionSet instructionSet)
+    {
+        m_sumFunction = MixerKernels::getSumFunction(instructionSet);
+    }
+
     void Mixer::turnVoiceOn(unsigned short voiceNumber)
     {
         m_voiceIsOn[voiceNumber] = true;
@@ -127,7 +301,7 @@ namespace ANGLECORE
         * by this method.
         */
 
-        for (uint32_t i = ANGLECORE_NUM_VOICES - 1; i >= 1; i--)
+        for (uint32_t i = m_numVoices - 1; i >= 1; i--)
 
             /*
             * We only mix a voice if that voice is on. If it is, we fix an increment
@@ -157,7 +331,7 @@ namespace ANGLECORE
         * by this method.
         */
 
-        for (uint32_t i = ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE - 1; i >= 1; i--)
+        for (uint32_t i = m_numRacks - 1; i >= 1; i--)
 
             /*
             * We only mix an instrument rack if the rack is activated. If it is, we
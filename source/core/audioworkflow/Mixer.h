@@ -24,7 +24,9 @@
 
 #include <stdint.h>
 
-#include "workflow/Worker.h"
+#include "workflow/DevirtualizedWorker.h"
+#include "MixerKernels.h"
+#include "ExportBuffer.h"
 #include "../../config/RenderingConfig.h"
 #include "../../config/AudioConfig.h"
 
@@ -33,24 +35,64 @@ namespace ANGLECORE
     /**
     * \class Mixer Mixer.h
     * Worker that sums all of its non-nullptr input stream, based on the audio
-    * channel they each represent.
+    * channel they each represent. The input streams are laid out as a grid of
+    * voices and racks, each with one Stream per channel, and only the voices that
+    * are on and the racks that are activated are mixed. The AudioWorkflow uses
+    * one Mixer per Voice to sum the racks of that Voice, and one final Mixer to
+    * sum the voices, so that most of the mixing happens within each Voice, and
+    * can therefore be rendered in parallel.
     */
     class Mixer :
-        public Worker
+        public DevirtualizedWorker<Mixer>
     {
     public:
 
         /**
-        * Initializes the Worker's buses size according to the audio
-        * configuration (number of channels, number of instruments...)
+        * Initializes the Worker's buses size according to the given grid of voices
+        * and racks, and to the number of channels. Every Voice starts off, and
+        * every rack deactivated.
+        * @param[in] numVoices Number of voices to mix. It must not exceed
+        *   ANGLECORE_NUM_VOICES.
+        * @param[in] numRacks Number of racks to mix in each Voice. It must not
+        *   exceed ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE.
         */
-        Mixer();
+        Mixer(unsigned short numVoices, unsigned short numRacks);
 
         /**
         * Mixes all the channels together
         */
         void work(unsigned int numSamplesToWorkOn);
 
+        /**
+        * Selects the instruction set the Mixer sums its input streams with. This
+        * method should not be called while the Mixer is rendering.
+        * @param[in] instructionSet The instruction set to use, which must be
+        *   supported by the CPU (see MixerKernels::detectInstructionSet()).
+        */
+        void setInstructionSet(MixerKernels::InstructionSet instructionSet);
+
+        /**
+        * Enables or disables the fused export. When enabled, the Mixer no longer
+        * writes into its output streams: it applies the Exporter's gain to its
+        * mix, converts it into the host's format, and writes it directly into the
+        * buffer given by setOutputBuffer(), in a single pass. This saves a pass
+        * through memory on every rendering session, but it can only be used if
+        * the Exporter is the only reader of the Mixer's output streams, and if
+        * the Exporter itself is told to skip its work. This method should not be
+        * called while the Mixer is rendering.
+        * @param[in] isFused True to export directly, false to write into the
+        *   output streams.
+        */
+        void setFusedExport(bool isFused);
+
+        /**
+        * Sets the memory location to export into when the fused export is enabled,
+        * with the same meaning as in Exporter::setOutputBuffer().
+        * @param[in] buffer The new memory location.
+        * @param[in] startSample Position to start from in the buffer.
+        */
+        void setOutputBuffer(const ExportBuffer& buffer, uint32_t startSample);
+
         /**
         * Instructs the Mixer to turn a Voice on, and to recompute its increments.
         * This method is really fast, as it will only be called by the real-time
@@ -85,6 +127,21 @@ namespace ANGLECORE
 
     private:
 
+        /**
+        * Mixes the instruments like work(), but sums them with the precision of
+        * accumulation_type rather than floating_type. This is used when
+        * ANGLECORE_ACCUMULATION_PRECISION differs from ANGLECORE_PRECISION.
+        * @param[in] numSamplesToWorkOn Number of samples to mix.
+        */
+        void mixWithAccumulator(unsigned int numSamplesToWorkOn);
+
+        /**
+        * Mixes the instruments and exports the result into the output buffer, as
+        * described in setFusedExport().
+        * @param[in] numSamplesToWorkOn Number of samples to mix and export.
+        */
+        void mixAndExport(unsigned int numSamplesToWorkOn);
+
         /**
         * Recomputes the Mixer's voice increments after a Voice has been turned on
         * or off. This method is really fast, as it will only be called by the
@@ -99,7 +156,8 @@ namespace ANGLECORE
         */
         void updateRackIncrements();
 
-        const unsigned short m_totalNumInstruments;
+        const unsigned short m_numVoices;
+        const unsigned short m_numRacks;
 
         /**
         * Voice to start from when mixing voices. This may vary depending on which
@@ -129,6 +187,14 @@ namespace ANGLECORE
         uint32_t m_rackIncrements[ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
 
         /** Tracks the activated/deactivated status of every Rack */
-        bool m_rackIsActivated[ANGLECORE_NUM_VOICES];
+        bool m_rackIsActivated[ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
+
+        /** Function used to sum the input streams into each output stream */
+        MixerKernels::SumFunction m_sumFunction;
+
+        /** Fused export's status and destination (see setFusedExport()) */
+        bool m_isExportFused;
+        ExportBuffer m_outputBuffer;
+        uint32_t m_startSample;
     };
 }
\ No newline at end of file
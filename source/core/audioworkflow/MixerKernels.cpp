@@ -0,0 +1,244 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#include <algorithm>
+
+#include "MixerKernels.h"
+
+/*
+* The SIMD versions are only compiled on x86 processors. The compiler must be
+* allowed to use each instruction set within the corresponding functions only,
+* so that the rest of the binary still runs on any x86 CPU: MSVC allows this by
+* default, while GCC and Clang need a target attribute on those functions.
+*/
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define ANGLECORE_MIXER_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define ANGLECORE_TARGET(instructionSet)
+#else
+#define ANGLECORE_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#endif
+#else
+#define ANGLECORE_MIXER_KERNELS_X86 0
+#endif
+
+/*
+* Every version of the summing function shares the same algorithm, which only
+* differs by the vector type it uses. We therefore generate them with the
+* following macro, in which 'Vector' is a structure providing a vector 'type'
+* holding 'width' samples, along with the 'load', 'store' and 'add' operations.
+* The input streams are processed in groups of ANGLECORE_MIXER_INPUTS_PER_PASS:
+* the first group overwrites the output stream, and the next ones accumulate
+* into it. The last samples, which do not fill a whole vector, are summed one by
+* one.
+*/
+#define ANGLECORE_DEFINE_SUM_FUNCTION(functionName, Vector, targetAttribute) \
+    targetAttribute static void functionName(floating_type* output, const floating_type* const* inputs, unsigned int numInputs, unsigned int numSamples) \
+    { \
+        if (numInputs == 0) \
+        { \
+            for (unsigned int s = 0; s < numSamples; s++) \
+                output[s] = static_cast<floating_type>(0.0); \
+            return; \
+        } \
+        \
+        const unsigned int numVectorSamples = numSamples - numSamples % Vector::width; \
+        for (unsigned int first = 0; first < numInputs; first += ANGLECORE_MIXER_INPUTS_PER_PASS) \
+        { \
+            const unsigned int end = std::min(first + ANGLECORE_MIXER_INPUTS_PER_PASS, numInputs); \
+            const bool accumulates = first > 0; \
+            const unsigned int start = accumulates ? first : first + 1; \
+            \
+            for (unsigned int s = 0; s < numVectorSamples; s += Vector::width) \
+            { \
+                Vector::type sum = Vector::load(accumulates ? output + s : inputs[first] + s); \
+                for (unsigned int i = start; i < end; i++) \
+                    sum = Vector::add(sum, Vector::load(inputs[i] + s)); \
+                Vector::store(output + s, sum); \
+            } \
+            \
+            for (unsigned int s = numVectorSamples; s < numSamples; s++) \
+            { \
+                floating_type sum = accumulates ? output[s] : inputs[first][s]; \
+                for (unsigned int i = start; i < end; i++) \
+                    sum += inputs[i][s]; \
+                output[s] = sum; \
+            } \
+        } \
+    }
+
+namespace ANGLECORE
+{
+    /** A single sample, used by the scalar version */
+    struct ScalarVector
+    {
+        typedef floating_type type;
+        static const unsigned int width = 1;
+        static type load(const floating_type* address) { return *address; }
+        static void store(floating_type* address, type value) { *address = value; }
+        static type add(type a, type b) { return a + b; }
+    };
+
+    ANGLECORE_DEFINE_SUM_FUNCTION(sumScalar, ScalarVector, )
+
+#if ANGLECORE_MIXER_KERNELS_X86
+
+    /** SIMD register type holding \p numBytes bytes of samples of type \p T */
+    template <class T, unsigned int numBytes>
+    struct Register;
+
+    template <> struct Register<float, 16> { typedef __m128 type; };
+    template <> struct Register<double, 16> { typedef __m128d type; };
+    template <> struct Register<float, 32> { typedef __m256 type; };
+    template <> struct Register<double, 32> { typedef __m256d type; };
+    template <> struct Register<float, 64> { typedef __m512 type; };
+    template <> struct Register<double, 64> { typedef __m512d type; };
+
+    /*
+    * For each instruction set, the overloads below select the right intrinsics
+    * depending on whether floating_type is float or double.
+    */
+
+    struct SSE2Vector
+    {
+        typedef Register<floating_type, 16>::type type;
+        static const unsigned int width = 16 / sizeof(floating_type);
+        ANGLECORE_TARGET("sse2") static __m128 load(const float* address) { return _mm_loadu_ps(address); }
+        ANGLECORE_TARGET("sse2") static __m128d load(const double* address) { return _mm_loadu_pd(address); }
+        ANGLECORE_TARGET("sse2") static void store(float* address, __m128 value) { _mm_storeu_ps(address, value); }
+        ANGLECORE_TARGET("sse2") static void store(double* address, __m128d value) { _mm_storeu_pd(address, value); }
+        ANGLECORE_TARGET("sse2") static __m128 add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+        ANGLECORE_TARGET("sse2") static __m128d add(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+    };
+
+    struct AVX2Vector
+    {
+        typedef Register<floating_type, 32>::type type;
+        static const unsigned int width = 32 / sizeof(floating_type);
+        ANGLECORE_TARGET("avx2") static __m256 load(const float* address) { return _mm256_loadu_ps(address); }
+        ANGLECORE_TARGET("avx2") static __m256d load(const double* address) { return _mm256_loadu_pd(address); }
+        ANGLECORE_TARGET("avx2") static void store(float* address, __m256 value) { _mm256_storeu_ps(address, value); }
+        ANGLECORE_TARGET("avx2") static void store(double* address, __m256d value) { _mm256_storeu_pd(address, value); }
+        ANGLECORE_TARGET("avx2") static __m256 add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+        ANGLECORE_TARGET("avx2") static __m256d add(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+    };
+
+    struct AVX512Vector
+    {
+        typedef Register<floating_type, 64>::type type;
+        static const unsigned int width = 64 / sizeof(floating_type);
+        ANGLECORE_TARGET("avx512f") static __m512 load(const float* address) { return _mm512_loadu_ps(address); }
+        ANGLECORE_TARGET("avx512f") static __m512d load(const double* address) { return _mm512_loadu_pd(address); }
+        ANGLECORE_TARGET("avx512f") static void store(float* address, __m512 value) { _mm512_storeu_ps(address, value); }
+        ANGLECORE_TARGET("avx512f") static void store(double* address, __m512d value) { _mm512_storeu_pd(address, value); }
+        ANGLECORE_TARGET("avx512f") static __m512 add(__m512 a, __m512 b) { return _mm512_add_ps(a, b); }
+        ANGLECORE_TARGET("avx512f") static __m512d add(__m512d a, __m512d b) { return _mm512_add_pd(a, b); }
+    };
+
+    ANGLECORE_DEFINE_SUM_FUNCTION(sumSSE2, SSE2Vector, ANGLECORE_TARGET("sse2"))
+    ANGLECORE_DEFINE_SUM_FUNCTION(sumAVX2, AVX2Vector, ANGLECORE_TARGET("avx2"))
+    ANGLECORE_DEFINE_SUM_FUNCTION(sumAVX512, AVX512Vector, ANGLECORE_TARGET("avx512f"))
+
+#endif
+
+    MixerKernels::InstructionSet MixerKernels::detectInstructionSet()
+    {
+#if ANGLECORE_MIXER_KERNELS_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+
+        /*
+        * With MSVC, we query the CPU directly. An instruction set is only usable
+        * if the operating system saves the corresponding registers, which we
+        * check with the XCR0 register.
+        */
+        int registers[4];
+        __cpuid(registers, 0);
+        const int maxLeaf = registers[0];
+
+        __cpuid(registers, 1);
+        const bool hasSSE2 = (registers[3] & (1 << 26)) != 0;
+        const bool hasOSXSave = (registers[2] & (1 << 27)) != 0;
+        const unsigned long long xcr0 = hasOSXSave ? _xgetbv(0) : 0;
+        const bool osSavesAVX = (xcr0 & 0x6) == 0x6;
+        const bool osSavesAVX512 = (xcr0 & 0xe6) == 0xe6;
+
+        bool hasAVX2 = false;
+        bool hasAVX512 = false;
+        if (maxLeaf >= 7)
+        {
+            __cpuidex(registers, 7, 0);
+            hasAVX2 = osSavesAVX && (registers[1] & (1 << 5)) != 0;
+            hasAVX512 = osSavesAVX512 && (registers[1] & (1 << 16)) != 0;
+        }
+#else
+
+        /* GCC and Clang provide builtins that also check the OS support */
+        __builtin_cpu_init();
+        const bool hasSSE2 = __builtin_cpu_supports("sse2");
+        const bool hasAVX2 = __builtin_cpu_supports("avx2");
+        const bool hasAVX512 = __builtin_cpu_supports("avx512f");
+#endif
+
+        if (hasAVX512)
+            return InstructionSet::AVX512;
+        if (hasAVX2)
+            return InstructionSet::AVX2;
+        if (hasSSE2)
+            return InstructionSet::SSE2;
+#endif
+        return InstructionSet::SCALAR;
+    }
+
+    MixerKernels::SumFunction MixerKernels::getSumFunction(InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+#if ANGLECORE_MIXER_KERNELS_X86
+        case InstructionSet::SSE2:
+            return &sumSSE2;
+        case InstructionSet::AVX2:
+            return &sumAVX2;
+        case InstructionSet::AVX512:
+            return &sumAVX512;
+#endif
+        default:
+            return &sumScalar;
+        }
+    }
+
+    const char* MixerKernels::getName(InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+        case InstructionSet::SSE2:
+            return "SSE2";
+        case InstructionSet::AVX2:
+            return "AVX2";
+        case InstructionSet::AVX512:
+            return "AVX-512";
+        default:
+            return "scalar";
+        }
+    }
+}
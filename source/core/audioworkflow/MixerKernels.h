@@ -0,0 +1,84 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include "../../config/RenderingConfig.h"
+
+namespace ANGLECORE
+{
+    /**
+    * \class MixerKernels MixerKernels.h
+    * Provides the functions the Mixer uses to sum its input streams, in several
+    * versions that each rely on a different instruction set. The best version
+    * the CPU supports is detected at runtime, so that the same binary runs on
+    * every x86 CPU and still takes advantage of the widest SIMD registers
+    * available. Every version sums up to ANGLECORE_MIXER_INPUTS_PER_PASS input
+    * streams per pass over the output stream, which reduces the number of times
+    * the output is loaded and stored.
+    */
+    class MixerKernels
+    {
+    public:
+        MixerKernels() = delete;
+
+        /** Instruction sets a summing function can be implemented with */
+        enum InstructionSet
+        {
+            SCALAR = 0,     /**< Plain C++, which runs on every CPU */
+            SSE2,           /**< 128-bit SIMD registers */
+            AVX2,           /**< 256-bit SIMD registers */
+            AVX512,         /**< 512-bit SIMD registers, using AVX-512F */
+            NUM_INSTRUCTION_SETS
+        };
+
+        /**
+        * Function that sums \p numInputs streams of \p numSamples samples into an
+        * output stream, whose previous content is overwritten. The output stream
+        * is filled with zeros if \p numInputs equals zero.
+        */
+        typedef void (*SumFunction)(floating_type* output, const floating_type* const* inputs, unsigned int numInputs, unsigned int numSamples);
+
+        /**
+        * Returns the widest instruction set supported by both the CPU and the
+        * operating system, among the ones ANGLECORE was compiled with. This
+        * method queries the CPU, so its result should be stored rather than
+        * computed on every rendering session.
+        */
+        static InstructionSet detectInstructionSet();
+
+        /**
+        * Returns the summing function implemented with the given instruction set.
+        * The instruction set must be supported by the CPU, which is the case for
+        * every instruction set up to the one returned by detectInstructionSet().
+        * @param[in] instructionSet The instruction set to use. If ANGLECORE was
+        *   not compiled with it, the scalar version is returned.
+        */
+        static SumFunction getSumFunction(InstructionSet instructionSet);
+
+        /**
+        * Returns the name of the given instruction set, for display purposes.
+        * @param[in] instructionSet The instruction set to name.
+        */
+        static const char* getName(InstructionSet instructionSet);
+    };
+}
@@ -0,0 +1,111 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+#pragma once
+
+#include <stdint.h>
+
+#include "../../config/AudioConfig.h"
+
+namespace ANGLECORE
+{
+    /**
+    * \struct ParameterHandle ParameterHandle.h
+    * Identifies a Parameter by its Instrument's rack number and by its position in
+    * the list of parameters the Instrument was constructed with. Unlike a
+    * Parameter's StringView identifier, a ParameterHandle gives direct access to
+    * the Parameter's slot in the AudioWorkflow's parameter registers, without
+    * hashing nor comparing any string. A handle can be retrieved once from the
+    * Master, or built at compile-time by an Instrument that declares the position
+    * of each of its parameters as a constant. It also records the generation of
+    * the Parameter's slot in the register, which only changes when the slot is
+    * emptied or given to another Parameter, so that a handle that has become
+    * stale is rejected instead of silently targeting another Parameter. A slot
+    * used for the first time is of generation 0.
+    */
+    struct ParameterHandle
+    {
+        /**
+        * Rack number of the Instrument the Parameter belongs to. It is out-of-range
+        * for invalid handles.
+        */
+        uint16_t rackNumber;
+
+        /** Position of the Parameter in its Instrument's list of parameters */
+        uint16_t parameterIndex;
+
+        /**
+        * Generation of the Parameter's slot in the register. The handle is
+        * rejected once the slot has moved on to another generation.
+        */
+        uint32_t generation;
+
+        /**
+        * Creates an invalid ParameterHandle, which does not correspond to any
+        * Parameter.
+        */
+        constexpr ParameterHandle() :
+            rackNumber(ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE),
+            parameterIndex(0),
+            generation(0)
+        {}
+
+        /**
+        * Creates a ParameterHandle from the given position, for a Parameter whose
+        * slot is used for the first time, which is the case of every Parameter of
+        * an Instrument inserted into a rack that was never used before. Note that
+        * the handle is not checked against the Instrument actually located at
+        * \p rackNumber, so this constructor can be used in constant expressions.
+        * @param[in] rackNumber The Instrument's rack number.
+        * @param[in] parameterIndex Position of the Parameter in the list of
+        *   parameters the Instrument was constructed with.
+        */
+        constexpr ParameterHandle(uint16_t rackNumber, uint16_t parameterIndex) :
+            rackNumber(rackNumber),
+            parameterIndex(parameterIndex),
+            generation(0)
+        {}
+
+        /**
+        * Creates a ParameterHandle from the given position and generation. Note
+        * that the handle is not checked against the parameter register of
+        * \p rackNumber, which only happens when the handle is used.
+        * @param[in] rackNumber The Instrument's rack number.
+        * @param[in] parameterIndex Position of the Parameter in the list of
+        *   parameters the Instrument was constructed with.
+        * @param[in] generation Generation of the Parameter's slot.
+        */
+        constexpr ParameterHandle(uint16_t rackNumber, uint16_t parameterIndex, uint32_t generation) :
+            rackNumber(rackNumber),
+            parameterIndex(parameterIndex),
+            generation(generation)
+        {}
+
+        /**
+        * Returns true if the handle's rack number is in-range. Note that a valid
+        * handle may still not correspond to any Parameter, if it has become stale.
+        */
+        constexpr bool isValid() const
+        {
+            return rackNumber < ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE;
+        }
+    };
+}
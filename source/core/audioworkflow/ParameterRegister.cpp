@@ -20,37 +20,255 @@
 **
 **********************************************************************/
 
+#include <thread>
+#include <mutex>
+
 #include "ParameterRegister.h"
 
 namespace ANGLECORE
 {
-    void ParameterRegister::insert(StringView parameterIdentifier, const Entry& entryToInsert)
+    /* Snapshot
+    ***************************************************/
+
+    void ParameterRegister::Snapshot::insert(StringView parameterIdentifier, unsigned short parameterIndex, const Entry& entryToInsert)
     {
-        m_data[parameterIdentifier] = entryToInsert;
+        /*
+        * The slots are indexed by the position of each parameter in the list of
+        * parameters of its instrument, so we grow the dense array if needed before
+        * storing the entry:
+        */
+        if (parameterIndex >= m_entries.size())
+        {
+            m_entries.resize(parameterIndex + 1);
+            m_generations.resize(parameterIndex + 1, 0);
+        }
+
+        /*
+        * If the slot already holds another parameter, then that parameter can no
+        * longer be found by its identifier, and the handles retrieved for it must
+        * no longer be accepted, so we move the slot on to its next generation.
+        * Re-inserting the same parameter keeps the handles valid.
+        */
+        const auto& snapshotIterator = m_indices.find(parameterIdentifier);
+        bool isSameParameter = snapshotIterator != m_indices.end() && snapshotIterator->second == parameterIndex;
+        if (m_entries[parameterIndex].generator && !isSameParameter)
+        {
+            for (auto indexIterator = m_indices.begin(); indexIterator != m_indices.end(); ++indexIterator)
+                if (indexIterator->second == parameterIndex)
+                {
+                    m_indices.erase(indexIterator);
+                    break;
+                }
+            m_generations[parameterIndex]++;
+        }
+
+        m_entries[parameterIndex] = entryToInsert;
+        m_indices[parameterIdentifier] = parameterIndex;
     }
 
-    ParameterRegister::Entry ParameterRegister::find(StringView parameterIdentifier) const
+    void ParameterRegister::Snapshot::remove(StringView parameterIdentifier)
+    {
+        const auto& snapshotIterator = m_indices.find(parameterIdentifier);
+
+        if (snapshotIterator != m_indices.end())
+        {
+            /*
+            * We empty the parameter's slot rather than erasing it, so that the
+            * other slots keep their index, and we move it on to its next
+            * generation, so that the parameter's handles are no longer accepted:
+            */
+            m_entries[snapshotIterator->second] = Entry();
+            m_generations[snapshotIterator->second]++;
+            m_indices.erase(snapshotIterator);
+        }
+    }
+
+    const ParameterRegister::Entry* ParameterRegister::Snapshot::find(StringView parameterIdentifier) const
+    {
+        const auto& snapshotIterator = m_indices.find(parameterIdentifier);
+
+        if (snapshotIterator != m_indices.end())
+            return &m_entries[snapshotIterator->second];
+
+        return nullptr;
+    }
+
+    bool ParameterRegister::Snapshot::findIndex(StringView parameterIdentifier, unsigned short& parameterIndex) const
+    {
+        const auto& snapshotIterator = m_indices.find(parameterIdentifier);
+
+        if (snapshotIterator != m_indices.end())
+        {
+            parameterIndex = snapshotIterator->second;
+            return true;
+        }
+
+        return false;
+    }
+
+    const ParameterRegister::Entry* ParameterRegister::Snapshot::get(unsigned short parameterIndex) const
+    {
+        if (parameterIndex < m_entries.size())
+            return &m_entries[parameterIndex];
+
+        return nullptr;
+    }
+
+    uint32_t ParameterRegister::Snapshot::getGeneration(unsigned short parameterIndex) const
+    {
+        if (parameterIndex < m_generations.size())
+            return m_generations[parameterIndex];
+
+        return 0;
+    }
+
+    /* ReadScope
+    ***************************************************/
+
+    ParameterRegister::ReadScope::ReadScope(const ParameterRegister& parameterRegister) :
+        m_numReaders(enter(parameterRegister))
+    {}
+
+    ParameterRegister::ReadScope::~ReadScope()
+    {
+        m_numReaders.fetch_sub(1);
+    }
+
+    std::atomic<uint32_t>& ParameterRegister::ReadScope::enter(const ParameterRegister& parameterRegister)
     {
         /*
-        * We check whether or not the register's map contains an entry for the given
-        * parameter, and if so, we return the corresponding entry.
+        * We count ourselves as a reader of the current epoch. If a new epoch has
+        * started in the meantime, then synchronize() may have already checked the
+        * counter we incremented, so we start again with the new epoch. Otherwise,
+        * any synchronize() call that starts after this point will wait for us.
+        * This loop only repeats if synchronize() is called concurrently, which
+        * happens rarely.
         */
+        while (true)
+        {
+            unsigned char epoch = parameterRegister.m_epoch.load();
+            std::atomic<uint32_t>& numReaders = parameterRegister.m_numReaders[epoch];
+            numReaders.fetch_add(1);
+
+            if (parameterRegister.m_epoch.load() == epoch)
+                return numReaders;
+
+            numReaders.fetch_sub(1);
+        }
+    }
+
+    /* ParameterRegister
+    ***************************************************/
+
+    ParameterRegister::ParameterRegister() :
+        m_snapshot(new Snapshot),
+        m_epoch(0)
+    {
+        m_numReaders[0].store(0);
+        m_numReaders[1].store(0);
+    }
 
-        const auto& registerIterator = m_data.find(parameterIdentifier);
+    ParameterRegister::~ParameterRegister()
+    {
+        delete m_snapshot.load();
+    }
+
+    ParameterRegister::Entry ParameterRegister::find(StringView parameterIdentifier) const
+    {
+        /*
+        * We check whether or not the current snapshot contains an entry for the
+        * given parameter, and if so, we return a copy of the corresponding entry.
+        * The copy is made before leaving the read scope, as the snapshot may be
+        * deleted right after.
+        */
+        ReadScope scope(*this);
+        const Entry* entry = m_snapshot.load()->find(parameterIdentifier);
 
         /* If an entry is found, we return it */
-        if (registerIterator != m_data.end())
-            return registerIterator->second;
+        if (entry)
+            return *entry;
 
         /* Otherwise, we return an empty entry */
-        Entry entry;
-        entry.generator = nullptr;
-        entry.stream = nullptr;
-        return entry;
+        return Entry();
     }
 
-    void ParameterRegister::remove(StringView parameterIdentifier)
+    bool ParameterRegister::findIndex(StringView parameterIdentifier, unsigned short& parameterIndex, uint32_t& generation) const
     {
-        m_data.erase(parameterIdentifier);
+        /*
+        * The index and the generation must come from the same snapshot, so we
+        * read both within a single read scope:
+        */
+        ReadScope scope(*this);
+        const Snapshot* snapshot = m_snapshot.load();
+        if (!snapshot->findIndex(parameterIdentifier, parameterIndex))
+            return false;
+
+        generation = snapshot->getGeneration(parameterIndex);
+        return true;
+    }
+
+    ParameterRegister::Entry ParameterRegister::get(unsigned short parameterIndex, uint32_t generation) const
+    {
+        /*
+        * If the slot has been given to another parameter since the index was
+        * retrieved, then we return an empty entry:
+        */
+        ReadScope scope(*this);
+        const Snapshot* snapshot = m_snapshot.load();
+        if (snapshot->getGeneration(parameterIndex) != generation)
+            return Entry();
+
+        const Entry* entry = snapshot->get(parameterIndex);
+
+        if (entry)
+            return *entry;
+
+        return Entry();
+    }
+
+    ParameterGenerator* ParameterRegister::getGenerator(unsigned short parameterIndex, uint32_t generation) const
+    {
+        /*
+        * Only the real-time thread calls this method, and it is the one that
+        * publishes snapshots, so no read scope is needed.
+        */
+        const Snapshot* snapshot = m_snapshot.load(std::memory_order_acquire);
+        if (snapshot->getGeneration(parameterIndex) != generation)
+            return nullptr;
+
+        const Entry* entry = snapshot->get(parameterIndex);
+
+        if (entry)
+            return entry->generator.get();
+
+        return nullptr;
+    }
+
+    std::unique_ptr<ParameterRegister::Snapshot> ParameterRegister::copySnapshot() const
+    {
+        ReadScope scope(*this);
+        return std::unique_ptr<Snapshot>(new Snapshot(*m_snapshot.load()));
+    }
+
+    ParameterRegister::Snapshot* ParameterRegister::publish(Snapshot* newSnapshot)
+    {
+        return m_snapshot.exchange(newSnapshot);
+    }
+
+    void ParameterRegister::synchronize()
+    {
+        std::lock_guard<Mutex> scopedLock(m_synchronizationLock);
+
+        /*
+        * We start a new epoch, so that new readers are counted separately, and we
+        * wait for the readers of the previous epoch to leave. Any reader that may
+        * still hold a snapshot replaced before this call was counted in the
+        * previous epoch, as it entered its read scope before the epoch changed.
+        */
+        unsigned char previousEpoch = m_epoch.load();
+        m_epoch.store(previousEpoch ^ 1);
+
+        while (m_numReaders[previousEpoch].load() != 0)
+            std::this_thread::yield();
     }
 }
\ No newline at end of file
@@ -22,12 +22,16 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <memory>
+#include <atomic>
 #include <unordered_map>
+#include <vector>
 
 #include "parameter/ParameterGenerator.h"
 #include "workflow/Stream.h"
 #include "../../utility/StringView.h"
+#include "../../utility/RealtimeThreadScope.h"
 
 namespace ANGLECORE
 {
@@ -36,7 +40,18 @@ namespace ANGLECORE
     * The goal of a ParameterRegister is to track which workflow items are involved
     * in the generation of a Parameter. It maps a Parameter with its corresponding
     * ParameterGenerator and with the Stream the generator will write into, which
-    * provides a more direct access to the Parameter's values.
+    * provides a more direct access to the Parameter's values. Entries are stored
+    * in a dense array, at the position of their Parameter in the Instrument's list
+    * of parameters, so that they can also be accessed by index through a
+    * ParameterHandle.
+    *
+    * The content of the register is held in an immutable Snapshot, which is never
+    * modified once published. To update the register, a non real-time thread
+    * prepares a modified copy of the current Snapshot, which the real-time thread
+    * then publishes by swapping a single pointer. Any thread can therefore look up
+    * the register in parallel without locking it. The Snapshot that was replaced
+    * is only deleted by a non real-time thread, after a call to synchronize()
+    * has ensured no thread is still reading it.
     */
     class ParameterRegister
     {
@@ -54,41 +69,203 @@ namespace ANGLECORE
         };
 
         /**
-        * Stores the given Entry into the register. Note that this method must only
-        * be called by the real-time thread to execute a ParameterRegistrationPlan.
-        * It should not be called by the non real-time thread, since the real-time
-        * thread may be using the register to dispatch parameter change requests in
-        * the meantime.
-        * @param[in] parameterIdentifier The Parameter's identifier.
-        * @param[in] entryToInsert The ParameterGenerator and Stream that correspond
-        *   to the Parameter identified by \p parameterIdentifier.
+        * \class Snapshot ParameterRegister.h
+        * Content of a ParameterRegister at a given time. A Snapshot can only be
+        * modified by the non real-time thread that prepares it, before it is
+        * published into the register. It is then read-only. Each slot of a
+        * Snapshot has a generation number, which starts at 0 and is incremented
+        * whenever the slot is emptied or given to another Parameter, so that a
+        * ParameterHandle retrieved for the slot's previous Parameter can be told
+        * apart. Generations are copied along with the slots, so modifying a slot
+        * never affects the handles of the others.
+        */
+        class Snapshot
+        {
+        public:
+
+            /**
+            * Stores the given Entry into the Snapshot. If the slot at
+            * \p parameterIndex already holds another Parameter, its generation is
+            * incremented. This method must not be called once the Snapshot has
+            * been published.
+            * @param[in] parameterIdentifier The Parameter's identifier.
+            * @param[in] parameterIndex Position of the Parameter in the list of
+            *   parameters of its Instrument.
+            * @param[in] entryToInsert The ParameterGenerator and Stream that
+            *   correspond to the Parameter identified by \p parameterIdentifier.
+            */
+            void insert(StringView parameterIdentifier, unsigned short parameterIndex, const Entry& entryToInsert);
+
+            /**
+            * Removes any Entry that matches the given Parameter from the Snapshot,
+            * and increments the generation of its slot. This method must not be
+            * called once the Snapshot has been published.
+            * @param[in] parameterIdentifier The Parameter's identifier.
+            */
+            void remove(StringView parameterIdentifier);
+
+            /**
+            * Searches for the given Parameter in the Snapshot, and returns a
+            * pointer to its Entry, or nullptr if the Parameter is not found.
+            * @param[in] parameterIdentifier The Parameter's identifier.
+            */
+            const Entry* find(StringView parameterIdentifier) const;
+
+            /**
+            * Searches for the given Parameter in the Snapshot, and writes its
+            * index, i.e. its position in the list of parameters of its Instrument,
+            * into \p parameterIndex. Returns true if the Parameter is found, and
+            * false otherwise, in which case \p parameterIndex is left untouched.
+            * @param[in] parameterIdentifier The Parameter's identifier.
+            * @param[out] parameterIndex The Parameter's index.
+            */
+            bool findIndex(StringView parameterIdentifier, unsigned short& parameterIndex) const;
+
+            /**
+            * Returns a pointer to the Entry stored at the given index, without
+            * searching for any identifier, or nullptr if \p parameterIndex is
+            * out-of-range. Note that the Entry may be empty.
+            * @param[in] parameterIndex Position of the Parameter in the list of
+            *   parameters of its Instrument.
+            */
+            const Entry* get(unsigned short parameterIndex) const;
+
+            /**
+            * Returns the generation number of the slot at the given index, or 0 if
+            * \p parameterIndex is out-of-range, as such a slot has never been used.
+            * @param[in] parameterIndex Position of the Parameter in the list of
+            *   parameters of its Instrument.
+            */
+            uint32_t getGeneration(unsigned short parameterIndex) const;
+
+        private:
+            /** Maps each Parameter's identifier to the index of its slot */
+            std::unordered_map<StringView, unsigned short> m_indices;
+            std::vector<Entry> m_entries;
+
+            /** Generation number of each slot of m_entries */
+            std::vector<uint32_t> m_generations;
+        };
+
+        /** Creates a ParameterRegister holding an empty Snapshot. */
+        ParameterRegister();
+
+        /**
+        * Deletes the current Snapshot. No other thread should be reading the
+        * register anymore.
         */
-        void insert(StringView parameterIdentifier, const Entry& entryToInsert);
+        ~ParameterRegister();
+
+        ParameterRegister(const ParameterRegister&) = delete;
+        ParameterRegister& operator=(const ParameterRegister&) = delete;
 
         /**
         * Searches for the given Parameter in the register. If the Parameter is
         * found, then the corresponding Entry is returned. Otherwise, this method
-        * will return an Entry with empty pointers.
+        * will return an Entry with empty pointers. This method can be called by
+        * any thread.
         * @param[in] parameterIdentifier The Parameter's identifier.
         */
         Entry find(StringView parameterIdentifier) const;
 
         /**
-        * Removes any Entry that matches the given Parameter from the register. Note
-        * that this method must only be called by the real-time thread to execute a
-        * ParameterRegistrationPlan. It should not be called by the non real-time
-        * thread, since the real-time thread may be using the register to dispatch
-        * parameter change requests in the meantime. Also note that this method
-        * deletes the shared pointers that were contained in the register after
-        * removing them. It is the responsibility of the Master to retrieve a copy
-        * of those pointers first, and then pass the copies to the non real-time
-        * thread for deletion, so that the real-time thread does not deallocate any
-        * memory.
+        * Searches for the given Parameter in the register, and writes its index
+        * into \p parameterIndex, along with the generation of its slot into
+        * \p generation. Returns true if the Parameter is found, and false
+        * otherwise. This method can be called by any thread.
         * @param[in] parameterIdentifier The Parameter's identifier.
+        * @param[out] parameterIndex The Parameter's index.
+        * @param[out] generation The generation of the Parameter's slot.
+        */
+        bool findIndex(StringView parameterIdentifier, unsigned short& parameterIndex, uint32_t& generation) const;
+
+        /**
+        * Returns the Entry stored at the given index, without searching for any
+        * identifier. If \p generation does not match the slot's, if
+        * \p parameterIndex is out-of-range, or if the slot is empty, this method
+        * will return an Entry with empty pointers. This method can be called by
+        * any thread.
+        * @param[in] parameterIndex Position of the Parameter in the list of
+        *   parameters of its Instrument.
+        * @param[in] generation Generation of the slot when \p parameterIndex was
+        *   retrieved.
+        */
+        Entry get(unsigned short parameterIndex, uint32_t generation) const;
+
+        /**
+        * Returns the ParameterGenerator stored at the given index, just like get(),
+        * but only as a raw pointer, or nullptr if the Entry is not found or if
+        * \p generation is not the slot's. Unlike get(), this method does not
+        * copy any shared pointer nor announce itself as a reader, so it must only
+        * be called by the real-time thread. The latter is the one that publishes
+        * snapshots, so the Snapshot it reads cannot be replaced in the meantime.
+        * @param[in] parameterIndex Position of the Parameter in the list of
+        *   parameters of its Instrument.
+        * @param[in] generation Generation of the slot when \p parameterIndex was
+        *   retrieved.
         */
-        void remove(StringView parameterIdentifier);
+        ParameterGenerator* getGenerator(unsigned short parameterIndex, uint32_t generation) const;
+
+        /**
+        * Returns a copy of the current Snapshot, which can then be modified and
+        * published. This method allocates memory, so it must only be called by a
+        * non real-time thread.
+        */
+        std::unique_ptr<Snapshot> copySnapshot() const;
+
+        /**
+        * Replaces the current Snapshot with \p newSnapshot, and returns the
+        * previous one. The register takes ownership of \p newSnapshot, and the
+        * caller takes ownership of the returned Snapshot, which must be passed to a
+        * non real-time thread and only deleted after a call to synchronize(). This
+        * method neither allocates nor frees any memory, and is meant to be called
+        * by the real-time thread.
+        * @param[in] newSnapshot The Snapshot to publish. It must not be null.
+        */
+        Snapshot* publish(Snapshot* newSnapshot);
+
+        /**
+        * Waits until every thread that was reading the register when this method
+        * was called is done, so that the snapshots replaced before the call can
+        * be safely deleted. This method blocks, so it must only be called by a
+        * non real-time thread.
+        */
+        void synchronize();
 
     private:
-        std::unordered_map<StringView, Entry> m_data;
+
+        /**
+        * \class ReadScope ParameterRegister.h
+        * Announces the calling thread as a reader of the register for as long as
+        * the ReadScope exists, so that synchronize() waits for it.
+        */
+        class ReadScope
+        {
+        public:
+            ReadScope(const ParameterRegister& parameterRegister);
+            ~ReadScope();
+
+            ReadScope(const ReadScope&) = delete;
+            ReadScope& operator=(const ReadScope&) = delete;
+
+        private:
+            std::atomic<uint32_t>& m_numReaders;
+
+            /** Returns the reader counter of the current epoch, once incremented */
+            static std::atomic<uint32_t>& enter(const ParameterRegister& parameterRegister);
+        };
+
+        std::atomic<Snapshot*> m_snapshot;
+
+        /**
+        * Readers are counted separately for the current and the previous epoch.
+        * Each call to synchronize() starts a new epoch, and waits for the readers
+        * of the previous one to leave.
+        */
+        std::atomic<unsigned char> m_epoch;
+        mutable std::atomic<uint32_t> m_numReaders[2];
+
+        /** Prevents two threads from running synchronize() concurrently */
+        Mutex m_synchronizationLock;
     };
 }
\ No newline at end of file
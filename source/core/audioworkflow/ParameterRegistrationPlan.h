@@ -26,8 +26,10 @@
 #include <vector>
 
 #include "../../utility/StringView.h"
+#include "../../config/AudioConfig.h"
 #include "parameter/ParameterGenerator.h"
 #include "workflow/Stream.h"
+#include "ParameterRegister.h"
 
 namespace ANGLECORE
 {
@@ -35,7 +37,9 @@ namespace ANGLECORE
     * \struct ParameterRegistrationPlan ParameterRegistrationPlan.h
     * When the end-user asks to add an Instrument to an AudioWorkflow or to remove
     * one from it, an instance of this structure is created to plan an update of its
-    * parameter registers.
+    * parameter registers. The instructions are turned into new snapshots of the
+    * registers by a non real-time thread, so that the real-time thread only has
+    * to publish them when executing the plan.
     */
     struct ParameterRegistrationPlan
     {
@@ -48,12 +52,16 @@ namespace ANGLECORE
         {
             unsigned short rackNumber;
             StringView parameterIdentifier;
+
+            /** Position of the Parameter in the list of parameters of its Instrument */
+            unsigned short parameterIndex;
             std::shared_ptr<ParameterGenerator> parameterGenerator;
             std::shared_ptr<Stream> parameterStream;
 
-            Instruction(unsigned short rackNumber, StringView parameterIdentifier, std::shared_ptr<ParameterGenerator> parameterGenerator, std::shared_ptr<Stream> parameterStream) :
+            Instruction(unsigned short rackNumber, StringView parameterIdentifier, unsigned short parameterIndex, std::shared_ptr<ParameterGenerator> parameterGenerator, std::shared_ptr<Stream> parameterStream) :
                 rackNumber(rackNumber),
                 parameterIdentifier(parameterIdentifier),
+                parameterIndex(parameterIndex),
                 parameterGenerator(parameterGenerator),
                 parameterStream(parameterStream)
             {}
@@ -61,5 +69,13 @@ namespace ANGLECORE
 
         std::vector<Instruction> removeInstructions;
         std::vector<Instruction> addInstructions;
+
+        /**
+        * Snapshots to publish into the parameter register of each rack, or null
+        * for the racks the plan does not modify. Once the plan is executed, they
+        * are replaced by the snapshots they took the place of, which must then be
+        * deleted by a non real-time thread.
+        */
+        std::unique_ptr<ParameterRegister::Snapshot> snapshots[ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
     };
 }
\ No newline at end of file
@@ -24,11 +24,15 @@
 
 namespace ANGLECORE
 {
-    Voice::Voice() :
+    Voice::Voice(StreamArena& streamArena) :
         isFree(true),
         isOn(false),
-        currentNoteNumber(0)
+        currentNoteNumber(0),
+        voiceContext(streamArena),
+        submixer(std::make_shared<Mixer>(1, ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE))
     {
+        submixer->turnVoiceOn(0);
+
         /*
         * The racks are all empty by default, so they should not contain any
         * instrument.
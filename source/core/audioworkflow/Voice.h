@@ -27,6 +27,7 @@
 #include "../../config/AudioConfig.h"
 #include "instrument/Instrument.h"
 #include "VoiceContext.h"
+#include "Mixer.h"
 
 namespace ANGLECORE
 {
@@ -62,9 +63,20 @@ namespace ANGLECORE
         VoiceContext voiceContext;
         Rack racks[ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE];
 
+        /**
+        * Mixer that sums the output of every rack of the Voice, hereby producing
+        * the Voice's submix. Since it belongs to the Voice, the submix is rendered
+        * right after the Voice's instruments, while their output streams are
+        * still in the cache, and in parallel with the other voices when the
+        * Renderer allows it. Its only Voice is always on.
+        */
+        std::shared_ptr<Mixer> submixer;
+
         /**
         * Creates a Voice only comprised of empty racks.
+        * @param[in] streamArena The StreamArena to create the VoiceContext's
+        *   streams with.
         */
-        Voice();
+        Voice(StreamArena& streamArena);
     };
 }
\ No newline at end of file
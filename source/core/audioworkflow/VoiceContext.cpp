@@ -33,27 +33,50 @@ namespace ANGLECORE
     ***************************************************/
 
     VoiceContext::RatioCalculator::RatioCalculator() :
-        Worker(Input::NUM_INPUTS, 1)
+        DevirtualizedWorker<VoiceContext::RatioCalculator>(Input::NUM_INPUTS, 1)
     {}
 
     void VoiceContext::RatioCalculator::work(unsigned int numSamplesToWorkOn)
     {
         /*
-        * To compute the division with better speed, we use the reciprocal of the
-        * sample rate which has already been computed for us, and compute a
-        * multiplication instead of a division:
+        * If both inputs are constant, which is the case as long as the Voice's
+        * frequency is not gliding, so is the ratio, and we only need to compute it
+        * once. This also lets the workers reading the ratio skip their own
+        * per-sample work.
         */
+        if (isInputConstant(Input::FREQUENCY) && isInputConstant(Input::SAMPLE_RATE_RECIPROCAL))
+        {
+            setOutputConstant(0, getInputConstantValue(Input::FREQUENCY) * getInputConstantValue(Input::SAMPLE_RATE_RECIPROCAL));
+            return;
+        }
+
+        /*
+        * Otherwise, to compute the division with better speed, we use the
+        * reciprocal of the sample rate which has already been computed for us, and
+        * compute a multiplication instead of a division. The sample rate being
+        * constant most of the time, we use its value directly when we can:
+        */
+        setOutputVarying(0);
         const floating_type* frequency = getInputStream(Input::FREQUENCY);
-        const floating_type* sampleRateReciprocal = getInputStream(Input::SAMPLE_RATE_RECIPROCAL);
         floating_type* output = getOutputStream(0);
-        for (unsigned int i = 0; i < numSamplesToWorkOn; i++)
-            output[i] = frequency[i] * sampleRateReciprocal[i];
+        if (isInputConstant(Input::SAMPLE_RATE_RECIPROCAL))
+        {
+            const floating_type sampleRateReciprocal = getInputConstantValue(Input::SAMPLE_RATE_RECIPROCAL);
+            for (unsigned int i = 0; i < numSamplesToWorkOn; i++)
+                output[i] = frequency[i] * sampleRateReciprocal;
+        }
+        else
+        {
+            const floating_type* sampleRateReciprocal = getInputStream(Input::SAMPLE_RATE_RECIPROCAL);
+            for (unsigned int i = 0; i < numSamplesToWorkOn; i++)
+                output[i] = frequency[i] * sampleRateReciprocal[i];
+        }
     }
 
     /* VoiceContext
     ***************************************************/
 
-    VoiceContext::VoiceContext() :
+    VoiceContext::VoiceContext(StreamArena& streamArena) :
 
         /*
         * We initialize the frequency parameter with a minimal value of
@@ -63,10 +86,10 @@ namespace ANGLECORE
         frequency(ANGLECORE_FREQUENCY_PARAMETER_ID, ANGLECORE_EPSILON, ANGLECORE_EPSILON, ANGLECORE_MAX_SAMPLE_RATE, Parameter::SmoothingMethod::MULTIPLICATIVE, false, 0)
     {
         frequencyGenerator = std::make_shared<ParameterGenerator>(frequency);
-        frequencyStream = std::make_shared<Stream>();
+        frequencyStream = std::make_shared<Stream>(streamArena);
         ratioCalculator = std::make_shared<RatioCalculator>();
-        frequencyOverSampleRateStream = std::make_shared<Stream>();
+        frequencyOverSampleRateStream = std::make_shared<Stream>(streamArena);
 
-        velocityStream = std::make_shared<Stream>();
+        velocityStream = std::make_shared<Stream>(streamArena);
     }
 }
\ No newline at end of file
@@ -22,7 +22,7 @@
 
 #pragma once
 
-#include "workflow/Worker.h"
+#include "workflow/DevirtualizedWorker.h"
 #include "parameter/Parameter.h"
 #include "parameter/ParameterGenerator.h"
 #include "workflow/Stream.h"
@@ -49,7 +49,7 @@ namespace ANGLECORE
         * shorter computation time.
         */
         class RatioCalculator :
-            public Worker
+            public DevirtualizedWorker<RatioCalculator>
         {
         public:
 
@@ -89,7 +89,8 @@ namespace ANGLECORE
         * Worker to a non null pointer. Note that this method does not do any
         * connection between streams and workers, as this is the responsability of
         * the AudioWorkflow to which the VoiceContext belong.
+        * @param[in] streamArena The StreamArena to create the streams with.
         */
-        VoiceContext();
+        VoiceContext(StreamArena& streamArena);
     };
 }
\ No newline at end of file
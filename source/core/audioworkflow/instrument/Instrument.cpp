@@ -47,7 +47,7 @@ namespace ANGLECORE
     ***************************************************/
 
     Instrument::Instrument(const std::vector<ContextParameter>& contextParameters, const std::vector<Parameter>& parameters) :
-        Worker(contextParameters.size() + parameters.size(), ANGLECORE_NUM_CHANNELS),
+        DevirtualizedWorker<Instrument>(contextParameters.size() + parameters.size(), ANGLECORE_NUM_CHANNELS),
 
         m_contextParameters(contextParameters),
         m_parameters(parameters),
@@ -128,6 +128,14 @@ namespace ANGLECORE
     void Instrument::turnOn()
     {
         m_state = State::ON;
+
+        /*
+        * The output streams were marked as constant when the Instrument went off,
+        * so we mark them as varying again before play() writes into them.
+        */
+        for (const std::shared_ptr<Stream>& outputStream : getOutputBus())
+            if (outputStream)
+                outputStream->setVarying();
     }
 
     void Instrument::turnOff()
@@ -198,7 +206,7 @@ namespace ANGLECORE
                     /*
                     * Note that, as a worker, an instrument is always guaranteed to
                     * receive a valid number of samples to render, which is a number
-                    * greater than 0 and less than ANGLECORE_FIXED_STREAM_SIZE. We
+                    * greater than 0 and less than the size of its streams. We
                     * must remember to pass that guarantee to the play() method
                     * here, and only call it if the number of samples queried is non
                     * null:
@@ -208,8 +216,8 @@ namespace ANGLECORE
                         /*
                         * Note that, as a worker, an instrument is always guaranteed
                         * to receive a valid number of samples to render, which is a
-                        * number greather than 0 and less than
-                        * ANGLECORE_FIXED_STREAM_SIZE. We will pass that guarantee
+                        * number greather than 0 and less than the size of its
+                        * streams. We will pass that guarantee
                         * to the play() method here:
                         */
                         play(remainingSamples);
@@ -250,13 +258,12 @@ namespace ANGLECORE
             * no longer generate any output and simply return immediately.
             */
 
-            /* So we first fill in the output streams with zeros: */
+            /*
+            * So we first fill in the output streams with zeros, marking them as
+            * constant at the same time:
+            */
             for (unsigned short c = 0; c < ANGLECORE_NUM_CHANNELS; c++)
-            {
-                floating_type* output = getOutputStream(c);
-                for (unsigned int i = 0; i < ANGLECORE_FIXED_STREAM_SIZE; i++)
-                    output[i] = static_cast<floating_type>(0.0);
-            }
+                setOutputConstant(c, static_cast<floating_type>(0.0));
 
             /* And then we enter the OFF state: */
             m_state = State::OFF;
@@ -266,8 +273,13 @@ namespace ANGLECORE
 
             /*
             * In the OFF state, we do not compute anything and return immediately,
-            * in order to save some computation time.
+            * in order to save some computation time. The output streams already
+            * hold zeros, so setting them constant again costs nothing, unless
+            * they share their buffers with the instruments of other voices, in
+            * which case the zeros need to be written again.
             */
+            for (unsigned short c = 0; c < ANGLECORE_NUM_CHANNELS; c++)
+                setOutputConstant(c, static_cast<floating_type>(0.0));
 
             break;
         }
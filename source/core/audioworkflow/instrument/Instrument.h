@@ -26,7 +26,7 @@
 #include <unordered_map>
 #include <stdint.h>
 
-#include "../workflow/Worker.h"
+#include "../workflow/DevirtualizedWorker.h"
 #include "../parameter/Parameter.h"
 #include "../../../utility/StringView.h"
 
@@ -37,7 +37,7 @@ namespace ANGLECORE
     * Worker that generates audio within an AudioWorkflow.
     */
     class Instrument :
-        public Worker
+        public DevirtualizedWorker<Instrument>
     {
     public:
 
@@ -139,6 +139,9 @@ namespace ANGLECORE
         * Generates the given number of samples according to the Instrument's
         * internal state. This method overrides the pure virtual work() method from
         * the Worker class, and it will only be called by the real-time thread.
+        * Subclasses should not override this method, but implement play()
+        * instead, as the Renderer calls Instrument::work() without any virtual
+        * dispatch.
         * @param[in] numSamplesToWorkOn Number of samples to generate.
         */
         void work(unsigned int numSamplesToWorkOn);
@@ -21,10 +21,10 @@
 **********************************************************************/
 
 #include <algorithm>
+#include <cmath>
 
 #include "ParameterGenerator.h"
 #include "../../../config/MathConfig.h"
-#include "../../../math/FastMath.h"
 #include "../../../config/RenderingConfig.h"
 
 namespace ANGLECORE
@@ -32,7 +32,7 @@ namespace ANGLECORE
     ParameterGenerator::ParameterGenerator(const Parameter& parameter) :
 
         /* A ParameterGenerator has no input and only one output */
-        Worker(0, 1),
+        DevirtualizedWorker<ParameterGenerator>(0, 1),
 
         m_parameter(parameter),
         m_currentValue(parameter.defaultValue),
@@ -44,17 +44,14 @@ namespace ANGLECORE
         */
         m_currentState(State::TRANSIENT_TO_STEADY),
 
-        /*
-        * In case multiple requests are received before a new rendering session
-        * begins, only the most recent will be processed. Therefore, the request
-        * queue needs no more space than one slot.
-        */
-        m_requestQueue(1)
+        m_clock(0),
+        m_numScheduledChanges(0)
     {}
 
-    void ParameterGenerator::postParameterChangeRequest(std::shared_ptr<ParameterChangeRequest>&& request)
+    void ParameterGenerator::postParameterChangeRequest(const ParameterChangeRequest& request)
     {
-        m_requestQueue.push(std::move(request));
+        m_requestMailbox.getBackBuffer() = request;
+        m_requestMailbox.publish();
     }
 
     void ParameterGenerator::work(unsigned int numSamplesToWorkOn)
@@ -65,154 +62,230 @@ namespace ANGLECORE
         * ===================================
         */
 
+        /* Has a ParameterChangeRequest been received? ... */
+        if (m_requestMailbox.update())
         {
             /*
-            * We define a scope here so that the following pointer is deleted as
-            * soon as possible. This pointer will hold a copy of any
-            * ParameterChangeRequest that has been sent by the Master to the
-            * ParameterGenerator. When it is deleted, its reference count will
-            * decrement, and hereby signal to the Master the ParameterChangeRequest
-            * has been processed.
+            * ... YES! So we need to process the request first. The mailbox only
+            * ever holds the most recent request, so any request posted in between
+            * two rendering sessions has been overridden.
             */
-            std::shared_ptr<const ParameterChangeRequest> request;
+            const ParameterChangeRequest& request = m_requestMailbox.getFrontBuffer();
+            applyChange(request.newValue, request.durationInSamples);
+        }
+
+        /*
+        * ===================
+        * STEP 2/2: RENDERING
+        * ===================
+        */
+
+        floating_type* output = getOutputStream(0);
+
+        /*
+        * Since a Worker is only called within a consistent rendering sequence, a
+        * ParameterGenerator will only be called if its unique output stream is
+        * connected to the rendering pipeline. Therefore, the 'output' pointer
+        * should never be null, and we will not verify that assertion in the code.
+        */
+
+        /*
+        * The scheduled changes that fall within this rendering session split it
+        * into segments: we render the segment preceding each change, then apply
+        * the change, and carry on with the next segment. Changes whose time has
+        * already passed, which only happens if the ParameterGenerator was not
+        * rendered for a while, are applied at the beginning of the session. This
+        * way, timestamped automation is sample-accurate without requiring the
+        * Master to split its rendering sessions.
+        */
+        const uint64_t sessionEnd = m_clock + numSamplesToWorkOn;
+        uint32_t segmentStart = 0;
+        unsigned int numAppliedChanges = 0;
+        while (numAppliedChanges < m_numScheduledChanges && m_scheduledChanges[numAppliedChanges].time < sessionEnd)
+        {
+            const ScheduledChange& change = m_scheduledChanges[numAppliedChanges];
+            const uint32_t changePosition = change.time > m_clock ? static_cast<uint32_t>(change.time - m_clock) : 0;
 
-            /* Has a ParameterChangeRequest been received? ... */
-            if (m_requestQueue.pop(request) && request)
+            if (changePosition > segmentStart)
             {
-                /*
-                * ... YES! So we need to process the request first. Note that null
-                * pointers are ignored.
-                */
+                renderSegment(output + segmentStart, changePosition - segmentStart, false);
+                segmentStart = changePosition;
+            }
+
+            applyChange(change.newValue, change.durationInSamples);
+            numAppliedChanges++;
+        }
 
-                uint32_t durationInSamples = m_parameter.minimalSmoothingEnabled ? std::max(request->durationInSamples, m_parameter.minimalSmoothingDurationInSamples) : request->durationInSamples;
+        /*
+        * The last segment always contains at least one sample, since the changes
+        * we applied are all located before the end of the session. It covers the
+        * whole output stream if no change was applied in the middle of the session.
+        */
+        renderSegment(output + segmentStart, numSamplesToWorkOn - segmentStart, segmentStart == 0);
+
+        /* Finally, we remove the changes we have applied */
+        if (numAppliedChanges > 0)
+        {
+            for (unsigned int c = numAppliedChanges; c < m_numScheduledChanges; c++)
+                m_scheduledChanges[c - numAppliedChanges] = m_scheduledChanges[c];
+            m_numScheduledChanges -= numAppliedChanges;
+        }
+
+        m_clock = sessionEnd;
+    }
+
+    bool ParameterGenerator::scheduleParameterChange(uint32_t offset, floating_type newValue, uint32_t durationInSamples)
+    {
+        if (m_numScheduledChanges >= ANGLECORE_PARAMETER_MAX_NUM_SCHEDULED_CHANGES)
+            return false;
+
+        /*
+        * The changes are kept sorted by time. Changes scheduled for the same time
+        * are applied in the order they were scheduled, so we insert the new change
+        * after them.
+        */
+        const uint64_t time = m_clock + offset;
+        unsigned int c = m_numScheduledChanges;
+        while (c > 0 && m_scheduledChanges[c - 1].time > time)
+        {
+            m_scheduledChanges[c] = m_scheduledChanges[c - 1];
+            c--;
+        }
+
+        m_scheduledChanges[c].time = time;
+        m_scheduledChanges[c].newValue = newValue;
+        m_scheduledChanges[c].durationInSamples = durationInSamples;
+        m_numScheduledChanges++;
+
+        return true;
+    }
+
+    void ParameterGenerator::applyChange(floating_type newValue, uint32_t requestedDurationInSamples)
+    {
+        uint32_t durationInSamples = m_parameter.minimalSmoothingEnabled ? std::max(requestedDurationInSamples, m_parameter.minimalSmoothingDurationInSamples) : requestedDurationInSamples;
+
+        /*
+        * If the requested value exceeds the range of the parameter, we need
+        * to clamp it into the right interval. Although the std::clamp
+        * function would have been perfect for that, it is only available in
+        * C++17 and forth, so for backward compatibility, we will simply use
+        * a combination of std::min and std::max:
+        */
+        floating_type targetValue = std::max(m_parameter.minimalValue, std::min(newValue, m_parameter.maximalValue));
+
+        /* Is this a smooth change? ... */
+        if (durationInSamples > 0)
+        {
+            /*
+            * ... YES! A smooth change should be performed. Therefore, we
+            * enter the TRANSIENT state.
+            */
+            m_currentState = State::TRANSIENT;
+
+            /*
+            * And we fill in the transient tracker. The first three
+            * attributes are easy to fill:
+            */
+            m_transientTracker.targetValue = targetValue;
+            m_transientTracker.transientDurationInSamples = durationInSamples;
+            m_transientTracker.position = 0;
+
+            /*
+            * Only the 'increment' requires a bit more calculations, as it
+            * depends on the parameter's smoothing method. We first
+            * initialize it to a default value:
+            */
+            m_transientTracker.increment = m_parameter.smoothingMethod == Parameter::SmoothingMethod::MULTIPLICATIVE ? 1.0 : 0.0;
+
+            /*
+            * And then we compute it depending on the smoothing technique.
+            */
+            switch (m_parameter.smoothingMethod)
+            {
+            case Parameter::SmoothingMethod::ADDITIVE:
 
                 /*
-                * If the requested value exceeds the range of the parameter, we need
-                * to clamp it into the right interval. Although the std::clamp
-                * function would have been perfect for that, it is only available in
-                * C++17 and forth, so for backward compatibility, we will simply use
-                * a combination of std::min and std::max:
+                * We know that durationInSamples > 0, so there is no need to
+                * test for a division by 0 here.
                 */
-                floating_type targetValue = std::max(m_parameter.minimalValue, std::min(request->newValue, m_parameter.maximalValue));
+                m_transientTracker.increment = (targetValue - m_currentValue) / durationInSamples;
 
-                /* Is this a smooth change? ... */
-                if (durationInSamples > 0)
-                {
-                    /*
-                    * ... YES! A smooth change should be performed. Therefore, we
-                    * enter the TRANSIENT state.
-                    */
-                    m_currentState = State::TRANSIENT;
+                break;
 
-                    /*
-                    * And we fill in the transient tracker. The first three
-                    * attributes are easy to fill:
-                    */
-                    m_transientTracker.targetValue = targetValue;
-                    m_transientTracker.transientDurationInSamples = durationInSamples;
-                    m_transientTracker.position = 0;
+            case Parameter::SmoothingMethod::MULTIPLICATIVE:
 
-                    /*
-                    * Only the 'increment' requires a bit more calculations, as it
-                    * depends on the parameter's smoothing method. We first
-                    * initialize it to a default value:
-                    */
-                    m_transientTracker.increment = m_parameter.smoothingMethod == Parameter::SmoothingMethod::MULTIPLICATIVE ? 1.0 : 0.0;
+                /*
+                * To generate a geometric sequence from the parameter's
+                * current value to its next, we must ensure both values at
+                * the beginning and end of the sequence are positive
+                * (otherwise, no such sequence exists). Therefore, we use
+                * two low-bounded auxiliary variables, 'startValue' and
+                * 'endValue', to compute the increment. To declare and use
+                * those two, we need to open a new scope within the case
+                * statement:
+                */
+                {
+                    floating_type startValue = std::max(m_currentValue, static_cast<floating_type>(ANGLECORE_EPSILON));
+                    floating_type endValue = std::max(targetValue, static_cast<floating_type>(ANGLECORE_EPSILON));
 
                     /*
-                    * And then we compute it depending on the smoothing technique.
+                    * We now know for sure that both 'startValue' and
+                    * 'endValue' are positive, so we can call the log
+                    * function on them:
                     */
-                    switch (m_parameter.smoothingMethod)
-                    {
-                    case Parameter::SmoothingMethod::ADDITIVE:
-
-                        /*
-                        * We know that durationInSamples > 0, so there is no need to
-                        * test for a division by 0 here.
-                        */
-                        m_transientTracker.increment = (targetValue - m_currentValue) / durationInSamples;
-
-                        break;
-
-                    case Parameter::SmoothingMethod::MULTIPLICATIVE:
-
-                        /*
-                        * To generate a geometric sequence from the parameter's
-                        * current value to its next, we must ensure both values at
-                        * the beginning and end of the sequence are positive
-                        * (otherwise, no such sequence exists). Therefore, we use
-                        * two low-bounded auxiliary variables, 'startValue' and
-                        * 'endValue', to compute the increment. To declare and use
-                        * those two, we need to open a new scope within the case
-                        * statement:
-                        */
-                        {
-                            floating_type startValue = std::max(m_currentValue, static_cast<floating_type>(ANGLECORE_EPSILON));
-                            floating_type endValue = std::max(targetValue, static_cast<floating_type>(ANGLECORE_EPSILON));
-
-                            /*
-                            * We now know for sure that both 'startValue' and
-                            * 'endValue' are positive, so we can call the log
-                            * function on them:
-                            */
-                            floating_type epsilon = (log(endValue) - log(startValue)) / durationInSamples;
-
-                            /*
-                            * Here we use FastMath::exp to compute the increment,
-                            * which is a lot faster than using its C counterpart,
-                            * and provides a good approximation assuming we have:
-                            * -0.5 <= epsilon <= 0.5.
-                            */
-                            m_transientTracker.increment = FastMath::exp(epsilon);
-                        }
-                        break;
-                    }
+                    floating_type epsilon = (log(endValue) - log(startValue)) / durationInSamples;
 
                     /*
-                    * Finally, if we are performing a multiplicative transient which
-                    * starts on the value 0, then we need to change the parameter's
-                    * current value to ANGLECORE_EPSILON in order for the geometric
-                    * sequence to start and render properly.
+                    * Since the ramp is computed in closed form, as the
+                    * start value times a power of the increment, the
+                    * increment must be accurate for the ramp to end on
+                    * its target. We therefore use the C exponential
+                    * function, which is only called once per request.
                     */
-                    if (m_parameter.smoothingMethod == Parameter::SmoothingMethod::MULTIPLICATIVE)
-                        m_currentValue = std::max(m_currentValue, static_cast<floating_type>(ANGLECORE_EPSILON));
-                }
-
-                /*
-                * ... NO! The change should be instantaneous. Therefore, we need to
-                * enter the TRANSIENT_TO_STEADY state, as if we had just completed
-                * an instantaneous transient.
-                */
-                else
-                {
-                    m_currentState = State::TRANSIENT_TO_STEADY;
-                    m_currentValue = targetValue;
+                    m_transientTracker.increment = std::exp(epsilon);
+                    m_transientTracker.logIncrement = epsilon;
                 }
+                break;
             }
 
             /*
-            * Once here, the 'request' pointer will be deleted, hereby decrementing
-            * its reference count by one. Since parameter change requests are
-            * supposed to be hold by the Master and copied before being sent to the
-            * ParameterGenerator, no memory deallocation should occur here.
+            * Finally, if we are performing a multiplicative transient which
+            * starts on the value 0, then we need to change the parameter's
+            * current value to ANGLECORE_EPSILON in order for the geometric
+            * sequence to start and render properly.
             */
-        }
+            if (m_parameter.smoothingMethod == Parameter::SmoothingMethod::MULTIPLICATIVE)
+                m_currentValue = std::max(m_currentValue, static_cast<floating_type>(ANGLECORE_EPSILON));
 
-        /*
-        * ===================
-        * STEP 2/2: RENDERING
-        * ===================
-        */
-
-        floating_type* output = getOutputStream(0);
+            /*
+            * The ramp is computed from the value it starts on, rather than
+            * from the previous sample, so we store that value. For
+            * multiplicative ramps, we also precompute the first powers of
+            * the increment, from which the ramp is computed block by block.
+            */
+            m_transientTracker.startValue = m_currentValue;
+            if (m_parameter.smoothingMethod == Parameter::SmoothingMethod::MULTIPLICATIVE)
+            {
+                m_transientTracker.powers[0] = m_transientTracker.increment;
+                for (unsigned int k = 1; k < ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE; k++)
+                    m_transientTracker.powers[k] = m_transientTracker.powers[k - 1] * m_transientTracker.increment;
+            }
+        }
 
         /*
-        * Since a Worker is only called within a consistent rendering sequence, a
-        * ParameterGenerator will only be called if its unique output stream is
-        * connected to the rendering pipeline. Therefore, the 'output' pointer
-        * should never be null, and we will not verify that assertion in the code.
+        * ... NO! The change should be instantaneous. Therefore, we need to
+        * enter the TRANSIENT_TO_STEADY state, as if we had just completed
+        * an instantaneous transient.
         */
+        else
+        {
+            m_currentState = State::TRANSIENT_TO_STEADY;
+            m_currentValue = targetValue;
+        }
+    }
 
+    void ParameterGenerator::renderSegment(floating_type* output, uint32_t numSamples, bool coversWholeStream)
+    {
         /*
         * If we are in a STEADY state, we actually have nothing to do. So we only
         * render samples if we are in a TRANSIENT or TRANSIENT_TO_STEADY state.
@@ -221,6 +294,12 @@ namespace ANGLECORE
         {
         case State::TRANSIENT:
 
+            /*
+            * The output stream is about to hold a transient curve, so its
+            * consumers should no longer consider it constant.
+            */
+            setOutputVarying(0);
+
             {
                 /*
                 * To detect the case of an ending transient, we need to compute the
@@ -231,80 +310,37 @@ namespace ANGLECORE
                 */
                 uint32_t remainingSamples = m_transientTracker.transientDurationInSamples - m_transientTracker.position;
 
-                switch (m_parameter.smoothingMethod)
+                /* We need to check for an ending transient, which would use
+                * less than 'numSamples' samples to terminate:
+                */
+                if (remainingSamples <= numSamples)
                 {
-                case Parameter::SmoothingMethod::ADDITIVE:
-
-                    output[0] = m_currentValue + m_transientTracker.increment;
-
-                    /* We need to check for an ending transient, which would use
-                    * less than 'numSamplesToWorkOn' samples to terminate:
-                    */
-                    if (remainingSamples < numSamplesToWorkOn)
-                    {
-                        /*
-                        * If the transient is very short, then we first fill the
-                        * transient samples (from index 0 to remainingSamples-1),
-                        * and then we fill the rest of the curve with the end value.
-                        * And since the first value of the transient curve has
-                        * already been set at index 0, we start the counter from 1:
-                        */
-                        for (uint32_t i = 1; i < remainingSamples; i++)
-                            output[i] = output[i - 1] + m_transientTracker.increment;
-                        for (uint32_t i = remainingSamples; i < numSamplesToWorkOn; i++)
-                            output[i] = m_transientTracker.targetValue;
-                    }
-                    else
-                    {
-                        /*
-                        * If the transient still needs more samples than
-                        * 'numSamplesToWorkOn' to be complete, then we simply fill
-                        * the samples in one row:
-                        */
-                        for (uint32_t i = 1; i < numSamplesToWorkOn; i++)
-                            output[i] = output[i - 1] + m_transientTracker.increment;
-                    }
-                    break;
-
-                case Parameter::SmoothingMethod::MULTIPLICATIVE:
-
-                    output[0] = m_currentValue * m_transientTracker.increment;
-
-                    /* We need to check for an ending transient, which would use
-                    * less than 'numSamplesToWorkOn' samples to terminate:
+                    /*
+                    * If the transient is very short, then we first fill the
+                    * transient samples (from index 0 to remainingSamples-2), and
+                    * then we fill the rest of the curve with the end value. The
+                    * last sample of the transient is set to the end value as well,
+                    * so that the curve lands exactly on its target.
                     */
-                    if (remainingSamples < numSamplesToWorkOn)
-                    {
-                        /*
-                        * If the transient is very short, then we first fill the
-                        * transient samples (from index 0 to remainingSamples-1),
-                        * and then we fill the rest of the curve with the end value.
-                        * And since the first value of the transient curve has
-                        * already been set at index 0, we start the counter from 1:
-                        */
-                        for (uint32_t i = 1; i < remainingSamples; i++)
-                            output[i] = output[i - 1] * m_transientTracker.increment;
-                        for (uint32_t i = remainingSamples; i < numSamplesToWorkOn; i++)
-                            output[i] = m_transientTracker.targetValue;
-                    }
-                    else
-                    {
-                        /*
-                        * If the transient still needs more samples than
-                        * 'numSamplesToWorkOn' to be complete, then we simply fill
-                        * the samples in one row:
-                        */
-                        for (uint32_t i = 1; i < numSamplesToWorkOn; i++)
-                            output[i] = output[i - 1] * m_transientTracker.increment;
-                    }
+                    renderTransient(output, remainingSamples - 1);
+                    for (uint32_t i = remainingSamples - 1; i < numSamples; i++)
+                        output[i] = m_transientTracker.targetValue;
                 }
+                else
+
+                    /*
+                    * If the transient still needs more samples than
+                    * 'numSamples' to be complete, then we simply fill
+                    * the samples in one row:
+                    */
+                    renderTransient(output, numSamples);
             }
 
             /*
-            * We increment the tracker's position by 'numSamplesToWorkOn', since we
+            * We increment the tracker's position by 'numSamples', since we
             * have just rendered that amount of samples:
             */
-            m_transientTracker.position += numSamplesToWorkOn;
+            m_transientTracker.position += numSamples;
 
             /*
             * Immediately afterwards, we check if the transient has just ended. If
@@ -320,10 +356,12 @@ namespace ANGLECORE
             else
 
                 /*
-                * The Master guarantee 'numSamplesToWorkOn' is strictly positive,
-                * so the following access is valid:
+                * Segments are never empty, since the Master guarantees
+                * 'numSamplesToWorkOn' is strictly positive, and since the work()
+                * method never renders an empty segment. So the following access
+                * is valid:
                 */
-                m_currentValue = output[numSamplesToWorkOn - 1];
+                m_currentValue = output[numSamples - 1];
 
             break;
 
@@ -342,17 +380,107 @@ namespace ANGLECORE
             * state.
             */
 
-            /* We fill in the output stream entirely */
-            for (unsigned int i = 0; i < ANGLECORE_FIXED_STREAM_SIZE; i++)
-                output[i] = m_currentValue;
+            /*
+            * If the segment covers the whole rendering session, we fill in the
+            * output stream entirely, and mark it as constant so that its consumers
+            * can skip their per-sample work while the Parameter remains STEADY.
+            */
+            if (coversWholeStream)
+            {
+                setOutputConstant(0, m_currentValue);
 
-            /* And we enter the STEADY state */
-            m_currentState = State::STEADY;
+                /* And we enter the STEADY state */
+                m_currentState = State::STEADY;
+            }
+
+            /*
+            * Otherwise, the segment follows or precedes a change that happens
+            * within the session, so the output stream does not hold a single
+            * value. We only fill in the segment, and we remain in the
+            * TRANSIENT_TO_STEADY state, so that the output stream is entirely
+            * filled on the next session.
+            */
+            else
+            {
+                setOutputVarying(0);
+                for (uint32_t i = 0; i < numSamples; i++)
+                    output[i] = m_currentValue;
+            }
 
             break;
         }
     }
 
+    void ParameterGenerator::renderTransient(floating_type* output, uint32_t numSamples) const
+    {
+        /*
+        * Each sample is computed from the ramp's start value and its position
+        * within the transient, rather than from the previous sample. This removes
+        * the dependency between consecutive samples, so that the compiler can
+        * vectorize the loops below, and it prevents the rounding errors from
+        * accumulating along the ramp. The first sample to render corresponds to
+        * the position following the tracker's current one.
+        */
+        const uint32_t firstPosition = m_transientTracker.position + 1;
+
+        switch (m_parameter.smoothingMethod)
+        {
+        case Parameter::SmoothingMethod::ADDITIVE:
+            {
+                /*
+                * Positions are converted from signed integers, which most SIMD
+                * instruction sets can convert directly, unlike unsigned ones.
+                */
+                const floating_type startValue = m_transientTracker.startValue;
+                const floating_type increment = m_transientTracker.increment;
+                const int32_t signedFirstPosition = static_cast<int32_t>(firstPosition);
+                const int32_t signedNumSamples = static_cast<int32_t>(numSamples);
+                for (int32_t i = 0; i < signedNumSamples; i++)
+                    output[i] = startValue + static_cast<floating_type>(signedFirstPosition + i) * increment;
+            }
+            break;
+
+        case Parameter::SmoothingMethod::MULTIPLICATIVE:
+            {
+                /*
+                * The geometric ramp is computed in blocks: within a block, each
+                * sample is the block's base value times a precomputed power of
+                * the increment, and the base value of the next block is obtained
+                * with one multiplication by the block's last power. The base
+                * value of the first block is computed directly from the start
+                * value and the logarithm of the increment, so that no rounding
+                * error is carried over from one rendering session to the next.
+                */
+                /*
+                * The powers are copied onto the stack, so that the compiler knows
+                * the output stream cannot overlap them.
+                */
+                floating_type powers[ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE];
+                for (unsigned int k = 0; k < ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE; k++)
+                    powers[k] = m_transientTracker.powers[k];
+
+                floating_type blockBase = m_transientTracker.startValue * std::exp(m_transientTracker.logIncrement * static_cast<floating_type>(firstPosition - 1));
+
+                /*
+                * Full blocks have a constant length, which lets the compiler
+                * unroll and vectorize their loop entirely.
+                */
+                uint32_t blockStart = 0;
+                for (; blockStart + ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE <= numSamples; blockStart += ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE)
+                {
+                    for (uint32_t k = 0; k < ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE; k++)
+                        output[blockStart + k] = blockBase * powers[k];
+                    blockBase *= powers[ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE - 1];
+                }
+
+                /* We finally render the last, incomplete block */
+                for (uint32_t k = 0; blockStart + k < numSamples; k++)
+                    output[blockStart + k] = blockBase * powers[k];
+            }
+            break;
+        }
+    }
+
     void ParameterGenerator::setParameterValue(floating_type newValue)
     {
         /*
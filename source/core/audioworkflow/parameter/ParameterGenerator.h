@@ -23,12 +23,12 @@
 #pragma once
 
 #include <stdint.h>
-#include <memory>
 
-#include "../workflow/Worker.h"
+#include "../workflow/DevirtualizedWorker.h"
 #include "Parameter.h"
-#include "../../../dependencies/farbot/fifo.h"
+#include "../../../utility/TripleBuffer.h"
 #include "ParameterChangeRequest.h"
+#include "../../../config/RenderingConfig.h"
 
 namespace ANGLECORE
 {
@@ -39,7 +39,7 @@ namespace ANGLECORE
     * sudden change to avoid audio glitches.
     */
     class ParameterGenerator :
-        public Worker
+        public DevirtualizedWorker<ParameterGenerator>
     {
     public:
 
@@ -51,15 +51,17 @@ namespace ANGLECORE
         ParameterGenerator(const Parameter& parameter);
 
         /**
-        * Pushes the given request into the request queue. This method uses move
-        * semantics, so it will take ownership of the pointer passed as argument. It
-        * will never be called by the real-time thread, and will only be called by
-        * the non real-time thread upon user request.
+        * Copies the given request into the request mailbox, replacing any request
+        * the real-time thread has not processed yet. Neither this method nor the
+        * real-time thread that processes the request allocates or frees any
+        * memory, and neither waits for the other. It will never be called by the
+        * real-time thread, and will only be called by one non real-time thread
+        * upon user request.
         * @param[in] request The ParameterChangeRequest to post to the
         *   ParameterGenerator. It will not be processed immediately, but before
         *   rendering the next audio block.
         */
-        void postParameterChangeRequest(std::shared_ptr<ParameterChangeRequest>&& request);
+        void postParameterChangeRequest(const ParameterChangeRequest& request);
 
         /**
         * Generates the successive values of the associated Parameter for the next
@@ -78,21 +80,78 @@ namespace ANGLECORE
         */
         void setParameterValue(floating_type newValue);
 
+        /**
+        * Schedules a change of the parameter's value at a precise sample of the
+        * audio block about to be rendered. Unlike the requests posted with
+        * postParameterChangeRequest(), the change can happen in the middle of a
+        * rendering session. This method must never be called by the non real-time
+        * thread, and should only be called by the real-time thread before
+        * rendering the audio block.
+        * @param[in] offset Position of the change, in samples, from the beginning
+        *   of the next rendering session.
+        * @param[in] newValue The new value of the Parameter.
+        * @param[in] durationInSamples Duration of the transient towards the new
+        *   value, in samples.
+        * @return False if the change could not be scheduled, because
+        *   ANGLECORE_PARAMETER_MAX_NUM_SCHEDULED_CHANGES changes are already
+        *   waiting to be rendered.
+        */
+        bool scheduleParameterChange(uint32_t offset, floating_type newValue, uint32_t durationInSamples);
+
     private:
 
+        /**
+        * Changes the parameter's value, either instantly or through a transient,
+        * depending on the requested duration and on the Parameter's minimal
+        * smoothing. The new value is clamped into the Parameter's range.
+        * @param[in] newValue The new value of the Parameter.
+        * @param[in] requestedDurationInSamples Requested duration of the
+        *   transient, in samples.
+        */
+        void applyChange(floating_type newValue, uint32_t requestedDurationInSamples);
+
+        /**
+        * Renders \p numSamples values of the parameter into \p output according
+        * to the current state, and updates the state accordingly.
+        * @param[in] output The memory location to write into.
+        * @param[in] numSamples Number of values to write. It must be positive.
+        * @param[in] coversWholeStream True if the segment covers the whole
+        *   rendering session, in which case a steady value can fill the output
+        *   stream entirely.
+        */
+        void renderSegment(floating_type* output, uint32_t numSamples, bool coversWholeStream);
+
+        /**
+        * Writes the next \p numSamples values of the current transient into
+        * \p output, starting from the position following the transient
+        * tracker's one. The values are computed in closed form, without
+        * depending on each other, so this method does not update the tracker.
+        * @param[in] output The memory location to write into.
+        * @param[in] numSamples Number of values to write. The transient must not
+        *   end before them.
+        */
+        void renderTransient(floating_type* output, uint32_t numSamples) const;
+
         /**
         * \struct TransientTracker ParameterGenerator.h
         * A TransientTracker tracks a Parameter's position while in a transient
         * state. This structure can store how close the Parameter is to its target
-        * value (in terms of remaining samples), as well as the increment to use for
-        * its update.
+        * value (in terms of remaining samples), as well as the value it started
+        * from and the increment to use for its update.
         */
         struct TransientTracker
         {
             floating_type targetValue;
             uint32_t transientDurationInSamples;
             uint32_t position;
+            floating_type startValue;
             floating_type increment;
+
+            /** The natural logarithm of the increment, for multiplicative transients */
+            floating_type logIncrement;
+
+            /** The increment raised to the powers 1 to ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE, for multiplicative transients */
+            floating_type powers[ANGLECORE_PARAMETER_RAMP_BLOCK_SIZE];
         };
 
         /**
@@ -107,19 +166,40 @@ namespace ANGLECORE
             NUM_STATES              /**< Counts the number of possible states */
         };
 
+        /**
+        * \struct ScheduledChange ParameterGenerator.h
+        * A change of the parameter's value scheduled at a precise sample (see
+        * scheduleParameterChange()).
+        */
+        struct ScheduledChange
+        {
+            /** Time of the change, on the ParameterGenerator's clock */
+            uint64_t time;
+            floating_type newValue;
+            uint32_t durationInSamples;
+        };
+
         const Parameter& m_parameter;
         floating_type m_currentValue;
         State m_currentState;
 
-        /** Queue for receiving Parameter change requests. */
-        farbot::fifo<
-            std::shared_ptr<const ParameterChangeRequest>,
-            farbot::fifo_options::concurrency::single,
-            farbot::fifo_options::concurrency::single,
-            farbot::fifo_options::full_empty_failure_mode::return_false_on_full_or_empty,
-            farbot::fifo_options::full_empty_failure_mode::overwrite_or_return_default
-        > m_requestQueue;
+        /**
+        * Mailbox for receiving Parameter change requests. Only the latest request
+        * matters, so each new request replaces the previous one, and the
+        * real-time thread checks the mailbox once per rendering session.
+        */
+        TripleBuffer<ParameterChangeRequest> m_requestMailbox;
 
         TransientTracker m_transientTracker;
+
+        /**
+        * Number of samples the ParameterGenerator has rendered since its
+        * creation, which is used to locate the scheduled changes.
+        */
+        uint64_t m_clock;
+
+        /** Changes waiting to be rendered, sorted by time */
+        ScheduledChange m_scheduledChanges[ANGLECORE_PARAMETER_MAX_NUM_SCHEDULED_CHANGES];
+        unsigned int m_numScheduledChanges;
     };
 }
\ No newline at end of file
@@ -80,4 +80,37 @@ namespace ANGLECORE
         }
         return voiceAssignments;
     }
+
+    bool VoiceAssigner::getVoiceSegmentStarts(const std::vector<VoiceAssignment>& voiceAssignments, uint32_t* segmentStarts)
+    {
+        uint32_t size = voiceAssignments.size();
+        uint32_t i = 0;
+
+        /* We first skip the workers that are not assigned to any voice... */
+        while (i < size && voiceAssignments[i].isNull)
+            i++;
+
+        /*
+        * ... Then, for each voice, we register the position of its segment and
+        * skip all of its workers. Empty segments simply start where the next
+        * segment does.
+        */
+        for (unsigned short v = 0; v < ANGLECORE_NUM_VOICES; v++)
+        {
+            segmentStarts[v] = i;
+            while (i < size && !voiceAssignments[i].isNull && voiceAssignments[i].voiceNumber == v)
+                i++;
+        }
+        segmentStarts[ANGLECORE_NUM_VOICES] = i;
+
+        /*
+        * Finally, every remaining worker should not be assigned to any voice.
+        * Otherwise, the voices are not grouped in increasing order, and the
+        * sequence does not follow the expected layout.
+        */
+        while (i < size && voiceAssignments[i].isNull)
+            i++;
+
+        return i == size;
+    }
 }
\ No newline at end of file
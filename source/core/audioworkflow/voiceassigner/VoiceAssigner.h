@@ -83,6 +83,26 @@ namespace ANGLECORE
         */
         std::vector<VoiceAssignment> getVoiceAssignments(const std::vector<std::shared_ptr<Worker>>& workers) const;
 
+        /**
+        * Computes the position of each Voice's segment within a rendering sequence
+        * grouped by voice, from the sequence's voice assignments. Such a sequence
+        * starts with workers that are not assigned to any Voice, then contains the
+        * workers of each Voice by increasing voice number, and ends with workers
+        * that are not assigned to any Voice. After this method returns true,
+        * \p segmentStarts[v] contains the position of the first Worker of Voice v,
+        * and the workers of Voice v are located between \p segmentStarts[v]
+        * (included) and \p segmentStarts[v + 1] (excluded). The last value,
+        * \p segmentStarts[ANGLECORE_NUM_VOICES], is the position of the first
+        * Worker after all voices. If the voice assignments do not follow the
+        * layout described above, this method returns false, and the content of
+        * \p segmentStarts should be ignored.
+        * @param[in] voiceAssignments Voice assignments of the rendering sequence,
+        *   as returned by getVoiceAssignments().
+        * @param[out] segmentStarts Array of ANGLECORE_NUM_VOICES + 1 positions to
+        *   fill in.
+        */
+        static bool getVoiceSegmentStarts(const std::vector<VoiceAssignment>& voiceAssignments, uint32_t* segmentStarts);
+
     private:
 
         /**
@@ -0,0 +1,91 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include "Worker.h"
+
+namespace ANGLECORE
+{
+    /**
+    * \class DevirtualizedWorker DevirtualizedWorker.h
+    * Intermediate base class that allows the Renderer to call a Worker's work()
+    * method without any virtual dispatch. It uses the curiously recurring template
+    * pattern: a class Derived should inherit from DevirtualizedWorker<Derived>
+    * rather than directly from Worker. The WorkCall it then provides will call
+    * Derived::work() directly, which the compiler can inline into the
+    * trampoline function.
+    * .
+    * Note that the work() method called is the one defined in Derived, so classes
+    * deriving from Derived should not override work() themselves, as their
+    * implementation would be bypassed by the Renderer.
+    */
+    template<class Derived>
+    class DevirtualizedWorker :
+        public Worker
+    {
+    public:
+
+        /**
+        * Creates a Worker with the given number of inputs and outputs.
+        * @param[in] numInputs Number of inputs.
+        * @param[in] numOutputs Number of output.
+        */
+        DevirtualizedWorker(unsigned short numInputs, unsigned short numOutputs);
+
+        /** Returns a WorkCall that directly calls Derived::work(). */
+        WorkCall getWorkCall() override;
+
+    private:
+
+        /**
+        * Trampoline function stored in the WorkCall, which converts the raw
+        * pointer back into a Derived object and performs a non-virtual call.
+        */
+        static void callWork(void* worker, unsigned int numSamplesToWorkOn);
+    };
+
+    template<class Derived>
+    DevirtualizedWorker<Derived>::DevirtualizedWorker(unsigned short numInputs, unsigned short numOutputs) :
+        Worker(numInputs, numOutputs)
+    {}
+
+    template<class Derived>
+    WorkCall DevirtualizedWorker<Derived>::getWorkCall()
+    {
+        /*
+        * The pointer stored must be the one of the Derived object, which may differ
+        * from this one, so that callWork() can safely cast it back.
+        */
+        WorkCall workCall;
+        workCall.function = &DevirtualizedWorker<Derived>::callWork;
+        workCall.worker = static_cast<Derived*>(this);
+        return workCall;
+    }
+
+    template<class Derived>
+    void DevirtualizedWorker<Derived>::callWork(void* worker, unsigned int numSamplesToWorkOn)
+    {
+        /* The qualified name prevents any virtual dispatch: */
+        static_cast<Derived*>(worker)->Derived::work(numSamplesToWorkOn);
+    }
+}
@@ -26,19 +26,53 @@
 
 namespace ANGLECORE
 {
-    Stream::Stream() :
-        WorkflowItem()
+    Stream::Stream(StreamArena& arena) :
+        WorkflowItem(),
+        m_arena(arena),
+        m_bufferOwner(nullptr),
+        m_isShared(false),
+
+        /*
+        * A Stream is varying by default, as most producers do not keep track of
+        * the constant-ness of their outputs.
+        */
+        m_isConstant(false),
+        m_constantValue(static_cast<floating_type>(0.0))
     {
-        data = new floating_type[ANGLECORE_FIXED_STREAM_SIZE];
+        data = m_arena.allocate();
 
         /* We initialize a Stream by filling it with zeros */
-        for (unsigned int i = 0; i < ANGLECORE_FIXED_STREAM_SIZE; i++)
+        const unsigned int size = getSize();
+        for (unsigned int i = 0; i < size; i++)
             data[i] = static_cast<floating_type>(0.0);
     }
 
+    Stream::Stream(const std::shared_ptr<Stream>& bufferOwner) :
+        WorkflowItem(),
+        m_arena(bufferOwner->m_arena),
+        data(bufferOwner->data),
+        m_bufferOwner(bufferOwner),
+        m_isShared(true),
+        m_isConstant(false),
+        m_constantValue(static_cast<floating_type>(0.0))
+    {
+        /*
+        * The owner can no longer trust its own constant-ness to skip rewriting
+        * its buffer, as this new Stream may write into it as well.
+        */
+        bufferOwner->m_isShared = true;
+    }
+
     Stream::~Stream()
     {
-        delete[] data;
+        /* A shared buffer is only released by its owner */
+        if (!m_bufferOwner)
+            m_arena.release(data);
+    }
+
+    unsigned int Stream::getSize() const
+    {
+        return m_arena.getStreamSize();
     }
 
     const floating_type* Stream::getDataForReading() const
@@ -50,4 +84,31 @@ namespace ANGLECORE
     {
         return data;
     }
+
+    void Stream::setConstant(floating_type value)
+    {
+        if (m_isShared || !m_isConstant || m_constantValue != value)
+        {
+            const unsigned int size = getSize();
+            for (unsigned int i = 0; i < size; i++)
+                data[i] = value;
+            m_constantValue = value;
+            m_isConstant = true;
+        }
+    }
+
+    void Stream::setVarying()
+    {
+        m_isConstant = false;
+    }
+
+    bool Stream::isConstant() const
+    {
+        return m_isConstant;
+    }
+
+    floating_type Stream::getConstantValue() const
+    {
+        return m_constantValue;
+    }
 }
\ No newline at end of file
@@ -22,7 +22,10 @@
 
 #pragma once
 
+#include <memory>
+
 #include "WorkflowItem.h"
+#include "StreamArena.h"
 
 #include "../../../config/RenderingConfig.h"
 
@@ -30,8 +33,16 @@ namespace ANGLECORE
 {
     /**
     * \class Stream Stream.h
-    * Owner of a data stream used in the rendering process. The class implements
-    * RAII.
+    * Owner of a data stream used in the rendering process. The Stream itself is
+    * a lightweight handle: its buffer comes from the StreamArena of the Workflow
+    * it belongs to, and is given back to the arena upon destruction. The class
+    * implements RAII. The size of a Stream is the one of its arena. Its samples
+    * are always of type floating_type, whose precision is set for every Stream
+    * at once at build time (see ANGLECORE_PRECISION).
+    *
+    * Several streams can also share the same buffer, when their content is never
+    * needed at the same time. In that case, the buffer belongs to the first
+    * Stream, and the others keep it alive until they are destroyed.
     */
     class Stream :
         public WorkflowItem
@@ -39,9 +50,20 @@ namespace ANGLECORE
     public:
 
         /**
-        * Creates a stream of constant size for rendering.
+        * Creates a stream of constant size for rendering, filled with zeros.
+        * @param[in] arena The StreamArena to take the Stream's buffer from. It must
+        *   outlive the Stream.
+        */
+        Stream(StreamArena& arena);
+
+        /**
+        * Creates a stream that uses the same buffer as \p bufferOwner, without
+        * resetting its content. The caller is responsible for never having both
+        * streams hold data that is still to be read at the same time.
+        * @param[in] bufferOwner The Stream whose buffer is to be shared. It must
+        *   not be sharing the buffer of another Stream itself.
         */
-        Stream();
+        Stream(const std::shared_ptr<Stream>& bufferOwner);
 
         /**
         * Delete the copy constructor.
@@ -49,19 +71,75 @@ namespace ANGLECORE
         Stream(const Stream& other) = delete;
 
         /**
-        * Deletes the stream and its internal buffer.
+        * Deletes the stream, and gives its internal buffer back to the arena. This
+        * never blocks, even when called by the real-time thread (see
+        * StreamArena::release()).
         */
         ~Stream();
 
+        /** Returns the number of samples in the Stream. */
+        unsigned int getSize() const;
+
         /** Provides a read access to the internal buffer. */
         const floating_type* getDataForReading() const;
 
         /** Provides a write access to the internal buffer. */
         floating_type* getDataForWriting();
 
+        /**
+        * Fills the entire Stream with the given value, and marks it as constant,
+        * so that the workers reading it can use a scalar fast path. The buffer is
+        * only written if the Stream did not already hold that value, which makes
+        * this method very cheap to call on every rendering session. This shortcut
+        * is not taken when the buffer is shared with another Stream, which may
+        * have overwritten it in the meantime.
+        * @param[in] value The value of every sample in the Stream.
+        */
+        void setConstant(floating_type value);
+
+        /**
+        * Marks the Stream as varying, meaning its samples may all be different.
+        * This must be called by the producer of a Stream before it writes anything
+        * but a constant into it.
+        */
+        void setVarying();
+
+        /**
+        * Returns true if every sample of the Stream equals getConstantValue(), and
+        * false if the Stream is varying or if its producer does not keep track of
+        * its constant-ness.
+        */
+        bool isConstant() const;
+
+        /**
+        * Returns the value of every sample in the Stream. This is only meaningful
+        * if isConstant() returns true.
+        */
+        floating_type getConstantValue() const;
+
     private:
 
-        /** Internal buffer */
+        StreamArena& m_arena;
+
+        /** Internal buffer, taken from m_arena */
         floating_type* data;
+
+        /**
+        * Stream that owns the internal buffer, if the latter is shared and does
+        * not belong to this Stream. The buffer is then given back to the arena by
+        * its owner.
+        */
+        std::shared_ptr<Stream> m_bufferOwner;
+
+        /** True if the internal buffer is used by several streams */
+        bool m_isShared;
+
+        /**
+        * Constant-ness of the Stream. These are only modified by the Stream's
+        * producer during a rendering session, and read by the workers called after
+        * it, so they need no synchronization of their own.
+        */
+        bool m_isConstant;
+        floating_type m_constantValue;
     };
 }
\ No newline at end of file
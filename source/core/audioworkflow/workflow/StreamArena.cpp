@@ -0,0 +1,206 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#else
+#include <stdlib.h>
+#include <sys/mman.h>
+#endif
+
+#include "StreamArena.h"
+
+namespace ANGLECORE
+{
+    static_assert(ANGLECORE_CACHE_LINE_SIZE % sizeof(floating_type) == 0, "The cache line size must be a multiple of the size of a sample, so that stream buffers can be aligned.");
+    static_assert((ANGLECORE_STREAM_ARENA_SLAB_SIZE & (ANGLECORE_STREAM_ARENA_SLAB_SIZE - 1)) == 0 && ANGLECORE_STREAM_ARENA_SLAB_SIZE >= ANGLECORE_CACHE_LINE_SIZE, "The slab size must be a power of two, at least as large as a cache line.");
+    static_assert(ANGLECORE_CACHE_LINE_SIZE >= sizeof(void*), "A released buffer must be able to hold the address of the next one.");
+
+    /** Number of samples in a cache line */
+    static const std::size_t CACHE_LINE_LENGTH = ANGLECORE_CACHE_LINE_SIZE / sizeof(floating_type);
+
+    namespace
+    {
+        /**
+        * Allocates a slab of \p size bytes, aligned on ANGLECORE_STREAM_ARENA_SLAB_SIZE,
+        * and asks the operating system to back it with huge pages where possible.
+        * Throws std::bad_alloc on failure, just like operator new.
+        * @param[in] size Size of the slab, which must be a multiple of
+        *   ANGLECORE_STREAM_ARENA_SLAB_SIZE.
+        */
+        floating_type* allocateSlab(std::size_t size)
+        {
+            void* slab = nullptr;
+#if defined(_WIN32)
+            slab = _aligned_malloc(size, ANGLECORE_STREAM_ARENA_SLAB_SIZE);
+#else
+            if (posix_memalign(&slab, ANGLECORE_STREAM_ARENA_SLAB_SIZE, size) != 0)
+                slab = nullptr;
+#endif
+            if (!slab)
+                throw std::bad_alloc();
+
+            /*
+            * Transparent huge pages are only a hint: the slab remains usable if
+            * the system ignores it.
+            */
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            madvise(slab, size, MADV_HUGEPAGE);
+#endif
+            return static_cast<floating_type*>(slab);
+        }
+
+        /** Frees a slab returned by allocateSlab() */
+        void freeSlab(floating_type* slab)
+        {
+#if defined(_WIN32)
+            _aligned_free(slab);
+#else
+            free(slab);
+#endif
+        }
+    }
+
+    StreamArena::StreamArena(unsigned int streamSize) :
+        m_streamSize(streamSize),
+        m_bufferStride((static_cast<std::size_t>(streamSize) + CACHE_LINE_LENGTH - 1) / CACHE_LINE_LENGTH * CACHE_LINE_LENGTH),
+
+        /*
+        * A slab holds as many buffers as it can, and at least one, in which case
+        * it may be larger than ANGLECORE_STREAM_ARENA_SLAB_SIZE.
+        */
+        m_numBuffersPerSlab(static_cast<unsigned int>(std::max(static_cast<std::size_t>(1), ANGLECORE_STREAM_ARENA_SLAB_SIZE / (m_bufferStride * sizeof(floating_type))))),
+        m_slabLength(m_numBuffersPerSlab * m_bufferStride),
+        m_slabSize((m_slabLength * sizeof(floating_type) + ANGLECORE_STREAM_ARENA_SLAB_SIZE - 1) / ANGLECORE_STREAM_ARENA_SLAB_SIZE * ANGLECORE_STREAM_ARENA_SLAB_SIZE),
+
+        m_currentSlab(0),
+        m_numBuffersUsedInCurrentSlab(0),
+        m_releasedBuffers(nullptr)
+    {}
+
+    StreamArena::~StreamArena()
+    {
+        for (floating_type* slab : m_slabs)
+            freeSlab(slab);
+    }
+
+    floating_type* StreamArena::allocate()
+    {
+        std::lock_guard<Mutex> scopedLock(m_lock);
+
+        /* Recycled buffers come first, so that the slabs remain compact */
+        collectReleasedBuffersLocked();
+        if (!m_freeBuffers.empty())
+        {
+            floating_type* buffer = m_freeBuffers.back();
+            m_freeBuffers.pop_back();
+            return buffer;
+        }
+
+        /*
+        * Otherwise, we hand out the next buffer of the current slab, moving on to
+        * the next slab when the current one is full. Slabs are only allocated
+        * when no reserved slab is left.
+        */
+        if (m_slabs.empty())
+            m_slabs.push_back(allocateSlab(m_slabSize));
+        else if (m_numBuffersUsedInCurrentSlab == m_numBuffersPerSlab)
+        {
+            m_currentSlab++;
+            m_numBuffersUsedInCurrentSlab = 0;
+            if (m_currentSlab == m_slabs.size())
+                m_slabs.push_back(allocateSlab(m_slabSize));
+        }
+
+        floating_type* buffer = m_slabs[m_currentSlab] + m_numBuffersUsedInCurrentSlab * m_bufferStride;
+        m_numBuffersUsedInCurrentSlab++;
+        return buffer;
+    }
+
+    void StreamArena::release(floating_type* buffer)
+    {
+        if (!buffer)
+            return;
+
+        /*
+        * We push the buffer onto the stack of released buffers, storing the
+        * address of the current top into the buffer itself. Buffers are only
+        * ever taken off the stack all at once, so this loop is not subject to the
+        * ABA problem.
+        */
+        floating_type* top = m_releasedBuffers.load();
+        do
+            std::memcpy(buffer, &top, sizeof(top));
+        while (!m_releasedBuffers.compare_exchange_weak(top, buffer));
+    }
+
+    void StreamArena::collectReleasedBuffers()
+    {
+        std::lock_guard<Mutex> scopedLock(m_lock);
+        collectReleasedBuffersLocked();
+    }
+
+    void StreamArena::reserve(unsigned int numBuffers)
+    {
+        std::lock_guard<Mutex> scopedLock(m_lock);
+
+        collectReleasedBuffersLocked();
+        std::size_t numAvailableBuffers = m_freeBuffers.size();
+        if (!m_slabs.empty())
+            numAvailableBuffers += (m_slabs.size() - m_currentSlab) * m_numBuffersPerSlab - m_numBuffersUsedInCurrentSlab;
+
+        while (numAvailableBuffers < numBuffers)
+        {
+            m_slabs.push_back(allocateSlab(m_slabSize));
+            numAvailableBuffers += m_numBuffersPerSlab;
+        }
+
+        /* We also make room for releasing every buffer without reallocating */
+        m_freeBuffers.reserve(m_slabs.size() * m_numBuffersPerSlab);
+    }
+
+    unsigned int StreamArena::getCapacity() const
+    {
+        std::lock_guard<Mutex> scopedLock(m_lock);
+        return static_cast<unsigned int>(m_slabs.size()) * m_numBuffersPerSlab;
+    }
+
+    unsigned int StreamArena::getStreamSize() const
+    {
+        return m_streamSize;
+    }
+
+    void StreamArena::collectReleasedBuffersLocked()
+    {
+        /* We take the whole stack at once, and walk through it */
+        floating_type* buffer = m_releasedBuffers.exchange(nullptr);
+        while (buffer)
+        {
+            m_freeBuffers.push_back(buffer);
+            std::memcpy(&buffer, buffer, sizeof(buffer));
+        }
+    }
+}
\ No newline at end of file
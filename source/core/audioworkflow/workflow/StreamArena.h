@@ -0,0 +1,155 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <vector>
+
+#include "../../../config/RenderingConfig.h"
+#include "../../../utility/RealtimeThreadScope.h"
+
+namespace ANGLECORE
+{
+    /**
+    * \class StreamArena StreamArena.h
+    * Allocator of stream buffers. Instead of allocating each buffer separately on
+    * the heap, the StreamArena carves them out of large slabs of
+    * ANGLECORE_STREAM_ARENA_SLAB_SIZE bytes, in the order they are requested.
+    * Each slab is aligned on its own size, so that the operating system can back
+    * it with huge pages, and every buffer is aligned on a cache line. All the
+    * buffers of an arena have the same size, which is chosen upon construction.
+    * Streams created together, such as the streams of one Voice, therefore end up
+    * next to each other in memory, which is also the order in which the Renderer
+    * accesses them. A slab is never moved nor freed before the arena is
+    * destroyed, so that the buffers handed out remain valid while the real-time
+    * thread reads them. Released buffers are recycled by subsequent allocations.
+    * The StreamArena is thread-safe. Apart from release(), which never blocks, its
+    * methods may block and allocate memory, so they should never be called by the
+    * real-time thread.
+    */
+    class StreamArena
+    {
+    public:
+
+        /**
+        * Creates an arena of stream buffers. No memory is allocated until the first
+        * buffer is requested.
+        * @param[in] streamSize Number of samples in each buffer. It should be
+        *   greater than 0.
+        */
+        StreamArena(unsigned int streamSize);
+
+        /** Frees every slab. Every buffer must have been released beforehand. */
+        ~StreamArena();
+
+        StreamArena(const StreamArena& other) = delete;
+        StreamArena& operator=(const StreamArena& other) = delete;
+
+        /**
+        * Returns a buffer of getStreamSize() samples, aligned on a cache line. The
+        * content of the buffer is unspecified. A new slab is allocated if all the
+        * existing ones are full.
+        */
+        floating_type* allocate();
+
+        /**
+        * Gives back a buffer obtained from allocate(), so that it can be reused.
+        * This method neither blocks nor allocates memory, so it can be called by
+        * any thread, including the real-time thread when a Stream is destroyed
+        * there. The buffer is only made available again once a non real-time
+        * thread collects it (see collectReleasedBuffers()).
+        * @param[in] buffer The buffer to release. Null pointers are ignored.
+        */
+        void release(floating_type* buffer);
+
+        /**
+        * Makes the buffers given back through release() available to subsequent
+        * allocations. This is done automatically by allocate() and reserve(), and
+        * can also be called by a non real-time thread once a Request is done, so
+        * that the arena does not hold on to released buffers for too long.
+        */
+        void collectReleasedBuffers();
+
+        /**
+        * Ensures the arena can provide \p numBuffers more buffers without having to
+        * allocate a new slab.
+        * @param[in] numBuffers Number of buffers to make room for.
+        */
+        void reserve(unsigned int numBuffers);
+
+        /** Returns the total number of buffers the current slabs can hold. */
+        unsigned int getCapacity() const;
+
+        /** Returns the number of samples in each buffer of the arena. */
+        unsigned int getStreamSize() const;
+
+    private:
+
+        const unsigned int m_streamSize;
+
+        /**
+        * Distance between two consecutive buffers of a slab, in samples. This is
+        * the stream size rounded up to a whole number of cache lines, so that
+        * every buffer remains aligned.
+        */
+        const std::size_t m_bufferStride;
+
+        /** Number of buffers that fit into one slab, which is at least one */
+        const unsigned int m_numBuffersPerSlab;
+
+        /** Number of samples in one slab */
+        const std::size_t m_slabLength;
+
+        /**
+        * Number of bytes allocated for each slab, which is m_slabLength samples
+        * rounded up to a multiple of ANGLECORE_STREAM_ARENA_SLAB_SIZE.
+        */
+        const std::size_t m_slabSize;
+
+        /**
+        * Slabs allocated so far. The slabs before m_currentSlab are full, and the
+        * ones after it have been reserved but not used yet.
+        */
+        std::vector<floating_type*> m_slabs;
+        std::size_t m_currentSlab;
+
+        /** Number of buffers already handed out from the current slab */
+        unsigned int m_numBuffersUsedInCurrentSlab;
+
+        /** Released buffers, reused first on the next allocations */
+        std::vector<floating_type*> m_freeBuffers;
+
+        /**
+        * Buffers released but not collected yet. They are linked together into a
+        * lock-free stack, each buffer holding the address of the next one in its
+        * first bytes.
+        */
+        std::atomic<floating_type*> m_releasedBuffers;
+
+        /** Moves the released buffers into m_freeBuffers. m_lock must be held. */
+        void collectReleasedBuffersLocked();
+
+        mutable Mutex m_lock;
+    };
+}
@@ -75,6 +75,13 @@ namespace ANGLECORE
         * real-time thread.
         */
         m_outputBus[index] = newOutputStream;
+
+        /*
+        * The new producer of the Stream may not keep track of its constant-ness,
+        * so we mark the Stream as varying to be on the safe side.
+        */
+        if (newOutputStream)
+            newOutputStream->setVarying();
     }
 
     void Worker::disconnectInput(unsigned short inputPortNumber)
@@ -107,6 +114,26 @@ namespace ANGLECORE
         return m_outputBus[index]->getDataForWriting();
     }
 
+    bool Worker::isInputConstant(unsigned short index) const
+    {
+        return m_inputBus[index] && m_inputBus[index]->isConstant();
+    }
+
+    floating_type Worker::getInputConstantValue(unsigned short index) const
+    {
+        return m_inputBus[index]->getConstantValue();
+    }
+
+    void Worker::setOutputConstant(unsigned short index, floating_type value) const
+    {
+        m_outputBus[index]->setConstant(value);
+    }
+
+    void Worker::setOutputVarying(unsigned short index) const
+    {
+        m_outputBus[index]->setVarying();
+    }
+
     const std::vector<std::shared_ptr<const Stream>>& Worker::getInputBus() const
     {
         return m_inputBus;
@@ -121,4 +148,16 @@ namespace ANGLECORE
     {
         return m_hasInputs;
     }
+
+    WorkCall Worker::getWorkCall()
+    {
+        /*
+        * A lambda function without captures can be converted into a plain function
+        * pointer. We use it to forward the call to the virtual work() method.
+        */
+        WorkCall workCall;
+        workCall.function = [](void* worker, unsigned int numSamplesToWorkOn) { static_cast<Worker*>(worker)->work(numSamplesToWorkOn); };
+        workCall.worker = this;
+        return workCall;
+    }
 }
\ No newline at end of file
@@ -27,9 +27,30 @@
 
 #include "WorkflowItem.h"
 #include "Stream.h"
+#include "../../../utility/AlignedAllocator.h"
+#include "../../../config/RenderingConfig.h"
 
 namespace ANGLECORE
 {
+    /**
+    * \struct WorkCall Worker.h
+    * Pair of raw pointers that allows to call a Worker's work() method through a
+    * plain function pointer, without any virtual dispatch nor shared pointer
+    * dereferencing. Calling \p function with \p worker as its first argument is
+    * equivalent to calling the work() method on the corresponding Worker.
+    */
+    struct WorkCall
+    {
+        void (*function)(void*, unsigned int);
+        void* worker;
+    };
+
+    /**
+    * Flat sequence of WorkCall objects, whose memory is aligned on a cache line.
+    * This is the form under which the Renderer consumes its rendering sequence.
+    */
+    typedef std::vector<WorkCall, AlignedAllocator<WorkCall, ANGLECORE_CACHE_LINE_SIZE>> WorkCallSequence;
+
     /**
     * \class Worker Worker.h
     * Represents an agent that processes input streams into output streams. This is
@@ -106,6 +127,41 @@ namespace ANGLECORE
         */
         floating_type* getOutputStream(unsigned short index) const;
 
+        /**
+        * Returns true if the Stream at \p index in the input bus is connected and
+        * constant, in which case the Worker can read its value with
+        * getInputConstantValue() rather than reading it sample by sample.
+        * @param[in] index Index of the stream within the input bus.
+        */
+        bool isInputConstant(unsigned short index) const;
+
+        /**
+        * Returns the value of the constant Stream at \p index in the input bus.
+        * This is only meaningful if isInputConstant() returns true.
+        * @param[in] index Index of the stream within the input bus.
+        */
+        floating_type getInputConstantValue(unsigned short index) const;
+
+        /**
+        * Fills the Stream at \p index in the output bus with the given value, and
+        * marks it as constant (see Stream::setConstant()). Workers that compute
+        * each output sample from the input samples at the same position should
+        * call this method whenever all of their inputs are constant, so that
+        * constant values propagate through the Workflow and whole parts of it
+        * reduce to scalar computations.
+        * @param[in] index Index of the stream within the output bus.
+        * @param[in] value The value of every sample in the output stream.
+        */
+        void setOutputConstant(unsigned short index, floating_type value) const;
+
+        /**
+        * Marks the Stream at \p index in the output bus as varying. Workers that
+        * mark their outputs as constant must call this method before writing
+        * anything else into them.
+        * @param[in] index Index of the stream within the output bus.
+        */
+        void setOutputVarying(unsigned short index) const;
+
         /**
         * Returns a vector containing all the input streams the worker is connected
         * to. The vector may contain null pointers when no stream is attached.
@@ -135,6 +191,14 @@ namespace ANGLECORE
         */
         virtual void work(unsigned int numSamplesToWorkOn) = 0;
 
+        /**
+        * Returns a WorkCall that calls the Worker's work() method. By default, the
+        * WorkCall returned still relies on a virtual call, so subclasses should
+        * preferably derive from the DevirtualizedWorker class, which overrides
+        * this method to call their work() method directly.
+        */
+        virtual WorkCall getWorkCall();
+
     private:
         const unsigned short m_numInputs;
         const unsigned short m_numOutputs;
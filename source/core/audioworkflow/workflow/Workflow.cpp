@@ -28,15 +28,38 @@
 
 namespace ANGLECORE
 {
+    Workflow::Workflow(unsigned int streamSize) :
+        m_streamArena(streamSize)
+    {}
+
     void Workflow::addStream(const std::shared_ptr<Stream>& streamToAdd)
     {
         /* The workflow will be modified only if the given pointer is valid */
         if (streamToAdd)
-
+        {
             /*
             * Since ID's are supposed to be unique, no replacement should occur here
             */
             m_streams[streamToAdd->id] = streamToAdd;
+
+            /*
+            * We also create the stream's entry in the input worker map right away,
+            * with no worker yet. That way, plugging a worker into the stream later
+            * on, which may happen on the real-time thread, only assigns an existing
+            * entry and never allocates memory.
+            */
+            m_inputWorkers.emplace(streamToAdd->id, nullptr);
+        }
+    }
+
+    StreamArena& Workflow::getStreamArena()
+    {
+        return m_streamArena;
+    }
+
+    unsigned int Workflow::getStreamSize() const
+    {
+        return m_streamArena.getStreamSize();
     }
 
     void Workflow::addWorker(const std::shared_ptr<Worker>& workerToAdd)
@@ -143,9 +166,11 @@ namespace ANGLECORE
                     * second. That way, if for some reason the workflow was seen
                     * and used in an intermediate state here, it would still build a
                     * reliable rendering sequence, and prevent the worker from using
-                    * uninitialized memory.
+                    * uninitialized memory. The stream's entry was created when the
+                    * stream was added to the workflow, so the research below
+                    * succeeds, and the assignment does not allocate any memory.
                     */
-                    m_inputWorkers[stream->id] = worker;
+                    m_inputWorkers.find(stream->id)->second = worker;
                     worker->connectOutput(outputPortNumber, stream);
 
                     /* The connection is successfull, so we return true */
@@ -344,118 +369,16 @@ namespace ANGLECORE
         if (sequenceIterator != currentRenderingSequence.cend())
             return;
 
+        /*
+        * We recursively call the completeRenderingSequenceForStream() method on
+        * every stream that will be plugged into the worker once the connection plan
+        * is executed, in order to retrieve all of the workers that need to be
+        * called to fill in those streams. Ports that will be left empty correspond
+        * to null pointers, which are ignored by the recursive call. We will add the
+        * worker at the end of this sequence, right after the 'for' loop on ports.
+        */
         for (unsigned short port = 0; port < worker->getNumInputs(); port++)
-        {
-            /*
-            * We first need to check if the port will be plugged into after the
-            * connection plan. If so, then no matter if the port is currently taken
-            * or not, or what unplug instructions could be executed first, we simply
-            * need to retrieve the new stream that will be connected instead. For
-            * that, we iterate through the plan in reverse order, so we only take
-            * into account the last valid plug instruction.
-            */
-
-            auto streamToWorkerPlugIterator = std::find_if(
-                plan.streamToWorkerPlugInstructions.crbegin(),
-                plan.streamToWorkerPlugInstructions.crend(),
-
-                /*
-                * We use a lambda function to detect if an instruction matches the
-                * current worker and port, and check if the instruction is valid
-                * (i.e. refers to existing elements in the workflow). We also ensure
-                * we capture the proper external variables in the capture list [],
-                * while avoiding unecessary copies (worker is passed by reference to
-                * avoid a temporary shared pointer reference count increment, for
-                * example). Note that the lambda function will check for validity by
-                * searching through m_streams only if the instruction matches the
-                * current worker and port (due to operator&& precedence), which
-                * brings better performance.
-                */
-                [&worker, port, this](ConnectionInstruction<STREAM_TO_WORKER, PLUG> instruction) { return instruction.downhillID == worker->id && instruction.portNumber == port && m_streams.find(instruction.uphillID) != m_streams.cend(); }
-            );
-
-            /* Is the port part of a valid PLUG instruction? ... */
-            if (streamToWorkerPlugIterator != plan.streamToWorkerPlugInstructions.crend())
-            {
-                /*
-                * ... YES! The port will receive a new valid stream after the
-                * connection plan is executed. Therefore, we need to use that new
-                * stream to compute the next part of the renderingSequence.
-                */
-                auto streamIterator = m_streams.find(streamToWorkerPlugIterator->uphillID);
-
-                /*
-                * Note that once here, since the plug instruction is considered
-                * valid only if the stream involved already exists in the workflow,
-                * it is guaranteed the research right above succeeded. Therefore, we
-                * do not need to test if streamIterator is at the end of m_streams:
-                * we know it is not.
-                */
-
-                /*
-                * We recursively call the current function on the new input stream
-                * found, in order to retrieve all of the workers that need to be
-                * called to fill in this stream. We will add the worker at the end
-                * of this sequence, right after the 'for' loop on ports.
-                */
-                completeRenderingSequenceForStream(streamIterator->second, plan, currentRenderingSequence);
-            }
-
-            /*
-            * If the port is not planned to receive a new input stream through a
-            * plug instruction, then we need to use the existing stream that is
-            * already plugged in to continue, and check if it will be unplugged.
-            */
-            else
-            {
-                const std::shared_ptr<const Stream>& stream = worker->getInputBus()[port];
-
-                /* Is the port already TAKEN? ... */
-                if (stream)
-                {
-                    /*
-                    * ... YES! So we need to check in the ConnectionPlan if the port
-                    * will be unplugged.
-                    */
-
-                    auto streamToWorkerUnplugIterator = std::find_if(
-                        plan.streamToWorkerUnplugInstructions.cbegin(),
-                        plan.streamToWorkerUnplugInstructions.cend(),
-
-                        /*
-                        * We use a lambda function to detect if an instruction
-                        * matches the current stream, worker, and port, and refers
-                        * to an existing stream. We also ensure we capture the
-                        * proper external variables in the capture list [], while
-                        * avoiding unecessary copies (worker is passed by reference
-                        * to avoid a temporary shared pointer reference count
-                        * increment, for example). Note that the lambda function
-                        * will check for validity by searching through m_streams
-                        * only if the instruction is a perfect match (due to
-                        * operator&& precedence), which provides better performance.
-                        */
-                        [&worker, port, &stream, this](ConnectionInstruction<STREAM_TO_WORKER, UNPLUG> instruction) { return instruction.downhillID == worker->id && instruction.portNumber == port && instruction.uphillID == stream->id && m_streams.find(instruction.uphillID) != m_streams.cend(); }
-                    );
-
-                    /* Is the port NOT part of any valid UNPLUG instruction? */
-                    if (streamToWorkerUnplugIterator == plan.streamToWorkerUnplugInstructions.cend())
-                    {
-                        /*
-                        * ... YES! So we should use the existing stream to continue
-                        * our computation. Note that the stream's existence will be
-                        * checked again in the following function call.
-                        */
-                        completeRenderingSequenceForStream(stream, plan, currentRenderingSequence);
-                    }
-
-                    /*
-                    * Otherwise, if the port will actually be unplugged and not
-                    * reconnected to a new stream, then we have nothing to do, so we
-                    * can stop here and wait to move on to the next port.
-                    */
-                }
-            }
-        }
+            completeRenderingSequenceForStream(findInputStreamAfterPlan(worker, port, plan), plan, currentRenderingSequence);
 
         /*
         * Finally, we add the worker to the rendering sequence if it is not already
@@ -479,6 +402,111 @@ namespace ANGLECORE
         if (!stream || m_streams.find(stream->id) == m_streams.end())
             return;
 
+        /*
+        * We recursively call the completeRenderingSequenceForWorker() method on the
+        * worker that will fill in the stream once the connection plan is executed,
+        * in order to retrieve all of the workers that need to be called before it.
+        * If no worker will be connected to the stream, then the pointer returned
+        * will be null, and the recursive call will simply return.
+        */
+        completeRenderingSequenceForWorker(findInputWorkerAfterPlan(stream, plan), plan, currentRenderingSequence);
+    }
+
+    std::shared_ptr<const Stream> Workflow::findInputStreamAfterPlan(const std::shared_ptr<Worker>& worker, unsigned short inputPortNumber, const ConnectionPlan& plan) const
+    {
+        /*
+        * We first need to check if the port will be plugged into after the
+        * connection plan. If so, then no matter if the port is currently taken or
+        * not, or what unplug instructions could be executed first, we simply need
+        * to retrieve the new stream that will be connected instead. For that, we
+        * iterate through the plan in reverse order, so we only take into account
+        * the last valid plug instruction.
+        */
+
+        auto streamToWorkerPlugIterator = std::find_if(
+            plan.streamToWorkerPlugInstructions.crbegin(),
+            plan.streamToWorkerPlugInstructions.crend(),
+
+            /*
+            * We use a lambda function to detect if an instruction matches the
+            * current worker and port, and check if the instruction is valid (i.e.
+            * refers to existing elements in the workflow). We also ensure we
+            * capture the proper external variables in the capture list [], while
+            * avoiding unecessary copies (worker is passed by reference to avoid a
+            * temporary shared pointer reference count increment, for example). Note
+            * that the lambda function will check for validity by searching through
+            * m_streams only if the instruction matches the current worker and port
+            * (due to operator&& precedence), which brings better performance.
+            */
+            [&worker, inputPortNumber, this](ConnectionInstruction<STREAM_TO_WORKER, PLUG> instruction) { return instruction.downhillID == worker->id && instruction.portNumber == inputPortNumber && m_streams.find(instruction.uphillID) != m_streams.cend(); }
+        );
+
+        /* Is the port part of a valid PLUG instruction? ... */
+        if (streamToWorkerPlugIterator != plan.streamToWorkerPlugInstructions.crend())
+        {
+            /*
+            * ... YES! The port will receive a new valid stream after the connection
+            * plan is executed, so this is the stream we return. Note that since the
+            * plug instruction is considered valid only if the stream involved
+            * already exists in the workflow, it is guaranteed the research below
+            * succeeds. Therefore, we do not need to test if the iterator is at the
+            * end of m_streams: we know it is not.
+            */
+            return m_streams.find(streamToWorkerPlugIterator->uphillID)->second;
+        }
+
+        /*
+        * If the port is not planned to receive a new input stream through a plug
+        * instruction, then we need to use the existing stream that is already
+        * plugged in, and check if it will be unplugged.
+        */
+        const std::shared_ptr<const Stream>& stream = worker->getInputBus()[inputPortNumber];
+
+        /* Is the port already TAKEN? ... */
+        if (stream)
+        {
+            /*
+            * ... YES! So we need to check in the ConnectionPlan if the port will be
+            * unplugged.
+            */
+
+            auto streamToWorkerUnplugIterator = std::find_if(
+                plan.streamToWorkerUnplugInstructions.cbegin(),
+                plan.streamToWorkerUnplugInstructions.cend(),
+
+                /*
+                * We use a lambda function to detect if an instruction matches the
+                * current stream, worker, and port, and refers to an existing
+                * stream. We also ensure we capture the proper external variables in
+                * the capture list [], while avoiding unecessary copies (worker is
+                * passed by reference to avoid a temporary shared pointer reference
+                * count increment, for example). Note that the lambda function will
+                * check for validity by searching through m_streams only if the
+                * instruction is a perfect match (due to operator&& precedence),
+                * which provides better performance.
+                */
+                [&worker, inputPortNumber, &stream, this](ConnectionInstruction<STREAM_TO_WORKER, UNPLUG> instruction) { return instruction.downhillID == worker->id && instruction.portNumber == inputPortNumber && instruction.uphillID == stream->id && m_streams.find(instruction.uphillID) != m_streams.cend(); }
+            );
+
+            /*
+            * If the port is NOT part of any valid UNPLUG instruction, then the
+            * existing stream will remain connected, so we return it. Note that the
+            * stream's existence within the workflow is not checked here, so the
+            * caller should check it if necessary.
+            */
+            if (streamToWorkerUnplugIterator == plan.streamToWorkerUnplugInstructions.cend())
+                return stream;
+        }
+
+        /*
+        * Otherwise, if the port is empty, or if it will actually be unplugged and
+        * not reconnected to a new stream, then no stream will be connected to it.
+        */
+        return nullptr;
+    }
+
+    std::shared_ptr<Worker> Workflow::findInputWorkerAfterPlan(const std::shared_ptr<const Stream>& stream, const ConnectionPlan& plan) const
+    {
         /*
         * We first need to check if a worker will be plugged into the stream after
         * the connection plan. If so, then no matter if a worker is currently
@@ -511,89 +539,142 @@ namespace ANGLECORE
         {
             /*
             * ... YES! The stream will be connected to a new input worker after the
-            * connection plan is executed. Therefore, we need to use that new worker
-            * to compute the next part of the renderingSequence.
+            * connection plan is executed, so this is the worker we return. Note
+            * that since the plug instruction is considered valid only if the
+            * worker involved already exists in the workflow, it is guaranteed the
+            * research below succeeds. Therefore, we do not need to test if the
+            * iterator is at the end of m_workers: we know it is not.
             */
-            auto workerIterator = m_workers.find(workerToStreamPlugIterator->uphillID);
+            return m_workers.find(workerToStreamPlugIterator->uphillID)->second;
+        }
+
+        /*
+        * If the stream is not planned to be connected to a new input worker through
+        * a plug instruction, then we need to use the existing input worker that is
+        * already plugged in, and check if it will be unplugged. We retrieve the
+        * current stream's input worker using the m_inputWorkers attribute, which
+        * stores that information.
+        */
+        auto inputWorkerIterator = m_inputWorkers.find(stream->id);
+        if (inputWorkerIterator != m_inputWorkers.end() && inputWorkerIterator->second)
+        {
+            /*
+            * Note that every stream has an entry in the map, which remains null
+            * until a worker is plugged into the stream, hence the test above.
+            */
+            const std::shared_ptr<Worker>& inputWorker = inputWorkerIterator->second;
 
             /*
-            * Note that once here, since the plug instruction is considered valid
-            * only if the worker involved already exists in the workflow, it is
-            * guaranteed the research right above succeeded. Therefore, we do not
-            * need to test if workerIterator is at the end of m_workers: we know it
-            * is not.
+            * We need to check in the ConnectionPlan if the input worker will be
+            * disconnected from the stream.
             */
-            
+
+            auto workerToStreamUnplugIterator = std::find_if(
+                plan.workerToStreamUnplugInstructions.cbegin(),
+                plan.workerToStreamUnplugInstructions.cend(),
+
+                /*
+                * We use a lambda function to detect if an unplug instruction
+                * matches the current worker and stream at a valid port, and refers
+                * to an existing worker. We also ensure we capture the proper
+                * external variables in the capture list [], while avoiding
+                * unecessary copies (inputWorker is passed by reference to avoid a
+                * temporary shared pointer reference count increment, for example).
+                * Note that the lambda function will check for validity by searching
+                * through m_workers only if the instruction is a perfect match (due
+                * to operator&& precedence), which provides better performance.
+                */
+                [&inputWorker, &stream, this](ConnectionInstruction<WORKER_TO_STREAM, UNPLUG> instruction) { return instruction.downhillID == stream->id && instruction.uphillID == inputWorker->id && instruction.portNumber < inputWorker->getNumOutputs() && inputWorker->getOutputBus()[instruction.portNumber] && inputWorker->getOutputBus()[instruction.portNumber]->id == stream->id && m_workers.find(instruction.uphillID) != m_workers.cend(); }
+            );
+
             /*
-            * We recursively call the current function on the worker, in order to
-            * retrieve all of the workers that need to be called before it. We will
-            * add the worker at the end of this sequence.
+            * If the stream is NOT part of any valid UNPLUG instruction, then its
+            * existing input worker will remain connected, so we return it.
             */
-            completeRenderingSequenceForWorker(workerIterator->second, plan, currentRenderingSequence);
+            if (workerToStreamUnplugIterator == plan.workerToStreamUnplugInstructions.cend())
+                return inputWorker;
         }
 
         /*
-        * If the stream is not planned to be connected to a new input worker through
-        * a plug instruction, then we need to use the existing input worker that is
-        * already plugged in to continue, and check if it will be unplugged
+        * Otherwise, if the stream has no input worker, or if it will actually be
+        * disconnected from its input worker without any replacement, then no worker
+        * will fill it in.
         */
-        else
+        return nullptr;
+    }
+
+    std::vector<std::shared_ptr<Worker>> Workflow::findInputWorkersAfterPlan(const std::shared_ptr<Worker>& worker, const ConnectionPlan& plan) const
+    {
+        std::vector<std::shared_ptr<Worker>> inputWorkers;
+
+        for (unsigned short port = 0; port < worker->getNumInputs(); port++)
         {
             /*
-            * We retrieve the current stream's input worker using the m_inputWorkers
-            * attribute, which stores that information.
+            * We retrieve the stream that will be connected to the current port, and
+            * skip the port if it will be left empty or if the stream is not part of
+            * the workflow, just like the rendering sequence computation does.
             */
-            auto inputWorkerIterator = m_inputWorkers.find(stream->id);
-            if (inputWorkerIterator != m_inputWorkers.end())
-            {
-                const std::shared_ptr<Worker>& inputWorker = inputWorkerIterator->second;
+            std::shared_ptr<const Stream> stream = findInputStreamAfterPlan(worker, port, plan);
+            if (!stream || m_streams.find(stream->id) == m_streams.end())
+                continue;
 
-                /*
-                * Note that once here, since we found the input worker in the map,
-                * it is guaranteed inputWorker is not a null pointer, as we only
-                * insert non-null shared pointers into the workflow's maps.
-                */
+            /*
+            * Then we retrieve the worker that will fill in that stream, and add it
+            * to the result if it is valid and not already there (several input
+            * streams may be filled in by the same worker).
+            */
+            std::shared_ptr<Worker> inputWorker = findInputWorkerAfterPlan(stream, plan);
+            if (inputWorker && std::find(inputWorkers.cbegin(), inputWorkers.cend(), inputWorker) == inputWorkers.cend())
+                inputWorkers.push_back(std::move(inputWorker));
+        }
 
-                /* We need to check in the ConnectionPlan if the input worker will
-                * be disconnected from the stream.
-                */
+        return inputWorkers;
+    }
 
-                auto workerToStreamUnplugIterator = std::find_if(
-                    plan.workerToStreamUnplugInstructions.cbegin(),
-                    plan.workerToStreamUnplugInstructions.cend(),
+    void Workflow::buildDependencyGraph(const std::vector<std::shared_ptr<Worker>>& renderingSequence, const ConnectionPlan& plan, std::vector<uint32_t>& predecessorCounts, std::vector<uint32_t>& successorOffsets, std::vector<uint32_t>& successors) const
+    {
+        uint32_t size = renderingSequence.size();
 
-                    /*
-                    * We use a lambda function to detect if an unplug instruction
-                    * matches the current worker and stream at a valid port, and
-                    * refers to an existing worker. We also ensure we capture the
-                    * proper external variables in the capture list [], while
-                    * avoiding unecessary copies (inputWorker is passed by reference
-                    * to avoid a temporary shared pointer reference count increment,
-                    * for example). Note that the lambda function will check for
-                    * validity by searching through m_workers only if the
-                    * instruction is a perfect match (due to operator&& precedence),
-                    * which provides better performance.
-                    */
-                    [&inputWorker, &stream, this](ConnectionInstruction<WORKER_TO_STREAM, UNPLUG> instruction) { return instruction.downhillID == stream->id && instruction.uphillID == inputWorker->id && instruction.portNumber < inputWorker->getNumOutputs() && inputWorker->getOutputBus()[instruction.portNumber] && inputWorker->getOutputBus()[instruction.portNumber]->id == stream->id && m_streams.find(instruction.uphillID) != m_streams.cend(); }
-                );
+        /* We first map each worker's ID to its position in the sequence */
+        std::unordered_map<uint32_t, uint32_t> positions;
+        for (uint32_t i = 0; i < size; i++)
+            positions[renderingSequence[i]->id] = i;
 
-                /* Is the stream NOT part of any valid UNPLUG instruction? */
-                if (workerToStreamUnplugIterator == plan.workerToStreamUnplugInstructions.cend())
+        /*
+        * Then, we retrieve the predecessors of each worker, ignoring those that
+        * are not part of the sequence, and count the successors of each worker
+        * along the way.
+        */
+        std::vector<std::vector<uint32_t>> predecessors(size);
+        std::vector<uint32_t> successorCounts(size, 0);
+        predecessorCounts.assign(size, 0);
+        for (uint32_t i = 0; i < size; i++)
+        {
+            for (const std::shared_ptr<Worker>& inputWorker : findInputWorkersAfterPlan(renderingSequence[i], plan))
+            {
+                auto positionIterator = positions.find(inputWorker->id);
+                if (positionIterator != positions.end())
                 {
-                    /*
-                    * ... YES! So we should use its existing input worker to
-                    * continue our computation. Note that the stream's existence
-                    * will be checked again in the following function call.
-                    */
-                    completeRenderingSequenceForWorker(inputWorker, plan, currentRenderingSequence);
+                    predecessors[i].push_back(positionIterator->second);
+                    successorCounts[positionIterator->second]++;
                 }
-
-                /*
-                * Otherwise, if the stream will actually be disconnected from its
-                * input worker without any replacement, then we have nothing to do,
-                * so we can stop here.
-                */
             }
+            predecessorCounts[i] = predecessors[i].size();
         }
+
+        /*
+        * Finally, we flatten the successor lists into a single vector. Each
+        * worker's successors are written at the position given by the cumulated
+        * successor counts of the workers placed before it.
+        */
+        successorOffsets.assign(size + 1, 0);
+        for (uint32_t i = 0; i < size; i++)
+            successorOffsets[i + 1] = successorOffsets[i] + successorCounts[i];
+
+        successors.assign(successorOffsets[size], 0);
+        std::vector<uint32_t> writePositions(successorOffsets.begin(), successorOffsets.end() - 1);
+        for (uint32_t i = 0; i < size; i++)
+            for (uint32_t predecessor : predecessors[i])
+                successors[writePositions[predecessor]++] = i;
     }
 }
\ No newline at end of file
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <unordered_map>
 
 #include "Stream.h"
@@ -40,15 +41,31 @@ namespace ANGLECORE
     {
     public:
 
+        /**
+        * Creates an empty Workflow.
+        * @param[in] streamSize Number of samples in each Stream of the Workflow.
+        */
+        Workflow(unsigned int streamSize);
+
         /**
         * Adds the given Stream into the Workflow, and updates the workflow's
         * internal ID-Stream map accordingly. Note that streams are never created by
         * the Workflow itself, but rather passed as arguments after being created by
-        * a dedicated entity.
+        * a dedicated entity. This method allocates memory, so it should never be
+        * called by the real-time thread.
         * @param[in] streamToAdd The Stream to add into the Workflow.
         */
         void addStream(const std::shared_ptr<Stream>& streamToAdd);
 
+        /**
+        * Returns the StreamArena that provides the buffers of the Workflow's
+        * streams. Every Stream added into the Workflow should be created with it.
+        */
+        StreamArena& getStreamArena();
+
+        /** Returns the number of samples in each Stream of the Workflow. */
+        unsigned int getStreamSize() const;
+
         /**
         * Adds the given Worker into the Workflow, and updates the workflow's
         * internal ID-Worker map accordingly. Note that workers are never created by
@@ -189,6 +206,31 @@ namespace ANGLECORE
         */
         bool executeConnectionPlan(const ConnectionPlan& plan);
 
+        /**
+        * Computes the dependency graph of the given rendering sequence, as it will
+        * be once the given ConnectionPlan is executed. The graph is returned in a
+        * compact form: for each Worker at position i in the sequence,
+        * \p predecessorCounts[i] contains the number of workers of the sequence it
+        * directly depends on, and its successors, i.e. the positions of the
+        * workers that directly depend on it, are stored in \p successors between
+        * positions \p successorOffsets[i] (included) and \p successorOffsets[i + 1]
+        * (excluded). Dependencies are derived from the streams connecting the
+        * workers together. This method allocates memory, so it should never be
+        * called by the real-time thread.
+        * @param[in] renderingSequence The rendering sequence to compute the graph
+        *   of. It should not contain any null pointer.
+        * @param[in] plan The ConnectionPlan that will be executed next, and that
+        *   should therefore be taken into account in the computation.
+        * @param[out] predecessorCounts Number of predecessors of each Worker. It
+        *   will be of the same size as \p renderingSequence.
+        * @param[out] successorOffsets Start position of each Worker's successors
+        *   within \p successors. It will contain one more element than
+        *   \p renderingSequence, the last one being the size of \p successors.
+        * @param[out] successors Positions of every Worker's successors, listed one
+        *   Worker after the other.
+        */
+        void buildDependencyGraph(const std::vector<std::shared_ptr<Worker>>& renderingSequence, const ConnectionPlan& plan, std::vector<uint32_t>& predecessorCounts, std::vector<uint32_t>& successorOffsets, std::vector<uint32_t>& successors) const;
+
     protected:
 
         /**
@@ -223,8 +265,56 @@ namespace ANGLECORE
         */
         void completeRenderingSequenceForStream(const std::shared_ptr<const Stream>& stream, const ConnectionPlan& plan, std::vector<std::shared_ptr<Worker>>& currentRenderingSequence) const;
 
+        /**
+        * Returns the Stream that will be connected to the given \p worker's input
+        * bus at \p inputPortNumber once the given \p plan is executed, or a null
+        * pointer if the port will be left empty. This method takes into account
+        * both the current connections of the Workflow and the plug and unplug
+        * instructions of the plan. Note that \p worker is expected to be a non-null
+        * pointer to a Worker of the Workflow, and \p inputPortNumber to be
+        * in-range.
+        * @param[in] worker The Worker whose input bus should be inspected.
+        * @param[in] inputPortNumber The index of the port to inspect in the
+        *   Worker's input bus.
+        * @param[in] plan The ConnectionPlan that will be executed next, and which
+        *   should therefore be taken into account in the computation
+        */
+        std::shared_ptr<const Stream> findInputStreamAfterPlan(const std::shared_ptr<Worker>& worker, unsigned short inputPortNumber, const ConnectionPlan& plan) const;
+
+        /**
+        * Returns the Worker that will fill in the given \p stream once the given
+        * \p plan is executed, or a null pointer if no Worker will be connected to
+        * it. This method takes into account both the current connections of the
+        * Workflow and the plug and unplug instructions of the plan. Note that \p
+        * stream is expected to be a non-null pointer to a Stream of the Workflow.
+        * @param[in] stream The Stream whose input Worker should be retrieved.
+        * @param[in] plan The ConnectionPlan that will be executed next, and which
+        *   should therefore be taken into account in the computation
+        */
+        std::shared_ptr<Worker> findInputWorkerAfterPlan(const std::shared_ptr<const Stream>& stream, const ConnectionPlan& plan) const;
+
+        /**
+        * Returns every Worker that will directly fill in one of the given \p
+        * worker's input streams once the given \p plan is executed. In other
+        * words, this method returns the direct predecessors of \p worker in the
+        * Workflow's graph. The vector returned contains no null pointer and no
+        * duplicate. This method allocates memory, so it should never be called by
+        * the real-time thread.
+        * @param[in] worker The Worker whose predecessors should be retrieved. It
+        *   should be a non-null pointer to a Worker of the Workflow.
+        * @param[in] plan The ConnectionPlan that will be executed next, and which
+        *   should therefore be taken into account in the computation
+        */
+        std::vector<std::shared_ptr<Worker>> findInputWorkersAfterPlan(const std::shared_ptr<Worker>& worker, const ConnectionPlan& plan) const;
+
     private:
 
+        /*
+        * The arena is declared first, so that it is destroyed after every Stream
+        * held by the Workflow.
+        */
+        StreamArena m_streamArena;
+
         /**
         * Maps a Stream with its ID, hereby providing an ID-based access to a Stream
         * in constant time. This unordered_map will always verify:
@@ -239,7 +329,11 @@ namespace ANGLECORE
         */
         std::unordered_map<uint32_t, std::shared_ptr<Worker>> m_workers;
 
-        /** Maps a Stream ID to its input worker */
+        /**
+        * Maps a Stream ID to its input worker. Every Stream has an entry from the
+        * moment it is added to the Workflow, which remains null until a Worker is
+        * plugged into the Stream.
+        */
         std::unordered_map<uint32_t, std::shared_ptr<Worker>> m_inputWorkers;
     };
 }
\ No newline at end of file
@@ -0,0 +1,118 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#include <chrono>
+#include <cmath>
+
+#include "LoadMonitor.h"
+
+namespace ANGLECORE
+{
+    /** Returns the current time, in nanoseconds */
+    static uint64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    LoadMonitor::LoadMonitor() :
+        m_lastLoad(0.0f),
+        m_smoothedLoad(0.0f),
+        m_peakLoad(0.0f),
+        m_numOverruns(0),
+        m_budget(static_cast<float>(ANGLECORE_LOAD_MONITOR_DEFAULT_BUDGET)),
+        m_blockStartTime(0)
+    {}
+
+    void LoadMonitor::beginBlock()
+    {
+        m_blockStartTime = now();
+    }
+
+    void LoadMonitor::endBlock(uint32_t numSamples, floating_type sampleRate)
+    {
+        /* An empty block has no deadline, so it cannot be measured */
+        if (numSamples == 0 || sampleRate <= 0)
+            return;
+
+        double blockDuration = static_cast<double>(numSamples) / static_cast<double>(sampleRate);
+        double renderingDuration = static_cast<double>(now() - m_blockStartTime) * 1e-9;
+        float load = static_cast<float>(renderingDuration / blockDuration);
+
+        m_lastLoad.store(load, std::memory_order_relaxed);
+
+        /*
+        * The smoothing is a one-pole low-pass filter whose coefficient depends on
+        * the block's duration, so that the smoothing time remains the same
+        * whatever the block size. Only the real-time thread writes into
+        * m_smoothedLoad, so we do not need a read-modify-write operation here.
+        */
+        float coefficient = static_cast<float>(1.0 - std::exp(-blockDuration / ANGLECORE_LOAD_MONITOR_SMOOTHING_TIME));
+        float smoothedLoad = m_smoothedLoad.load(std::memory_order_relaxed);
+        m_smoothedLoad.store(smoothedLoad + coefficient * (load - smoothedLoad), std::memory_order_relaxed);
+
+        /*
+        * The peak load can be reset by another thread at any time, so we use a
+        * compare-and-swap loop to never overwrite a reset with an outdated peak.
+        */
+        float peakLoad = m_peakLoad.load(std::memory_order_relaxed);
+        while (load > peakLoad && !m_peakLoad.compare_exchange_weak(peakLoad, load, std::memory_order_relaxed))
+            ;
+
+        if (load > m_budget.load(std::memory_order_relaxed))
+            m_numOverruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    float LoadMonitor::getLastLoad() const
+    {
+        return m_lastLoad.load(std::memory_order_relaxed);
+    }
+
+    float LoadMonitor::getSmoothedLoad() const
+    {
+        return m_smoothedLoad.load(std::memory_order_relaxed);
+    }
+
+    float LoadMonitor::getPeakLoad() const
+    {
+        return m_peakLoad.load(std::memory_order_relaxed);
+    }
+
+    void LoadMonitor::resetPeakLoad()
+    {
+        m_peakLoad.store(0.0f, std::memory_order_relaxed);
+    }
+
+    uint64_t LoadMonitor::getNumOverruns() const
+    {
+        return m_numOverruns.load(std::memory_order_relaxed);
+    }
+
+    float LoadMonitor::getBudget() const
+    {
+        return m_budget.load(std::memory_order_relaxed);
+    }
+
+    void LoadMonitor::setBudget(float budget)
+    {
+        m_budget.store(budget > 0.0f ? budget : 0.0f, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,105 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+#include "../../config/RenderingConfig.h"
+
+namespace ANGLECORE
+{
+    /**
+    * \class LoadMonitor LoadMonitor.h
+    * Compares the time spent rendering each audio block with the duration of the
+    * audio it contains, hereby measuring how close the real-time thread is to
+    * missing its deadline. The measurements are stored into atomic variables, so
+    * that they can be read from any thread (typically to display a CPU meter in
+    * the UI) while the real-time thread keeps updating them.
+    */
+    class LoadMonitor
+    {
+    public:
+        LoadMonitor();
+
+        /**
+        * Starts measuring the rendering time of an audio block. This method must
+        * only be called by the real-time thread.
+        */
+        void beginBlock();
+
+        /**
+        * Ends the measurement started by the last call to beginBlock(), and updates
+        * the load values and the overrun count accordingly. This method must only
+        * be called by the real-time thread.
+        * @param[in] numSamples Number of samples in the audio block rendered.
+        * @param[in] sampleRate Sample rate of the audio block, in Hz.
+        */
+        void endBlock(uint32_t numSamples, floating_type sampleRate);
+
+        /**
+        * Returns the DSP load of the last audio block, that is the ratio between
+        * its rendering time and its audio duration. A value of 1.0 or more means
+        * the deadline has been missed.
+        */
+        float getLastLoad() const;
+
+        /**
+        * Returns the DSP load smoothed over ANGLECORE_LOAD_MONITOR_SMOOTHING_TIME
+        * seconds of audio, which is better suited for display.
+        */
+        float getSmoothedLoad() const;
+
+        /** Returns the highest DSP load measured since the last resetPeakLoad(). */
+        float getPeakLoad() const;
+
+        /** Resets the peak load, so that a new peak can be measured. */
+        void resetPeakLoad();
+
+        /**
+        * Returns the number of audio blocks whose DSP load exceeded the budget
+        * since the LoadMonitor was created.
+        */
+        uint64_t getNumOverruns() const;
+
+        /** Returns the fraction of each block's duration allowed for rendering. */
+        float getBudget() const;
+
+        /**
+        * Sets the fraction of each block's duration allowed for rendering. Blocks
+        * that exceed it are counted as overruns.
+        * @param[in] budget The new budget. Negative values are replaced by zero.
+        */
+        void setBudget(float budget);
+
+    private:
+        std::atomic<float> m_lastLoad;
+        std::atomic<float> m_smoothedLoad;
+        std::atomic<float> m_peakLoad;
+        std::atomic<uint64_t> m_numOverruns;
+        std::atomic<float> m_budget;
+
+        /** Time at which the current block started, only used by the real-time thread */
+        uint64_t m_blockStartTime;
+    };
+}
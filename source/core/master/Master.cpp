@@ -20,6 +20,8 @@
 **
 **********************************************************************/
 
+#include <algorithm>
+
 #include "Master.h"
 
 #include "../../config/RenderingConfig.h"
@@ -27,16 +29,52 @@
 
 namespace ANGLECORE
 {
-    Master::Master()
+    Master::Master() :
+        Master(Renderer::SEQUENTIAL, 0)
+    {}
+
+    Master::Master(Renderer::RenderingMode renderingMode, unsigned short numHelperThreads) :
+        Master(renderingMode, numHelperThreads, ANGLECORE_DEFAULT_STREAM_SIZE)
+    {}
+
+    Master::Master(Renderer::RenderingMode renderingMode, unsigned short numHelperThreads, unsigned int streamSize) :
+#if ANGLECORE_ENABLE_TRACING
+        m_tracer(numHelperThreads + 1),
+#endif
+
+        /*
+        * The voices are only rendered one after the other when the Renderer has no
+        * helper thread or renders sequentially, in which case they can all write
+        * their instruments' outputs into the same buffers.
+        */
+        m_audioWorkflow(std::max(streamSize, 1u), renderingMode == Renderer::SEQUENTIAL || numHelperThreads == 0),
+        m_renderer(renderingMode, numHelperThreads),
+        m_numDroppedParameterEvents(0),
+        m_numActiveVoices(0),
+        m_numNotesStarted(0)
     {
+#if ANGLECORE_ENABLE_TRACING
+        m_renderer.setTracer(&m_tracer);
+#endif
+
+        /* The Mixer uses the widest SIMD instructions the CPU supports */
+        m_audioWorkflow.setMixerInstructionSet(MixerKernels::detectInstructionSet());
+
         for (unsigned short v = 0; v < ANGLECORE_NUM_VOICES; v++)
         {
             m_voiceIsStopping[v] = false;
             m_stopTrackers[v].stopDurationInSamples = 0;
             m_stopTrackers[v].position = 0;
+            m_voiceIsOn[v] = false;
+            m_voiceStartOrders[v] = 0;
         }
     }
 
+    unsigned int Master::getStreamSize() const
+    {
+        return m_audioWorkflow.getStreamSize();
+    }
+
     void Master::setSampleRate(floating_type sampleRate)
     {
         m_audioWorkflow.setSampleRate(sampleRate);
@@ -52,6 +90,61 @@ namespace ANGLECORE
         return m_midiBuffer.pushBackNewMIDIMessage();
     }
 
+    void Master::clearParameterEventsForNextAudioBlock()
+    {
+        m_parameterEventBuffer.clear();
+    }
+
+    ParameterEvent& Master::pushBackNewParameterEvent()
+    {
+        return m_parameterEventBuffer.pushBackNewParameterEvent();
+    }
+
+    uint32_t Master::getNumDroppedParameterEvents() const
+    {
+        return m_numDroppedParameterEvents;
+    }
+
+    LoadMonitor& Master::getLoadMonitor()
+    {
+        return m_loadMonitor;
+    }
+
+    VoiceLimiter& Master::getVoiceLimiter()
+    {
+        return m_voiceLimiter;
+    }
+
+#if ANGLECORE_ENABLE_PROFILING
+    bool Master::getRenderProfile(RenderProfile& profile)
+    {
+        return m_renderer.getRenderProfile(profile);
+    }
+#endif
+
+#if ANGLECORE_ENABLE_TRACING
+    bool Master::startTracing(const char* filePath)
+    {
+        return m_tracer.start(filePath);
+    }
+
+    void Master::stopTracing()
+    {
+        m_tracer.stop();
+    }
+#endif
+
+    ParameterHandle Master::getParameterHandle(unsigned short rackNumber, StringView parameterIdentifier) const
+    {
+        /*
+        * This method must return an invalid handle if rackNumber is out-of-range.
+        */
+        if (rackNumber >= ANGLECORE_MAX_NUM_INSTRUMENTS_PER_VOICE)
+            return ParameterHandle();
+
+        return m_audioWorkflow.getParameterHandle(rackNumber, parameterIdentifier);
+    }
+
     void Master::setParameterValue(unsigned short rackNumber, StringView parameterIdentifier, floating_type newParameterValue)
     {
         /*
@@ -62,93 +155,85 @@ namespace ANGLECORE
             return;
 
         /*
-        * We try to retrieve the parameter generator corresponding to the given
-        * parameter:
+        * We look for the parameter generator with a single lookup into the rack's
+        * register, rather than retrieving a handle first and resolving it next,
+        * as the register may change between the two lookups.
         */
         std::shared_ptr<ParameterGenerator> generator = m_audioWorkflow.findParameterGenerator(rackNumber, parameterIdentifier);
 
         /*
         * If the pointer returned by the instruction above is not null, then it
-        * means that the parameter was found in one of the AudioWorkflow's parameter
-        * register (the one corresponding to the given rackNumber), and so we can
-        * post a new parameter change request to the corresponding parameter
-        * generator we have just retrieved.
+        * means that the parameter was found in the register, and so we can post a
+        * new parameter change request to the corresponding parameter generator.
         */
         if (generator)
-        {
-            /*
-            * We create a new parameter change request with the new value that is
-            * requested:
-            */
-            std::shared_ptr<ParameterChangeRequest> request = std::make_shared<ParameterChangeRequest>();
-            request->newValue = newParameterValue;
-            request->durationInSamples = 0;
-
-            /*
-            * Finally, we need to send the ParameterChangeRequest to the real-time
-            * thread. To avoid any memory deallocation by the real-time thread after
-            * it is done with the request, we do not pass the request straight to
-            * it. Instead, we create a copy and send that copy to the real-time
-            * thread. Therefore, when it is done with the request, it will only
-            * delete a copy of a shared pointer and decrement its reference count by
-            * one, signaling the request has been processed by the parameter
-            * generator, and that it can be safely destroyed by the non real-time
-            * thread that created it.
-            */
-
-            /* We copy the ParameterChangeRequest... */
-            std::shared_ptr<ParameterChangeRequest> requestCopy = request;
+            postParameterChange(*generator, newParameterValue);
+    }
 
-            /* And we send it to the parameter generator */
-            generator->postParameterChangeRequest(std::move(requestCopy));
+    void Master::setParameterValue(ParameterHandle handle, floating_type newParameterValue)
+    {
+        /*
+        * This method must return without performing any task if the handle's rack
+        * number is out-of-range.
+        */
+        if (!handle.isValid())
+            return;
 
-            /*
-            * From now on, the ParameterChangeRequest is in the hands of the
-            * real-time thread. We cannot access any member of 'request'. We will
-            * still use the reference count of the shared pointer as an indicator of
-            * when the real-time thread is done with the request (although it is not
-            * guaranteed to be safe by the standard). As long as that number is
-            * greater than 1 (and, normally, equal to 2), the real-time thread is
-            * still in possession of the copy, and possibly processing it. So the
-            * non real-time thread should wait. When this number reaches 1, it means
-            * the real-time thread is done with the request and the non real-time
-            * thread can safely delete it.
-            */
+        /*
+        * We try to retrieve the parameter generator corresponding to the given
+        * parameter. The handle gives us its slot in the corresponding register
+        * directly, so no identifier needs to be hashed nor compared. If the
+        * register has changed since the handle was retrieved, the handle is stale
+        * and we get a null pointer:
+        */
+        std::shared_ptr<ParameterGenerator> generator = m_audioWorkflow.findParameterGenerator(handle);
 
-            /*
-            * To avoid infinite loops and therefore deadlocks while waiting for the
-            * real-time thread, we introduce a timeout, using a number of attempts.
-            */
-            const unsigned short timeoutAttempts = 0;
-            unsigned short attempt = 0;
+        if (generator)
+            postParameterChange(*generator, newParameterValue);
+    }
 
-            /*
-            * We then wait for the real-time thread to finish, or for when we reach
-            * the timeout.
-            */
-            while (request.use_count() > 1 && attempt++ < timeoutAttempts)
-                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    void Master::postParameterChange(ParameterGenerator& generator, floating_type newParameterValue)
+    {
+        /*
+        * We create a new parameter change request with the new value that is
+        * requested:
+        */
+        ParameterChangeRequest request;
+        request.newValue = newParameterValue;
+        request.durationInSamples = 0;
 
-            /*
-            * Once here, we either reached the timeout, or the copy of the
-            * ParameterChangeRequest has been destroyed, and only the original
-            * remains, and can be safely deleted. In any case, the original request
-            * will be deleted, so if the timeout is the reason for leaving the loop,
-            * then the copy will outlive the original request in the real-time
-            * thread, which will trigger memory deallocation upon destruction, and
-            * possibly provoke an audio glitch (this should actually be very rare).
-            * If we left the loop because the copy was destroyed (which is the
-            * common case), then the original will be safely deleted here by the non
-            * real-time thread.
-            */
-        }
+        /*
+        * Finally, we send the ParameterChangeRequest to the real-time thread. The
+        * request is copied by value into the parameter generator's mailbox, where
+        * it replaces any request the real-time thread has not processed yet.
+        * Neither thread allocates nor frees any memory, and we do not need to wait
+        * for the real-time thread to be done with the request.
+        */
+        generator.postParameterChangeRequest(request);
     }
 
     void Master::renderNextAudioBlock(export_type** audioBlockToGenerate, unsigned short numChannels, uint32_t numSamples)
     {
+        renderNextAudioBlock(ExportBuffer(audioBlockToGenerate, numChannels), numSamples);
+    }
+
+    void Master::renderNextAudioBlock(const ExportBuffer& audioBlockToGenerate, uint32_t numSamples)
+    {
+        /*
+        * Everything that happens below must be real-time safe: no memory
+        * allocation, no deallocation, and no blocking lock.
+        */
+        RealtimeThreadScope realtimeThreadScope;
+
+#if ANGLECORE_ENABLE_TRACING
+        ScopedTraceEvent traceEvent(m_tracer, "renderNextAudioBlock");
+#endif
+
+        m_loadMonitor.beginBlock();
+
         /*
         * ===================================
-        * STEP 1/2: PROCESS REQUESTS
+        * STEP 1/3: PROCESS REQUESTS
         * ===================================
         */
 
@@ -156,7 +241,15 @@ namespace ANGLECORE
 
         /*
         * ===================================
-        * STEP 2/2: RENDERING
+        * STEP 2/3: PARAMETER EVENTS
+        * ===================================
+        */
+
+        dispatchParameterEvents(numSamples);
+
+        /*
+        * ===================================
+        * STEP 3/3: RENDERING
         * ===================================
         */
 
@@ -169,7 +262,7 @@ namespace ANGLECORE
         */
         if (numMIDIMessages == 0)
         {
-            splitAndRenderNextAudioBlock(audioBlockToGenerate, numChannels, numSamples, 0);
+            splitAndRenderNextAudioBlock(audioBlockToGenerate, numSamples, 0);
         }
         else
         {
@@ -195,7 +288,7 @@ namespace ANGLECORE
                 {
                     uint32_t samplesBeforeNextMessage = message.timestamp - position;
 
-                    splitAndRenderNextAudioBlock(audioBlockToGenerate, numChannels, samplesBeforeNextMessage, position);
+                    splitAndRenderNextAudioBlock(audioBlockToGenerate, samplesBeforeNextMessage, position);
 
                     processMIDIMessage(message);
 
@@ -211,24 +304,31 @@ namespace ANGLECORE
             * renderer one last time.
             */
 
-            splitAndRenderNextAudioBlock(audioBlockToGenerate, numChannels, numSamples - position, position);
+            splitAndRenderNextAudioBlock(audioBlockToGenerate, numSamples - position, position);
         }
+
+        m_loadMonitor.endBlock(numSamples, m_audioWorkflow.getSampleRate());
+        m_voiceLimiter.update(m_loadMonitor.getLastLoad(), m_loadMonitor.getBudget(), m_numActiveVoices);
     }
 
-    void Master::splitAndRenderNextAudioBlock(export_type** audioBlockToGenerate, unsigned short numChannels, uint32_t numSamples, uint32_t startSample)
+    void Master::splitAndRenderNextAudioBlock(const ExportBuffer& audioBlockToGenerate, uint32_t numSamples, uint32_t startSample)
     {
+#if ANGLECORE_ENABLE_TRACING
+        ScopedTraceEvent traceEvent(m_tracer, "splitAndRenderNextAudioBlock");
+#endif
+
         /*
         * The purpose of this method is to fulfill the Master's responsibility to
         * only request a valid number of samples to the renderer. Since a valid
-        * number of samples is a number that is both greater than 0 and less than
-        * ANGLECORE_FIXED_STREAM_SIZE, we need to cut the audio block to generate
-        * into smaller chunks, using the same idea as the Euclidian division: we
-        * launch rendering sessions on blocks of size ANGLECORE_FIXED_STREAM_SIZE
-        * until we obtain one remainder, which size will consequently be between 0
-        * and ANGLECORE_FIXED_STREAM_SIZE - 1. This is what this method does, which
-        * ensures that the number of samples requested to the renderer is always
-        * less than ANGLECORE_FIXED_STREAM_SIZE. The method also ensures we never
-        * ask the renderer to generate 0 samples, which completes the requirements.
+        * number of samples is a number that is both greater than 0 and at most
+        * the stream size, we need to cut the audio block to generate into smaller
+        * chunks, using the same idea as the Euclidian division: we launch
+        * rendering sessions on blocks of the stream size until we obtain one
+        * remainder, which size will consequently be between 0 and the stream size
+        * minus one. This is what this method does, which ensures that the number
+        * of samples requested to the renderer is always less than or equal to the
+        * stream size. The method also ensures we never ask the renderer to
+        * generate 0 samples, which completes the requirements.
         */
 
         /*
@@ -237,14 +337,15 @@ namespace ANGLECORE
         */
         if (numSamples > 0)
         {
+            const uint32_t streamSize = m_audioWorkflow.getStreamSize();
             uint32_t start = startSample;
             uint32_t remainingSamples = numSamples;
-            while (remainingSamples >= ANGLECORE_FIXED_STREAM_SIZE)
+            while (remainingSamples >= streamSize)
             {
-                m_audioWorkflow.setExporterOutput(audioBlockToGenerate, numChannels, start);
-                m_renderer.render(ANGLECORE_FIXED_STREAM_SIZE);
-                start += ANGLECORE_FIXED_STREAM_SIZE;
-                remainingSamples -= ANGLECORE_FIXED_STREAM_SIZE;
+                m_audioWorkflow.setExporterOutput(audioBlockToGenerate, start);
+                m_renderer.render(streamSize);
+                start += streamSize;
+                remainingSamples -= streamSize;
             }
 
             /*
@@ -255,7 +356,7 @@ namespace ANGLECORE
             */
             if (remainingSamples != 0)
             {
-                m_audioWorkflow.setExporterOutput(audioBlockToGenerate, numChannels, start);
+                m_audioWorkflow.setExporterOutput(audioBlockToGenerate, start);
                 m_renderer.render(remainingSamples);
             }
 
@@ -270,8 +371,46 @@ namespace ANGLECORE
         }
     }
 
+    void Master::dispatchParameterEvents(uint32_t numSamples)
+    {
+        /*
+        * Each event is handed to its parameter generator, which will apply it at
+        * the right sample while rendering. This is why, unlike MIDI messages,
+        * parameter events do not need to split the audio block, and do not need
+        * to be sorted either. Since nothing has been rendered yet in the audio
+        * block, the events' timestamps are also their offsets from the beginning
+        * of the next rendering session.
+        */
+        m_numDroppedParameterEvents = 0;
+
+        uint32_t numParameterEvents = m_parameterEventBuffer.getNumParameterEvents();
+        for (uint32_t i = 0; i < numParameterEvents; i++)
+        {
+            const ParameterEvent& event = m_parameterEventBuffer[i];
+
+            if (event.timestamp >= numSamples || !event.parameter.isValid())
+            {
+                m_numDroppedParameterEvents++;
+                continue;
+            }
+
+            /*
+            * The event's handle directly gives the parameter's slot in its
+            * register, so no identifier needs to be hashed nor compared here. A
+            * stale handle results in a null pointer.
+            */
+            ParameterGenerator* generator = m_audioWorkflow.getParameterGenerator(event.parameter);
+            if (!generator || !generator->scheduleParameterChange(event.timestamp, event.newValue, event.durationInSamples))
+                m_numDroppedParameterEvents++;
+        }
+    }
+
     void Master::processRequests()
     {
+#if ANGLECORE_ENABLE_TRACING
+        ScopedTraceEvent traceEvent(m_tracer, "processRequests");
+#endif
+
         /*
         * The following pointer will hold a copy of any Request that has been sent
         * by the Master to itself (on different threads). When it is deleted, its
@@ -307,11 +446,36 @@ namespace ANGLECORE
 
     void Master::processMIDIMessage(const MIDIMessage& message)
     {
+#if ANGLECORE_ENABLE_TRACING
+        ScopedTraceEvent traceEvent(m_tracer, "processMIDIMessage");
+#endif
+
         switch (message.type)
         {
 
         case MIDIMessage::Type::NOTE_ON:
             {
+                /*
+                * Before playing a new note, we check that the DSP load leaves
+                * room for one more voice, according to the VoiceLimiter.
+                */
+                VoiceLimiter::Policy policy = m_voiceLimiter.getPolicy();
+                if (policy != VoiceLimiter::DISABLED && m_numActiveVoices >= m_voiceLimiter.getVoiceLimit())
+                {
+                    if (policy == VoiceLimiter::REFUSE)
+                        return;
+
+                    /*
+                    * When stealing, we release the oldest note to make room for the
+                    * new one. The stolen voice still renders its tail, so the number
+                    * of active voices will only go back under the limit once the
+                    * tail is over, but this avoids any audible click.
+                    */
+                    unsigned short oldestVoiceNumber = findOldestPlayingVoice();
+                    if (oldestVoiceNumber < ANGLECORE_NUM_VOICES)
+                        releaseVoice(oldestVoiceNumber);
+                }
+
                 /* Can we play a new note? We need to find a free voice first: */
                 unsigned short freeVoiceNumber = m_audioWorkflow.findFreeVoice();
                 if (freeVoiceNumber >= ANGLECORE_NUM_VOICES)
@@ -336,6 +500,9 @@ namespace ANGLECORE
                 */
                 m_audioWorkflow.turnVoiceOn(freeVoiceNumber);
                 m_renderer.turnVoiceOn(freeVoiceNumber);
+                m_voiceIsOn[freeVoiceNumber] = true;
+                m_numActiveVoices++;
+                m_voiceStartOrders[freeVoiceNumber] = ++m_numNotesStarted;
             }
             break;
 
@@ -360,33 +527,16 @@ namespace ANGLECORE
                     * because it will call the instruments'
                     * computeStopDurationInSamples() and stopPlaying() methods in an
                     * illegal order, before reset() and startPlaying() are called).
+                    * For the same reason, we skip the voices that are already
+                    * stopping, which happens when a voice has been stolen.
                     */
-                    if (m_audioWorkflow.playsNoteNumber(v, message.noteNumber))
+                    if (m_audioWorkflow.playsNoteNumber(v, message.noteNumber) && !m_voiceIsStopping[v])
                     {
                         /*
                         * If the voice is on and playing the note that has been
                         * released, then we need to stop the voice.
                         */
-
-                        /*
-                        * We first register the voice as being in a stopping state:
-                        */
-                        m_voiceIsStopping[v] = true;
-
-                        /*
-                        * And then we effectively stop the voice. To do that, we
-                        * call the AudioWorkflow's stopVoice() method which stops
-                        * the given voice, and returns number of samples that the
-                        * voice needs to complete its fade out properly.
-                        */
-                        uint32_t voiceStopDuration = m_audioWorkflow.stopVoice(v);
-
-                        /*
-                        * We finally use that value to initialize the voice's stop
-                        * tracker.
-                        */
-                        m_stopTrackers[v].stopDurationInSamples = voiceStopDuration;
-                        m_stopTrackers[v].position = 0;
+                        releaseVoice(v);
                     }
                 }
             }
@@ -394,6 +544,42 @@ namespace ANGLECORE
         }
     }
 
+    void Master::releaseVoice(unsigned short voiceNumber)
+    {
+        /*
+        * We first register the voice as being in a stopping state:
+        */
+        m_voiceIsStopping[voiceNumber] = true;
+
+        /*
+        * And then we effectively stop the voice. To do that, we call the
+        * AudioWorkflow's stopVoice() method which stops the given voice, and
+        * returns number of samples that the voice needs to complete its fade out
+        * properly.
+        */
+        uint32_t voiceStopDuration = m_audioWorkflow.stopVoice(voiceNumber);
+
+        /*
+        * We finally use that value to initialize the voice's stop tracker.
+        */
+        m_stopTrackers[voiceNumber].stopDurationInSamples = voiceStopDuration;
+        m_stopTrackers[voiceNumber].position = 0;
+    }
+
+    unsigned short Master::findOldestPlayingVoice() const
+    {
+        unsigned short oldestVoiceNumber = ANGLECORE_NUM_VOICES;
+        for (unsigned short v = 0; v < ANGLECORE_NUM_VOICES; v++)
+        {
+            if (m_voiceIsOn[v] && !m_voiceIsStopping[v])
+            {
+                if (oldestVoiceNumber == ANGLECORE_NUM_VOICES || m_voiceStartOrders[v] < m_voiceStartOrders[oldestVoiceNumber])
+                    oldestVoiceNumber = v;
+            }
+        }
+        return oldestVoiceNumber;
+    }
+
     void Master::updateStopTrackersAfterRendering(uint32_t numSamples)
     {
         for (unsigned short v = 0; v < ANGLECORE_NUM_VOICES; v++)
@@ -418,6 +604,8 @@ namespace ANGLECORE
                     /* We turn off the current voice */
                     m_audioWorkflow.turnVoiceOffAndSetItFree(v);
                     m_renderer.turnVoiceOff(v);
+                    m_voiceIsOn[v] = false;
+                    m_numActiveVoices--;
 
                     /*
                     * And we save the information that the voice is no longer in its
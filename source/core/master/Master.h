@@ -29,12 +29,18 @@
 #include <utility>
 
 #include "../audioworkflow/AudioWorkflow.h"
+#include "../audioworkflow/ExportBuffer.h"
+#include "../audioworkflow/ParameterHandle.h"
 #include "../renderer/Renderer.h"
 #include "MIDIBuffer.h"
+#include "ParameterEventBuffer.h"
+#include "LoadMonitor.h"
+#include "VoiceLimiter.h"
 #include "../audioworkflow/instrument/Instrument.h"
 #include "../../config/RenderingConfig.h"
 #include "../../config/AudioConfig.h"
 #include "../../utility/StringView.h"
+#include "../../utility/RealtimeThreadScope.h"
 #include "../requestmanager/RequestManager.h"
 #include "../requestmanager/requests/AddInstrumentRequest.h"
 
@@ -49,8 +55,41 @@ namespace ANGLECORE
     class Master
     {
     public:
+
+        /**
+        * Creates a Master whose Renderer renders every Worker sequentially on the
+        * real-time thread.
+        */
         Master();
 
+        /**
+        * Creates a Master whose Renderer uses the given RenderingMode.
+        * @param[in] renderingMode The RenderingMode of the Master's Renderer.
+        * @param[in] numHelperThreads Number of threads the Renderer should spawn to
+        *   help the real-time thread. This parameter is ignored in SEQUENTIAL mode.
+        */
+        Master(Renderer::RenderingMode renderingMode, unsigned short numHelperThreads);
+
+        /**
+        * Creates a Master whose Renderer uses the given RenderingMode, and whose
+        * streams hold the given number of samples. The audio blocks are rendered in
+        * chunks of that size, so a small size suits low-latency rendering, while a
+        * large one reduces the overhead of each rendering session for offline
+        * rendering.
+        * @param[in] renderingMode The RenderingMode of the Master's Renderer.
+        * @param[in] numHelperThreads Number of threads the Renderer should spawn to
+        *   help the real-time thread. This parameter is ignored in SEQUENTIAL mode.
+        * @param[in] streamSize Number of samples in each Stream. Values lower than
+        *   one are replaced by one.
+        */
+        Master(Renderer::RenderingMode renderingMode, unsigned short numHelperThreads, unsigned int streamSize);
+
+        /**
+        * Returns the number of samples in each Stream of the Master, which is the
+        * size of the chunks the audio blocks are rendered in.
+        */
+        unsigned int getStreamSize() const;
+
         /**
         * Sets the sample rate of the Master's AudioWorkflow.
         * @param[in] sampleRate The value of the sample rate, in Hz.
@@ -70,11 +109,41 @@ namespace ANGLECORE
         */
         MIDIMessage& pushBackNewMIDIMessage();
 
+        /**
+        * Clears the Master's internal ParameterEventBuffer to prepare for rendering
+        * the next audio block.
+        */
+        void clearParameterEventsForNextAudioBlock();
+
+        /**
+        * Adds a new ParameterEvent at the end of the Master's internal
+        * ParameterEventBuffer, and returns a reference to it. Each event changes
+        * the value of a Parameter at the sample given by its timestamp, even in
+        * the middle of a rendering session, so that automation is sample-accurate.
+        * Unlike MIDI messages, parameter events do not split the audio block into
+        * more rendering sessions, and they can be pushed in any order. This method
+        * should only be called by the real-time thread, right before calling the
+        * renderNextAudioBlock() method.
+        */
+        ParameterEvent& pushBackNewParameterEvent();
+
+        /**
+        * Returns the number of ParameterEvents that were dropped during the last
+        * call to renderNextAudioBlock(), either because their timestamp was out of
+        * the audio block, because their handle was invalid or stale, or because
+        * their Parameter already had ANGLECORE_PARAMETER_MAX_NUM_SCHEDULED_CHANGES
+        * changes waiting to be rendered. This method should only be called by the
+        * real-time thread, after calling renderNextAudioBlock().
+        */
+        uint32_t getNumDroppedParameterEvents() const;
+
         /**
         * Requests the Master to change one Parameter's value within the Instrument
         * positioned at the rack number \p rackNumber. Note that this does not mean
         * the request will take effect immediately: the Master will post the request
         * to the real-time thread to be taken care of in the next rendering session.
+        * Several threads can call this method at the same time, as the parameter
+        * registers are looked up without locking them.
         * @param[in] rackNumber The Instrument's rack number. If this number is not
         *   valid, this method will have no effect.
         * @param[in] parameterIdentifier The Parameter's identifier. This can be
@@ -86,6 +155,34 @@ namespace ANGLECORE
         */
         void setParameterValue(unsigned short rackNumber, StringView parameterIdentifier, floating_type newParameterValue);
 
+        /**
+        * Returns a ParameterHandle corresponding to the given Parameter, which can
+        * then be passed to setParameterValue() instead of the Parameter's
+        * identifier, to avoid searching for the Parameter on each call. The
+        * handle remains valid as long as the Parameter stays registered at the
+        * same slot, regardless of the changes made to the other parameters. Once
+        * the Parameter is replaced by another one, the handle becomes stale, and
+        * setParameterValue() ignores it, so a new handle should be retrieved.
+        * This method can be called by any thread.
+        * @param[in] rackNumber The Instrument's rack number.
+        * @param[in] parameterIdentifier The Parameter's identifier. If this
+        *   parameter does not correspond to any parameter of the Instrument located
+        *   at \p rackNumber, or if the rack number is not valid, then this method
+        *   will return an invalid handle.
+        */
+        ParameterHandle getParameterHandle(unsigned short rackNumber, StringView parameterIdentifier) const;
+
+        /**
+        * Requests the Master to change the value of the Parameter identified by
+        * the given \p handle, just like the other overload of this method does,
+        * but without searching for the Parameter by its identifier.
+        * @param[in] handle The Parameter's handle. If it is invalid, stale, or if
+        *   it does not correspond to any Parameter, this method will have no
+        *   effect.
+        * @param[in] newParameterValue The Parameter's new value.
+        */
+        void setParameterValue(ParameterHandle handle, floating_type newParameterValue);
+
         /**
         * Renders the next audio block, using the internal MIDIBuffer as a source
         * of MIDI messages, and the provided parameters for computing and exporting
@@ -103,6 +200,20 @@ namespace ANGLECORE
         */
         void renderNextAudioBlock(export_type** audioBlockToGenerate, unsigned short numChannels, uint32_t numSamples);
 
+        /**
+        * Renders the next audio block just like the method above, but into a
+        * buffer of any layout, such as the interleaved integer buffer of an audio
+        * device or a network stream. The samples are converted while being
+        * exported, so they are written directly into the given buffer without any
+        * intermediate copy.
+        * @param[in] audioBlockToGenerate The memory location that will be used to
+        *   output the audio data generated by the Renderer, along with its layout.
+        *   It should hold at least \p numSamples frames.
+        * @param[in] numSamples The number of samples to generate and write into
+        *   each channel of \p audioBlockToGenerate.
+        */
+        void renderNextAudioBlock(const ExportBuffer& audioBlockToGenerate, uint32_t numSamples);
+
         /**
         * Requests the Master to add an Instrument of the given type to the
         * AudioWorkflow. The type given as a template parameter must be a class that
@@ -160,6 +271,56 @@ namespace ANGLECORE
         template<class InstrumentType>
         void addInstrument(AddInstrumentListener<InstrumentType>* listener);
 
+        /**
+        * Returns the LoadMonitor that measures how much of each audio block's
+        * duration the Master spends rendering it. Its measurements can be read,
+        * and its budget changed, from any thread.
+        */
+        LoadMonitor& getLoadMonitor();
+
+        /**
+        * Returns the VoiceLimiter that lowers the polyphony when the DSP load
+        * approaches the LoadMonitor's budget. Its Policy is DISABLED by default,
+        * and can be changed from any thread.
+        */
+        VoiceLimiter& getVoiceLimiter();
+
+#if ANGLECORE_ENABLE_PROFILING
+        /**
+        * Copies the time measurements of the Renderer's last rendering session
+        * into \p profile, so that one can identify which Worker takes the most
+        * time. Returns true if a new session has been profiled since the last
+        * call, and false otherwise. This method is only available if
+        * ANGLECORE_ENABLE_PROFILING is set to 1. It is thread-safe and never
+        * blocks the real-time thread, but it should not be called by the
+        * real-time thread itself. Note that RenderProfile is a large structure,
+        * which should preferably be allocated on the heap.
+        * @param[out] profile The RenderProfile to copy the measurements into.
+        */
+        bool getRenderProfile(RenderProfile& profile);
+#endif
+
+#if ANGLECORE_ENABLE_TRACING
+        /**
+        * Starts recording the rendering sessions, the calls to every Worker and
+        * the Master's own processing into a trace file, which can be opened in
+        * Chrome's "about:tracing" page or in Perfetto. Returns true if the file
+        * could be opened, and false otherwise. This method is only available if
+        * ANGLECORE_ENABLE_TRACING is set to 1, and should not be called by the
+        * real-time thread.
+        * @param[in] filePath Path of the trace file to create. Any existing file
+        *   at this location is overwritten.
+        */
+        bool startTracing(const char* filePath);
+
+        /**
+        * Stops recording, and completes the trace file. This method is only
+        * available if ANGLECORE_ENABLE_TRACING is set to 1, and should not be
+        * called by the real-time thread.
+        */
+        void stopTracing();
+#endif
+
     protected:
 
         /**
@@ -180,26 +341,52 @@ namespace ANGLECORE
         * method is the one that guarantees the Renderer only receives a valid
         * number of samples to render.
         * @param[in] audioBlockToGenerate The memory location that will be used to
-        *   output the audio data generated by the Renderer. This should correspond
-        *   to an audio buffer of at least \p numChannels audio channels and \p
-        *   numSamples audio samples.
-        * @param[in] numChannels The number of channels available at the memory
-        *   location \p audioBlockToGenerate. Note that ANGLECORE's engine may
-        *   generate more channels than this number, and eventually merge them all
-        *   to match that number.
+        *   output the audio data generated by the Renderer, along with its layout.
+        *   It should hold at least \p startSample + \p numSamples frames.
         * @param[in] numSamples The number of samples to generate and write into
         *   \p audioBlockToGenerate.
         * @param[in] startSample The position within the \p audioBlockToGenerate to
         *   start writing from.
         */
-        void splitAndRenderNextAudioBlock(export_type** audioBlockToGenerate, unsigned short numChannels, uint32_t numSamples, uint32_t startSample);
+        void splitAndRenderNextAudioBlock(const ExportBuffer& audioBlockToGenerate, uint32_t numSamples, uint32_t startSample);
+
+        /**
+        * Sends a ParameterChangeRequest to the given ParameterGenerator, so that
+        * its Parameter instantly changes to \p newParameterValue.
+        * @param[in] generator The Parameter's generator.
+        * @param[in] newParameterValue The Parameter's new value.
+        */
+        void postParameterChange(ParameterGenerator& generator, floating_type newParameterValue);
 
         /** Processes the requests received in its internal queues. */
         void processRequests();
 
+        /**
+        * Schedules the events of the ParameterEventBuffer into the corresponding
+        * parameter generators. Events that are out of the audio block, that refer
+        * to a Parameter that does not exist, or that cannot be scheduled, are
+        * dropped and counted (see getNumDroppedParameterEvents()).
+        * @param[in] numSamples The number of samples in the audio block.
+        */
+        void dispatchParameterEvents(uint32_t numSamples);
+
         /** Processes the given MIDIMessage. */
         void processMIDIMessage(const MIDIMessage& message);
 
+        /**
+        * Stops the given Voice, and starts tracking its tail so that it can be
+        * turned off once the tail is over.
+        * @param[in] voiceNumber The Voice to stop. It must be on.
+        */
+        void releaseVoice(unsigned short voiceNumber);
+
+        /**
+        * Returns the number of the Voice that started playing its note first,
+        * among the voices that are on and not stopping yet, or
+        * ANGLECORE_NUM_VOICES if there is no such Voice.
+        */
+        unsigned short findOldestPlayingVoice() const;
+
         /**
         * Updates the Master's internal stop trackers corresponding to each Voice,
         * after \p numSamples were rendered. This method detects if it is necessary
@@ -210,12 +397,32 @@ namespace ANGLECORE
         void updateStopTrackersAfterRendering(uint32_t numSamples);
 
     private:
+#if ANGLECORE_ENABLE_TRACING
+        /*
+        * The Tracer is declared before the Renderer, so that it outlives the
+        * Renderer and its helper threads.
+        */
+        Tracer m_tracer;
+#endif
         AudioWorkflow m_audioWorkflow;
         Renderer m_renderer;
         MIDIBuffer m_midiBuffer;
+        ParameterEventBuffer m_parameterEventBuffer;
+        uint32_t m_numDroppedParameterEvents;
+        LoadMonitor m_loadMonitor;
+        VoiceLimiter m_voiceLimiter;
+        unsigned short m_numActiveVoices;
         RequestManager m_requestManager;
         bool m_voiceIsStopping[ANGLECORE_NUM_VOICES];
         StopTracker m_stopTrackers[ANGLECORE_NUM_VOICES];
+        bool m_voiceIsOn[ANGLECORE_NUM_VOICES];
+
+        /*
+        * Number of notes started so far, used to order the voices by age for
+        * voice stealing.
+        */
+        uint64_t m_numNotesStarted;
+        uint64_t m_voiceStartOrders[ANGLECORE_NUM_VOICES];
     };
 
     template<class InstrumentType>
@@ -0,0 +1,90 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#include "ParameterEventBuffer.h"
+
+namespace ANGLECORE
+{
+    /* ParameterEvent
+    ***************************************************/
+
+    ParameterEvent::ParameterEvent() :
+        parameter(),
+        newValue(0.0),
+        timestamp(0),
+        durationInSamples(0)
+    {}
+
+    /* ParameterEventBuffer
+    ***************************************************/
+
+    ParameterEventBuffer::ParameterEventBuffer() :
+
+        /*
+        * Just like the MIDIBuffer, the buffer's capacity is initialized to a large
+        * value to minimize the chances of resizing, and the buffer is considered
+        * initially empty despite having its memory pre-allocated.
+        */
+        m_capacity(ANGLECORE_PARAMETER_EVENT_BUFFER_SIZE),
+        m_events(ANGLECORE_PARAMETER_EVENT_BUFFER_SIZE),
+        m_numEvents(0)
+    {}
+
+    uint32_t ParameterEventBuffer::getNumParameterEvents() const
+    {
+        return m_numEvents;
+    }
+
+    ParameterEvent& ParameterEventBuffer::pushBackNewParameterEvent()
+    {
+        m_numEvents++;
+
+        /*
+        * If we reach the buffer's maximal capacity, we augment it by
+        * ANGLECORE_PARAMETER_EVENT_BUFFER_SIZE through a resize operation on the
+        * internal vector. This will trigger memory allocation, but it should only
+        * be used as a last resort when receiving more events than expected.
+        */
+        if (m_numEvents > m_capacity)
+        {
+            m_events.resize(m_capacity + ANGLECORE_PARAMETER_EVENT_BUFFER_SIZE);
+            m_capacity += ANGLECORE_PARAMETER_EVENT_BUFFER_SIZE;
+        }
+
+        /*
+        * Events are reused from one audio block to the next, so we reset the one
+        * we return to avoid leaking the attributes of a previous event.
+        */
+        m_events[m_numEvents - 1] = ParameterEvent();
+        return m_events[m_numEvents - 1];
+    }
+
+    void ParameterEventBuffer::clear()
+    {
+        m_numEvents = 0;
+    }
+
+    ParameterEvent& ParameterEventBuffer::operator[](uint32_t index)
+    {
+        return m_events[index];
+    }
+}
@@ -0,0 +1,109 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "../../config/RenderingConfig.h"
+#include "../audioworkflow/ParameterHandle.h"
+
+namespace ANGLECORE
+{
+    /**
+    * \struct ParameterEvent ParameterEventBuffer.h
+    * Represents a change of a Parameter's value that should happen at a precise
+    * sample within the audio block being rendered. The Parameter is designated by
+    * a ParameterHandle, so that the real-time thread can find it without hashing
+    * nor comparing any string.
+    */
+    struct ParameterEvent
+    {
+        /**
+        * Handle of the Parameter, as returned by Master::getParameterHandle().
+        * Events with an invalid or stale handle are dropped.
+        */
+        ParameterHandle parameter;
+
+        /** The Parameter's new value */
+        floating_type newValue;
+
+        /**
+        * Timestamp of the event as a sample position within the current audio
+        * buffer
+        */
+        uint32_t timestamp;
+
+        /**
+        * Duration of the transition towards the new value, in samples. The
+        * Parameter's minimal smoothing duration applies just like it does for the
+        * other change requests.
+        */
+        uint32_t durationInSamples;
+
+        /**
+        * Creates a ParameterEvent with an invalid handle, and initializes every
+        * other attribute to its default value.
+        */
+        ParameterEvent();
+    };
+
+    /**
+    * \class ParameterEventBuffer ParameterEventBuffer.h
+    * Buffer of ParameterEvents.
+    */
+    class ParameterEventBuffer
+    {
+    public:
+
+        /** Creates a ParameterEvent buffer of fixed size */
+        ParameterEventBuffer();
+
+        /**
+        * Returns the number of ParameterEvents contained in the buffer. This will be
+        * different from the buffer's capacity.
+        */
+        uint32_t getNumParameterEvents() const;
+
+        /**
+        * Adds a new empty ParameterEvent at the end of the buffer, and returns a
+        * reference to it.
+        */
+        ParameterEvent& pushBackNewParameterEvent();
+
+        /** Removes every ParameterEvent from the buffer. */
+        void clear();
+
+        /**
+        * Provides a read an write access to the ParameterEvents.
+        * @param[in] index Position of the ParameterEvent to retrieve from the
+        *   buffer. It should be in-range, as it will not be checked at runtime.
+        */
+        ParameterEvent& operator[](uint32_t index);
+
+    private:
+        uint32_t m_capacity;
+        std::vector<ParameterEvent> m_events;
+        uint32_t m_numEvents;
+    };
+}
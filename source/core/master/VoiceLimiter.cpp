@@ -0,0 +1,92 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#include <algorithm>
+
+#include "VoiceLimiter.h"
+
+namespace ANGLECORE
+{
+    VoiceLimiter::VoiceLimiter() :
+        m_policy(DISABLED),
+        m_voiceLimit(ANGLECORE_NUM_VOICES),
+        m_baseLoad(0.0f),
+        m_loadPerVoice(0.0f)
+    {}
+
+    void VoiceLimiter::update(float load, float budget, unsigned short numActiveVoices)
+    {
+        const float smoothing = static_cast<float>(ANGLECORE_VOICE_LIMITER_SMOOTHING);
+
+        /*
+        * Blocks rendered without any Voice measure the base load directly. Other
+        * blocks give a measure of the load per Voice, once the base load has been
+        * removed.
+        */
+        if (numActiveVoices == 0)
+            m_baseLoad += smoothing * (load - m_baseLoad);
+        else
+        {
+            float measuredLoadPerVoice = std::max(0.0f, load - m_baseLoad) / numActiveVoices;
+            m_loadPerVoice += smoothing * (measuredLoadPerVoice - m_loadPerVoice);
+        }
+
+        /*
+        * We can now compute the number of voices that fit in the budget. We always
+        * allow at least one Voice, so that the instrument never becomes silent.
+        */
+        unsigned short targetLimit = ANGLECORE_NUM_VOICES;
+        if (m_loadPerVoice > 0.0f)
+        {
+            float numVoicesInBudget = (budget - m_baseLoad) / m_loadPerVoice;
+            if (numVoicesInBudget < static_cast<float>(ANGLECORE_NUM_VOICES))
+                targetLimit = static_cast<unsigned short>(std::max(1.0f, numVoicesInBudget));
+        }
+
+        /*
+        * Lowering the limit must take effect immediately to avoid the next
+        * overruns, but raising it too fast would make the limit oscillate, so we
+        * only release one more Voice per audio block.
+        */
+        unsigned short voiceLimit = m_voiceLimit.load(std::memory_order_relaxed);
+        if (targetLimit < voiceLimit)
+            voiceLimit = targetLimit;
+        else if (targetLimit > voiceLimit)
+            voiceLimit++;
+        m_voiceLimit.store(voiceLimit, std::memory_order_relaxed);
+    }
+
+    VoiceLimiter::Policy VoiceLimiter::getPolicy() const
+    {
+        return static_cast<Policy>(m_policy.load(std::memory_order_relaxed));
+    }
+
+    void VoiceLimiter::setPolicy(Policy policy)
+    {
+        m_policy.store(policy, std::memory_order_relaxed);
+    }
+
+    unsigned short VoiceLimiter::getVoiceLimit() const
+    {
+        return m_voiceLimit.load(std::memory_order_relaxed);
+    }
+}
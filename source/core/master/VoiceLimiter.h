@@ -0,0 +1,97 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+#include "../../config/RenderingConfig.h"
+
+namespace ANGLECORE
+{
+    /**
+    * \class VoiceLimiter VoiceLimiter.h
+    * Estimates how much of the DSP load each active Voice costs, and deduces the
+    * maximum number of voices that can play together without exceeding the load
+    * budget. The Master consults it before playing a new note, so that it can
+    * refuse the note, or steal the oldest Voice, instead of missing the deadline.
+    * The limit is lowered as soon as the load approaches the budget, and raised
+    * back one Voice at a time when the load drops.
+    */
+    class VoiceLimiter
+    {
+    public:
+
+        /**
+        * \enum Policy
+        * Defines what the Master does with a new note when the voice limit is
+        * reached.
+        */
+        enum Policy
+        {
+            DISABLED = 0,   /**< The limit is ignored, and notes only fail when every Voice is busy */
+            REFUSE,         /**< The new note is ignored */
+            STEAL,          /**< The oldest note is released to make room for the new one */
+            NUM_POLICIES
+        };
+
+        VoiceLimiter();
+
+        /**
+        * Updates the estimates of the DSP load per Voice using the measurements of
+        * the last audio block, and recomputes the voice limit accordingly. This
+        * method must only be called by the real-time thread.
+        * @param[in] load DSP load of the last audio block.
+        * @param[in] budget Maximum DSP load allowed.
+        * @param[in] numActiveVoices Number of voices that were rendered in the
+        *   last audio block.
+        */
+        void update(float load, float budget, unsigned short numActiveVoices);
+
+        /** Returns the current Policy. */
+        Policy getPolicy() const;
+
+        /**
+        * Sets the Policy applied when the voice limit is reached. This method can
+        * be called from any thread.
+        */
+        void setPolicy(Policy policy);
+
+        /**
+        * Returns the maximum number of voices that can currently play together.
+        * It is always between 1 and ANGLECORE_NUM_VOICES.
+        */
+        unsigned short getVoiceLimit() const;
+
+    private:
+        std::atomic<int> m_policy;
+        std::atomic<unsigned short> m_voiceLimit;
+
+        /*
+        * The following estimates are only used by the real-time thread. The load
+        * of a block is modelled as a base load, spent whatever the number of
+        * voices, plus a load proportional to the number of active voices.
+        */
+        float m_baseLoad;
+        float m_loadPerVoice;
+    };
+}
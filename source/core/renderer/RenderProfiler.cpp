@@ -0,0 +1,90 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#include <algorithm>
+
+#include "RenderProfiler.h"
+
+namespace ANGLECORE
+{
+    /* RenderProfile
+    ***************************************************/
+
+    RenderProfile::RenderProfile() :
+        numWorkers(0),
+        sessionDuration(0),
+        numSamplesRendered(0),
+        sessionNumber(0)
+    {}
+
+    /* RenderProfiler
+    ***************************************************/
+
+    RenderProfiler::RenderProfiler() :
+        m_lastDurations(ANGLECORE_PROFILER_MAX_NUM_WORKERS, 0),
+        m_maxDurations(ANGLECORE_PROFILER_MAX_NUM_WORKERS, 0),
+        m_sessionNumber(0)
+    {}
+
+    void RenderProfiler::reset()
+    {
+        std::fill(m_lastDurations.begin(), m_lastDurations.end(), 0);
+        std::fill(m_maxDurations.begin(), m_maxDurations.end(), 0);
+    }
+
+    void RenderProfiler::publishSession(const std::vector<uint32_t>& workerIDs, unsigned int numSamplesRendered, uint64_t sessionDuration)
+    {
+        RenderProfile& profile = m_snapshots.getBackBuffer();
+
+        /* We only copy the entries that are actually used */
+        uint32_t numWorkers = std::min<uint32_t>(workerIDs.size(), ANGLECORE_PROFILER_MAX_NUM_WORKERS);
+        for (uint32_t i = 0; i < numWorkers; i++)
+        {
+            profile.workers[i].workerID = workerIDs[i];
+            profile.workers[i].lastDuration = m_lastDurations[i];
+            profile.workers[i].maxDuration = m_maxDurations[i];
+        }
+        profile.numWorkers = numWorkers;
+        profile.sessionDuration = sessionDuration;
+        profile.numSamplesRendered = numSamplesRendered;
+        profile.sessionNumber = ++m_sessionNumber;
+
+        m_snapshots.publish();
+    }
+
+    bool RenderProfiler::getLatestProfile(RenderProfile& profile)
+    {
+        std::lock_guard<Mutex> scopedLock(m_readerLock);
+
+        bool isNew = m_snapshots.update();
+        const RenderProfile& latestProfile = m_snapshots.getFrontBuffer();
+
+        /* Once again, we only copy the entries that are actually used */
+        std::copy(latestProfile.workers, latestProfile.workers + latestProfile.numWorkers, profile.workers);
+        profile.numWorkers = latestProfile.numWorkers;
+        profile.sessionDuration = latestProfile.sessionDuration;
+        profile.numSamplesRendered = latestProfile.numSamplesRendered;
+        profile.sessionNumber = latestProfile.sessionNumber;
+
+        return isNew;
+    }
+}
@@ -0,0 +1,160 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+#include <chrono>
+
+#include "../../config/RenderingConfig.h"
+#include "../../utility/TripleBuffer.h"
+#include "../../utility/RealtimeThreadScope.h"
+
+namespace ANGLECORE
+{
+    /**
+    * \struct RenderProfile RenderProfiler.h
+    * Snapshot of the time spent by the Renderer in each Worker of its rendering
+    * sequence during a rendering session. Its size is fixed, so that it can be
+    * published by the real-time thread without allocating any memory.
+    */
+    struct RenderProfile
+    {
+        /**
+        * \struct WorkerEntry RenderProfiler.h
+        * Time measurements of one Worker, identified by its WorkflowItem ID.
+        */
+        struct WorkerEntry
+        {
+            uint32_t workerID;
+
+            /** Duration of the Worker's last call, in nanoseconds */
+            uint64_t lastDuration;
+
+            /**
+            * Longest duration of the Worker's calls since the rendering sequence
+            * last changed, in nanoseconds
+            */
+            uint64_t maxDuration;
+        };
+
+        RenderProfile();
+
+        /**
+        * Measurements of each Worker, in the order of the rendering sequence. Only
+        * the first numWorkers entries are meaningful.
+        */
+        WorkerEntry workers[ANGLECORE_PROFILER_MAX_NUM_WORKERS];
+        uint32_t numWorkers;
+
+        /** Total duration of the rendering session, in nanoseconds */
+        uint64_t sessionDuration;
+
+        /** Number of samples rendered during the rendering session */
+        unsigned int numSamplesRendered;
+
+        /** Number of rendering sessions profiled so far, including this one */
+        uint64_t sessionNumber;
+    };
+
+    /**
+    * \class RenderProfiler RenderProfiler.h
+    * Records the time spent by the Renderer in each Worker, and publishes the
+    * result of each rendering session to a non real-time reader through a
+    * TripleBuffer. Recording and publishing never block nor allocate memory, so
+    * they can be performed by the real-time thread.
+    */
+    class RenderProfiler
+    {
+    public:
+
+        /**
+        * Allocates all the memory the profiler needs. This constructor should
+        * never be called by the real-time thread.
+        */
+        RenderProfiler();
+
+        /**
+        * Returns the current time, in nanoseconds, to be used for measuring
+        * durations.
+        */
+        static uint64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /**
+        * Resets the durations measured, which should be done whenever the
+        * rendering sequence changes. This method must only be called by the
+        * real-time thread.
+        */
+        void reset();
+
+        /**
+        * Records the duration of the Worker at the given position in the rendering
+        * sequence. This method can be called by any rendering thread, as long as
+        * each position is recorded by only one thread per rendering session.
+        * @param[in] position Position of the Worker in the rendering sequence.
+        * @param[in] duration Duration of the Worker's call, in nanoseconds.
+        */
+        void recordWorker(uint32_t position, uint64_t duration)
+        {
+            if (position < ANGLECORE_PROFILER_MAX_NUM_WORKERS)
+            {
+                m_lastDurations[position] = duration;
+                if (duration > m_maxDurations[position])
+                    m_maxDurations[position] = duration;
+            }
+        }
+
+        /**
+        * Publishes the measurements of the rendering session that just ended. This
+        * method must only be called by the real-time thread, once every Worker of
+        * the session has been rendered.
+        * @param[in] workerIDs The IDs of the workers of the rendering sequence, in
+        *   the same order.
+        * @param[in] numSamplesRendered Number of samples rendered in the session.
+        * @param[in] sessionDuration Total duration of the session, in nanoseconds.
+        */
+        void publishSession(const std::vector<uint32_t>& workerIDs, unsigned int numSamplesRendered, uint64_t sessionDuration);
+
+        /**
+        * Copies the last published profile into \p profile. Returns true if a new
+        * profile has been published since the last call, and false otherwise, in
+        * which case the same profile as before is copied. This method is
+        * thread-safe, but should never be called by the real-time thread.
+        * @param[out] profile The RenderProfile to copy the measurements into.
+        */
+        bool getLatestProfile(RenderProfile& profile);
+
+    private:
+        std::vector<uint64_t> m_lastDurations;
+        std::vector<uint64_t> m_maxDurations;
+        uint64_t m_sessionNumber;
+        TripleBuffer<RenderProfile> m_snapshots;
+
+        /** Serializes the readers, as the TripleBuffer only allows one consumer */
+        Mutex m_readerLock;
+    };
+}
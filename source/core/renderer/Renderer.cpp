@@ -20,16 +20,153 @@
 **
 **********************************************************************/
 
+#include <thread>
+#include <utility>
+
 #include "Renderer.h"
 
 namespace ANGLECORE
 {
+    /* Renderer::HelperThread
+    ***************************************************/
+
+    Renderer::HelperThread::HelperThread(Renderer& renderer, unsigned short threadNumber) :
+        Thread(),
+        m_renderer(renderer),
+        m_threadNumber(threadNumber)
+    {}
+
+    void Renderer::HelperThread::run()
+    {
+#if ANGLECORE_ENABLE_TRACING
+        Tracer::setCurrentThreadNumber(m_threadNumber);
+#endif
+
+        RealtimeThreadScope realtimeThreadScope;
+
+        unsigned int numAttempts = 0;
+        bool hasAdoptedPriority = false;
+        while (true)
+        {
+            /*
+            * We retrieve the session signal's epoch before checking for anything
+            * to do, so that a session published (or a stop requested) after this
+            * point wakes us up if we decide to sleep below.
+            */
+            uint32_t epoch = m_renderer.m_sessionSignal.getEpoch();
+            if (shouldStop())
+                return;
+
+            /*
+            * The helper thread renders alongside the real-time thread, so it should
+            * be scheduled like the latter. Otherwise, the real-time thread could
+            * end up waiting for a voice claimed by a helper thread that has been
+            * preempted. We copy the priority of the real-time thread rather than
+            * choosing one, so that we never starve the host's audio thread. If the
+            * system refuses, we still help with a regular priority.
+            */
+            if (!hasAdoptedPriority && m_renderer.m_hasRealtimeThreadPriority.load(std::memory_order_acquire))
+            {
+                setCurrentPriority(m_renderer.m_realtimeThreadPriority);
+                hasAdoptedPriority = true;
+            }
+
+            bool hasRendered = m_renderer.claimAndRenderVoice();
+            if (!hasRendered && m_renderer.m_renderingMode == DEPENDENCY_PARALLEL)
+                hasRendered = m_renderer.popOrStealAndRenderTask(m_threadNumber);
+
+            /*
+            * When there is nothing to render, we first spin for a while, as the
+            * real-time thread may be about to publish some work, and then sleep
+            * until the next rendering session, to leave the CPU to other threads.
+            * We spin with pause instructions rather than yielding: yielding under
+            * a real-time policy only hands the core over to threads of the same
+            * priority, and would not help a lower-priority thread anyway.
+            */
+            if (hasRendered)
+                numAttempts = 0;
+            else if (++numAttempts < ANGLECORE_RENDERER_SPIN_COUNT)
+                Renderer::pause(numAttempts);
+            else
+            {
+                m_renderer.m_sessionSignal.wait(epoch);
+                numAttempts = 0;
+            }
+        }
+    }
+
+    /* Renderer
+    ***************************************************/
+
     Renderer::Renderer() :
-        m_isReadyToRender(false),
-        m_start(0),
-        m_shouldUpdateIncrements(false)
+        Renderer(SEQUENTIAL, 0)
     {}
 
+    Renderer::Renderer(RenderingMode renderingMode, unsigned short numHelperThreads) :
+        m_isReadyToRender(false),
+        m_activeVoices(0),
+        m_shouldUpdateActiveTasks(false),
+        m_renderingMode(renderingMode),
+        m_isSplittableByVoice(false),
+        m_numSamplesToRender(0),
+        m_sessionNumber(0),
+        m_voiceTicket(0),
+        m_numRenderedVoices(0),
+        m_realtimeThreadPriority(),
+        m_hasRealtimeThreadPriority(false),
+        m_hasDependencyGraph(false),
+        m_numRootTasks(0),
+        m_numActiveTasks(0),
+        m_numCompletedTasks(0)
+#if ANGLECORE_ENABLE_TRACING
+        , m_tracer(nullptr)
+#endif
+    {
+        /*
+        * In DEPENDENCY_PARALLEL mode, we allocate the scheduling memory once and
+        * for all, including one task queue for the real-time thread and one for
+        * each helper thread.
+        */
+        if (m_renderingMode == DEPENDENCY_PARALLEL)
+        {
+            m_taskIsActive.resize(ANGLECORE_RENDERER_MAX_NUM_TASKS, false);
+            m_activePredecessorCounts.resize(ANGLECORE_RENDERER_MAX_NUM_TASKS, 0);
+            m_pendingPredecessorCounts = std::vector<std::atomic<uint32_t>>(ANGLECORE_RENDERER_MAX_NUM_TASKS);
+            m_rootTasks.resize(ANGLECORE_RENDERER_MAX_NUM_TASKS, 0);
+            for (unsigned short t = 0; t <= numHelperThreads; t++)
+                m_taskQueues.emplace_back(new WorkStealingQueue(ANGLECORE_RENDERER_MAX_NUM_TASKS));
+        }
+
+        /*
+        * Helper threads are only useful in parallel modes, so we only spawn them in
+        * that case. They are spawned once and for all, so that the real-time
+        * thread never has to create any thread.
+        */
+        if (m_renderingMode != SEQUENTIAL)
+        {
+            m_helperThreads.reserve(numHelperThreads);
+            for (unsigned short t = 0; t < numHelperThreads; t++)
+            {
+                m_helperThreads.emplace_back(new HelperThread(*this, t + 1));
+                m_helperThreads.back()->start();
+            }
+        }
+    }
+
+    Renderer::~Renderer()
+    {
+        /*
+        * We first ask all threads to stop, so that they terminate concurrently.
+        * Each thread's destructor will then wait for it to effectively stop.
+        */
+        for (std::unique_ptr<HelperThread>& thread : m_helperThreads)
+            thread->stop();
+
+        /* We also wake up the threads that are sleeping, so that they can stop */
+        m_sessionSignal.notifyAll();
+        m_helperThreads.clear();
+    }
+
     void Renderer::render(unsigned int numSamplesToRender)
     {
         /*
@@ -40,59 +177,137 @@ namespace ANGLECORE
         * all the variables have been set to their initial value.
         */
         
-        /*===============================
-        * STEP 1/2: UPDATE THE INCREMENTS
-        =================================*/
+        /*=================================
+        * STEP 1/2: UPDATE THE ACTIVE TASKS
+        ===================================*/
 
-        if (m_shouldUpdateIncrements)
+        /*
+        * Only the dependency graph needs some preparation when voices are turned
+        * on or off. The other rendering paths directly read the active voices.
+        */
+        if (m_shouldUpdateActiveTasks)
         {
-            updateIncrements();
-            m_shouldUpdateIncrements = false;
+            updateActiveTasks();
+            m_shouldUpdateActiveTasks = false;
         }
 
         /*=========================
         * STEP 2/2: RENDER SEQUENCE
         ===========================*/
 
+        /*
+        * If some threads can help, then we render the sequence by following its
+        * dependency graph, or by rendering the voices in parallel if the sequence
+        * is grouped by voice. Otherwise, we simply render the sequence on the
+        * real-time thread.
+        */
         if (m_isReadyToRender)
-            for (uint32_t i = m_start; i < m_renderingSequence.size(); i += m_increments[i])
-                m_renderingSequence[i]->work(numSamplesToRender);
+        {
+#if ANGLECORE_ENABLE_PROFILING
+            uint64_t sessionStart = RenderProfiler::now();
+#endif
+#if ANGLECORE_ENABLE_TRACING
+            if (m_tracer)
+                m_tracer->beginEvent("render");
+#endif
+
+            /*
+            * The first time we render with helper threads, we record the priority
+            * of the real-time thread, which the helper threads will adopt.
+            */
+            if (!m_helperThreads.empty() && !m_hasRealtimeThreadPriority.load(std::memory_order_relaxed))
+            {
+                m_realtimeThreadPriority = Thread::getCurrentPriority();
+                m_hasRealtimeThreadPriority.store(true, std::memory_order_release);
+            }
+
+            if (m_hasDependencyGraph && !m_helperThreads.empty())
+                renderDependencyGraph(numSamplesToRender);
+            else if (m_isSplittableByVoice && !m_helperThreads.empty())
+                renderVoicesInParallel(numSamplesToRender);
+            else
+                renderSequentially(numSamplesToRender);
+
+#if ANGLECORE_ENABLE_PROFILING
+            /*
+            * Every worker has been rendered once here, whatever the rendering mode,
+            * so the measurements of the session are complete.
+            */
+            m_profiler.publishSession(m_workerIDs, numSamplesToRender, RenderProfiler::now() - sessionStart);
+#endif
+#if ANGLECORE_ENABLE_TRACING
+            if (m_tracer)
+                m_tracer->endEvent("render");
+#endif
+        }
     }
 
 
     void Renderer::turnVoiceOn(unsigned short voiceNumber)
     {
-        m_voiceIsOn[voiceNumber] = true;
+        m_activeVoices |= static_cast<uint64_t>(1) << voiceNumber;
 
-        if (m_isReadyToRender)
-            m_shouldUpdateIncrements = true;
+        if (m_hasDependencyGraph)
+            m_shouldUpdateActiveTasks = true;
     }
 
     void Renderer::turnVoiceOff(unsigned short voiceNumber)
     {
-        m_voiceIsOn[voiceNumber] = false;
+        m_activeVoices &= ~(static_cast<uint64_t>(1) << voiceNumber);
 
-        if (m_isReadyToRender)
-            m_shouldUpdateIncrements = true;
+        if (m_hasDependencyGraph)
+            m_shouldUpdateActiveTasks = true;
     }
 
     void Renderer::processConnectionRequest(ConnectionRequest& request)
     {
         /*
         * The request is assumed to be valid, i.e. it should contain a non-empty
-        * rendering sequence, and its voice assigments and one increment vector
-        * should be of the same size as the sequence.
+        * rendering sequence, and its voice assigments should be of the same size
+        * as the sequence.
+        */
+
+        /*
+        * We swap every vector with the request's, rather than moving them, so
+        * that the previous vectors are handed over to the request and deallocated
+        * along with it, outside of the real-time thread. Note that the Renderer
+        * does not take the workers themselves: they remain owned by the Workflow,
+        * and the Renderer only calls them through their WorkCall.
         */
+        std::swap(m_workCalls, request.newWorkCalls);
+        std::swap(m_voiceAssignments, request.newVoiceAssignments);
 
-        /* We move every vector from the request to the renderer */
-        m_renderingSequence = std::move(request.newRenderingSequence);
-        m_voiceAssignments = std::move(request.newVoiceAssignments);
-        m_increments = std::move(request.oneIncrements);
+#if ANGLECORE_ENABLE_PROFILING || ANGLECORE_ENABLE_TRACING
+        std::swap(m_workerIDs, request.newWorkerIDs);
+#endif
+#if ANGLECORE_ENABLE_PROFILING
+        m_profiler.reset();
+#endif
+
+        /* We also copy the positions of each voice, if relevant */
+        m_isSplittableByVoice = request.isSplittableByVoice;
+        if (m_isSplittableByVoice)
+            for (unsigned short v = 0; v <= ANGLECORE_NUM_VOICES; v++)
+                m_voiceSegmentStarts[v] = request.newVoiceSegmentStarts[v];
+
+        /*
+        * In DEPENDENCY_PARALLEL mode, we also take the dependency graph, provided
+        * it is consistent with the sequence and fits within the memory allocated
+        * for scheduling.
+        */
+        if (m_renderingMode == DEPENDENCY_PARALLEL)
+        {
+            uint32_t size = m_workCalls.size();
+            std::swap(m_predecessorCounts, request.newPredecessorCounts);
+            std::swap(m_successorOffsets, request.newSuccessorOffsets);
+            std::swap(m_successors, request.newSuccessors);
+            m_hasDependencyGraph = size <= ANGLECORE_RENDERER_MAX_NUM_TASKS && m_predecessorCounts.size() == size && m_successorOffsets.size() == size + 1 && m_successorOffsets.back() == m_successors.size();
+        }
 
         /*
-        * Note that once here, after the move operations, the three vectors
-        * newRenderingSequence, newVoiceAssignments, and oneIncrements are in a
-        * valid but unspecified state within the ConnectionRequest. So the
+        * Note that once here, after the swap operations, the vectors newWorkCalls
+        * and newVoiceAssignments contain the Renderer's previous data within the
+        * ConnectionRequest. So the
         * Master should never try to access these vectors once it has posted a
         * ConnectionRequest. The Master can still access the
         * hasBeenSuccessfullyProcessed atomic variable though, and use it to
@@ -101,47 +316,293 @@ namespace ANGLECORE
         */
 
         m_isReadyToRender = true;
-        m_shouldUpdateIncrements = true;
+        m_shouldUpdateActiveTasks = m_hasDependencyGraph;
     }
 
-    void Renderer::updateIncrements()
+    bool Renderer::claimAndRenderVoice()
     {
+        uint64_t ticket = m_voiceTicket.load(std::memory_order_acquire);
+
         /*
-        * We only enter this function if the renderer already works on a valid, non-
-        * empty sequence to render. Therefore we are ensured m_renderingSequence,
-        * m_voiceAssignments, and m_increments are all of equal length, and that
-        * none is empty. So we do not need to make any out-of-range checks here.
+        * We try to increment the index of the next voice to claim, as long as
+        * some voices are left. If the compare-and-swap fails, then another thread
+        * has claimed a voice or a new session has started in the meantime, and
+        * the ticket is reloaded for another attempt.
         */
+        while ((ticket & 0xFFFF) < ((ticket >> 16) & 0xFFFF))
+        {
+            if (m_voiceTicket.compare_exchange_weak(ticket, ticket + 1, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                /*
+                * The voice is ours. Since the real-time thread waits for every
+                * claimed voice to be rendered before starting a new session, the
+                * session's data cannot change until we are done.
+                */
+                unsigned short voiceNumber = m_voicesToRender[ticket & 0xFFFF];
+                renderRange(m_voiceSegmentStarts[voiceNumber], m_voiceSegmentStarts[voiceNumber + 1], m_numSamplesToRender);
+                m_numRenderedVoices.fetch_add(1, std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Renderer::renderVoicesInParallel(unsigned int numSamplesToRender)
+    {
+        /*=========================
+        * STEP 1/3: RENDER THE HEAD
+        ===========================*/
+
+        renderRange(0, m_voiceSegmentStarts[0], numSamplesToRender);
+
+        /*=============================
+        * STEP 2/3: RENDER EVERY VOICE
+        ===============================*/
+
+        /* We first list the voices that are on and have something to render */
+        unsigned short numVoicesToRender = 0;
+        for (uint64_t voices = m_activeVoices; voices != 0; voices &= voices - 1)
+        {
+            unsigned short v = BitMath::countTrailingZeros(voices);
+            if (m_voiceSegmentStarts[v] != m_voiceSegmentStarts[v + 1])
+                m_voicesToRender[numVoicesToRender++] = v;
+        }
 
         /*
-        * The algorithm used here is a fast, backward algorithm that computes the
-        * number of jumps the renderer should make after calling a worker from the
-        * rendering sequence. Note that the last value of m_increments is always
-        * equal to 1, because m_increments is always initialized to a valid state
-        * by capturing the content of a ConnectionRequest's oneIncrements vector.
+        * If there is only one voice to render, there is nothing to parallelize, so
+        * we render it directly and avoid any synchronization.
         */
+        if (numVoicesToRender == 1)
+            renderRange(m_voiceSegmentStarts[m_voicesToRender[0]], m_voiceSegmentStarts[m_voicesToRender[0] + 1], numSamplesToRender);
+        else if (numVoicesToRender > 1)
+        {
+            /*
+            * We publish the new session to the helper threads. The release
+            * semantics ensure the helper threads will see the voices to render and
+            * the number of samples once they claim a voice.
+            */
+            m_numSamplesToRender = numSamplesToRender;
+            m_numRenderedVoices.store(0, std::memory_order_relaxed);
+            m_sessionNumber++;
+            m_voiceTicket.store((static_cast<uint64_t>(m_sessionNumber) << 32) | (static_cast<uint64_t>(numVoicesToRender) << 16), std::memory_order_release);
+            m_sessionSignal.notifyAll();
+
+            /* The real-time thread participates in the rendering as well... */
+            while (claimAndRenderVoice());
+
+            /*
+            * ... And then waits for the helper threads to finish the voices they
+            * have claimed. This is the barrier before the voice-free tail.
+            */
+            unsigned int numAttempts = 0;
+            while (m_numRenderedVoices.load(std::memory_order_acquire) < numVoicesToRender)
+                backOff(numAttempts);
+        }
+
+        /*=========================
+        * STEP 3/3: RENDER THE TAIL
+        ===========================*/
 
-        for (uint32_t i = m_renderingSequence.size() - 1; i >= 1; i--)
+        renderRange(m_voiceSegmentStarts[ANGLECORE_NUM_VOICES], m_workCalls.size(), numSamplesToRender);
+    }
 
+    void Renderer::renderSequentially(unsigned int numSamplesToRender)
+    {
+        if (m_isSplittableByVoice)
+        {
+            /*
+            * The sequence is grouped by voice, so we render the head, then the
+            * segment of each active voice, and finally the tail. Clearing the
+            * lowest bit set at each iteration visits the active voices in
+            * increasing order, and never touches the inactive ones.
+            */
+            renderRange(0, m_voiceSegmentStarts[0], numSamplesToRender);
+            for (uint64_t voices = m_activeVoices; voices != 0; voices &= voices - 1)
+            {
+                unsigned short v = BitMath::countTrailingZeros(voices);
+                renderRange(m_voiceSegmentStarts[v], m_voiceSegmentStarts[v + 1], numSamplesToRender);
+            }
+            renderRange(m_voiceSegmentStarts[ANGLECORE_NUM_VOICES], m_workCalls.size(), numSamplesToRender);
+        }
+        else
+        {
             /*
-            * We only render a worker if it is assigned to a voice that is on, or if
-            * it was not assigned to any voice and is completely free. Therefore, we
-            * test each voice assignment to see if it is null, or if it refers to a
-            * voice which is currently playing. If it is, then the corresponding
-            * worker should be called for rendering, so we fix an increment of 1
-            * after the previous worker. Otherwise, we should skip the worker, so we
-            * fix an increment that ensures we bypass the worker when traversing the
-            * rendering sequence.
+            * Otherwise, we have no choice but to check the voice assignment of
+            * every worker: we only render a worker if it was not assigned to any
+            * voice, or if its voice is on.
             */
-            m_increments[i - 1] = m_voiceAssignments[i].isNull || m_voiceIsOn[m_voiceAssignments[i].voiceNumber] ? 1 : m_increments[i] + 1;
+            for (uint32_t i = 0; i < m_workCalls.size(); i++)
+                if (m_voiceAssignments[i].isNull || (m_activeVoices >> m_voiceAssignments[i].voiceNumber) & 1)
+                    callWorker(i, numSamplesToRender);
+        }
+    }
+
+    void Renderer::renderRange(uint32_t begin, uint32_t end, unsigned int numSamplesToRender)
+    {
+        for (uint32_t i = begin; i < end; i++)
+            callWorker(i, numSamplesToRender);
+    }
+
+    bool Renderer::popOrStealAndRenderTask(unsigned short threadNumber)
+    {
+        uint32_t task;
+        uint32_t numQueues = m_taskQueues.size();
+
+        /*
+        * We first look into our own queue, then visit the other threads' queues in
+        * turn, until we find a worker to render.
+        */
+        bool hasFoundTask = m_taskQueues[threadNumber]->pop(task);
+        for (uint32_t q = 1; q < numQueues && !hasFoundTask; q++)
+            hasFoundTask = m_taskQueues[(threadNumber + q) % numQueues]->steal(task);
+
+        if (!hasFoundTask)
+            return false;
+
+        callWorker(task, m_numSamplesToRender);
 
         /*
-        * Finally, using the same test as before, we compute the start position
-        * within the rendering sequence, which may vary depending on the voices'
-        * on/off status. The start position can be 0, if the first worker should be
-        * rendered. Otherwise, we use the precomputed increments to determine the
-        * position of the first worker to render.
+        * Once the worker is rendered, each of its active successors has one less
+        * predecessor to wait for. The thread that renders the last predecessor of a
+        * worker pushes the latter into its own queue. The acquire-release ordering
+        * ensures that the thread which eventually renders the successor sees the
+        * results of all of its predecessors.
         */
-        m_start = m_voiceAssignments[0].isNull || m_voiceIsOn[m_voiceAssignments[0].voiceNumber] ? 0 : m_increments.front();
+        for (uint32_t s = m_successorOffsets[task]; s < m_successorOffsets[task + 1]; s++)
+        {
+            uint32_t successor = m_successors[s];
+            if (m_taskIsActive[successor] && m_pendingPredecessorCounts[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                m_taskQueues[threadNumber]->push(successor);
+        }
+
+        m_numCompletedTasks.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    void Renderer::renderDependencyGraph(unsigned int numSamplesToRender)
+    {
+        /*
+        * We first reset the number of predecessors each worker has to wait for.
+        * These stores do not need to be ordered, as pushing the first tasks below
+        * will publish them to the helper threads.
+        */
+        m_numSamplesToRender = numSamplesToRender;
+        uint32_t size = m_workCalls.size();
+        for (uint32_t i = 0; i < size; i++)
+            m_pendingPredecessorCounts[i].store(m_activePredecessorCounts[i], std::memory_order_relaxed);
+        m_numCompletedTasks.store(0, std::memory_order_relaxed);
+
+        /* Then, we push the workers that are ready to be rendered right away... */
+        for (uint32_t r = 0; r < m_numRootTasks; r++)
+            m_taskQueues[0]->push(m_rootTasks[r]);
+        m_sessionSignal.notifyAll();
+
+        /*
+        * ... And we participate in the rendering until every active worker has
+        * been rendered, by any thread.
+        */
+        unsigned int numAttempts = 0;
+        while (m_numCompletedTasks.load(std::memory_order_acquire) < m_numActiveTasks)
+        {
+            if (popOrStealAndRenderTask(0))
+                numAttempts = 0;
+            else
+                backOff(numAttempts);
+        }
+    }
+
+    void Renderer::updateActiveTasks()
+    {
+        uint32_t size = m_workCalls.size();
+
+        /*
+        * A worker is active if it is not assigned to any voice, or if its voice is
+        * on.
+        */
+        for (uint32_t i = 0; i < size; i++)
+        {
+            m_taskIsActive[i] = m_voiceAssignments[i].isNull || (m_activeVoices >> m_voiceAssignments[i].voiceNumber) & 1;
+            m_activePredecessorCounts[i] = 0;
+        }
+
+        /*
+        * Inactive workers will not be rendered, so their successors should not
+        * wait for them: we only count the active predecessors of each worker.
+        */
+        for (uint32_t i = 0; i < size; i++)
+            if (m_taskIsActive[i])
+                for (uint32_t s = m_successorOffsets[i]; s < m_successorOffsets[i + 1]; s++)
+                    m_activePredecessorCounts[m_successors[s]]++;
+
+        /* Finally, we list the active workers that can be rendered right away */
+        m_numActiveTasks = 0;
+        m_numRootTasks = 0;
+        for (uint32_t i = 0; i < size; i++)
+        {
+            if (m_taskIsActive[i])
+            {
+                m_numActiveTasks++;
+                if (m_activePredecessorCounts[i] == 0)
+                    m_rootTasks[m_numRootTasks++] = i;
+            }
+        }
+    }
+
+    void Renderer::backOff(unsigned int& numAttempts)
+    {
+        /*
+        * The real-time thread never sleeps, but once it has waited for a while, it
+        * yields the CPU between its checks. As the helper threads share its
+        * priority, this lets a helper thread that was preempted on the same core
+        * finish its work, instead of having the real-time thread spin against it.
+        */
+        if (numAttempts < ANGLECORE_RENDERER_SPIN_COUNT)
+            pause(++numAttempts);
+        else
+            std::this_thread::yield();
+    }
+
+    void Renderer::pause(unsigned int numAttempts)
+    {
+        unsigned int numPauses = numAttempts < 16 ? 1u << numAttempts : ANGLECORE_RENDERER_MAX_PAUSES;
+        if (numPauses > ANGLECORE_RENDERER_MAX_PAUSES)
+            numPauses = ANGLECORE_RENDERER_MAX_PAUSES;
+        for (unsigned int p = 0; p < numPauses; p++)
+            Thread::pause();
+    }
+
+    inline void Renderer::callWorker(uint32_t position, unsigned int numSamplesToRender)
+    {
+#if ANGLECORE_ENABLE_PROFILING
+        uint64_t start = RenderProfiler::now();
+#endif
+#if ANGLECORE_ENABLE_TRACING
+        if (m_tracer)
+            m_tracer->beginEvent("work", m_workerIDs[position]);
+#endif
+
+        m_workCalls[position].function(m_workCalls[position].worker, numSamplesToRender);
+
+#if ANGLECORE_ENABLE_TRACING
+        if (m_tracer)
+            m_tracer->endEvent("work", m_workerIDs[position]);
+#endif
+#if ANGLECORE_ENABLE_PROFILING
+        m_profiler.recordWorker(position, RenderProfiler::now() - start);
+#endif
+    }
+
+#if ANGLECORE_ENABLE_TRACING
+    void Renderer::setTracer(Tracer* tracer)
+    {
+        m_tracer = tracer;
+    }
+#endif
+
+#if ANGLECORE_ENABLE_PROFILING
+    bool Renderer::getRenderProfile(RenderProfile& profile)
+    {
+        return m_profiler.getLatestProfile(profile);
     }
+#endif
 }
\ No newline at end of file
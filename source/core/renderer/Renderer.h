@@ -24,12 +24,27 @@
 
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <stdint.h>
 
 #include "../audioworkflow/workflow/Worker.h"
 #include "../audioworkflow/voiceassigner/VoiceAssigner.h"
 #include "../../config/RenderingConfig.h"
 #include "../../dependencies/farbot/fifo.h"
 #include "../requestmanager/requests/ConnectionRequest.h"
+#include "../../utility/Thread.h"
+#include "../../utility/WakeupSignal.h"
+#include "../../utility/WorkStealingQueue.h"
+#include "../../utility/RealtimeThreadScope.h"
+#include "../../math/BitMath.h"
+#include "RenderProfiler.h"
+#include "../tracer/Tracer.h"
+
+/*
+* The Renderer tracks the active voices using the bits of a 64-bit integer, so it
+* cannot handle more than 64 voices.
+*/
+static_assert(ANGLECORE_NUM_VOICES <= 64, "The Renderer supports at most 64 voices.");
 
 namespace ANGLECORE
 {
@@ -43,12 +58,45 @@ namespace ANGLECORE
     public:
 
         /**
-        * Creates a Renderer with an empty rendering sequence. The Renderer will not
-        * be ready to render anything upon creation: it will wait to be initialized
+        * \enum RenderingMode Renderer.h
+        * Defines how the Renderer should distribute its rendering sequence across
+        * threads.
+        */
+        enum RenderingMode
+        {
+            SEQUENTIAL = 0,     /**< Every Worker is rendered by the real-time thread, one after the other. */
+            VOICE_PARALLEL,     /**< The voices are rendered in parallel by the real-time thread and a pool of helper threads, and joined before the voice-free workers that depend on them (such as the Mixer). */
+            DEPENDENCY_PARALLEL,    /**< Every Worker is rendered as soon as all the workers it depends on have been rendered, by any thread among the real-time thread and a pool of helper threads, which steal work from one another. This mode falls back to VOICE_PARALLEL if the dependency graph is not available. */
+            NUM_MODES
+        };
+
+        /**
+        * Creates a Renderer with an empty rendering sequence, which renders every
+        * Worker sequentially on the real-time thread. The Renderer will not be
+        * ready to render anything upon creation: it will wait to be initialized
         * with a ConnectionRequest.
         */
         Renderer();
 
+        /**
+        * Creates a Renderer with an empty rendering sequence and the given
+        * RenderingMode. The Renderer will not be ready to render anything upon
+        * creation: it will wait to be initialized with a ConnectionRequest.
+        * @param[in] renderingMode The RenderingMode to use.
+        * @param[in] numHelperThreads Number of threads to spawn in order to help
+        *   the real-time thread render the voices in parallel. These threads are
+        *   spawned upon creation and kept alive until the Renderer is destroyed.
+        *   This parameter is ignored in SEQUENTIAL mode. If it is null, the
+        *   Renderer will behave as in SEQUENTIAL mode.
+        */
+        Renderer(RenderingMode renderingMode, unsigned short numHelperThreads);
+
+        /**
+        * Stops and destroys the helper threads, if any. The destructor waits for
+        * each thread to terminate before returning.
+        */
+        ~Renderer();
+
         /**
         * Renders the given number of samples. This method constitutes the kernel of
         * ANGLECORE's real-time rendering pipeline. It will be repeatedly called by
@@ -60,24 +108,25 @@ namespace ANGLECORE
         void render(unsigned int numSamplesToRender);
 
         /**
-        * Instructs the Renderer to turn a Voice on, and to recompute its increments
-        * later, before rendering the next audio block. This method is really fast,
+        * Instructs the Renderer to turn a Voice on, so that its workers are
+        * rendered from the next audio block on. This method runs in constant time,
         * as it will only be called by the real-time thread.
         * @param[in] voiceNumber Number identifying the Voice to turn on
         */
         void turnVoiceOn(unsigned short voiceNumber);
 
         /**
-        * Instructs the Renderer to turn a Voice off, and to recompute its
-        * increments later, before rendering the next audio block. This method is
-        * really fast, as it will only be called by the real-time thread.
+        * Instructs the Renderer to turn a Voice off, so that its workers are
+        * skipped from the next audio block on. This method runs in constant time,
+        * as it will only be called by the real-time thread.
         * @param[in] voiceNumber Number identifying the Voice to turn off
         */
         void turnVoiceOff(unsigned short voiceNumber);
 
         /**
         * Acquires the new rendering sequence and voice assignments from the given
-        * ConnectionRequest, as well as the increment vector. The request passed as
+        * ConnectionRequest, as well as the voice segments and dependency graph
+        * computed along with them. The request passed as
         * argument must be valid, as this method will perform no validity check and
         * take the ConnectionRequest's results from granted. This method uses move
         * semantics, so it will take ownership of the vectors contained in the
@@ -85,20 +134,164 @@ namespace ANGLECORE
         * the real-time thread.
         * @param[in] request The ConnectionRequest to take the results from. It
         *   should be a valid ConnectionRequest, i.e. it should respect the two
-        *   properties defined in the structure definition (the rendering sequence,
-        *   voice assignments and one increment vectors must all be of the same size
-        *   and must all be non empty).
+        *   properties defined in the structure definition (the rendering sequence
+        *   and voice assignments must be of the same size and must both be non
+        *   empty).
         */
         void processConnectionRequest(ConnectionRequest& request);
 
-    private:
+#if ANGLECORE_ENABLE_TRACING
+        /**
+        * Sets the Tracer to record the rendering sessions and the workers' calls
+        * into. This method should be called before any rendering takes place.
+        * @param[in] tracer The Tracer to use. If null, nothing is recorded.
+        */
+        void setTracer(Tracer* tracer);
+#endif
+
+#if ANGLECORE_ENABLE_PROFILING
+        /**
+        * Copies the measurements of the last rendering session into \p profile.
+        * Returns true if a new session has been profiled since the last call, and
+        * false otherwise. This method is thread-safe, but should never be called
+        * by the real-time thread.
+        * @param[out] profile The RenderProfile to copy the measurements into.
+        */
+        bool getRenderProfile(RenderProfile& profile);
+#endif
+
+    protected:
+
+        /**
+        * \class HelperThread Renderer.h
+        * Thread that helps the real-time thread render the voices in parallel. It
+        * adopts the priority of the real-time thread as soon as the latter has
+        * rendered once, whenever the system allows it, and never runs with a
+        * higher priority. It polls the Renderer for something to render, so that
+        * it can react as fast as possible when a new rendering session begins,
+        * and pauses the processor with an exponential backoff in between. Once it
+        * has found nothing to render ANGLECORE_RENDERER_SPIN_COUNT times in a
+        * row, it sleeps until the real-time thread publishes the next session.
+        */
+        class HelperThread :
+            public Thread
+        {
+        public:
+
+            /**
+            * Creates a HelperThread that will help the given Renderer once started.
+            * @param[in] renderer The Renderer to help.
+            * @param[in] threadNumber Number identifying the thread within the
+            *   Renderer, starting from 1 (0 designates the real-time thread).
+            */
+            HelperThread(Renderer& renderer, unsigned short threadNumber);
+
+        protected:
+
+            /**
+            * Polls the Renderer for something to render, and sleeps in between
+            * rendering sessions, until the thread is requested to stop.
+            */
+            void run();
+
+        private:
+            Renderer& m_renderer;
+            const unsigned short m_threadNumber;
+        };
+
+        /**
+        * Tries to claim one of the voices published for the current rendering
+        * session, and renders its segment if it succeeds. Returns true if a voice
+        * was rendered, and false if no voice was left to claim. This method is
+        * lock-free, and is called by both the real-time thread and the helper
+        * threads.
+        */
+        bool claimAndRenderVoice();
+
+        /**
+        * Renders the given number of samples by splitting the rendering sequence
+        * by voice: the voice-free head is rendered first, then the active voices
+        * are rendered in parallel, and the voice-free tail is rendered once every
+        * voice has been rendered. This method must only be called by the
+        * real-time thread, and only if the current rendering sequence is
+        * splittable by voice.
+        * @param[in] numSamplesToRender Number of samples to render.
+        */
+        void renderVoicesInParallel(unsigned int numSamplesToRender);
+
+        /**
+        * Tries to take a Worker that is ready to be rendered, first from the
+        * calling thread's own queue, and then from the other threads' queues, and
+        * renders it if it succeeds. Returns true if a Worker was rendered, and
+        * false if no Worker could be found. This method is lock-free, and is
+        * called by both the real-time thread and the helper threads.
+        * @param[in] threadNumber Number identifying the calling thread, 0 being the
+        *   real-time thread.
+        */
+        bool popOrStealAndRenderTask(unsigned short threadNumber);
+
+        /**
+        * Renders the given number of samples by following the dependency graph of
+        * the rendering sequence: the real-time thread pushes the workers without
+        * active predecessors into its queue, and every rendered Worker then pushes
+        * its successors once they are ready. The method returns once every active
+        * Worker has been rendered. This method must only be called by the
+        * real-time thread, and only if the current dependency graph is valid.
+        * @param[in] numSamplesToRender Number of samples to render.
+        */
+        void renderDependencyGraph(unsigned int numSamplesToRender);
+
+        /**
+        * Called by the real-time thread each time it checks in vain whether the
+        * helper threads are done. It pauses the processor for the first
+        * ANGLECORE_RENDERER_SPIN_COUNT attempts, and yields the CPU afterwards.
+        * @param[in, out] numAttempts Number of attempts made so far, which should
+        *   be set to zero before the first one.
+        */
+        static void backOff(unsigned int& numAttempts);
+
+        /**
+        * Pauses the processor a number of times that doubles with each attempt,
+        * up to ANGLECORE_RENDERER_MAX_PAUSES, so that a spinning thread leaves
+        * the memory bus and the sibling hardware thread alone without ever
+        * giving up its core.
+        * @param[in] numAttempts Number of fruitless attempts made so far.
+        */
+        static void pause(unsigned int numAttempts);
+
+        /**
+        * Recomputes which workers are active, the number of active predecessors of
+        * each Worker, and the workers to start from, after a Voice has been turned
+        * on or off, or after a ConnectionRequest has been processed. This method
+        * will be called by the real-time thread.
+        */
+        void updateActiveTasks();
+
+        /**
+        * Renders the given number of samples on the calling thread only. If the
+        * rendering sequence is grouped by voice, only the segments of the active
+        * voices are visited. Otherwise, the voice assignment of every Worker is
+        * checked before rendering it.
+        * @param[in] numSamplesToRender Number of samples to render.
+        */
+        void renderSequentially(unsigned int numSamplesToRender);
 
         /**
-        * Recomputes the Renderer's increments after a Voice has been turned on or
-        * off, or after a ConnectionRequest has been processed. This method is fast,
-        * as it will be called by the real-time thread.
+        * Calls the Worker at the given position in the rendering sequence. If
+        * profiling is enabled, this method also measures the duration of the
+        * call.
+        * @param[in] position Position of the Worker in the rendering sequence.
+        * @param[in] numSamplesToRender Number of samples to render.
         */
-        void updateIncrements();
+        inline void callWorker(uint32_t position, unsigned int numSamplesToRender);
+
+        /**
+        * Renders the workers located between positions \p begin (included) and
+        * \p end (excluded) in the rendering sequence, without any voice check.
+        */
+        void renderRange(uint32_t begin, uint32_t end, unsigned int numSamplesToRender);
+
+    private:
 
         /**
         * Boolean flag which signals when the rendering sequence and voice
@@ -110,40 +303,164 @@ namespace ANGLECORE
         bool m_isReadyToRender;
 
         /**
-        * The current rendering sequence used by the renderer. It should always be
-        * of the same length as m_voiceAssignments and m_increments.
+        * The current rendering sequence used by the renderer, as a flat array of
+        * WorkCall objects aligned on a cache line. It should always be of the same
+        * length as m_voiceAssignments.
         */
-        std::vector<std::shared_ptr<Worker>> m_renderingSequence;
+        WorkCallSequence m_workCalls;
 
         /**
         * The voice assignments corresponding to each Worker in the current
         * rendering sequence. It should always be of the same length as
-        * m_renderingSequence and m_increments.
+        * m_workCalls.
         */
         std::vector<VoiceAssignment> m_voiceAssignments;
 
         /**
-        * Position to start from in the rendering sequence. This may vary depending
-        * on which Voice is on and off, and depending on the Workflow's connections.
+        * Tracks the on/off status of every Voice: the bit at position v is set if
+        * and only if Voice v is on. Iterating over the bits set visits the active
+        * voices in increasing order, which is the order of their segments in the
+        * rendering sequence.
         */
-        uint32_t m_start;
+        uint64_t m_activeVoices;
+
+        /**
+        * Flag that indicates whether to recompute the active workers of the
+        * dependency graph or not in the next rendering session. This flag is
+        * useful for preventing the Renderer from updating them twice, after a
+        * Voice has been turned on or off and a new ConnectionRequest has been
+        * received.
+        */
+        bool m_shouldUpdateActiveTasks;
+
+        /** The RenderingMode used by the Renderer */
+        const RenderingMode m_renderingMode;
+
+        /**
+        * Indicates whether the current rendering sequence is grouped by voice, and
+        * can therefore be rendered using the VOICE_PARALLEL mode.
+        */
+        bool m_isSplittableByVoice;
+
+        /**
+        * Position of each Voice's segment within the current rendering sequence.
+        * The last value corresponds to the start of the voice-free tail. This array
+        * is only meaningful if m_isSplittableByVoice is true.
+        */
+        uint32_t m_voiceSegmentStarts[ANGLECORE_NUM_VOICES + 1];
+
+        /**
+        * Voices to render in the current rendering session. This array is written
+        * by the real-time thread before the session is published, and only read
+        * by the other threads during the session.
+        */
+        unsigned short m_voicesToRender[ANGLECORE_NUM_VOICES];
+
+        /** Number of samples to render in the current rendering session */
+        unsigned int m_numSamplesToRender;
+
+        /** Counts the rendering sessions published to the helper threads */
+        uint32_t m_sessionNumber;
+
+        /**
+        * Ticket used by the threads to claim the voices to render. It packs the
+        * session number in its 32 most significant bits, the number of voices to
+        * render in the next 16 bits, and the index of the next voice to claim in
+        * the 16 least significant bits. Packing them together allows a thread to
+        * claim a voice with a single compare-and-swap operation, which fails if
+        * the session has changed in the meantime.
+        */
+        std::atomic<uint64_t> m_voiceTicket;
+
+        /**
+        * Number of voices that have been entirely rendered in the current
+        * rendering session. The real-time thread waits for this number to reach
+        * the number of voices to render before rendering the voice-free tail.
+        */
+        std::atomic<unsigned short> m_numRenderedVoices;
+
+        /**
+        * Signal the real-time thread sends at the beginning of each parallel
+        * rendering session, to wake up the helper threads that went to sleep.
+        */
+        WakeupSignal m_sessionSignal;
+
+        /**
+        * Scheduling priority of the real-time thread, which the helper threads
+        * adopt once m_hasRealtimeThreadPriority is true. It is recorded when the
+        * real-time thread renders for the first time, as the Renderer is usually
+        * created on another thread.
+        */
+        Thread::Priority m_realtimeThreadPriority;
+        std::atomic<bool> m_hasRealtimeThreadPriority;
+
+        /**
+        * Indicates whether the current rendering sequence comes with a valid
+        * dependency graph, and can therefore be rendered using the
+        * DEPENDENCY_PARALLEL mode.
+        */
+        bool m_hasDependencyGraph;
+
+        /**
+        * Dependency graph of the current rendering sequence: the positions of the
+        * successors of the Worker at position i are stored in m_successors between
+        * m_successorOffsets[i] (included) and m_successorOffsets[i + 1] (excluded).
+        */
+        std::vector<uint32_t> m_predecessorCounts;
+        std::vector<uint32_t> m_successorOffsets;
+        std::vector<uint32_t> m_successors;
+
+        /**
+        * The following vectors are only allocated in DEPENDENCY_PARALLEL mode, with
+        * a fixed size of ANGLECORE_RENDERER_MAX_NUM_TASKS, so that the real-time
+        * thread never allocates memory. For each Worker of the sequence, they
+        * respectively store whether it should be rendered, its number of active
+        * predecessors, and its number of active predecessors that remain to be
+        * rendered in the current rendering session.
+        */
+        std::vector<bool> m_taskIsActive;
+        std::vector<uint32_t> m_activePredecessorCounts;
+        std::vector<std::atomic<uint32_t>> m_pendingPredecessorCounts;
+
+        /** Active workers without any active predecessor */
+        std::vector<uint32_t> m_rootTasks;
+        uint32_t m_numRootTasks;
+
+        /** Number of workers to render in each rendering session */
+        uint32_t m_numActiveTasks;
+
+        /** Number of workers rendered so far in the current rendering session */
+        std::atomic<uint32_t> m_numCompletedTasks;
+
+        /**
+        * Queues of workers ready to be rendered, one per thread. The first one
+        * belongs to the real-time thread.
+        */
+        std::vector<std::unique_ptr<WorkStealingQueue>> m_taskQueues;
+
+#if ANGLECORE_ENABLE_PROFILING
+        /** Measures the time spent in each Worker */
+        RenderProfiler m_profiler;
+#endif
+
+#if ANGLECORE_ENABLE_TRACING
+        /** Records the rendering sessions and workers' calls, if not null */
+        Tracer* m_tracer;
+#endif
 
+#if ANGLECORE_ENABLE_PROFILING || ANGLECORE_ENABLE_TRACING
         /**
-        * Jumps to perform in the rendering sequence, in order to avoid Workers that
-        * should not be called. It should always be of the same length as
-        * m_renderingSequence and m_voiceAssignments.
+        * The ID of every Worker in the rendering sequence, used to identify the
+        * workers in the profiling measurements and in the trace.
         */
-        std::vector<uint32_t> m_increments;
+        std::vector<uint32_t> m_workerIDs;
+#endif
 
-        /** Tracks the on/off status of every Voice */
-        bool m_voiceIsOn[ANGLECORE_NUM_VOICES];
-        
         /**
-        * Flag that indicates whether to recompute the increments or not in the next
-        * rendering session. This flag is useful for preventing the Renderer from
-        * updating its increments twice, after a Voice has been turned on or off and
-        * a new ConnectionRequest has been received.
+        * Threads helping the real-time thread to render the voices. This member is
+        * declared last, so that the threads are destroyed before any other member
+        * they could access.
         */
-        bool m_shouldUpdateIncrements;
+        std::vector<std::unique_ptr<HelperThread>> m_helperThreads;
     };
 }
\ No newline at end of file
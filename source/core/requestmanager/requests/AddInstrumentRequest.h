@@ -146,7 +146,8 @@ namespace ANGLECORE
         void process();
 
         /**
-        * Calls the request's Listener to send information about how the request's
+        * Releases the snapshots of the parameter registers that were replaced, and
+        * calls the request's Listener to send information about how the request's
         * execution went.
         */
         void postprocess() override;
@@ -196,7 +197,7 @@ namespace ANGLECORE
     template<class InstrumentType>
     bool AddInstrumentRequest<InstrumentType>::preprocess()
     {
-        std::lock_guard<std::mutex> scopedLock(m_audioWorkflow.getLock());
+        std::lock_guard<Mutex> scopedLock(m_audioWorkflow.getLock());
 
         /* Can we insert a new instrument? We need to find an empty spot first: */
         unsigned short emptyRackNumber = m_audioWorkflow.findEmptyRack();
@@ -235,6 +236,13 @@ namespace ANGLECORE
             m_audioWorkflow.addInstrumentAndPlanBridging(v, m_selectedRackNumber, instrument, connectionPlan, m_parameterRegistrationPlan);
         }
 
+        /*
+        * The parameter registration plan is then turned into new snapshots of the
+        * parameter registers, so that the real-time thread only has to publish
+        * them:
+        */
+        m_audioWorkflow.prepareParameterRegistrationPlan(m_parameterRegistrationPlan);
+
         /*
         * Once here, we have a ConnectionPlan and a ParameterRegisterPlan ready to
         * be used. We now need to precompute the consequences of executing the
@@ -246,7 +254,8 @@ namespace ANGLECORE
         * We first calculate the rendering sequence that will take effect right
         * after the connection plan is executed.
         */
-        std::vector<std::shared_ptr<Worker>> newRenderingSequence = m_audioWorkflow.buildRenderingSequence(connectionPlan);
+        bool isSplittableByVoice;
+        std::vector<std::shared_ptr<Worker>> newRenderingSequence = m_audioWorkflow.buildRenderingSequence(connectionPlan, isSplittableByVoice);
 
         /*
         * And from that sequence, we can precompute and assign the rest of the
@@ -254,7 +263,27 @@ namespace ANGLECORE
         */
         m_connectionRequest.newRenderingSequence = newRenderingSequence;
         m_connectionRequest.newVoiceAssignments = m_audioWorkflow.getVoiceAssignments(newRenderingSequence);
-        m_connectionRequest.oneIncrements.resize(newRenderingSequence.size(), 1);
+        m_connectionRequest.newWorkCalls.reserve(newRenderingSequence.size());
+        for (const std::shared_ptr<Worker>& worker : newRenderingSequence)
+            m_connectionRequest.newWorkCalls.push_back(worker->getWorkCall());
+
+#if ANGLECORE_ENABLE_PROFILING || ANGLECORE_ENABLE_TRACING
+        m_connectionRequest.newWorkerIDs.reserve(newRenderingSequence.size());
+        for (const std::shared_ptr<Worker>& worker : newRenderingSequence)
+            m_connectionRequest.newWorkerIDs.push_back(worker->id);
+#endif
+
+        /*
+        * We also locate each voice within the new sequence, so that the Renderer
+        * can render the voices independently if the sequence allows it.
+        */
+        m_connectionRequest.isSplittableByVoice = isSplittableByVoice && VoiceAssigner::getVoiceSegmentStarts(m_connectionRequest.newVoiceAssignments, m_connectionRequest.newVoiceSegmentStarts);
+
+        /*
+        * Finally, we compute the dependencies between the workers of the new
+        * sequence, so that the Renderer can schedule them across threads.
+        */
+        m_audioWorkflow.buildDependencyGraph(newRenderingSequence, connectionPlan, m_connectionRequest.newPredecessorCounts, m_connectionRequest.newSuccessorOffsets, m_connectionRequest.newSuccessors);
 
         /*
         * If we arrive here, then the preparation went well, so we return true for
@@ -293,6 +322,20 @@ namespace ANGLECORE
     template<class InstrumentType>
     void AddInstrumentRequest<InstrumentType>::postprocess()
     {
+        /*
+        * We first delete the snapshots of the parameter registers that were
+        * replaced during processing, once no other thread reads them anymore. If
+        * the request was not processed, these are simply the snapshots that were
+        * prepared and never published.
+        */
+        m_audioWorkflow.releaseParameterRegistrationPlan(m_parameterRegistrationPlan);
+
+        /*
+        * The embedded ConnectionRequest is never posted on its own, so we
+        * postprocess it here.
+        */
+        m_connectionRequest.postprocess();
+
         if (m_listener)
         {
             if (hasBeenPreprocessed.load() && hasBeenProcessed.load() && success.load())
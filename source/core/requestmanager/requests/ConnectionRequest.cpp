@@ -27,6 +27,7 @@ namespace ANGLECORE
 {
     ConnectionRequest::ConnectionRequest(AudioWorkflow& audioWorkflow, Renderer& renderer) :
         Request(),
+        isSplittableByVoice(false),
         m_audioWorkflow(audioWorkflow),
         m_renderer(renderer)
     {}
@@ -35,7 +36,7 @@ namespace ANGLECORE
     {
         /* We first test if the connection request is valid... */
         uint32_t size = newRenderingSequence.size();
-        if (size > 0 && newVoiceAssignments.size() == size && oneIncrements.size() == size)
+        if (size > 0 && newVoiceAssignments.size() == size && newWorkCalls.size() == size)
         {
             /* The request is valid, so we execute the ConnectionPlan... */
             bool successAfterExecution = m_audioWorkflow.executeConnectionPlan(plan);
@@ -62,4 +63,9 @@ namespace ANGLECORE
             m_renderer.processConnectionRequest(*this);
         }
     }
+
+    void ConnectionRequest::postprocess()
+    {
+        m_audioWorkflow.getStreamArena().collectReleasedBuffers();
+    }
 }
\ No newline at end of file
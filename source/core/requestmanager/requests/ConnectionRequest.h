@@ -32,6 +32,7 @@
 #include "../../audioworkflow/workflow/Worker.h"
 #include "../../audioworkflow/voiceassigner/VoiceAssigner.h"
 #include "../../audioworkflow/AudioWorkflow.h"
+#include "../../../config/RenderingConfig.h"
 
 namespace ANGLECORE
 {
@@ -51,7 +52,7 @@ namespace ANGLECORE
     * computed in advance for the Renderer. To be valid, a ConnectionRequest should
     * verify the following two properties:
     * 1. None of its three vectors newRenderingSequence, newVoiceAssignments, and
-    * oneIncrements should be empty;
+    * newWorkCalls should be empty;
     * 2. All of those three vectors should be of the same length.
     * .
     * To be consistent, both vectors newRenderingSequence and newVoiceAssignments
@@ -70,17 +71,61 @@ namespace ANGLECORE
         */
         void process();
 
+        /**
+        * Makes the stream buffers released during processing available again in
+        * the AudioWorkflow's StreamArena. A Stream destroyed by the real-time
+        * thread only gives its buffer back to the arena without blocking, so the
+        * buffer is collected here, on a non real-time thread.
+        */
+        void postprocess() override;
+
     public:
         ConnectionPlan plan;
         std::vector<std::shared_ptr<Worker>> newRenderingSequence;
         std::vector<VoiceAssignment> newVoiceAssignments;
 
         /**
-        * This vector provides pre-allocated memory for the Renderer's increment
-        * computation. It should always be of the same size as newRenderingSequence
-        * and newVoiceAssignments, and should always end with the number 1.
+        * The WorkCall of every Worker in newRenderingSequence, in the same order.
+        * This is what the Renderer actually uses to call the workers, while the
+        * workers themselves remain owned by the Workflow.
+        */
+        WorkCallSequence newWorkCalls;
+
+#if ANGLECORE_ENABLE_PROFILING || ANGLECORE_ENABLE_TRACING
+        /**
+        * The ID of every Worker in newRenderingSequence, in the same order, which
+        * the Renderer uses to identify its profiling measurements and traces.
+        */
+        std::vector<uint32_t> newWorkerIDs;
+#endif
+
+        /**
+        * Indicates whether newRenderingSequence is grouped by voice, i.e. whether
+        * it consists of a voice-free head, followed by one contiguous segment per
+        * Voice, and a voice-free tail. If so, the Renderer can render each Voice
+        * independently, and possibly in parallel.
+        */
+        bool isSplittableByVoice;
+
+        /**
+        * Position of each Voice's segment within newRenderingSequence, as computed
+        * by VoiceAssigner::getVoiceSegmentStarts(). The last value corresponds to
+        * the start of the voice-free tail. This array is only meaningful if
+        * isSplittableByVoice is true.
+        */
+        uint32_t newVoiceSegmentStarts[ANGLECORE_NUM_VOICES + 1];
+
+        /**
+        * Dependency graph of newRenderingSequence, as computed by
+        * Workflow::buildDependencyGraph(): the number of predecessors of each
+        * Worker, and the positions of each Worker's successors, stored between
+        * newSuccessorOffsets[i] and newSuccessorOffsets[i + 1] in newSuccessors.
+        * These vectors may be left empty, in which case the Renderer will not be
+        * able to use its DEPENDENCY_PARALLEL mode.
         */
-        std::vector<uint32_t> oneIncrements;
+        std::vector<uint32_t> newPredecessorCounts;
+        std::vector<uint32_t> newSuccessorOffsets;
+        std::vector<uint32_t> newSuccessors;
 
     private:
         AudioWorkflow& m_audioWorkflow;
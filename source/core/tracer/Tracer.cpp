@@ -0,0 +1,214 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#include <thread>
+#include <chrono>
+
+#include "Tracer.h"
+
+namespace ANGLECORE
+{
+    /*
+    * Returns the current time, in nanoseconds.
+    */
+    static uint64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /* Tracer::DrainingThread
+    ***************************************************/
+
+    Tracer::DrainingThread::DrainingThread(Tracer& tracer) :
+        Thread(),
+        m_tracer(tracer)
+    {}
+
+    void Tracer::DrainingThread::run()
+    {
+        while (!shouldStop())
+        {
+            m_tracer.drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(ANGLECORE_TRACER_DRAINING_PERIOD));
+        }
+    }
+
+    /* Tracer
+    ***************************************************/
+
+    thread_local unsigned short Tracer::s_currentThreadNumber = 0;
+
+    Tracer::Tracer(unsigned short numThreads) :
+        m_isRecording(false),
+        m_numDroppedEvents(0),
+        m_isFirstEvent(true),
+        m_startTimestamp(0)
+    {
+        m_queues.reserve(numThreads);
+        for (unsigned short t = 0; t < numThreads; t++)
+            m_queues.emplace_back(new EventQueue(ANGLECORE_TRACER_QUEUE_SIZE));
+    }
+
+    Tracer::~Tracer()
+    {
+        stop();
+    }
+
+    bool Tracer::start(const char* filePath)
+    {
+        std::lock_guard<Mutex> scopedLock(m_controlLock);
+
+        /* If we are already recording, there is nothing to do */
+        if (m_drainingThread)
+            return true;
+
+        m_file.open(filePath, std::ios::out | std::ios::trunc);
+        if (!m_file.is_open())
+            return false;
+
+        /*
+        * We discard any event left in the queues from a previous recording, as
+        * those may have been recorded after the previous trace file was closed.
+        */
+        TraceEvent event;
+        for (std::unique_ptr<EventQueue>& queue : m_queues)
+            while (queue->pop(event));
+
+        m_file << "[\n";
+        m_isFirstEvent = true;
+        m_startTimestamp = now();
+        m_numDroppedEvents.store(0);
+        m_isRecording.store(true);
+
+        m_drainingThread.reset(new DrainingThread(*this));
+        m_drainingThread->start();
+        return true;
+    }
+
+    void Tracer::stop()
+    {
+        std::lock_guard<Mutex> scopedLock(m_controlLock);
+
+        if (!m_drainingThread)
+            return;
+
+        /*
+        * We stop recording, and wait for the draining thread to terminate before
+        * writing the last events ourselves.
+        */
+        m_isRecording.store(false);
+        m_drainingThread.reset();
+        drain();
+
+        m_file << "\n]\n";
+        m_file.close();
+    }
+
+    void Tracer::beginEvent(const char* name, uint32_t workerID)
+    {
+        recordEvent(name, workerID, 'B');
+    }
+
+    void Tracer::endEvent(const char* name, uint32_t workerID)
+    {
+        recordEvent(name, workerID, 'E');
+    }
+
+    uint64_t Tracer::getNumDroppedEvents() const
+    {
+        return m_numDroppedEvents.load();
+    }
+
+    void Tracer::setCurrentThreadNumber(unsigned short threadNumber)
+    {
+        s_currentThreadNumber = threadNumber;
+    }
+
+    void Tracer::recordEvent(const char* name, uint32_t workerID, char phase)
+    {
+        if (!m_isRecording.load(std::memory_order_relaxed))
+            return;
+
+        unsigned short threadNumber = s_currentThreadNumber;
+        if (threadNumber >= m_queues.size())
+            return;
+
+        TraceEvent event;
+        event.name = name;
+        event.workerID = workerID;
+        event.timestamp = now();
+        event.threadNumber = threadNumber;
+        event.phase = phase;
+
+        /* If the queue is full, we drop the event and keep track of it */
+        if (!m_queues[threadNumber]->push(std::move(event)))
+            m_numDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Tracer::drain()
+    {
+        TraceEvent event;
+        for (std::unique_ptr<EventQueue>& queue : m_queues)
+        {
+            while (queue->pop(event))
+            {
+                /*
+                * Events that occurred before the recording started come from a
+                * previous recording, so we ignore them.
+                */
+                if (event.timestamp < m_startTimestamp)
+                    continue;
+
+                if (!m_isFirstEvent)
+                    m_file << ",\n";
+                m_isFirstEvent = false;
+
+                /*
+                * The trace event format expects timestamps in microseconds, which
+                * can have a fractional part.
+                */
+                uint64_t elapsed = event.timestamp - m_startTimestamp;
+                m_file << "{\"name\":\"" << event.name << "\",\"cat\":\"ANGLECORE\",\"ph\":\"" << event.phase
+                    << "\",\"ts\":" << elapsed / 1000 << "." << (elapsed % 1000) / 100 << (elapsed % 100) / 10 << elapsed % 10
+                    << ",\"pid\":0,\"tid\":" << event.threadNumber;
+                if (event.workerID != 0)
+                    m_file << ",\"args\":{\"workerID\":" << event.workerID << "}";
+                m_file << "}";
+            }
+        }
+    }
+
+    /* ScopedTraceEvent
+    ***************************************************/
+
+    ScopedTraceEvent::ScopedTraceEvent(Tracer& tracer, const char* name) :
+        m_tracer(tracer),
+        m_name(name)
+    {
+        m_tracer.beginEvent(m_name);
+    }
+
+    ScopedTraceEvent::~ScopedTraceEvent()
+    {
+        m_tracer.endEvent(m_name);
+    }
+}
@@ -0,0 +1,216 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <fstream>
+
+#include "../../config/RenderingConfig.h"
+#include "../../dependencies/farbot/fifo.h"
+#include "../../utility/Thread.h"
+#include "../../utility/RealtimeThreadScope.h"
+
+namespace ANGLECORE
+{
+    /**
+    * \struct TraceEvent Tracer.h
+    * Beginning or end of a traced operation, as recorded by a Tracer.
+    */
+    struct TraceEvent
+    {
+        /** Name of the operation. It must point to a string literal. */
+        const char* name;
+
+        /** ID of the Worker involved in the operation, or 0 if not relevant */
+        uint32_t workerID;
+
+        /** Time of the event, in nanoseconds */
+        uint64_t timestamp;
+
+        /** Number of the thread the event occurred in */
+        unsigned short threadNumber;
+
+        /** 'B' for the beginning of the operation, and 'E' for its end */
+        char phase;
+    };
+
+    /**
+    * \class Tracer Tracer.h
+    * Records the beginning and end of the engine's operations, and writes them
+    * into a file using the Chrome trace event format, which can be opened in
+    * Chrome's about:tracing page or in Perfetto.
+    * .
+    * Each thread that records events owns a single-producer, single-consumer
+    * queue, so that recording an event never blocks nor allocates memory, and can
+    * be done by the real-time thread. A background thread regularly empties the
+    * queues and writes the events into the trace file. Threads identify
+    * themselves with a thread number, 0 being the real-time thread, which they
+    * set using setCurrentThreadNumber().
+    */
+    class Tracer
+    {
+    public:
+
+        /**
+        * Creates a Tracer that does not record anything until start() is called.
+        * This constructor allocates memory, so it should never be called by the
+        * real-time thread.
+        * @param[in] numThreads Number of threads that will record events. Events
+        *   recorded by threads whose number is out of this range are dropped.
+        */
+        Tracer(unsigned short numThreads);
+
+        /** Stops recording, and closes the trace file if necessary. */
+        ~Tracer();
+
+        /**
+        * Opens the given trace file and starts recording events. Returns true if
+        * the file could be opened, and false otherwise. This method should never
+        * be called by the real-time thread.
+        * @param[in] filePath Path of the trace file to create or overwrite.
+        */
+        bool start(const char* filePath);
+
+        /**
+        * Stops recording events, writes the events left into the trace file, and
+        * closes it. This method should never be called by the real-time thread.
+        */
+        void stop();
+
+        /**
+        * Records the beginning of an operation in the calling thread. This method
+        * is lock-free, and can be called by the real-time thread.
+        * @param[in] name Name of the operation. It must point to a string literal.
+        * @param[in] workerID ID of the Worker involved, or 0 if not relevant.
+        */
+        void beginEvent(const char* name, uint32_t workerID = 0);
+
+        /**
+        * Records the end of an operation in the calling thread. This method is
+        * lock-free, and can be called by the real-time thread.
+        * @param[in] name Name of the operation. It must be the same as the one
+        *   used in the matching call to beginEvent().
+        * @param[in] workerID ID of the Worker involved, or 0 if not relevant.
+        */
+        void endEvent(const char* name, uint32_t workerID = 0);
+
+        /**
+        * Returns the number of events that could not be recorded because a queue
+        * was full, since the Tracer was started.
+        */
+        uint64_t getNumDroppedEvents() const;
+
+        /**
+        * Sets the thread number of the calling thread, which identifies its queue
+        * and its track in the trace file. Threads that never call this method are
+        * considered to be the real-time thread.
+        * @param[in] threadNumber The number of the calling thread.
+        */
+        static void setCurrentThreadNumber(unsigned short threadNumber);
+
+    protected:
+
+        typedef farbot::fifo<
+            TraceEvent,
+            farbot::fifo_options::concurrency::single,
+            farbot::fifo_options::concurrency::single,
+            farbot::fifo_options::full_empty_failure_mode::return_false_on_full_or_empty,
+            farbot::fifo_options::full_empty_failure_mode::return_false_on_full_or_empty
+        > EventQueue;
+
+        /**
+        * \class DrainingThread Tracer.h
+        * Thread that regularly writes the events recorded by a Tracer into its
+        * trace file.
+        */
+        class DrainingThread :
+            public Thread
+        {
+        public:
+            DrainingThread(Tracer& tracer);
+
+        protected:
+
+            /**
+            * Writes the events recorded into the trace file every
+            * ANGLECORE_TRACER_DRAINING_PERIOD milliseconds, until the thread is
+            * requested to stop.
+            */
+            void run();
+
+        private:
+            Tracer& m_tracer;
+        };
+
+        /** Records the given event in the calling thread's queue. */
+        void recordEvent(const char* name, uint32_t workerID, char phase);
+
+        /**
+        * Empties every queue, and writes the events into the trace file, if it is
+        * open.
+        */
+        void drain();
+
+    private:
+        std::vector<std::unique_ptr<EventQueue>> m_queues;
+        std::atomic<bool> m_isRecording;
+        std::atomic<uint64_t> m_numDroppedEvents;
+        std::ofstream m_file;
+        bool m_isFirstEvent;
+        uint64_t m_startTimestamp;
+        std::unique_ptr<DrainingThread> m_drainingThread;
+
+        /** Serializes the calls to start() and stop() */
+        Mutex m_controlLock;
+
+        static thread_local unsigned short s_currentThreadNumber;
+    };
+
+    /**
+    * \class ScopedTraceEvent Tracer.h
+    * Records the beginning of an operation upon construction, and its end upon
+    * destruction, so that a whole scope can be traced with a single declaration.
+    */
+    class ScopedTraceEvent
+    {
+    public:
+
+        /**
+        * Records the beginning of the operation.
+        * @param[in] tracer The Tracer to record the operation into.
+        * @param[in] name Name of the operation. It must point to a string literal.
+        */
+        ScopedTraceEvent(Tracer& tracer, const char* name);
+
+        /** Records the end of the operation. */
+        ~ScopedTraceEvent();
+
+    private:
+        Tracer& m_tracer;
+        const char* m_name;
+    };
+}
@@ -0,0 +1,62 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+namespace ANGLECORE
+{
+    /**
+    * \class BitMath BitMath.h
+    * Provides fast and portable bit manipulation routines.
+    */
+    class BitMath
+    {
+    public:
+        BitMath() = delete;
+
+        /**
+        * Returns the position of the least significant bit set in \p value, using
+        * a de Bruijn sequence to avoid any loop or branch. The result is undefined
+        * if \p value equals zero.
+        * @param[in] value The value to inspect. It should not be null.
+        */
+        inline static unsigned short countTrailingZeros(uint64_t value)
+        {
+            static const unsigned short positions[64] =
+            {
+                0, 1, 2, 53, 3, 7, 54, 27, 4, 38, 41, 8, 34, 55, 48, 28,
+                62, 5, 39, 46, 44, 42, 22, 9, 24, 35, 59, 56, 49, 18, 29, 11,
+                63, 52, 6, 26, 37, 40, 33, 47, 61, 45, 43, 21, 23, 58, 17, 10,
+                51, 25, 36, 32, 60, 20, 57, 16, 50, 31, 19, 15, 30, 14, 13, 12
+            };
+
+            /*
+            * Isolating the lowest bit set gives a power of two, which, multiplied by
+            * the de Bruijn constant, places a unique 6-bit pattern in the upper
+            * bits of the product.
+            */
+            return positions[((value & (~value + 1)) * 0x022FDD63CC95386DULL) >> 58];
+        }
+    };
+}
@@ -0,0 +1,100 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace ANGLECORE
+{
+    /**
+    * \class AlignedAllocator AlignedAllocator.h
+    * Standard-compliant allocator that aligns every memory block it allocates on
+    * the given \p Alignment, in bytes. It can be used with standard containers,
+    * for example to ensure the content of a std::vector starts at the beginning of
+    * a cache line. The alignment is achieved by over-allocating memory and storing
+    * the address of the original block right before the aligned one, which keeps
+    * the allocator portable across platforms.
+    */
+    template<class T, std::size_t Alignment>
+    class AlignedAllocator
+    {
+    public:
+        static_assert(Alignment >= sizeof(void*) && (Alignment & (Alignment - 1)) == 0, "The alignment must be a power of two, and at least the size of a pointer.");
+
+        typedef T value_type;
+
+        /** Allows containers to rebind the allocator to another type */
+        template<class U>
+        struct rebind
+        {
+            typedef AlignedAllocator<U, Alignment> other;
+        };
+
+        AlignedAllocator() {}
+
+        template<class U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+        /**
+        * Allocates a memory block that can hold \p n objects of type T, and whose
+        * address is a multiple of Alignment.
+        * @param[in] n Number of objects to allocate memory for.
+        */
+        T* allocate(std::size_t n)
+        {
+            /*
+            * We allocate enough memory to move the block forward up to the next
+            * aligned address, while keeping room for the original address.
+            */
+            char* block = static_cast<char*>(::operator new(n * sizeof(T) + Alignment + sizeof(void*)));
+            std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block + sizeof(void*));
+            char* alignedBlock = reinterpret_cast<char*>((address + Alignment - 1) & ~static_cast<std::uintptr_t>(Alignment - 1));
+            reinterpret_cast<void**>(alignedBlock)[-1] = block;
+            return reinterpret_cast<T*>(alignedBlock);
+        }
+
+        /**
+        * Deallocates a memory block previously returned by allocate().
+        * @param[in] p Address of the memory block.
+        */
+        void deallocate(T* p, std::size_t)
+        {
+            if (p)
+                ::operator delete(reinterpret_cast<void**>(p)[-1]);
+        }
+    };
+
+    template<class T, class U, std::size_t Alignment>
+    bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+    {
+        return true;
+    }
+
+    template<class T, class U, std::size_t Alignment>
+    bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+    {
+        return false;
+    }
+}
@@ -22,7 +22,7 @@
 
 #pragma once
 
-#include <mutex>
+#include "RealtimeThreadScope.h"
 
 namespace ANGLECORE
 {
@@ -42,12 +42,12 @@ namespace ANGLECORE
         * lock a Lockable appropriately when consulting or modifying its content in
         * a multi-threaded environment.
         */
-        std::mutex& getLock()
+        Mutex& getLock()
         {
             return m_lock;
         }
 
     private:
-        std::mutex m_lock;
+        Mutex m_lock;
     };
 }
\ No newline at end of file
@@ -0,0 +1,174 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#include "RealtimeThreadScope.h"
+
+#if ANGLECORE_ENABLE_REALTIME_GUARD
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#include <unistd.h>
+#define ANGLECORE_HAS_BACKTRACE 1
+#else
+#define ANGLECORE_HAS_BACKTRACE 0
+#endif
+
+namespace ANGLECORE
+{
+    /*
+    * Both variables are plain integers, so that accessing them never requires any
+    * dynamic initialization, which could itself allocate memory from within
+    * operator new.
+    */
+
+    /** Number of nested real-time scopes the current thread is in */
+    static thread_local unsigned int s_scopeDepth = 0;
+
+    /**
+    * Whether the current thread is reporting a violation, in which case the
+    * guard is suspended, so that the handler can allocate memory freely.
+    */
+    static thread_local bool s_isReporting = false;
+
+    static std::atomic<RealtimeThreadScope::ViolationHandler> s_violationHandler(nullptr);
+
+    static void defaultViolationHandler(const char* description)
+    {
+        std::fprintf(stderr, "ANGLECORE: %s on a real-time thread\n", description);
+
+#if ANGLECORE_HAS_BACKTRACE
+        void* callStack[64];
+        int numFrames = backtrace(callStack, 64);
+        backtrace_symbols_fd(callStack, numFrames, STDERR_FILENO);
+#endif
+    }
+
+    RealtimeThreadScope::RealtimeThreadScope()
+    {
+        s_scopeDepth++;
+    }
+
+    RealtimeThreadScope::~RealtimeThreadScope()
+    {
+        s_scopeDepth--;
+    }
+
+    bool RealtimeThreadScope::isActive()
+    {
+        return s_scopeDepth > 0 && !s_isReporting;
+    }
+
+    void RealtimeThreadScope::check(const char* description)
+    {
+        if (!isActive())
+            return;
+
+        s_isReporting = true;
+        ViolationHandler handler = s_violationHandler.load();
+        if (handler)
+            handler(description);
+        else
+            defaultViolationHandler(description);
+        s_isReporting = false;
+    }
+
+    void RealtimeThreadScope::setViolationHandler(ViolationHandler handler)
+    {
+        s_violationHandler.store(handler);
+    }
+}
+
+/*
+* =====================================================================
+* GLOBAL ALLOCATION FUNCTIONS
+* =====================================================================
+*/
+
+/*
+* The replaced allocation functions forward to malloc and free, after checking
+* the calling thread is not in a real-time scope.
+*/
+
+void* operator new(std::size_t size)
+{
+    ANGLECORE::RealtimeThreadScope::check("Allocating memory");
+
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    ANGLECORE::RealtimeThreadScope::check("Allocating memory");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer)
+        ANGLECORE::RealtimeThreadScope::check("Deallocating memory");
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    operator delete(pointer);
+}
+
+#endif
@@ -0,0 +1,131 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <mutex>
+
+#include "../config/RenderingConfig.h"
+
+namespace ANGLECORE
+{
+    /**
+    * \class RealtimeThreadScope RealtimeThreadScope.h
+    * Marks the calling thread as a real-time thread for as long as the object
+    * lives. When ANGLECORE_ENABLE_REALTIME_GUARD is set to 1, every memory
+    * allocation and deallocation made through the global operator new and
+    * operator delete, as well as every blocking lock of a Mutex, that occur on a
+    * real-time thread are reported as violations, along with the call stack when
+    * the platform allows it. Scopes can be nested. When the guard is disabled,
+    * this class does nothing and costs nothing.
+    *
+    * Only the locks taken through ANGLECORE's Mutex type are intercepted. A
+    * std::mutex, or any other synchronization primitive, locked on a real-time
+    * thread goes unnoticed, as do system calls that block without allocating,
+    * so the guard can only prove the presence of violations, not their absence.
+    */
+    class RealtimeThreadScope
+    {
+    public:
+
+        /**
+        * Function called whenever a violation occurs, with a short description of
+        * the violation. It is called on the offending thread, while the guard is
+        * suspended, so it is allowed to allocate memory.
+        */
+        typedef void (*ViolationHandler)(const char* description);
+
+#if ANGLECORE_ENABLE_REALTIME_GUARD
+        /** Marks the calling thread as a real-time thread. */
+        RealtimeThreadScope();
+
+        /**
+        * Restores the calling thread's previous state, which is non real-time
+        * unless the scope was nested inside another one.
+        */
+        ~RealtimeThreadScope();
+
+        /** Returns true if the calling thread is currently in a real-time scope. */
+        static bool isActive();
+
+        /**
+        * Reports a violation if the calling thread is currently in a real-time
+        * scope, and does nothing otherwise.
+        * @param[in] description Short description of the violation. It must point
+        *   to a string literal.
+        */
+        static void check(const char* description);
+
+        /**
+        * Replaces the function called on each violation. By default, violations
+        * are printed to the standard error output, along with the call stack on
+        * platforms that support it.
+        * @param[in] handler The new handler. If null, the default one is used.
+        */
+        static void setViolationHandler(ViolationHandler handler);
+#else
+        RealtimeThreadScope() {}
+        static bool isActive() { return false; }
+        static void check(const char*) {}
+        static void setViolationHandler(ViolationHandler) {}
+#endif
+
+        RealtimeThreadScope(const RealtimeThreadScope&) = delete;
+        RealtimeThreadScope& operator=(const RealtimeThreadScope&) = delete;
+    };
+
+#if ANGLECORE_ENABLE_REALTIME_GUARD
+    /**
+    * \class GuardedMutex RealtimeThreadScope.h
+    * Mutex that reports a violation when a real-time thread blocks on it.
+    * Attempting to lock it with try_lock() is allowed, since it never blocks.
+    */
+    class GuardedMutex
+    {
+    public:
+        void lock()
+        {
+            RealtimeThreadScope::check("Locking a mutex");
+            m_mutex.lock();
+        }
+
+        bool try_lock()
+        {
+            return m_mutex.try_lock();
+        }
+
+        void unlock()
+        {
+            m_mutex.unlock();
+        }
+
+    private:
+        std::mutex m_mutex;
+    };
+
+    /** Mutex type used throughout ANGLECORE */
+    typedef GuardedMutex Mutex;
+#else
+    /** Mutex type used throughout ANGLECORE */
+    typedef std::mutex Mutex;
+#endif
+}
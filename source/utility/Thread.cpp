@@ -23,6 +23,17 @@
 #include <thread>
 #include <chrono>
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(_MSC_VER)
+#include <immintrin.h>
+#endif
+
 #include "Thread.h"
 
 /*
@@ -86,4 +97,45 @@ namespace ANGLECORE
     {
         return m_shouldStop.load();
     }
+
+    Thread::Priority Thread::getCurrentPriority()
+    {
+        Priority priority;
+#if defined(_WIN32)
+        priority.policy = 0;
+        priority.level = GetThreadPriority(GetCurrentThread());
+#else
+        sched_param parameters;
+        if (pthread_getschedparam(pthread_self(), &priority.policy, &parameters) == 0)
+            priority.level = parameters.sched_priority;
+        else
+        {
+            priority.policy = SCHED_OTHER;
+            priority.level = 0;
+        }
+#endif
+        return priority;
+    }
+
+    bool Thread::setCurrentPriority(const Priority& priority)
+    {
+#if defined(_WIN32)
+        return SetThreadPriority(GetCurrentThread(), priority.level) != 0;
+#else
+        sched_param parameters;
+        parameters.sched_priority = priority.level;
+        return pthread_setschedparam(pthread_self(), priority.policy, &parameters) == 0;
+#endif
+    }
+
+    void Thread::pause()
+    {
+#if defined(_WIN32)
+        YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
 }
\ No newline at end of file
@@ -58,6 +58,42 @@ namespace ANGLECORE
     {
     public:
 
+        /**
+        * \struct Priority Thread.h
+        * Scheduling policy and priority of a thread, as defined by the operating
+        * system. The policy is only meaningful on POSIX systems.
+        */
+        struct Priority
+        {
+            int policy;
+            int level;
+        };
+
+        /**
+        * Returns the scheduling policy and priority of the calling thread. This
+        * method neither allocates memory nor locks any Mutex.
+        */
+        static Priority getCurrentPriority();
+
+        /**
+        * Gives the calling thread the given scheduling policy and priority, for
+        * example to schedule it like another thread. Returns false if the
+        * operating system refused the change, for example because the process
+        * lacks the required privileges, in which case the thread keeps its
+        * priority.
+        * @param[in] priority The new scheduling policy and priority.
+        */
+        static bool setCurrentPriority(const Priority& priority);
+
+        /**
+        * Tells the processor that the calling thread is busy-waiting, using the
+        * dedicated instruction of the platform (pause on x86, yield on ARM).
+        * Unlike std::this_thread::yield(), this never enters the scheduler of
+        * the operating system, so it cannot hand the core over to another
+        * thread, but it saves power and lets the sibling hardware thread run.
+        */
+        static void pause();
+
         /**
         * Creates a Thread object, but does not effectively spawn the thread. The
         * start() method must be called for that to happen.
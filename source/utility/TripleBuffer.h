@@ -0,0 +1,135 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace ANGLECORE
+{
+    /**
+    * \class TripleBuffer TripleBuffer.h
+    * Lock-free mechanism that allows one producer thread to publish successive
+    * versions of an object to one consumer thread, without either thread ever
+    * waiting for the other. The producer writes into a back buffer and publishes
+    * it, while the consumer reads from a front buffer it can update to the latest
+    * published version. A third buffer sits in between, and is exchanged
+    * atomically by both threads. The producer can therefore be the real-time
+    * thread: publishing never blocks nor allocates memory.
+    * .
+    * The three objects are allocated upon construction, so the type T must be
+    * default constructible and copy assignable.
+    */
+    template<class T>
+    class TripleBuffer
+    {
+    public:
+
+        /** Allocates the three buffers. */
+        TripleBuffer();
+
+        /**
+        * Returns the buffer the producer should write into before publishing it.
+        * This method must only be called by the producer thread.
+        */
+        T& getBackBuffer();
+
+        /**
+        * Publishes the back buffer, making it available to the consumer thread,
+        * and provides a new back buffer to the producer. Note that the content of
+        * the new back buffer is not specified. This method must only be called by
+        * the producer thread.
+        */
+        void publish();
+
+        /**
+        * Makes the front buffer point to the last version published by the
+        * producer, if any. Returns true if a new version was available, and false
+        * otherwise. This method must only be called by the consumer thread.
+        */
+        bool update();
+
+        /**
+        * Returns the buffer the consumer can read from. This method must only be
+        * called by the consumer thread.
+        */
+        const T& getFrontBuffer() const;
+
+    private:
+
+        /**
+        * Flag stored alongside the middle buffer's index, which indicates that the
+        * middle buffer contains a version the consumer has not read yet.
+        */
+        static const unsigned char NEW_DATA = 4;
+        static const unsigned char INDEX_MASK = 3;
+
+        std::unique_ptr<T[]> m_buffers;
+        unsigned char m_back;
+        std::atomic<unsigned char> m_middle;
+        unsigned char m_front;
+    };
+
+    template<class T>
+    TripleBuffer<T>::TripleBuffer() :
+        m_buffers(new T[3]),
+        m_back(0),
+        m_middle(1),
+        m_front(2)
+    {}
+
+    template<class T>
+    T& TripleBuffer<T>::getBackBuffer()
+    {
+        return m_buffers[m_back];
+    }
+
+    template<class T>
+    void TripleBuffer<T>::publish()
+    {
+        /*
+        * We exchange the back and middle buffers, and flag the middle buffer as
+        * new. The release semantics ensure that the consumer will see everything
+        * written into the buffer, while the acquire semantics ensure we do not
+        * start writing into the previous middle buffer before the consumer is done
+        * with it.
+        */
+        m_back = m_middle.exchange(m_back | NEW_DATA, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    template<class T>
+    bool TripleBuffer<T>::update()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & NEW_DATA))
+            return false;
+
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    template<class T>
+    const T& TripleBuffer<T>::getFrontBuffer() const
+    {
+        return m_buffers[m_front];
+    }
+}
@@ -0,0 +1,102 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#pragma comment(lib, "synchronization.lib")
+#else
+#include <chrono>
+#endif
+
+#include "WakeupSignal.h"
+
+/*
+* Longest time, in milliseconds, a thread sleeps on the condition variable
+* before checking the epoch again, on platforms without futexes. This bounds the
+* delay caused by a notification sent while the thread was about to sleep.
+*/
+#define ANGLECORE_WAKEUP_SIGNAL_POLLING_PERIOD 1
+
+namespace ANGLECORE
+{
+    /* The epoch's address is handed over to the operating system as a 32-bit word */
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "std::atomic<uint32_t> must have the same size as uint32_t");
+
+    WakeupSignal::WakeupSignal() :
+        m_epoch(0),
+        m_numWaitingThreads(0)
+    {}
+
+    uint32_t WakeupSignal::getEpoch() const
+    {
+        return m_epoch.load();
+    }
+
+    void WakeupSignal::wait(uint32_t epoch)
+    {
+        /*
+        * We announce ourselves before checking the epoch, so that notifyAll()
+        * either sees us waiting, or has already changed the epoch we check below.
+        * Both operations are sequentially consistent, so they cannot be reordered.
+        */
+        m_numWaitingThreads.fetch_add(1);
+
+        if (m_epoch.load() == epoch)
+        {
+#if defined(__linux__)
+            /*
+            * The kernel checks again that the epoch has not changed before putting
+            * us to sleep, atomically with respect to the FUTEX_WAKE operation.
+            */
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_epoch), FUTEX_WAIT_PRIVATE, epoch, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+            WaitOnAddress(&m_epoch, &epoch, sizeof(epoch), INFINITE);
+#else
+            std::unique_lock<std::mutex> scopedLock(m_lock);
+            m_condition.wait_for(scopedLock, std::chrono::milliseconds(ANGLECORE_WAKEUP_SIGNAL_POLLING_PERIOD), [this, epoch]() { return m_epoch.load() != epoch; });
+#endif
+        }
+
+        m_numWaitingThreads.fetch_sub(1);
+    }
+
+    void WakeupSignal::notifyAll()
+    {
+        m_epoch.fetch_add(1);
+
+        /* We only make a system call if some thread may be sleeping */
+        if (m_numWaitingThreads.load() == 0)
+            return;
+
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_epoch), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+        WakeByAddressAll(&m_epoch);
+#else
+        m_condition.notify_all();
+#endif
+    }
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+#if !defined(__linux__) && !defined(_WIN32)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace ANGLECORE
+{
+    /**
+    * \class WakeupSignal WakeupSignal.h
+    * Lets threads sleep until another thread signals them. The signal is
+    * represented by an epoch number, which notifyAll() increments: a thread
+    * retrieves the current epoch with getEpoch(), checks whether it has anything
+    * to do, and if not, calls wait() with the epoch it retrieved. If notifyAll()
+    * is called in between, wait() returns immediately, so no signal can be lost.
+    * .
+    * notifyAll() never blocks and never allocates memory, so it can be called by
+    * the real-time thread. It only makes a system call when a thread is actually
+    * sleeping. Threads sleep on a futex on Linux, and on their epoch's address on
+    * Windows. On other platforms, they sleep on a condition variable for short
+    * periods of time, as notifyAll() does not lock the corresponding mutex.
+    */
+    class WakeupSignal
+    {
+    public:
+
+        /** Creates a WakeupSignal, with no thread waiting for it. */
+        WakeupSignal();
+
+        WakeupSignal(const WakeupSignal&) = delete;
+        WakeupSignal& operator=(const WakeupSignal&) = delete;
+
+        /**
+        * Returns the current epoch, which should be passed to wait() once the
+        * calling thread has found nothing to do.
+        */
+        uint32_t getEpoch() const;
+
+        /**
+        * Blocks the calling thread until the epoch differs from \p epoch. This
+        * method may also return spuriously, so the caller should check again if it
+        * has anything to do. It must never be called by the real-time thread.
+        * @param[in] epoch The epoch returned by getEpoch().
+        */
+        void wait(uint32_t epoch);
+
+        /**
+        * Starts a new epoch, and wakes up every thread waiting for the signal. This
+        * method never blocks, and can be called by any thread.
+        */
+        void notifyAll();
+
+    private:
+        std::atomic<uint32_t> m_epoch;
+        std::atomic<uint32_t> m_numWaitingThreads;
+
+#if !defined(__linux__) && !defined(_WIN32)
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+#endif
+    };
+}
\ No newline at end of file
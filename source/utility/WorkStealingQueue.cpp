@@ -0,0 +1,102 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#include "WorkStealingQueue.h"
+
+namespace ANGLECORE
+{
+    WorkStealingQueue::WorkStealingQueue(uint32_t capacity) :
+        m_mask(capacity - 1),
+        m_tasks(new std::atomic<uint32_t>[capacity]),
+        m_top(0),
+        m_bottom(0)
+    {}
+
+    void WorkStealingQueue::push(uint32_t task)
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        m_tasks[bottom & m_mask].store(task, std::memory_order_relaxed);
+
+        /*
+        * The release semantics ensure that any thread that sees the new bottom
+        * index also sees the task written above, as well as everything the owner
+        * thread did before pushing it.
+        */
+        m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    bool WorkStealingQueue::pop(uint32_t& task)
+    {
+        /*
+        * We first reserve the bottom task by decrementing the bottom index, and
+        * then check if some thief has taken it in the meantime. The sequentially
+        * consistent fence ensures thieves see the reservation before we read the
+        * top index.
+        */
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        /* Was the queue empty? If so, we restore the bottom index... */
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        /* ... Otherwise, we take the task: */
+        task = m_tasks[bottom & m_mask].load(std::memory_order_relaxed);
+
+        /*
+        * If there are other tasks left, then no thief can compete with us for the
+        * one we took. But if it was the last one, then we need to race against the
+        * thieves by incrementing the top index, just as they would do.
+        */
+        if (top == bottom)
+        {
+            bool hasWon = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return hasWon;
+        }
+        return true;
+    }
+
+    bool WorkStealingQueue::steal(uint32_t& task)
+    {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+        /* Is there anything to steal? */
+        if (top >= bottom)
+            return false;
+
+        /*
+        * We read the task before trying to claim it, as the owner may overwrite
+        * its slot right after we claim it. If another thread claims the task
+        * first, then the value read is simply discarded.
+        */
+        task = m_tasks[top & m_mask].load(std::memory_order_relaxed);
+        return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,85 @@
+/**********************************************************************
+**
+** This file is part of ANGLECORE, an open-source software development
+** kit for audio plugins.
+**
+** ANGLECORE is free software: you can redistribute it and / or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** ANGLECORE is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with ANGLECORE.If not, see <https://www.gnu.org/licenses/>.
+**
+** Copyright(C) 2020, ANGLE
+**
+**********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+
+namespace ANGLECORE
+{
+    /**
+    * \class WorkStealingQueue WorkStealingQueue.h
+    * Fixed-capacity, lock-free double-ended queue of task numbers, based on the
+    * Chase-Lev algorithm. The queue has one owner thread, which pushes and pops
+    * tasks at the bottom of the queue, while any other thread can steal tasks from
+    * the top of the queue.
+    * .
+    * The indices of the queue's ends only ever increase, and are mapped onto the
+    * internal buffer using a bit mask. As a consequence, the queue never moves or
+    * reallocates memory after creation, and can be used by real-time threads. It
+    * is the responsibility of the owner thread not to push more tasks than the
+    * queue's capacity.
+    */
+    class WorkStealingQueue
+    {
+    public:
+
+        /**
+        * Creates an empty queue. This constructor allocates memory, so it should
+        * never be called by the real-time thread.
+        * @param[in] capacity Maximum number of tasks the queue can hold at the same
+        *   time. It must be a power of two.
+        */
+        WorkStealingQueue(uint32_t capacity);
+
+        /**
+        * Pushes a task at the bottom of the queue. This method must only be called
+        * by the owner thread.
+        * @param[in] task The task to push.
+        */
+        void push(uint32_t task);
+
+        /**
+        * Pops a task from the bottom of the queue. Returns true if a task could be
+        * popped, and false if the queue was empty. This method must only be called
+        * by the owner thread.
+        * @param[out] task The task popped, if any.
+        */
+        bool pop(uint32_t& task);
+
+        /**
+        * Steals a task from the top of the queue. Returns true if a task could be
+        * stolen, and false if the queue was empty or if another thread took the
+        * task first. This method can be called by any thread.
+        * @param[out] task The task stolen, if any.
+        */
+        bool steal(uint32_t& task);
+
+    private:
+        const int64_t m_mask;
+        std::unique_ptr<std::atomic<uint32_t>[]> m_tasks;
+        std::atomic<int64_t> m_top;
+        std::atomic<int64_t> m_bottom;
+    };
+}